@@ -83,7 +83,7 @@ void Isf_isp(
 void Int_isp(
      Word16 isp_old[],                     /* input : isps from past frame              */
      Word16 isp_new[],                     /* input : isps from present frame           */
-     Word16 frac[],                        /* input : fraction for 3 first subfr (Q15)  */
+     const Word16 frac[],                  /* input : fraction for 3 first subfr (Q15)  */
      Word16 Az[]                           /* output: LP coefficients in 4 subframes    */
 );
 void Weight_a(
@@ -141,7 +141,7 @@ void Disf_ns(
 );
 Word16 Sub_VQ(                             /* output: return quantization index     */
      Word16 * x,                           /* input : ISF residual vector           */
-     Word16 * dico,                        /* input : quantization codebook         */
+     const Word16 * dico,                  /* input : quantization codebook         */
      Word16 dim,                           /* input : dimention of vector           */
      Word16 dico_size,                     /* input : size of quantization codebook */
      Word32 * distance                     /* output: error of quantization         */
@@ -409,6 +409,25 @@ void ACELP_4t64_fx(
 										   /* (o) : index (72): 10+2+10+2+10+14+10+14 = 72 bits.     */
 										   /* (o) : index (88): 11+11+11+11+11+11+11+11 = 88 bits.   */
 );
+/* ACELP_4t64_fx() specialized per mode (c4t64fx.inc), same arguments and indices; */
+/* grp runs the iterations of the search together (taskgrp.h), NULL: in turn       */
+struct Task_Group;
+void ACELP_4t64_9k_fx(Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 _index[],
+     struct Task_Group *grp);
+void ACELP_4t64_12k_fx(Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 _index[],
+     struct Task_Group *grp);
+void ACELP_4t64_14k_fx(Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 _index[],
+     struct Task_Group *grp);
+void ACELP_4t64_16k_fx(Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 _index[],
+     struct Task_Group *grp);
+void ACELP_4t64_18k_fx(Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 _index[],
+     struct Task_Group *grp);
+void ACELP_4t64_20k_fx(Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 _index[],
+     struct Task_Group *grp);
+void ACELP_4t64_23k_fx(Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 _index[],
+     struct Task_Group *grp);
+void ACELP_4t64_24k_fx(Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 _index[],
+     struct Task_Group *grp);
 void DEC_ACELP_4t64_fx(
      Word16 index[],                       /* (i) : index (20): 5+5+5+5 = 20 bits.                 */
 										   /* (i) : index (36): 9+9+9+9 = 36 bits.                 */
@@ -433,7 +452,7 @@ void Pit_shrp(
  *-----------------------------------------------------------------*/
 
 void Copy(
-     Word16 x[],                           /* (i)   : input vector   */
+     const Word16 x[],                     /* (i)   : input vector   */
      Word16 y[],                           /* (o)   : output vector  */
      Word16 L                              /* (i)   : vector length  */
 );
@@ -441,6 +460,12 @@ void Set_zero(
      Word16 x[],                           /* (o)    : vector to clear     */
      Word16 L                              /* (i)    : length of vector    */
 );
+void Fir_sym31(
+     Word16 x[],                           /* (i)   : memory + input, lg+30 samples */
+     const Word16 fir[],                   /* (i)   : symmetric coefficients (31)   */
+     Word16 y[],                           /* (o)   : output, lg samples            */
+     Word16 lg                             /* (i)   : number of outputs             */
+);
 void Updt_tar(
      Word16 * x,                           /* (i) Q0  : old target (for pitch search)     */
      Word16 * x2,                          /* (o) Q0  : new target (for codebook search)  */
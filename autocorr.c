@@ -10,11 +10,12 @@
 #include "oper_32b.h"
 #include "acelp.h"
 #include "count.h"
+#include "cpu_disp.h"
 
 #include "ham_wind.tab"
 
 
-void Autocorr(
+void Autocorr_ref(
      Word16 x[],                           /* (i)    : Input signal                      */
      Word16 m,                             /* (i)    : LPC order                         */
      Word16 r_h[],                         /* (o) Q15: Autocorrelations  (msb)           */
@@ -79,3 +80,19 @@ void Autocorr(
 
     return;
 }
+
+void Autocorr(
+     Word16 x[],                           /* (i)    : Input signal                      */
+     Word16 m,                             /* (i)    : LPC order                         */
+     Word16 r_h[],                         /* (o) Q15: Autocorrelations  (msb)           */
+     Word16 r_l[]                          /* (o)    : Autocorrelations  (lsb)           */
+)
+{
+#if (WMOPS == 0)
+    disp_kern->autocorr(x, m, r_h, r_l);
+#else
+    Autocorr_ref(x, m, r_h, r_l);
+#endif
+
+    return;
+}
@@ -5,8 +5,21 @@
  | $Id $
  |___________________________________________________________________________|
 */
-extern Flag Overflow;
-extern Flag Carry;
+
+/* Without complexity counting, the flags are per thread: the codebook
+ * searches (taskgrp.c), the pipelined encoder (cod_pipe.c) and the
+ * real-time scheduler (rtsched.c) run the basic operators on several
+ * threads. With WMOPS, the counters of count.c are global anyway. */
+#if (WMOPS == 0) && defined(__GNUC__)
+#define BASOP_TLS __thread
+#elif (WMOPS == 0) && defined(_MSC_VER)
+#define BASOP_TLS __declspec(thread)
+#else
+#define BASOP_TLS
+#endif
+
+extern BASOP_TLS Flag Overflow;
+extern BASOP_TLS Flag Carry;
 
 #define MAX_32 (Word32)0x7fffffffL
 #define MIN_32 (Word32)0x80000000L
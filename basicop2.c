@@ -36,8 +36,8 @@ Word16 saturate (Word32 L_var1);
  |   Constants and Globals                                                   |
  |___________________________________________________________________________|
 */
-Flag Overflow = 0;
-Flag Carry = 0;
+BASOP_TLS Flag Overflow = 0;
+BASOP_TLS Flag Carry = 0;
 
 /*___________________________________________________________________________
  |                                                                           |
@@ -0,0 +1,686 @@
+/*___________________________________________________________________________
+ |                                                                           |
+ | Fixed-point C simulation of AMR WB ACELP coding algorithm with 20 ms      |
+ | speech frames for wideband speech signals.                                |
+ |___________________________________________________________________________|
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#define POSIX_WORKERS
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/select.h>
+#include <signal.h>
+#endif
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "cnst.h"
+#include "main.h"
+#include "bits.h"
+#include "dtx.h"
+#include "count.h"
+#include "pcm_io.h"
+
+/*-------------------------------------------------------------------*
+ * BATCH.C                                                           *
+ * ~~~~~~~                                                           *
+ * Encodes and decodes many files in one process invocation.         *
+ *                                                                   *
+ *    Usage : batch (-j workers) manifest_file                       *
+ *                                                                   *
+ *    One job per line of manifest_file (empty lines and lines       *
+ *    starting with '#' are skipped):                                *
+ *                                                                   *
+ *      enc (-dtx) (-itu | -mime) mode speech_file bitstream_file    *
+ *      dec (-itu | -mime) bitstream_file synth_file                 *
+ *                                                                   *
+ *    The options and files are those of the coder and decoder       *
+ *    programs (16-bit speech files) and the outputs are identical.  *
+ *                                                                   *
+ *    The jobs run on a pool of worker processes (default: one per   *
+ *    processor; a worker process also with -j 1, so a corrupt file  *
+ *    stops the worker only). Each worker allocates one encoder and  *
+ *    one decoder and resets them (Reset_encoder(), Reset_decoder()) *
+ *    for each file. Nothing is printed per frame; a line is printed *
+ *    for each file which fails, and the aggregate throughput at the *
+ *    end. Without POSIX processes the jobs run in sequence.         *
+ *-------------------------------------------------------------------*/
+
+#define MAX_WORKERS  64
+#define MAX_LINE     1024
+
+typedef struct
+{
+    Word16 encode;                         /* 1: coder(), 0: decoder()                 */
+    Word16 mode;                           /* encoder mode 0..8                        */
+    Word16 allow_dtx;
+    Word16 bitstreamformat;                /* 0: default, 1: ITU, 2: MIME              */
+    char *in;
+    char *out;
+    long line;                             /* line in the manifest                     */
+} Job;
+
+typedef struct
+{
+    long job;
+    long frames;                           /* frames processed, -1: error              */
+} Result;
+
+typedef struct
+{
+    void *enc_state;                       /* reused for all the jobs of the worker    */
+    void *dec_state;
+    TX_State *tx_state;
+    RX_State *rx_state;
+} Worker;
+
+/*-----------------------------------------------------------------*
+ *   Encode_file: one "enc" job, as coder.c                        *
+ *-----------------------------------------------------------------*/
+
+static long Encode_file(Worker * w, Job * job)
+{
+    FILE *f_speech, *f_serial;
+    PCM_State *pcm_state;
+    Word16 signal[L_FRAME16k];
+    Word16 prms[NB_BITS_MAX];
+    Word16 coding_mode, nb_bits, reset_flag, dtx_skip, i;
+    long frame;
+
+    if ((f_speech = fopen(job->in, "rb")) == NULL)
+    {
+        fprintf(stderr, "line %ld: error opening input file %s\n", job->line, job->in);
+        return -1;
+    }
+    Blk_buffer(f_speech);
+    if (Init_read_pcm(&pcm_state, f_speech, PCM_LINEAR, 0) != 0)
+    {
+        fprintf(stderr, "line %ld: error reading input file %s\n", job->line, job->in);
+        fclose(f_speech);
+        return -1;
+    }
+    if ((f_serial = fopen(job->out, "wb")) == NULL)
+    {
+        fprintf(stderr, "line %ld: error opening output file %s\n", job->line, job->out);
+        Close_read_pcm(pcm_state);
+        fclose(f_speech);
+        return -1;
+    }
+    Blk_buffer(f_serial);
+
+    Reset_encoder(w->enc_state, 1);
+    Reset_write_serial(w->tx_state);
+
+    if (job->bitstreamformat == 2)
+    {
+        fwrite("#!AMR-WB\n", sizeof(char), 9, f_serial);
+    }
+
+    frame = 0;
+    while (Read_pcm(f_speech, signal, L_FRAME16k, pcm_state) == L_FRAME16k)
+    {
+        frame++;
+        coding_mode = job->mode;
+
+        reset_flag = encoder_homing_frame_test(signal);
+
+        for (i = 0; i < L_FRAME16k; i++)   /* Delete the 2 LSBs (14-bit input) */
+        {
+            signal[i] = (Word16) (signal[i] & 0xfffC);
+        }
+
+        dtx_skip = DTX_SKIP_NONE;
+        if ((job->allow_dtx != 0) && (job->mode != MODE_24k) && Tx_dtx_no_data(w->tx_state))
+        {
+            dtx_skip = (Word16) ((job->bitstreamformat == 0) ? DTX_SKIP_SYN : DTX_SKIP_SID);
+        }
+        Set_encoder_dtx_skip(w->enc_state, dtx_skip);
+        coder(&coding_mode, signal, prms, &nb_bits, w->enc_state, job->allow_dtx);
+
+        Write_serial(f_serial, prms, coding_mode, job->mode, w->tx_state, job->bitstreamformat);
+
+        if (reset_flag != 0)
+        {
+            Reset_encoder(w->enc_state, 1);
+        }
+    }
+
+    Close_read_pcm(pcm_state);
+    fclose(f_speech);
+    if (fclose(f_serial) != 0)
+    {
+        fprintf(stderr, "line %ld: error writing output file %s\n", job->line, job->out);
+        return -1;
+    }
+
+    return frame;
+}
+
+/*-----------------------------------------------------------------*
+ *   Decode_file: one "dec" job, as decoder.c                      *
+ *-----------------------------------------------------------------*/
+
+static long Decode_file(Worker * w, Job * job)
+{
+    FILE *f_serial, *f_synth;
+    PCM_State *pcm_state;
+    Word16 synth[L_FRAME16k];
+    Word16 prms[NB_BITS_MAX];
+    Word16 mode, frame_type, frame_length, i;
+    Word16 reset_flag, reset_flag_old, mode_old;
+    char magic[10];
+    long frame;
+
+    if ((f_serial = fopen(job->in, "rb")) == NULL)
+    {
+        fprintf(stderr, "line %ld: error opening input file %s\n", job->line, job->in);
+        return -1;
+    }
+    Blk_buffer(f_serial);
+    if (job->bitstreamformat == 2)
+    {
+        if ((fread(magic, sizeof(char), 9, f_serial) != 9) || (strncmp(magic, "#!AMR-WB\n", 9) != 0))
+        {
+            fprintf(stderr, "line %ld: invalid magic number in %s\n", job->line, job->in);
+            fclose(f_serial);
+            return -1;
+        }
+    }
+    if ((f_synth = fopen(job->out, "wb")) == NULL)
+    {
+        fprintf(stderr, "line %ld: error opening output file %s\n", job->line, job->out);
+        fclose(f_serial);
+        return -1;
+    }
+    Blk_buffer(f_synth);
+    Init_write_pcm(&pcm_state, f_synth, PCM_LINEAR, 0);
+
+    Reset_decoder(w->dec_state, 1);
+    Reset_read_serial(w->rx_state);
+    Map_read_serial(w->rx_state, f_serial);
+
+    reset_flag = 0;
+    reset_flag_old = 1;
+    mode_old = 0;
+    frame = 0;
+
+    while (Read_serial(f_serial, prms, &frame_type, &mode, w->rx_state, job->bitstreamformat) != 0)
+    {
+        frame++;
+
+        if ((frame_type == RX_NO_DATA) || (frame_type == RX_SPEECH_LOST))
+        {
+            mode = mode_old;
+            reset_flag = 0;
+        } else
+        {
+            mode_old = mode;
+
+            /* if homed: check if this frame is another homing frame */
+            if (reset_flag_old == 1)
+            {
+                reset_flag = decoder_homing_frame_test_first(prms, mode);
+            }
+        }
+
+        /* produce encoder homing frame if homed & input=decoder homing frame */
+        if ((reset_flag != 0) && (reset_flag_old != 0))
+        {
+            for (i = 0; i < L_FRAME16k; i++)
+            {
+                synth[i] = EHF_MASK;
+            }
+        } else
+        {
+            decoder(mode, prms, synth, &frame_length, w->dec_state, frame_type);
+        }
+
+        for (i = 0; i < L_FRAME16k; i++)   /* Delete the 2 LSBs (14-bit output) */
+        {
+            synth[i] = (Word16) (synth[i] & 0xfffC);
+        }
+        Write_pcm(f_synth, synth, L_FRAME16k, pcm_state);
+
+        /* if not homed: check whether current frame is a homing frame */
+        if (reset_flag_old == 0)
+        {
+            reset_flag = decoder_homing_frame_test(prms, mode);
+        }
+        if (reset_flag != 0)
+        {
+            Reset_decoder(w->dec_state, 1);
+        }
+        reset_flag_old = reset_flag;
+    }
+
+    Close_write_pcm(pcm_state, f_synth);
+    fclose(f_serial);
+    if (fclose(f_synth) != 0)
+    {
+        fprintf(stderr, "line %ld: error writing output file %s\n", job->line, job->out);
+        return -1;
+    }
+
+    return frame;
+}
+
+static void Init_worker(Worker * w)
+{
+    Init_coder(&(w->enc_state));
+    Init_decoder(&(w->dec_state));
+    Init_write_serial(&(w->tx_state));
+    Init_read_serial(&(w->rx_state));
+    if ((w->enc_state == NULL) || (w->dec_state == NULL) || (w->tx_state == NULL) || (w->rx_state == NULL))
+    {
+        fprintf(stderr, "batch: can not init encoder/decoder\n");
+        exit(1);
+    }
+    return;
+}
+
+static void Close_worker(Worker * w)
+{
+    Close_coder(w->enc_state);
+    Close_decoder(w->dec_state);
+    Close_write_serial(w->tx_state);
+    Close_read_serial(w->rx_state);
+    return;
+}
+
+static long Run_job(Worker * w, Job * job)
+{
+    return job->encode ? Encode_file(w, job) : Decode_file(w, job);
+}
+
+/*-----------------------------------------------------------------*
+ *   Read_manifest: jobs of the manifest file                      *
+ *-----------------------------------------------------------------*/
+
+static char *Copy_string(const char *s)
+{
+    char *p;
+
+    if ((p = (char *) malloc(strlen(s) + 1)) == NULL)
+    {
+        fprintf(stderr, "batch: can not malloc manifest\n");
+        exit(1);
+    }
+    strcpy(p, s);
+    return p;
+}
+
+static long Read_manifest(FILE * f, Job ** jobs)
+{
+    char buf[MAX_LINE], *tok[8], *p;
+    long nb_jobs, size, line;
+    Word16 nb_tok, k;
+    Job *job;
+
+    nb_jobs = 0;
+    size = 256;
+    if ((*jobs = (Job *) malloc(size * sizeof(Job))) == NULL)
+    {
+        fprintf(stderr, "batch: can not malloc manifest\n");
+        exit(1);
+    }
+
+    for (line = 1; fgets(buf, MAX_LINE, f) != NULL; line++)
+    {
+        nb_tok = 0;
+        for (p = strtok(buf, " \t\r\n"); (p != NULL) && (nb_tok < 8); p = strtok(NULL, " \t\r\n"))
+        {
+            tok[nb_tok++] = p;
+        }
+        if ((nb_tok == 0) || (tok[0][0] == '#'))
+        {
+            continue;
+        }
+
+        if (nb_jobs == size)
+        {
+            size *= 2;
+            if ((*jobs = (Job *) realloc(*jobs, size * sizeof(Job))) == NULL)
+            {
+                fprintf(stderr, "batch: can not malloc manifest\n");
+                exit(1);
+            }
+        }
+        job = &((*jobs)[nb_jobs]);
+        job->line = line;
+        job->allow_dtx = 0;
+        job->bitstreamformat = 0;
+        job->mode = 0;
+
+        if (strcmp(tok[0], "enc") == 0)
+        {
+            job->encode = 1;
+        } else if (strcmp(tok[0], "dec") == 0)
+        {
+            job->encode = 0;
+        } else
+        {
+            fprintf(stderr, "manifest line %ld: 'enc' or 'dec' expected\n", line);
+            exit(1);
+        }
+
+        for (k = 1; (k < nb_tok) && (tok[k][0] == '-'); k++)
+        {
+            if ((strcmp(tok[k], "-dtx") == 0) && job->encode)
+                job->allow_dtx = 1;
+            else if (strcmp(tok[k], "-itu") == 0)
+                job->bitstreamformat = 1;
+            else if (strcmp(tok[k], "-mime") == 0)
+                job->bitstreamformat = 2;
+            else
+            {
+                fprintf(stderr, "manifest line %ld: unknown option %s\n", line, tok[k]);
+                exit(1);
+            }
+        }
+
+        if (job->encode)
+        {
+            if ((nb_tok - k != 3) || (atoi(tok[k]) < 0) || (atoi(tok[k]) > 8))
+            {
+                fprintf(stderr, "manifest line %ld: enc (-dtx) (-itu | -mime) mode speech_file bitstream_file\n", line);
+                exit(1);
+            }
+            job->mode = (Word16) atoi(tok[k++]);
+        } else if (nb_tok - k != 2)
+        {
+            fprintf(stderr, "manifest line %ld: dec (-itu | -mime) bitstream_file synth_file\n", line);
+            exit(1);
+        }
+        job->in = Copy_string(tok[k]);
+        job->out = Copy_string(tok[k + 1]);
+        nb_jobs++;
+    }
+
+    return nb_jobs;
+}
+
+static double Wall_time(void)
+{
+#ifdef POSIX_WORKERS
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (double) tv.tv_sec + 1e-6 * (double) tv.tv_usec;
+#else
+    return (double) time(NULL);
+#endif
+}
+
+#ifdef POSIX_WORKERS
+
+/*-----------------------------------------------------------------*
+ *   Run_pool: the jobs on nb_workers processes. Each worker reads *
+ *   job numbers from its pipe and answers with a Result; a job is *
+ *   given to a worker when its previous one is done. A worker     *
+ *   which dies (the bitstream reader exits on a corrupt file)     *
+ *   fails its job and is replaced.                                *
+ *-----------------------------------------------------------------*/
+
+typedef struct
+{
+    pid_t pid;
+    int to_w;                              /* job numbers to the worker                */
+    int from_w;                            /* results from the worker                  */
+    long job;                              /* job of the worker, -1: idle              */
+} Pool_Worker;
+
+static void Start_worker(Pool_Worker pool[], Word16 k, Word16 nb_workers, Job * jobs)
+{
+    int to_w[2], from_w[2];
+    Word16 i;
+    Result res;
+    Worker w;
+
+    if ((pipe(to_w) != 0) || (pipe(from_w) != 0))
+    {
+        perror("batch: pipe");
+        exit(1);
+    }
+    fflush(stderr);
+    if ((pool[k].pid = fork()) < 0)
+    {
+        perror("batch: fork");
+        exit(1);
+    }
+    if (pool[k].pid == 0)
+    {
+        /* worker: pipes of the other workers closed */
+        for (i = 0; i < nb_workers; i++)
+        {
+            if ((i != k) && (pool[i].to_w >= 0))
+            {
+                close(pool[i].to_w);
+                close(pool[i].from_w);
+            }
+        }
+        close(to_w[1]);
+        close(from_w[0]);
+
+        Init_worker(&w);
+        while (read(to_w[0], &res.job, sizeof(res.job)) == sizeof(res.job))
+        {
+            res.frames = Run_job(&w, &jobs[res.job]);
+            fflush(stderr);
+            if (write(from_w[1], &res, sizeof(res)) != sizeof(res))
+            {
+                break;
+            }
+        }
+        Close_worker(&w);
+        _exit(0);
+    }
+    close(to_w[0]);
+    close(from_w[1]);
+    pool[k].to_w = to_w[1];
+    pool[k].from_w = from_w[0];
+    pool[k].job = -1;
+
+    return;
+}
+
+static void Run_pool(Job * jobs, long nb_jobs, long frames[], Word16 nb_workers)
+{
+    Pool_Worker pool[MAX_WORKERS];
+    long next, nb_done;
+    Word16 k;
+    Result res;
+    fd_set rd;
+    int max_fd;
+
+    signal(SIGPIPE, SIG_IGN);              /* a dead worker fails its job only */
+
+    for (k = 0; k < nb_workers; k++)
+    {
+        pool[k].to_w = -1;
+        pool[k].from_w = -1;
+    }
+    for (k = 0; k < nb_workers; k++)
+    {
+        Start_worker(pool, k, nb_workers, jobs);
+    }
+
+    next = 0;
+    nb_done = 0;
+    while (nb_done < nb_jobs)
+    {
+        /* a job for each idle worker */
+        for (k = 0; (k < nb_workers) && (next < nb_jobs); k++)
+        {
+            if (pool[k].job < 0)
+            {
+                pool[k].job = next++;
+                if (write(pool[k].to_w, &(pool[k].job), sizeof(long)) != sizeof(long))
+                {
+                    break;                 /* dead: seen by select() */
+                }
+            }
+        }
+
+        FD_ZERO(&rd);
+        max_fd = -1;
+        for (k = 0; k < nb_workers; k++)
+        {
+            if (pool[k].job >= 0)
+            {
+                FD_SET(pool[k].from_w, &rd);
+                if (pool[k].from_w > max_fd)
+                    max_fd = pool[k].from_w;
+            }
+        }
+        if (select(max_fd + 1, &rd, NULL, NULL, NULL) < 0)
+        {
+            perror("batch: select");
+            exit(1);
+        }
+
+        for (k = 0; k < nb_workers; k++)
+        {
+            if ((pool[k].job < 0) || !FD_ISSET(pool[k].from_w, &rd))
+            {
+                continue;
+            }
+            if (read(pool[k].from_w, &res, sizeof(res)) == sizeof(res))
+            {
+                frames[res.job] = res.frames;
+            } else
+            {
+                fprintf(stderr, "line %ld: failed (worker stopped)\n", jobs[pool[k].job].line);
+                frames[pool[k].job] = -1;
+
+                close(pool[k].to_w);
+                close(pool[k].from_w);
+                waitpid(pool[k].pid, NULL, 0);
+                pool[k].to_w = -1;
+                pool[k].from_w = -1;
+                Start_worker(pool, k, nb_workers, jobs);
+            }
+            pool[k].job = -1;
+            nb_done++;
+        }
+    }
+
+    for (k = 0; k < nb_workers; k++)
+    {
+        close(pool[k].to_w);
+        close(pool[k].from_w);
+    }
+    for (k = 0; k < nb_workers; k++)
+    {
+        waitpid(pool[k].pid, NULL, 0);
+    }
+    return;
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    FILE *f_manifest;
+    Job *jobs;
+    long nb_jobs, j, nb_failed, nb_frames, *frames;
+    Word16 nb_workers;
+    double t0, t;
+#ifndef POSIX_WORKERS
+    Worker w;
+#endif
+
+    fprintf(stderr, "\n");
+    fprintf(stderr, " ==================================================================================================\n");
+    fprintf(stderr, " AMR Wideband Codec 3GPP TS26.190 / ITU-T G.722.2, Aug 25, 2003. Version %s.\n", CODEC_VERSION);
+    fprintf(stderr, " ==================================================================================================\n");
+    fprintf(stderr, "\n");
+
+#ifdef POSIX_WORKERS
+    nb_workers = (Word16) sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    nb_workers = 1;
+#endif
+    if ((argc > 2) && (strcmp(argv[1], "-j") == 0))
+    {
+        nb_workers = (Word16) atoi(argv[2]);
+        argv += 2;
+        argc -= 2;
+    }
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage : batch  (-j workers) manifest_file\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "One job per line of manifest_file:\n");
+        fprintf(stderr, "  enc (-dtx) (-itu | -mime) mode speech_file bitstream_file\n");
+        fprintf(stderr, "  dec (-itu | -mime) bitstream_file synth_file\n");
+        fprintf(stderr, "Options and file formats as the coder and decoder programs (16-bit speech files).\n");
+        fprintf(stderr, "-j: number of worker processes (default: number of processors)\n");
+        fprintf(stderr, "\n");
+        exit(0);
+    }
+    if (nb_workers < 1)
+        nb_workers = 1;
+    if (nb_workers > MAX_WORKERS)
+        nb_workers = MAX_WORKERS;
+
+    if ((f_manifest = fopen(argv[1], "r")) == NULL)
+    {
+        fprintf(stderr, "Manifest file '%s' does not exist !!\n", argv[1]);
+        exit(0);
+    }
+    nb_jobs = Read_manifest(f_manifest, &jobs);
+    fclose(f_manifest);
+    if ((frames = (long *) malloc((nb_jobs + 1) * sizeof(long))) == NULL)
+    {
+        fprintf(stderr, "batch: can not malloc manifest\n");
+        exit(1);
+    }
+    if (nb_workers > nb_jobs)
+        nb_workers = (Word16) (nb_jobs > 0 ? nb_jobs : 1);
+    fprintf(stderr, "%ld jobs, %d workers\n", nb_jobs, nb_workers);
+
+    t0 = Wall_time();
+#ifdef POSIX_WORKERS
+    /* a worker process even for -j 1: a corrupt file stops the worker only */
+    Run_pool(jobs, nb_jobs, frames, nb_workers);
+#else
+    Init_worker(&w);
+    for (j = 0; j < nb_jobs; j++)
+    {
+        frames[j] = Run_job(&w, &jobs[j]);
+    }
+    Close_worker(&w);
+#endif
+    t = Wall_time() - t0;
+
+    nb_failed = 0;
+    nb_frames = 0;
+    for (j = 0; j < nb_jobs; j++)
+    {
+        if (frames[j] < 0)
+            nb_failed++;
+        else
+            nb_frames += frames[j];
+    }
+    fprintf(stderr, "Files:      %ld done, %ld failed\n", nb_jobs - nb_failed, nb_failed);
+    fprintf(stderr, "Frames:     %ld (%.1f s of speech)\n", nb_frames, (double) nb_frames * 0.02);
+    fprintf(stderr, "Time:       %.2f s, %.0f frames/s, %.1f x real time\n", t,
+        t > 0.0 ? (double) nb_frames / t : 0.0, t > 0.0 ? (double) nb_frames * 0.02 / t : 0.0);
+
+    for (j = 0; j < nb_jobs; j++)
+    {
+        free(jobs[j].in);
+        free(jobs[j].out);
+    }
+    free(jobs);
+    free(frames);
+
+    return (nb_failed != 0);
+}
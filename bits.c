@@ -13,6 +13,7 @@
 #include "acelp.h"
 #include "count.h"
 #include "dtx.h"
+#include "rtp_pl.h"
 
 #include "mime_io.tab"
 
@@ -31,6 +32,7 @@ Word16 Init_write_serial(TX_State ** st)
         fprintf(stderr, "write_serial_init: can not malloc state structure\n");
         return -1;
     }
+    s->rtp = NULL;
     Reset_write_serial(s);
     *st = s;
 
@@ -43,6 +45,10 @@ Word16 Close_write_serial(TX_State *st)
     test();
     if (st != NULL)
     {
+        if (st->rtp != NULL)
+        {
+            Close_rtp(st->rtp);
+        }
         free(st);
         st = NULL;
         return 0;
@@ -57,12 +63,15 @@ void Reset_write_serial(TX_State * st)
     st->prev_ft = TX_SPEECH;
 }
 
-void Write_serial(FILE * fp, Word16 prms[], Word16 coding_mode, Word16 mode, TX_State *st, Word16 bitstreamformat)
+/*-----------------------------------------------------*
+ * Tx_frame_type -> SID scheduling of the DTX frames   *
+ *   returns TX_SPEECH, TX_SID_FIRST, TX_SID_UPDATE    *
+ *   or TX_NO_DATA for the frame coded in coding_mode  *
+ *-----------------------------------------------------*/
+
+Word16 Tx_frame_type(TX_State *st, Word16 coding_mode)
 {
-   Word16 i, frame_type;
-   Word16 stream[SIZE_MAX];
-   UWord8 temp;
-   UWord8 *stream_ptr;
+   Word16 frame_type;
 
    if (coding_mode == MRDTX)
    {	   
@@ -98,8 +107,116 @@ void Write_serial(FILE * fp, Word16 prms[], Word16 coding_mode, Word16 mode, TX_
 	   frame_type = TX_SPEECH;
    }
    st->prev_ft = frame_type;
-   
-      
+
+   return frame_type;
+}
+
+/*-----------------------------------------------------*
+ * Tx_dtx_no_data -> returns 1 if a DTX frame coded    *
+ *   now would be scheduled as TX_NO_DATA by           *
+ *   Tx_frame_type() (state is not modified)           *
+ *-----------------------------------------------------*/
+
+Word16 Tx_dtx_no_data(TX_State *st)
+{
+   if (st->prev_ft == TX_SPEECH)
+   {
+	   return 0;                           /* TX_SID_FIRST */
+   }
+   if ((st->sid_handover_debt > 0) && (st->sid_update_counter - 1 > 2))
+   {
+	   return 0;                           /* delayed TX_SID_UPDATE */
+   }
+   if (st->sid_update_counter - 1 == 0)
+   {
+	   return 0;                           /* TX_SID_UPDATE */
+   }
+   return 1;
+}
+
+static void Write_frame(FILE * fp, Word16 prms[], Word16 coding_mode, Word16 mode, Word16 frame_type, TX_State *st, Word16 bitstreamformat);
+
+void Write_serial(FILE * fp, Word16 prms[], Word16 coding_mode, Word16 mode, TX_State *st, Word16 bitstreamformat)
+{
+   Word16 frame_type;
+
+   frame_type = Tx_frame_type(st, coding_mode);
+
+   Write_frame(fp, prms, coding_mode, mode, frame_type, st, bitstreamformat);
+}
+
+/*-----------------------------------------------------*
+ * Write_serial_rx -> write a received frame (frame    *
+ *   type from Read_serial(), no SID scheduling), for  *
+ *   the bitstream rewriting tools                     *
+ *   Bad frames keep their RX frame type in the        *
+ *   default format, other formats send them as       *
+ *   NO_DATA.                                          *
+ *-----------------------------------------------------*/
+
+void Write_serial_rx(FILE * fp, Word16 prms[], Word16 frame_type, Word16 mode, TX_State *st, Word16 bitstreamformat)
+{
+   Word16 i, coding_mode, tx_type;
+   Word16 stream[SIZE_MAX];
+
+   coding_mode = mode;
+   switch (frame_type)
+   {
+   case RX_SPEECH_GOOD:
+	   tx_type = TX_SPEECH;
+	   break;
+   case RX_SID_FIRST:
+	   tx_type = TX_SID_FIRST;
+	   coding_mode = MRDTX;
+	   break;
+   case RX_SID_UPDATE:
+	   tx_type = TX_SID_UPDATE;
+	   coding_mode = MRDTX;
+	   break;
+   case RX_NO_DATA:
+	   tx_type = TX_NO_DATA;
+	   coding_mode = MRDTX;
+	   break;
+   default:								/* bad frames */
+	   if (bitstreamformat == 0)
+	   {
+		   if (frame_type == RX_SID_BAD)
+		   {
+			   coding_mode = MRDTX;
+		   }
+		   stream[0] = RX_FRAME_TYPE;
+		   stream[1] = frame_type;
+		   stream[2] = mode;
+		   for (i = 0; i < nb_of_bits[coding_mode]; i++)
+		   {
+			   stream[3 + i] = prms[i];
+		   }
+		   fwrite(stream, sizeof(Word16), 3 + nb_of_bits[coding_mode], fp);
+		   st->prev_ft = TX_SPEECH;
+		   return;
+	   }
+	   tx_type = TX_NO_DATA;
+	   coding_mode = MRDTX;
+	   break;
+   }
+   st->prev_ft = tx_type;
+
+   Write_frame(fp, prms, coding_mode, mode, tx_type, st, bitstreamformat);
+}
+
+static void Write_frame(FILE * fp, Word16 prms[], Word16 coding_mode, Word16 mode, Word16 frame_type, TX_State *st, Word16 bitstreamformat)
+{
+   Word16 i;
+   Word16 stream[SIZE_MAX];
+   UWord8 temp;
+   UWord8 *stream_ptr;
+
+   if(bitstreamformat >= 3)				/* RTP payload formats (rtp_pl.c) */
+   {
+	   Write_rtp(fp, prms, coding_mode, mode, frame_type, st->rtp);
+	   return;
+   }
+
    if(bitstreamformat == 0)				/* default file format */
    {
 	   stream[0] = TX_FRAME_TYPE;
@@ -234,6 +351,8 @@ Word16 Init_read_serial(RX_State ** st)
         fprintf(stderr, "read_serial_init: can not malloc state structure\n");
         return -1;
     }
+    s->rtp = NULL;
+    Blk_init(&(s->map));
     Reset_read_serial(s);
     *st = s;
 
@@ -246,6 +365,11 @@ Word16 Close_read_serial(RX_State *st)
     test();
     if (st != NULL)
     {
+        if (st->rtp != NULL)
+        {
+            Close_rtp(st->rtp);
+        }
+        Blk_unmap(&(st->map));
         free(st);
         st = NULL;
         return 0;
@@ -257,6 +381,28 @@ void Reset_read_serial(RX_State * st)
 {
     st->prev_ft = RX_SPEECH_GOOD;
     st->prev_mode = 0;
+    Blk_unmap(&(st->map));
+}
+
+/*-----------------------------------------------------*
+ * Map_read_serial -> the next frames of fp (formats   *
+ *   0 to 2) are parsed out of a mapping of the file.  *
+ *   Returns -1 if fp can not be mapped: it is read    *
+ *   with stdio.                                       *
+ *-----------------------------------------------------*/
+
+Word16 Map_read_serial(RX_State * st, FILE * fp)
+{
+    return Blk_map(&(st->map), fp);
+}
+
+static Word16 Read_words(void *ptr, Word16 size, Word16 nmemb, FILE * fp, RX_State * st)
+{
+    if (st->map.data != NULL)
+    {
+        return (Word16) Blk_read(ptr, size, nmemb, &(st->map));
+    }
+    return (Word16) fread(ptr, size, nmemb, fp);
 }
 
 
@@ -265,11 +411,16 @@ Word16 Read_serial(FILE * fp, Word16 prms[], Word16 * frame_type, Word16 * mode,
    Word16 n, n1, type_of_frame_type, coding_mode, datalen, i;
    UWord8 toc, q, temp, *packet_ptr, packet[64];
 
+   if(bitstreamformat >= 3)				/* RTP payload formats (rtp_pl.c) */
+   {
+	   return Read_rtp(fp, prms, frame_type, mode, st->rtp);
+   }
+
    if(bitstreamformat == 0)				/* default file format */
    {
-	   n = (Word16) fread(&type_of_frame_type, sizeof(Word16), 1, fp);
-	   n = (Word16) (n + fread(frame_type, sizeof(Word16), 1, fp));
-	   n = (Word16) (n + fread(mode, sizeof(Word16), 1, fp));
+	   n = Read_words(&type_of_frame_type, sizeof(Word16), 1, fp, st);
+	   n = (Word16) (n + Read_words(frame_type, sizeof(Word16), 1, fp, st));
+	   n = (Word16) (n + Read_words(mode, sizeof(Word16), 1, fp, st));
 	   coding_mode = *mode;
 	   if(*mode < 0 || *mode > NUM_OF_MODES-1)
 	   {
@@ -304,7 +455,7 @@ Word16 Read_serial(FILE * fp, Word16 prms[], Word16 * frame_type, Word16 * mode,
 		   {
 			   coding_mode = MRDTX;
 		   }
-		   n = (Word16) fread(prms, sizeof(Word16), nb_of_bits[coding_mode], fp);
+		   n = Read_words(prms, sizeof(Word16), nb_of_bits[coding_mode], fp, st);
 		   if (n != nb_of_bits[coding_mode])
 			   n = 0;
 	   }
@@ -313,8 +464,8 @@ Word16 Read_serial(FILE * fp, Word16 prms[], Word16 * frame_type, Word16 * mode,
    {
 	   if (bitstreamformat == 1)		/* ITU file format */
 	   {
-			n = (Word16) fread(&type_of_frame_type, sizeof(Word16), 1, fp);
-			n = (Word16)(n+fread(&datalen, sizeof(Word16), 1, fp));
+			n = Read_words(&type_of_frame_type, sizeof(Word16), 1, fp, st);
+			n = (Word16)(n+Read_words(&datalen, sizeof(Word16), 1, fp, st));
 
 			if(n == 2)
 			{
@@ -373,7 +524,7 @@ Word16 Read_serial(FILE * fp, Word16 prms[], Word16 * frame_type, Word16 * mode,
 				  exit(-1);
 			  }
       }
-			n1 = fread(prms, sizeof(Word16), datalen, fp);
+			n1 = Read_words(prms, sizeof(Word16), datalen, fp, st);
 			n += n1;
 			for(i=0; i<n1; i++)
 			{
@@ -385,7 +536,7 @@ Word16 Read_serial(FILE * fp, Word16 prms[], Word16 * frame_type, Word16 * mode,
 	   } else							/* MIME/storage file format */
 	   {
 		   /* read ToC byte, return immediately if no more data available */
-		   if (fread(&toc, sizeof(UWord8), 1, fp) == 0)
+		   if (Read_words(&toc, sizeof(UWord8), 1, fp, st) == 0)
 		   {
 			   return 0;
 		   }
@@ -395,14 +546,29 @@ Word16 Read_serial(FILE * fp, Word16 prms[], Word16 * frame_type, Word16 * mode,
 		   *mode = (toc >> 3) & 0x0F;
 
 		   /* read speech bits, return with empty frame if mismatch between mode info and available data */
-		   if ((Word16)fread(packet, sizeof(UWord8), packed_size[*mode], fp) != packed_size[*mode])
+		   if (st->map.data != NULL)
 		   {
-			   return 0;
+			   /* unpacked straight from the mapped file */
+			   if ((packet_ptr = Blk_get(&(st->map), packed_size[*mode])) == NULL)
+			   {
+				   return 0;
+			   }
+		   } else
+		   {
+			   if ((Word16)fread(packet, sizeof(UWord8), packed_size[*mode], fp) != packed_size[*mode])
+			   {
+				   return 0;
+			   }
+			   packet_ptr = (UWord8*)packet;
 		   }
 
-		   packet_ptr = (UWord8*)packet;
-		   temp = *packet_ptr;
-		   packet_ptr++;
+		   /* no byte to read for NO_DATA, SPEECH_LOST and modes 10-13 */
+		   temp = 0;
+		   if (packed_size[*mode] > 0)
+		   {
+			   temp = *packet_ptr;
+			   packet_ptr++;
+		   }
 		   
 		   /* unpack and unsort speech or SID bits */
 		   for (i = 1; i < unpacked_size[*mode] + 1; i++)
@@ -4,9 +4,13 @@
  *       Number of bits for different modes			                        *
  *--------------------------------------------------------------------------*/
 
+#ifndef bits_h
+#define bits_h
+
 #include <stdio.h>
 #include "typedef.h"
 #include "cnst.h"
+#include "blk_io.h"
 
 #define NBBITS_7k     132                  /* 6.60k  */
 #define NBBITS_9k     177                  /* 8.85k  */
@@ -21,6 +25,13 @@
 #define NBBITS_SID    35
 #define NB_BITS_MAX   NBBITS_24k
 
+/* MIME/storage and RTP payload tables (mime_io.tab, defined in bits.c) */
+extern const UWord8 toc_byte[16];          /* ToC byte of each frame type        */
+extern const Word16 unpacked_size[16];     /* speech bits of each frame type     */
+extern const Word16 packed_size[16];       /* bytes of a packed frame, no ToC    */
+extern const Word16 unused_size[16];       /* padding bits of a packed frame     */
+extern const Word16 *const sort_ptr[16];   /* order of the bits of a frame       */
+
 #define BIT_0     (Word16)-127
 #define BIT_1     (Word16)127
 #define BIT_0_ITU (Word16)0x007F
@@ -42,11 +53,16 @@ static const Word16 nb_of_bits[NUM_OF_MODES] = {
     NBBITS_24k,
 NBBITS_SID};
 
+/* number of bits of the algebraic codebook indices per subframe */
+static const Word16 nb_of_cb_bits[NUM_OF_MODES] = {
+    12, 20, 36, 44, 52, 64, 72, 88, 88, 0};
+
 typedef struct
 {
     Word16 sid_update_counter;
     Word16 sid_handover_debt;
     Word16 prev_ft;
+    struct RTP_State *rtp;                 /* RTP payload formats (rtp_pl.h) */
 } TX_State;
 
 
@@ -54,6 +70,8 @@ typedef struct
 {
     Word16 prev_ft;
     Word16 prev_mode;
+    struct RTP_State *rtp;                 /* RTP payload formats (rtp_pl.h) */
+    Blk_Map map;                           /* mapped input, see Map_read_serial() */
 } RX_State;
 
 
@@ -63,7 +81,11 @@ void Reset_write_serial(TX_State * st);
 Word16 Init_read_serial(RX_State ** st);
 Word16 Close_read_serial(RX_State *st);
 void Reset_read_serial(RX_State * st);
+Word16 Map_read_serial(RX_State * st, FILE * fp);
+Word16 Tx_frame_type(TX_State *st, Word16 coding_mode);
+Word16 Tx_dtx_no_data(TX_State *st);
 void Write_serial(FILE * fp, Word16 prms[], Word16 coding_mode, Word16 mode, TX_State *st, Word16 bitstreamformat);
+void Write_serial_rx(FILE * fp, Word16 prms[], Word16 frame_type, Word16 mode, TX_State *st, Word16 bitstreamformat);
 Word16 Read_serial(FILE * fp, Word16 prms[], Word16 * frame_type, Word16 * mode, RX_State *st, Word16 bitstreamformat);
 
 void Parm_serial(
@@ -75,3 +97,5 @@ Word16 Serial_parm(                        /* Return the parameter    */
      Word16 no_of_bits,                    /* input : number of bits  */
      Word16 ** prms
 );
+
+#endif
@@ -0,0 +1,131 @@
+/*------------------------------------------------------------------------*
+ *                         BLK_IO.C                                       *
+ *------------------------------------------------------------------------*
+ * Block file I/O                                                         *
+ *                                                                        *
+ * An input file is mapped in memory (mmap) from its current position to  *
+ * its end, and the frames are parsed out of the mapping: no read call    *
+ * and no copy to an intermediate buffer per frame. The streams which can *
+ * not be mapped (pipes, systems without mmap) and the output files are   *
+ * given a large stdio buffer, so they are read and written in blocks of  *
+ * BLK_BUF_SIZE bytes.                                                    *
+ *------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#define POSIX_MMAP
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+#include "typedef.h"
+#include "blk_io.h"
+
+void Blk_init(Blk_Map * m)
+{
+    m->data = NULL;
+    m->size = 0;
+    m->pos = 0;
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Blk_map                                              *
+ *            ~~~~~~~~                                             *
+ *   ->Maps a regular file; the reads start at the position of fp  *
+ *     (after a header already read with stdio).                   *
+ *-----------------------------------------------------------------*/
+
+Word16 Blk_map(Blk_Map * m, FILE * fp)
+{
+#ifdef POSIX_MMAP
+    struct stat sb;
+    void *p;
+    long pos;
+
+    Blk_unmap(m);
+
+    if ((fstat(fileno(fp), &sb) != 0) || !S_ISREG(sb.st_mode) || (sb.st_size <= 0) ||
+        ((pos = ftell(fp)) < 0) || (pos > (long) sb.st_size))
+    {
+        return -1;
+    }
+    p = mmap(NULL, (size_t) sb.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if (p == MAP_FAILED)
+    {
+        return -1;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(p, (size_t) sb.st_size, MADV_SEQUENTIAL);
+#endif
+    m->data = (UWord8 *) p;
+    m->size = (long) sb.st_size;
+    m->pos = pos;
+
+    return 0;
+#else
+    Blk_unmap(m);
+
+    return -1;
+#endif
+}
+
+void Blk_unmap(Blk_Map * m)
+{
+#ifdef POSIX_MMAP
+    if (m->data != NULL)
+    {
+        munmap(m->data, (size_t) m->size);
+    }
+#endif
+    Blk_init(m);
+
+    return;
+}
+
+void Blk_buffer(FILE * fp)
+{
+    setvbuf(fp, NULL, _IOFBF, BLK_BUF_SIZE);
+
+    return;
+}
+
+long Blk_read(void *ptr, long size, long nmemb, Blk_Map * m)
+{
+    long n;
+
+    n = (m->size - m->pos) / size;
+    if (n > nmemb)
+    {
+        n = nmemb;
+    }
+    if (n <= 0)
+    {
+        return 0;
+    }
+    memcpy(ptr, m->data + m->pos, (size_t) (n * size));
+    m->pos += n * size;
+
+    return n;
+}
+
+UWord8 *Blk_get(Blk_Map * m, long n)
+{
+    UWord8 *p;
+
+    if (m->size - m->pos < n)
+    {
+        m->pos = m->size;
+        return NULL;
+    }
+    p = m->data + m->pos;
+    m->pos += n;
+
+    return p;
+}
@@ -0,0 +1,44 @@
+/*--------------------------------------------------------------------------*
+ *                         BLK_IO.H                                         *
+ *--------------------------------------------------------------------------*
+ *       Block file I/O: memory-mapped input, large stdio buffers           *
+ *--------------------------------------------------------------------------*/
+
+#ifndef blk_io_h
+#define blk_io_h
+
+#include <stdio.h>
+#include "typedef.h"
+
+#define BLK_BUF_SIZE      (256 * 1024)     /* stdio buffer of the streams not mapped */
+
+typedef struct
+{
+    UWord8 *data;                          /* whole file, NULL: not mapped (use fp)  */
+    long size;                             /* bytes of the file                      */
+    long pos;                              /* next byte to read                      */
+} Blk_Map;
+
+void Blk_init(Blk_Map * m);
+
+Word16 Blk_map(                            /* Return 0 if mapped, -1: read fp        */
+     Blk_Map * m,                          /* o   : mapping                          */
+     FILE * fp                             /* i   : file, read from its position     */
+);
+void Blk_unmap(Blk_Map * m);
+
+void Blk_buffer(FILE * fp);                /* before the first read or write of fp   */
+
+long Blk_read(                             /* Return the items read, as fread()      */
+     void *ptr,                            /* o   : items                            */
+     long size,                            /* i   : bytes per item                   */
+     long nmemb,                           /* i   : number of items                  */
+     Blk_Map * m                           /* i/o : mapping                          */
+);
+
+UWord8 *Blk_get(                           /* Return the next n bytes, NULL: no more */
+     Blk_Map * m,                          /* i/o : mapping                          */
+     long n                                /* i   : number of bytes                  */
+);
+
+#endif
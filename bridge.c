@@ -0,0 +1,160 @@
+/*___________________________________________________________________________
+ |                                                                           |
+ | Fixed-point C simulation of AMR WB ACELP coding algorithm with 20 ms      |
+ | speech frames for wideband speech signals.                                |
+ |___________________________________________________________________________|
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "cnst.h"
+#include "bits.h"
+#include "dtx.h"
+#include "count.h"
+#include "conf.h"
+#include "runstat.h"
+
+/*-------------------------------------------------------------------*
+ * BRIDGE.C                                                          *
+ * ~~~~~~~~                                                          *
+ * Conference bridge (conf.c) between N participants.                *
+ *                                                                   *
+ *    Usage : bridge (-dtx) mode in_bitstream out_bitstream          *
+ *                  (mode in_bitstream out_bitstream) ...            *
+ *                                                                   *
+ *    For each participant: the stream it sends (in_bitstream, any   *
+ *    mode) and the stream it receives (out_bitstream, coded in      *
+ *    mode 0..8), in the default bitstream format. A participant     *
+ *    whose input has ended sends NO_DATA frames.                    *
+ *    -dtx: DTX in the streams sent to the participants              *
+ *-------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    FILE *f_in[CONF_MAX], *f_out[CONF_MAX];
+    Word16 prms_in[CONF_MAX][NB_BITS_MAX], prms_out[CONF_MAX][NB_BITS_MAX];
+    Word16 mode_in[CONF_MAX], frame_type[CONF_MAX], mode[CONF_MAX], coding_mode[CONF_MAX];
+    Word16 p, nb_party, allow_dtx, nb_ended;
+    long frame;
+
+    RX_State *rx_state[CONF_MAX];
+    TX_State *tx_state[CONF_MAX];
+    Conf_State *conf;
+    Run_State *run_st;
+
+    fprintf(stderr, "\n");
+    fprintf(stderr, " ==================================================================================================\n");
+    fprintf(stderr, " AMR Wideband Codec 3GPP TS26.190 / ITU-T G.722.2, Aug 25, 2003. Version %s.\n", CODEC_VERSION);
+    fprintf(stderr, " ==================================================================================================\n");
+    fprintf(stderr, "\n");
+
+    allow_dtx = 0;
+    if ((argc > 1) && (strcmp(argv[1], "-dtx") == 0))
+    {
+        allow_dtx = 1;
+        argv++;
+        argc--;
+        fprintf(stderr, "DTX: enabled\n");
+    }
+
+    nb_party = (Word16) ((argc - 1) / 3);
+    if ((argc < 4) || ((argc - 1) % 3 != 0) || (nb_party > CONF_MAX))
+    {
+        fprintf(stderr, "Usage : bridge  (-dtx) mode in_bitstream out_bitstream (mode in_bitstream out_bitstream) ...\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "One triplet per participant (1 to %d): mode of the stream it receives (0 to 8),\n", CONF_MAX);
+        fprintf(stderr, "stream it sends and stream it receives (default bitstream format).\n");
+        fprintf(stderr, "Each participant receives the sum of the other active talkers.\n");
+        fprintf(stderr, "\n");
+        exit(0);
+    }
+
+    for (p = 0; p < nb_party; p++)
+    {
+        mode[p] = (Word16) atoi(argv[3 * p + 1]);
+        if ((mode[p] < 0) || (mode[p] > 8))
+        {
+            fprintf(stderr, " error in bit rate mode %d: use 0 to 8\n", mode[p]);
+            exit(0);
+        }
+        if ((f_in[p] = fopen(argv[3 * p + 2], "rb")) == NULL)
+        {
+            fprintf(stderr, "Input file '%s' does not exist !!\n", argv[3 * p + 2]);
+            exit(0);
+        }
+        if ((f_out[p] = fopen(argv[3 * p + 3], "wb")) == NULL)
+        {
+            fprintf(stderr, "Cannot open file '%s' !!\n", argv[3 * p + 3]);
+            exit(0);
+        }
+        fprintf(stderr, "Participant %d: mode %d, %s -> %s\n", p, mode[p], argv[3 * p + 2], argv[3 * p + 3]);
+        Blk_buffer(f_out[p]);
+
+        Init_read_serial(&rx_state[p]);
+        Init_write_serial(&tx_state[p]);
+        Map_read_serial(rx_state[p], f_in[p]);
+    }
+    if ((Init_conf(&conf, nb_party, mode, allow_dtx) != 0) || (Init_runstat(&run_st, "bridge", 0) != 0))
+    {
+        exit(0);
+    }
+    Init_WMOPS_counter();
+
+    frame = 0;
+    for (;;)
+    {
+        nb_ended = 0;
+        for (p = 0; p < nb_party; p++)
+        {
+            if ((f_in[p] == NULL) ||
+                (Read_serial(f_in[p], prms_in[p], &frame_type[p], &mode_in[p], rx_state[p], 0) == 0))
+            {
+                if (f_in[p] != NULL)
+                {
+                    fclose(f_in[p]);
+                    f_in[p] = NULL;
+                }
+                frame_type[p] = RX_NO_DATA;
+                mode_in[p] = MRDTX;
+                nb_ended++;
+            }
+        }
+        if (nb_ended == nb_party)
+        {
+            break;
+        }
+        Reset_WMOPS_counter();
+
+        frame++;
+        Run_progress(stderr, run_st, "Frames processed", frame, 0);
+
+        Conference(conf, prms_in, mode_in, frame_type, prms_out, coding_mode);
+
+        for (p = 0; p < nb_party; p++)
+        {
+            Write_serial(f_out[p], prms_out[p], coding_mode[p], mode[p], tx_state[p], 0);
+        }
+        WMOPS_output(0);
+    }
+    Run_progress(stderr, run_st, "Frames processed", frame, 1);
+
+    fprintf(stderr, "Talkers:  %.2f per frame (%ld participant frames not mixed)\n",
+        (double) conf->stats.talkers / (double) (frame ? frame : 1), (long) conf->stats.silent);
+    fprintf(stderr, "Encoding: %ld coder() calls for %ld frames sent (%.2f per frame)\n",
+        (long) conf->stats.encoded, (long) conf->stats.sent, (double) conf->stats.encoded / (double) (frame ? frame : 1));
+
+    Close_conf(conf);
+    Close_runstat(run_st);
+    for (p = 0; p < nb_party; p++)
+    {
+        Close_read_serial(rx_state[p]);
+        Close_write_serial(tx_state[p]);
+        fclose(f_out[p]);
+    }
+
+    return (0);
+}
@@ -0,0 +1,222 @@
+/*___________________________________________________________________________
+ |                                                                           |
+ | Fixed-point C simulation of AMR WB ACELP coding algorithm with 20 ms      |
+ | speech frames for wideband speech signals.                                |
+ |___________________________________________________________________________|
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "cnst.h"
+#include "bits.h"
+#include "dtx.h"
+#include "count.h"
+#include "rtp_pl.h"
+#include "gscale.h"
+#include "transrate.h"
+#include "runstat.h"
+
+/*-------------------------------------------------------------------*
+ * BSPROC.C                                                          *
+ * ~~~~~~~~                                                          *
+ * Bitstream processing in the coded domain (no decoding/encoding).  *
+ *                                                                   *
+ *    Usage : bsproc (-itu | -mime | -rtp | -rtpoa) (-fpp n)         *
+ *                   (-mode n) (-gain dB) in_bitstream out_bitstream *
+ *                                                                   *
+ *    -mode n:  frames above mode n transrated to mode n             *
+ *              (transrate.c), from the decoded parameters           *
+ *    -gain dB: level of the stream changed by dB (gscale.c), by     *
+ *              rewriting the gain indices and SID energy indices    *
+ *                                                                   *
+ *    The output is written in the format of the input; with -rtp    *
+ *    and -rtpoa, -fpp n sets the frames per output packet.          *
+ *-------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    FILE *f_in, *f_out;
+    Word16 prms[NB_BITS_MAX];
+    Word16 frame_type, mode, rtp_fpp, bitstreamformat, mode_out;
+    long frame;
+    double gain_db;
+    char magic[10];
+
+    RX_State *rx_state;
+    TX_State *tx_state;
+    GScale_State *gs;
+    Run_State *run_st;
+    Trans_State *tr;
+
+    fprintf(stderr, "\n");
+    fprintf(stderr, " ==================================================================================================\n");
+    fprintf(stderr, " AMR Wideband Codec 3GPP TS26.190 / ITU-T G.722.2, Aug 25, 2003. Version %s.\n", CODEC_VERSION);
+    fprintf(stderr, " ==================================================================================================\n");
+    fprintf(stderr, "\n");
+
+    if ((argc < 5) || (argc > 10))
+    {
+        fprintf(stderr, "Usage : bsproc  (-itu | -mime | -rtp | -rtpoa) (-fpp n) (-mode n) (-gain dB) in_bitstream out_bitstream\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "-mode n:  transrate the frames above mode n (0 to 7) to mode n\n");
+        fprintf(stderr, "-gain dB: change the level of the stream by dB in the coded domain\n");
+        fprintf(stderr, "The output bitstream has the format of the input bitstream (see decoder).\n");
+        fprintf(stderr, "\n");
+        exit(0);
+    }
+
+    bitstreamformat = 0;
+    if (strcmp(argv[1], "-itu") == 0)
+    {
+        bitstreamformat = 1;
+        argv++;
+        fprintf(stderr, "Bitstream format: ITU\n");
+    } else if (strcmp(argv[1], "-mime") == 0)
+    {
+        bitstreamformat = 2;
+        argv++;
+        fprintf(stderr, "Bitstream format: MIME\n");
+    } else if (strcmp(argv[1], "-rtp") == 0)
+    {
+        bitstreamformat = 3;
+        argv++;
+        fprintf(stderr, "Bitstream format: RTP payload (bandwidth-efficient)\n");
+    } else if (strcmp(argv[1], "-rtpoa") == 0)
+    {
+        bitstreamformat = 4;
+        argv++;
+        fprintf(stderr, "Bitstream format: RTP payload (octet-aligned)\n");
+    } else
+    {
+        fprintf(stderr, "Bitstream format: Default\n");
+    }
+
+    rtp_fpp = 1;
+    if (strcmp(argv[1], "-fpp") == 0)
+    {
+        rtp_fpp = (Word16)atoi(argv[2]);
+        argv += 2;
+    }
+
+    mode_out = -1;
+    if (strcmp(argv[1], "-mode") == 0)
+    {
+        mode_out = (Word16)atoi(argv[2]);
+        argv += 2;
+        if ((mode_out < 0) || (mode_out >= MODE_24k))
+        {
+            fprintf(stderr, "Transrating mode must be between 0 and 7\n");
+            exit(0);
+        }
+        fprintf(stderr, "Transrating to mode: %d\n", mode_out);
+    }
+
+    gain_db = 0.0;
+    if (strcmp(argv[1], "-gain") == 0)
+    {
+        gain_db = atof(argv[2]);
+        argv += 2;
+        if ((gain_db < -30.0) || (gain_db > 30.0))
+        {
+            fprintf(stderr, "Gain must be between -30 and 30 dB\n");
+            exit(0);
+        }
+        fprintf(stderr, "Gain: %.2f dB\n", gain_db);
+    } else if (mode_out < 0)
+    {
+        fprintf(stderr, "No processing requested (-mode n, -gain dB)\n");
+        exit(0);
+    }
+
+    if ((f_in = fopen(argv[1], "rb")) == NULL)
+    {
+        fprintf(stderr, "Input file '%s' does not exist !!\n", argv[1]);
+        exit(0);
+    } else
+        fprintf(stderr, "Input bitstream file:   %s\n", argv[1]);
+    Blk_buffer(f_in);
+
+    if ((f_out = fopen(argv[2], "wb")) == NULL)
+    {
+        fprintf(stderr, "Cannot open file '%s' !!\n", argv[2]);
+        exit(0);
+    } else
+        fprintf(stderr, "Output bitstream file:  %s\n", argv[2]);
+    Blk_buffer(f_out);
+
+    Init_read_serial(&rx_state);
+    Init_write_serial(&tx_state);
+    if (bitstreamformat >= 3)
+    {
+        if ((Init_rtp(&rx_state->rtp, (Word16) (bitstreamformat == 4), 1, 0) != 0) ||
+            (Init_rtp(&tx_state->rtp, (Word16) (bitstreamformat == 4), rtp_fpp, 0) != 0))
+        {
+            exit(0);
+        }
+    }
+    if (Init_gain_scale(&gs) != 0)
+    {
+        exit(0);
+    }
+    Set_gain_scale(gs, (Word16) (gain_db * 1024.0 + (gain_db < 0.0 ? -0.5 : 0.5)));
+    tr = NULL;
+    if ((mode_out >= 0) && (Init_transrate(&tr) != 0))
+    {
+        exit(0);
+    }
+    if (Init_runstat(&run_st, "bsproc", 0) != 0)
+    {
+        exit(0);
+    }
+
+    if (bitstreamformat == 2)
+    {
+        if ((fread(magic, sizeof(char), 9, f_in) != 9) || (strncmp(magic, "#!AMR-WB\n", 9) != 0))
+        {
+            fprintf(stderr, "Invalid magic number\n");
+            exit(0);
+        }
+        fwrite(magic, sizeof(char), 9, f_out);
+    }
+    if (bitstreamformat < 3)
+    {
+        Map_read_serial(rx_state, f_in);
+    }
+
+    frame = 0;
+    while (Read_serial(f_in, prms, &frame_type, &mode, rx_state, bitstreamformat) != 0)
+    {
+        frame++;
+        Run_progress(stderr, run_st, "Frames processed", frame, 0);
+
+        if (tr != NULL)
+        {
+            Transrate(mode_out, &mode, prms, &frame_type, tr);
+        }
+        Gain_scale(mode, prms, frame_type, gs);
+
+        Write_serial_rx(f_out, prms, frame_type, mode, tx_state, bitstreamformat);
+    }
+    if (bitstreamformat >= 3)
+    {
+        Flush_rtp(f_out, tx_state->rtp);
+    }
+    Run_progress(stderr, run_st, "Frames processed", frame, 1);
+
+    if (tr != NULL)
+    {
+        Close_transrate(tr);
+    }
+    Close_gain_scale(gs);
+    Close_runstat(run_st);
+    Close_read_serial(rx_state);
+    Close_write_serial(tx_state);
+    fclose(f_in);
+    fclose(f_out);
+
+    return (0);
+}
@@ -0,0 +1,1276 @@
+/*------------------------------------------------------------------------*
+ *                         COD_FLT.C                                      *
+ *------------------------------------------------------------------------*
+ * Performs the main encoder routine in floating point                    *
+ *------------------------------------------------------------------------*/
+
+/*___________________________________________________________________________
+ |                                                                           |
+ | Floating-point version of cod_main.c.                                     |
+ |                                                                           |
+ | The signal processing (filtering, LP analysis, pitch and codebook search, |
+ | gain quantization, HF gain estimation) is done in floating point without  |
+ | any dynamic scaling. The parts which define the bitstream or which are    |
+ | shared with the decoder state machine (VAD, DTX, ISF quantization, pitch  |
+ | clipping, parameter packing) call the fixed-point routines, so that the   |
+ | bitstream is decoded by the fixed-point decoder.                          |
+ |___________________________________________________________________________|
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "typedef.h"
+#include "cnst.h"
+#include "acelp.h"
+#include "cod_flt.h"
+#include "bits.h"
+#include "main.h"
+#include "flt_lib.h"
+#include "rom_tab.h"
+
+#define PREEMPH_FAC_FLT  0.68f             /* preemphasis factor                    */
+#define GAMMA1_FLT       0.92f             /* weighting factor (numerator)          */
+#define TILT_FAC_FLT     0.68f             /* tilt factor (denominator)             */
+#define PIT_SHARP_FLT    0.85f             /* pitch sharpening factor               */
+#define GP_CLIP_FLT      0.95f             /* pitch gain clipping                   */
+
+/* LPC interpolation coef */
+static const Float interpol_frac_flt[NB_SUBFR] = {0.45f, 0.8f, 0.96f, 1.0f};
+
+/* High Band encoding (Q14) */
+static const Word16 HP_gain[16] =
+{
+   3624, 4673, 5597, 6479, 7425, 8378, 9324, 10264,
+   11210, 12206, 13391, 14844, 16770, 19655, 24289, 32728
+};
+
+static Word16 synthesis_flt(
+     Float Aq[],                           /* A(z)  : quantized Az               */
+     Float exc[],                          /* (i)   : excitation at 12kHz        */
+     Word16 synth16k[],                    /* (i)   : 16kHz input speech         */
+     Coder_State_flt * st                  /* (i/o) : State structure            */
+);
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_coder_flt                                       *
+ *            ~~~~~~~~~~~~~~                                       *
+ *   ->Initialization of variables for the floating-point coder.   *
+ *-----------------------------------------------------------------*/
+
+void Init_coder_flt(void **spe_state)
+{
+    Coder_State_flt *st;
+
+    *spe_state = NULL;
+
+    /*-------------------------------------------------------------------------*
+     * Memory allocation for coder state.                                      *
+     *-------------------------------------------------------------------------*/
+
+    if ((st = (Coder_State_flt *) malloc(sizeof(Coder_State_flt))) == NULL)
+    {
+        printf("Can not malloc Coder_State_flt structure!\n");
+        return;
+    }
+    st->vadSt = NULL;
+    st->dtx_encSt = NULL;
+
+    wb_vad_init(&(st->vadSt));
+    dtx_enc_init(&(st->dtx_encSt), isf_init);
+    st->dtx_skip = DTX_SKIP_NONE;
+
+    Reset_encoder_flt((void *) st, 1);
+
+    *spe_state = (void *) st;
+
+    return;
+}
+
+
+void Reset_encoder_flt(void *st, Word16 reset_all)
+{
+    Word16 i;
+
+    Coder_State_flt *cod_state;
+
+    cod_state = (Coder_State_flt *) st;
+
+    for (i = 0; i < PIT_MAX + L_INTERPOL; i++)
+        cod_state->old_exc[i] = 0.0f;
+    for (i = 0; i < M; i++)
+    {
+        cod_state->mem_syn[i] = 0.0f;
+        cod_state->past_isfq[i] = 0;
+    }
+
+    cod_state->mem_w0 = 0.0f;
+    cod_state->tilt_code = 0.0f;
+    cod_state->first_frame = 1;
+
+    Init_gp_clip(cod_state->gp_clip);
+
+    cod_state->gc_thres = 0.0f;
+
+    if (reset_all != 0)
+    {
+        /* Static vectors to zero */
+
+        for (i = 0; i < L_TOTAL - L_FRAME; i++)
+            cod_state->old_speech[i] = 0.0f;
+        for (i = 0; i < PIT_MAX / OPL_DECIM; i++)
+            cod_state->old_wsp[i] = 0.0f;
+        for (i = 0; i < 3; i++)
+            cod_state->mem_decim2[i] = 0.0f;
+
+        /* routines initialization */
+
+        for (i = 0; i < 2 * L_FILT16k; i++)
+        {
+            cod_state->mem_decim[i] = 0.0f;
+            cod_state->mem_hf[i] = 0.0f;
+            cod_state->mem_hf2[i] = 0.0f;
+        }
+        for (i = 0; i < 4; i++)
+        {
+            cod_state->mem_sig_in[i] = 0.0f;
+            cod_state->mem_sig_out[i] = 0.0f;
+            cod_state->mem_hp400[i] = 0.0f;
+        }
+        for (i = 0; i <= M; i++)
+            cod_state->mem_levinson[i] = 0.0f;
+        cod_state->mem_levinson[0] = 1.0f;
+
+        Init_Q_gain2_flt(cod_state->qua_gain);
+
+        for (i = 0; i < 6; i++)
+            cod_state->hp_wsp_mem[i] = 0.0f;
+
+        /* isp initialization */
+
+        for (i = 0; i < M; i++)
+        {
+            cod_state->ispold[i] = (Float) isp_init[i] / 32768.0f;
+            cod_state->ispold_q[i] = cod_state->ispold[i];
+        }
+
+        /* variable initialization */
+
+        cod_state->mem_preemph = 0.0f;
+        cod_state->mem_wsp = 0.0f;
+
+        /* pitch ol initialization */
+
+        cod_state->old_T0_med = 40;
+        cod_state->ol_gain = 0.0f;
+        cod_state->ada_w = 0.0f;
+        cod_state->ol_wght_flg = 0;
+        for (i = 0; i < 5; i++)
+        {
+            cod_state->old_ol_lag[i] = 40;
+        }
+        for (i = 0; i < (L_FRAME / 2) / OPL_DECIM + (PIT_MAX / OPL_DECIM); i++)
+            cod_state->old_hp_wsp[i] = 0.0f;
+
+        for (i = 0; i < M; i++)
+        {
+            cod_state->mem_syn_hf[i] = 0.0f;
+            cod_state->mem_syn2[i] = 0.0f;
+            cod_state->isfold[i] = isf_init[i];
+        }
+
+        cod_state->mem_deemph = 0.0f;
+
+        cod_state->seed2 = 21845;
+
+        cod_state->gain_alpha = 1.0f;
+
+        cod_state->vad_hist = 0;
+
+        wb_vad_reset(cod_state->vadSt);
+        dtx_enc_reset(cod_state->dtx_encSt, isf_init);
+    }
+    return;
+}
+
+/* DTX frames not transmitted, see Set_encoder_dtx_skip() */
+
+void Set_encoder_dtx_skip_flt(void *spe_state, Word16 skip)
+{
+    ((Coder_State_flt *) spe_state)->dtx_skip = skip;
+    return;
+}
+
+void Close_coder_flt(void *spe_state)
+{
+    wb_vad_exit(&(((Coder_State_flt *) spe_state)->vadSt));
+    dtx_enc_exit(&(((Coder_State_flt *) spe_state)->dtx_encSt));
+    free(spe_state);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  coder_flt                                            *
+ *            ~~~~~~~~~                                            *
+ *   ->Main floating-point coder routine (same interface and       *
+ *     bitstream as coder()).                                      *
+ *-----------------------------------------------------------------*/
+
+void coder_flt(
+     Word16 * mode,                        /* input :  used mode                             */
+     Word16 speech16k[],                   /* input :  320 new speech samples (at 16 kHz)    */
+     Word16 prms[],                        /* output:  output parameters                     */
+     Word16 * ser_size,                    /* output:  bit rate of the used mode             */
+     void *spe_state,                      /* i/o   :  State structure                       */
+     Word16 allow_dtx                      /* input :  DTX ON/OFF                            */
+)
+{
+
+    /* Coder states */
+    Coder_State_flt *st;
+
+    /* Speech vector */
+    Float old_speech[L_TOTAL];
+    Float *new_speech, *speech, *p_window;
+
+    /* Weighted speech vector */
+    Float old_wsp[L_FRAME + (PIT_MAX / OPL_DECIM)];
+    Float *wsp;
+
+    /* Excitation vector */
+    Float old_exc[(L_FRAME + 1) + PIT_MAX + L_INTERPOL];
+    Float *exc;
+
+    /* LPC coefficients */
+
+    Float r[M + 1];                        /* Autocorrelations of windowed speech  */
+    Float Ap[M + 1];                       /* A(z) with spectral expansion         */
+    Float ispnew[M];                       /* immittance spectral pairs at 4nd sfr */
+    Float ispnew_q[M];                     /* quantized ISPs at 4nd subframe       */
+    Word16 isf[M];                         /* ISF (frequency domain) at 4nd sfr    */
+    Float *p_A, *p_Aq;                     /* ptr to A(z) for the 4 subframes      */
+    Float A[NB_SUBFR * (M + 1)];           /* A(z) unquantized for the 4 subframes */
+    Float Aq[NB_SUBFR * (M + 1)];          /* A(z)   quantized for the 4 subframes */
+
+    /* Other vectors */
+
+    Float xn[L_SUBFR];                     /* Target vector for pitch search     */
+    Float xn2[L_SUBFR];                    /* Target vector for codebook search  */
+    Float dn[L_SUBFR];                     /* Correlation between xn2 and h1     */
+    Float cn[L_SUBFR];                     /* Target vector in residual domain   */
+
+    Float h1[L_SUBFR];                     /* Impulse response vector            */
+    Float h2[L_SUBFR];                     /* Impulse response vector            */
+    Float code[L_SUBFR];                   /* Fixed codebook excitation          */
+    Float y1[L_SUBFR];                     /* Filtered adaptive excitation       */
+    Float y2[L_SUBFR];                     /* Filtered adaptive excitation       */
+    Float error[M + L_SUBFR];              /* error of quantization              */
+    Float synth[L_SUBFR];                  /* 12.8kHz synthesis vector           */
+    Float exc2[L_FRAME];                   /* excitation vector                  */
+    Float mem[2 * L_FILT16k];              /* temporary filter memory            */
+    Float sig16k[L_FRAME16k];              /* input speech at 16kHz              */
+    Word16 exc2_16[L_FRAME];               /* excitation vector for DTX          */
+    Word16 buf[L_FRAME];                   /* VAD buffer                         */
+
+    /* Scalars */
+
+    Word16 i, j, i_subfr, select, pit_flag, clip_gain, vad_flag;
+    Word16 codec_mode;
+    Word16 T_op, T_op2, T0, T0_min, T0_max, T0_frac, index;
+    Float gain_pit, gain_code, g_coeff[2], g_coeff2[2];
+    Float tmp, gain1, gain2, s, voice_fac;
+    Word16 indice[8];
+
+    Word32 L_tmp;
+
+    Float code2[L_SUBFR];                  /* Fixed codebook excitation  */
+    Float stab_fac, fac, gc_enh;
+
+    Word16 corr_gain;
+
+    st = (Coder_State_flt *) spe_state;
+
+    *ser_size = nb_of_bits[*mode];
+    codec_mode = *mode;
+
+    /*--------------------------------------------------------------------------*
+     *          Initialize pointers to speech vector (see cod_main.c).          *
+     *--------------------------------------------------------------------------*/
+
+    new_speech = old_speech + L_TOTAL - L_FRAME - L_FILT;       /* New speech     */
+    speech = old_speech + L_TOTAL - L_FRAME - L_NEXT;           /* Present frame  */
+    p_window = old_speech + L_TOTAL - L_WINDOW;
+
+    exc = old_exc + PIT_MAX + L_INTERPOL;
+    wsp = old_wsp + (PIT_MAX / OPL_DECIM);
+
+    /* copy coder memory state into working space */
+
+    for (i = 0; i < L_TOTAL - L_FRAME; i++)
+        old_speech[i] = st->old_speech[i];
+    for (i = 0; i < PIT_MAX / OPL_DECIM; i++)
+        old_wsp[i] = st->old_wsp[i];
+    for (i = 0; i < PIT_MAX + L_INTERPOL; i++)
+        old_exc[i] = st->old_exc[i];
+
+    /*---------------------------------------------------------------*
+     * Down sampling signal from 16kHz to 12.8kHz                    *
+     * -> The signal is extended by L_FILT samples (padded to zero)  *
+     * to avoid additional delay (L_FILT samples) in the coder.      *
+     *---------------------------------------------------------------*/
+
+    Word16_to_flt(speech16k, sig16k, L_FRAME16k);
+    Decim_12k8_flt(sig16k, L_FRAME16k, new_speech, st->mem_decim);
+
+    /* last L_FILT samples for autocorrelation window */
+    for (i = 0; i < 2 * L_FILT16k; i++)
+        mem[i] = st->mem_decim[i];
+    for (i = 0; i < L_FILT16k; i++)
+        sig16k[i] = 0.0f;                  /* set next sample to zero */
+    Decim_12k8_flt(sig16k, L_FILT16k, new_speech + L_FRAME, mem);
+
+    /*---------------------------------------------------------------*
+     * Perform 50Hz HP filtering of input signal.                    *
+     *---------------------------------------------------------------*/
+
+    HP50_12k8_flt(new_speech, L_FRAME, st->mem_sig_in);
+
+    /* last L_FILT samples for autocorrelation window */
+    for (i = 0; i < 4; i++)
+        mem[i] = st->mem_sig_in[i];
+    HP50_12k8_flt(new_speech + L_FRAME, L_FILT, mem);
+
+    /*---------------------------------------------------------------*
+     * Perform fixed preemphasis through 1 - g z^-1                  *
+     * (no scaling is needed in floating point)                      *
+     *---------------------------------------------------------------*/
+
+    tmp = new_speech[L_FRAME - 1];
+    Preemph_flt(new_speech, PREEMPH_FAC_FLT, L_FRAME + L_FILT, &(st->mem_preemph));
+    st->mem_preemph = tmp;
+
+    /*------------------------------------------------------------------------*
+     *  Call VAD (fixed point, on the preemphased signal)                     *
+     *------------------------------------------------------------------------*/
+
+    Flt_to_word16(new_speech, buf, L_FRAME);
+
+    vad_flag = wb_vad(st->vadSt, buf);
+    if (vad_flag == 0)
+    {
+        st->vad_hist = (Word16) (st->vad_hist + 1);
+    } else
+    {
+        st->vad_hist = 0;
+    }
+
+    /* DTX processing */
+    if (allow_dtx != 0)
+    {
+        /* Note that mode may change here */
+        tx_dtx_handler(st->dtx_encSt, vad_flag, mode);
+        *ser_size = nb_of_bits[*mode];
+    }
+
+    if (*mode != MRDTX)
+    {
+        Parm_serial(vad_flag, 1, &prms);
+    }
+    /*------------------------------------------------------------------------*
+     *  Perform LPC analysis                                                  *
+     *------------------------------------------------------------------------*/
+
+    /* LP analysis centered at 4nd subframe */
+    Autocorr_flt(p_window, M, r);          /* Autocorrelations */
+    Lag_window_flt(r);                     /* Lag windowing    */
+    Levinson_flt(r, A, st->mem_levinson);  /* Levinson Durbin  */
+    Az_isp_flt(A, ispnew, st->ispold);     /* From A(z) to ISP */
+
+    /* Find the interpolated ISPs and convert to a[] for all subframes */
+    Int_isp_flt(st->ispold, ispnew, interpol_frac_flt, A);
+
+    /* update ispold[] for the next frame */
+    for (i = 0; i < M; i++)
+        st->ispold[i] = ispnew[i];
+
+    /* Convert ISPs to frequency domain 0..6400 */
+    Isp_isf_flt(ispnew, isf, M);
+
+    /* check resonance for pitch clipping algorithm */
+    Gp_clip_test_isf(*ser_size, isf, st->gp_clip);
+
+    /*----------------------------------------------------------------------*
+     *  Perform PITCH_OL analysis                                           *
+     * - Find the weighted input speech wsp[] for the whole speech frame    *
+     * - Find open loop pitch lag for whole speech frame                    *
+     *----------------------------------------------------------------------*/
+
+    p_A = A;
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        Weight_a_flt(p_A, Ap, GAMMA1_FLT, M);
+        Residu_flt(Ap, M, &speech[i_subfr], &wsp[i_subfr], L_SUBFR);
+        p_A += (M + 1);
+    }
+    Deemph_flt(wsp, TILT_FAC_FLT, L_FRAME, &(st->mem_wsp));
+
+    /* decimation of wsp[] to search pitch in LF and to reduce complexity */
+    LP_Decim2_flt(wsp, L_FRAME, st->mem_decim2);
+
+    if (*ser_size == NBBITS_7k)
+    {
+        /* Find open loop pitch lag for whole speech frame */
+        T_op = Pitch_med_ol_flt(wsp, PIT_MIN / OPL_DECIM, PIT_MAX / OPL_DECIM,
+            L_FRAME / OPL_DECIM, st->old_T0_med, &(st->ol_gain), st->hp_wsp_mem, st->old_hp_wsp, st->ol_wght_flg);
+    } else
+    {
+        /* Find open loop pitch lag for first 1/2 frame */
+        T_op = Pitch_med_ol_flt(wsp, PIT_MIN / OPL_DECIM, PIT_MAX / OPL_DECIM,
+            (L_FRAME / 2) / OPL_DECIM, st->old_T0_med, &(st->ol_gain), st->hp_wsp_mem, st->old_hp_wsp, st->ol_wght_flg);
+    }
+
+    if (st->ol_gain > 0.6f)
+    {
+        st->old_T0_med = Med_olag(T_op, st->old_ol_lag);
+        st->ada_w = 1.0f;
+    } else
+    {
+        st->ada_w *= 0.9f;
+    }
+
+    if (st->ada_w < 0.8f)
+        st->ol_wght_flg = 0;
+    else
+        st->ol_wght_flg = 1;
+
+    tmp = st->ol_gain * 32768.0f;
+    Flt_to_word16(&tmp, &j, 1);
+    wb_vad_tone_detection(st->vadSt, j);
+
+    T_op *= OPL_DECIM;
+
+    if (*ser_size != NBBITS_7k)
+    {
+        /* Find open loop pitch lag for second 1/2 frame */
+        T_op2 = Pitch_med_ol_flt(wsp + ((L_FRAME / 2) / OPL_DECIM), PIT_MIN / OPL_DECIM, PIT_MAX / OPL_DECIM,
+            (L_FRAME / 2) / OPL_DECIM, st->old_T0_med, &(st->ol_gain), st->hp_wsp_mem, st->old_hp_wsp, st->ol_wght_flg);
+
+        if (st->ol_gain > 0.6f)
+        {
+            st->old_T0_med = Med_olag(T_op2, st->old_ol_lag);
+            st->ada_w = 1.0f;
+        } else
+        {
+            st->ada_w *= 0.9f;
+        }
+
+        if (st->ada_w < 0.8f)
+            st->ol_wght_flg = 0;
+        else
+            st->ol_wght_flg = 1;
+
+        tmp = st->ol_gain * 32768.0f;
+        Flt_to_word16(&tmp, &j, 1);
+        wb_vad_tone_detection(st->vadSt, j);
+
+        T_op2 *= OPL_DECIM;
+
+    } else
+    {
+        T_op2 = T_op;
+    }
+
+
+    /*----------------------------------------------------------------------*
+     *                              DTX-CNG                                 *
+     *----------------------------------------------------------------------*/
+
+    if (*mode == MRDTX)                    /* CNG mode */
+    {
+        /* Buffer isf's and energy */
+        Residu_flt(&A[3 * (M + 1)], M, speech, exc, L_FRAME);
+
+        Flt_to_word16(exc, exc2_16, L_FRAME);
+
+        L_tmp = 0;
+        for (i = 0; i < L_FRAME; i++)
+        {
+            L_tmp += (Word32) exc2_16[i] * exc2_16[i];
+            if (L_tmp > 0x3fffffffL)
+            {
+                L_tmp = 0x3fffffffL;       /* same saturation as L_mac() */
+            }
+        }
+
+        dtx_buffer(st->dtx_encSt, isf, L_tmp, codec_mode);
+
+        if (st->dtx_skip < DTX_SKIP_SID)
+        {
+            /* Quantize and code the ISFs */
+            dtx_enc(st->dtx_encSt, isf, exc2_16, &prms);
+        } else
+        {
+            dtx_enc_skip(st->dtx_encSt);
+        }
+
+        if (st->dtx_skip == DTX_SKIP_NONE)
+        {
+            /* Convert ISFs to the cosine domain */
+            Isf_isp_flt(isf, ispnew_q, M);
+            Isp_Az_flt(ispnew_q, Aq, M);
+
+            Word16_to_flt(exc2_16, exc2, L_FRAME);
+            for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+            {
+                corr_gain = synthesis_flt(Aq, &exc2[i_subfr], &speech16k[i_subfr * 5 / 4], st);
+            }
+        }
+        for (i = 0; i < M; i++)
+            st->isfold[i] = isf[i];
+
+        /* reset speech coder memories */
+        Reset_encoder_flt(st, 0);
+
+        /*--------------------------------------------------*
+         * Update signal for next frame.                    *
+         * -> save past of speech[] and wsp[].              *
+         *--------------------------------------------------*/
+
+        for (i = 0; i < L_TOTAL - L_FRAME; i++)
+            st->old_speech[i] = old_speech[L_FRAME + i];
+        for (i = 0; i < PIT_MAX / OPL_DECIM; i++)
+            st->old_wsp[i] = old_wsp[L_FRAME / OPL_DECIM + i];
+
+        return;
+    }
+    /*----------------------------------------------------------------------*
+     *                               ACELP                                  *
+     *----------------------------------------------------------------------*/
+
+    /* Quantize and code the ISFs */
+
+    if (*ser_size <= NBBITS_7k)
+    {
+        Qpisf_2s_36b(isf, isf, st->past_isfq, indice, 4);
+
+        Parm_serial(indice[0], 8, &prms);
+        Parm_serial(indice[1], 8, &prms);
+        Parm_serial(indice[2], 7, &prms);
+        Parm_serial(indice[3], 7, &prms);
+        Parm_serial(indice[4], 6, &prms);
+    } else
+    {
+        Qpisf_2s_46b(isf, isf, st->past_isfq, indice, 4);
+
+        Parm_serial(indice[0], 8, &prms);
+        Parm_serial(indice[1], 8, &prms);
+        Parm_serial(indice[2], 6, &prms);
+        Parm_serial(indice[3], 7, &prms);
+        Parm_serial(indice[4], 7, &prms);
+        Parm_serial(indice[5], 5, &prms);
+        Parm_serial(indice[6], 5, &prms);
+    }
+
+    /* Check stability on isf : distance between old isf and current isf */
+
+    s = 0.0f;
+    for (i = 0; i < M - 1; i++)
+    {
+        tmp = (Float) (isf[i] - st->isfold[i]);
+        s += tmp * tmp;
+    }
+    s *= (1.0f / 128.0f);                  /* same scale as cod_main.c */
+    if (s > 32767.0f)
+        s = 32767.0f;
+
+    stab_fac = 2.0f * (20480.0f - 0.8f * s) / 32768.0f;     /* 1.25 - distance */
+    if (stab_fac < 0.0f)
+        stab_fac = 0.0f;
+    if (stab_fac > 1.0f)
+        stab_fac = 1.0f;
+
+    for (i = 0; i < M; i++)
+        st->isfold[i] = isf[i];
+
+    /* Convert ISFs to the cosine domain */
+    Isf_isp_flt(isf, ispnew_q, M);
+
+    if (st->first_frame != 0)
+    {
+        st->first_frame = 0;
+        for (i = 0; i < M; i++)
+            st->ispold_q[i] = ispnew_q[i];
+    }
+    /* Find the interpolated ISPs and convert to a[] for all subframes */
+
+    Int_isp_flt(st->ispold_q, ispnew_q, interpol_frac_flt, Aq);
+
+    /* update ispold[] for the next frame */
+    for (i = 0; i < M; i++)
+        st->ispold_q[i] = ispnew_q[i];
+
+    p_Aq = Aq;
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        Residu_flt(p_Aq, M, &speech[i_subfr], &exc[i_subfr], L_SUBFR);
+        p_Aq += (M + 1);
+    }
+
+    /* Buffer isf's and energy for dtx on non-speech frame */
+
+    if (vad_flag == 0)
+    {
+        Flt_to_word16(exc, exc2_16, L_FRAME);
+
+        L_tmp = 0;
+        for (i = 0; i < L_FRAME; i++)
+        {
+            L_tmp += (Word32) exc2_16[i] * exc2_16[i];
+            if (L_tmp > 0x3fffffffL)
+            {
+                L_tmp = 0x3fffffffL;
+            }
+        }
+
+        dtx_buffer(st->dtx_encSt, isf, L_tmp, codec_mode);
+    }
+    /* range for closed loop pitch search in 1st subframe */
+
+    T0_min = (Word16) (T_op - 8);
+    if (T0_min < PIT_MIN)
+    {
+        T0_min = PIT_MIN;
+    }
+    T0_max = (Word16) (T0_min + 15);
+    if (T0_max > PIT_MAX)
+    {
+        T0_max = PIT_MAX;
+        T0_min = (Word16) (T0_max - 15);
+    }
+    /*------------------------------------------------------------------------*
+     *          Loop for every subframe in the analysis frame                 *
+     *------------------------------------------------------------------------*/
+
+    p_A = A;
+    p_Aq = Aq;
+
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        pit_flag = i_subfr;
+        if ((i_subfr == 2 * L_SUBFR) && (*ser_size > NBBITS_7k))
+        {
+            pit_flag = 0;
+
+            /* range for closed loop pitch search in 3rd subframe */
+
+            T0_min = (Word16) (T_op2 - 8);
+            if (T0_min < PIT_MIN)
+            {
+                T0_min = PIT_MIN;
+            }
+            T0_max = (Word16) (T0_min + 15);
+            if (T0_max > PIT_MAX)
+            {
+                T0_max = PIT_MAX;
+                T0_min = (Word16) (T0_max - 15);
+            }
+        }
+        /*-----------------------------------------------------------------------*
+         *        Find the target vector for pitch search (see cod_main.c)       *
+         *-----------------------------------------------------------------------*/
+
+        for (i = 0; i < M; i++)
+        {
+            error[i] = speech[i + i_subfr - M] - st->mem_syn[i];
+        }
+        Residu_flt(p_Aq, M, &speech[i_subfr], &exc[i_subfr], L_SUBFR);
+
+        Syn_filt_flt(p_Aq, M, &exc[i_subfr], error + M, L_SUBFR, error, 0);
+
+        Weight_a_flt(p_A, Ap, GAMMA1_FLT, M);
+        Residu_flt(Ap, M, error + M, xn, L_SUBFR);
+
+        Deemph_flt(xn, TILT_FAC_FLT, L_SUBFR, &(st->mem_w0));
+
+        /*----------------------------------------------------------------------*
+         * Find approx. target in residual domain "cn[]" for inovation search.  *
+         *----------------------------------------------------------------------*/
+
+        /* first half: xn[] --> cn[] */
+        for (i = 0; i < M; i++)
+            code[i] = 0.0f;
+        for (i = 0; i < L_SUBFR / 2; i++)
+            code[M + i] = xn[i];
+        tmp = 0.0f;
+        Preemph_flt(code + M, TILT_FAC_FLT, L_SUBFR / 2, &tmp);
+        Syn_filt_flt(Ap, M, code + M, code + M, L_SUBFR / 2, code, 0);
+        Residu_flt(p_Aq, M, code + M, cn, L_SUBFR / 2);
+
+        /* second half: res[] --> cn[] (approximated and faster) */
+        for (i = L_SUBFR / 2; i < L_SUBFR; i++)
+            cn[i] = exc[i_subfr + i];
+
+        /*---------------------------------------------------------------*
+         * Compute impulse response, h1[], of weighted synthesis filter  *
+         *---------------------------------------------------------------*/
+
+        for (i = 0; i < M + L_SUBFR; i++)
+            error[i] = 0.0f;
+        Weight_a_flt(p_A, error + M, GAMMA1_FLT, M);
+
+        for (i = 0; i < L_SUBFR; i++)
+        {
+            s = error[i + M];
+            for (j = 1; j <= M; j++)
+                s -= p_Aq[j] * error[i + M - j];
+
+            h1[i] = error[i + M] = s;
+        }
+        tmp = 0.0f;
+        Deemph_flt(h1, TILT_FAC_FLT, L_SUBFR, &tmp);
+
+        for (i = 0; i < L_SUBFR; i++)
+            h2[i] = h1[i];
+
+        /*----------------------------------------------------------------------*
+         *                 Closed-loop fractional pitch search                  *
+         *----------------------------------------------------------------------*/
+
+        if (*ser_size <= NBBITS_9k)
+        {
+            T0 = Pitch_fr4_flt(&exc[i_subfr], xn, h1, T0_min, T0_max, &T0_frac,
+                pit_flag, PIT_MIN, PIT_FR1_8b);
+
+            /* encode pitch lag */
+
+            if (pit_flag == 0)             /* if 1st/3rd subframe */
+            {
+                if (T0 < PIT_FR1_8b)
+                {
+                    index = (Word16) (T0 * 2 + (T0_frac >> 1) - (PIT_MIN * 2));
+                } else
+                {
+                    index = (Word16) (T0 - PIT_FR1_8b + ((PIT_FR1_8b - PIT_MIN) * 2));
+                }
+
+                Parm_serial(index, 8, &prms);
+
+                /* find T0_min and T0_max for subframe 2 and 4 */
+
+                T0_min = (Word16) (T0 - 8);
+                if (T0_min < PIT_MIN)
+                {
+                    T0_min = PIT_MIN;
+                }
+                T0_max = (Word16) (T0_min + 15);
+                if (T0_max > PIT_MAX)
+                {
+                    T0_max = PIT_MAX;
+                    T0_min = (Word16) (T0_max - 15);
+                }
+            } else
+            {                              /* if subframe 2 or 4 */
+                i = (Word16) (T0 - T0_min);
+                index = (Word16) (i * 2 + (T0_frac >> 1));
+
+                Parm_serial(index, 5, &prms);
+            }
+        } else
+        {
+            T0 = Pitch_fr4_flt(&exc[i_subfr], xn, h1, T0_min, T0_max, &T0_frac,
+                pit_flag, PIT_FR2, PIT_FR1_9b);
+
+            /* encode pitch lag */
+
+            if (pit_flag == 0)             /* if 1st/3rd subframe */
+            {
+                if (T0 < PIT_FR2)
+                {
+                    index = (Word16) (T0 * 4 + T0_frac - (PIT_MIN * 4));
+                } else if (T0 < PIT_FR1_9b)
+                {
+                    index = (Word16) (T0 * 2 + (T0_frac >> 1) - (PIT_FR2 * 2) + ((PIT_FR2 - PIT_MIN) * 4));
+                } else
+                {
+                    index = (Word16) (T0 - PIT_FR1_9b + ((PIT_FR2 - PIT_MIN) * 4) + ((PIT_FR1_9b - PIT_FR2) * 2));
+                }
+
+                Parm_serial(index, 9, &prms);
+
+                /* find T0_min and T0_max for subframe 2 and 4 */
+
+                T0_min = (Word16) (T0 - 8);
+                if (T0_min < PIT_MIN)
+                {
+                    T0_min = PIT_MIN;
+                }
+                T0_max = (Word16) (T0_min + 15);
+                if (T0_max > PIT_MAX)
+                {
+                    T0_max = PIT_MAX;
+                    T0_min = (Word16) (T0_max - 15);
+                }
+            } else
+            {                              /* if subframe 2 or 4 */
+                i = (Word16) (T0 - T0_min);
+                index = (Word16) (i * 4 + T0_frac);
+
+                Parm_serial(index, 6, &prms);
+            }
+        }
+
+        /*-----------------------------------------------------------------*
+         * Gain clipping test to avoid unstable synthesis on frame erasure *
+         *-----------------------------------------------------------------*/
+
+        clip_gain = Gp_clip(*ser_size, st->gp_clip);
+
+        /*-----------------------------------------------------------------*
+         * - find unity gain pitch excitation (adaptive codebook entry)    *
+         *   with fractional interpolation.                                *
+         * - find filtered pitch exc. y1[]=exc[] convolved with h1[])      *
+         * - compute pitch gain1                                           *
+         *-----------------------------------------------------------------*/
+
+        Pred_lt4_flt(&exc[i_subfr], T0, T0_frac, L_SUBFR + 1);
+
+        if (*ser_size > NBBITS_9k)
+        {
+            Convolve_flt(&exc[i_subfr], h1, y1, L_SUBFR);
+            gain1 = G_pitch_flt(xn, y1, g_coeff, L_SUBFR);
+
+            /* clip gain if necessary to avoid problem at decoder */
+            if ((clip_gain != 0) && (gain1 > GP_CLIP_FLT))
+            {
+                gain1 = GP_CLIP_FLT;
+            }
+            /* find energy of new target xn2[] */
+            for (i = 0; i < L_SUBFR; i++)
+                dn[i] = xn[i] - gain1 * y1[i];         /* dn used temporary */
+        } else
+        {
+            gain1 = 0.0f;
+        }
+
+        /*-----------------------------------------------------------------*
+         * - find pitch excitation filtered by 1st order LP filter.        *
+         * - find filtered pitch exc. y2[]=exc[] convolved with h1[])      *
+         * - compute pitch gain2                                           *
+         *-----------------------------------------------------------------*/
+
+        for (i = 0; i < L_SUBFR; i++)
+        {
+            code[i] = 0.18f * exc[i - 1 + i_subfr] + 0.64f * exc[i + i_subfr]
+                + 0.18f * exc[i + 1 + i_subfr];
+        }
+
+        Convolve_flt(code, h1, y2, L_SUBFR);
+        gain2 = G_pitch_flt(xn, y2, g_coeff2, L_SUBFR);
+
+        /* clip gain if necessary to avoid problem at decoder */
+        if ((clip_gain != 0) && (gain2 > GP_CLIP_FLT))
+        {
+            gain2 = GP_CLIP_FLT;
+        }
+        /* find energy of new target xn2[] */
+        for (i = 0; i < L_SUBFR; i++)
+            xn2[i] = xn[i] - gain2 * y2[i];
+
+        /*-----------------------------------------------------------------*
+         * use the best prediction (minimise quadratic error).             *
+         *-----------------------------------------------------------------*/
+
+        select = 0;
+        if (*ser_size > NBBITS_9k)
+        {
+            s = Dot_product_flt(dn, dn, L_SUBFR) - Dot_product_flt(xn2, xn2, L_SUBFR);
+
+            if (s <= 0.0f)
+            {
+                select = 1;
+            }
+            Parm_serial(select, 1, &prms);
+        }
+        if (select == 0)
+        {
+            /* use the lp filter for pitch excitation prediction */
+            gain_pit = gain2;
+            for (i = 0; i < L_SUBFR; i++)
+            {
+                exc[i_subfr + i] = code[i];
+                y1[i] = y2[i];
+            }
+            g_coeff[0] = g_coeff2[0];
+            g_coeff[1] = g_coeff2[1];
+        } else
+        {
+            /* no filter used for pitch excitation prediction */
+            gain_pit = gain1;
+            for (i = 0; i < L_SUBFR; i++)
+                xn2[i] = dn[i];            /* target vector for codebook search */
+        }
+
+        /*-----------------------------------------------------------------*
+         * - update cn[] for codebook search                               *
+         *-----------------------------------------------------------------*/
+
+        for (i = 0; i < L_SUBFR; i++)
+            cn[i] -= gain_pit * exc[i_subfr + i];
+
+        /*-----------------------------------------------------------------*
+         * - include fixed-gain pitch contribution into impulse resp. h1[] *
+         *-----------------------------------------------------------------*/
+
+        tmp = 0.0f;
+        Preemph_flt(h2, st->tilt_code, L_SUBFR, &tmp);
+
+        if (T0_frac > 2)
+            T0 = (Word16) (T0 + 1);
+        Pit_shrp_flt(h2, T0, PIT_SHARP_FLT, L_SUBFR);
+
+        /*-----------------------------------------------------------------*
+         * - Correlation between target xn2[] and impulse response h1[]    *
+         * - Innovative codebook search                                    *
+         *-----------------------------------------------------------------*/
+
+        Cor_h_x_flt(h2, xn2, dn);
+
+        if (*ser_size <= NBBITS_7k)
+        {
+            ACELP_2t64_flt(dn, cn, h2, code, y2, indice);
+
+            Parm_serial(indice[0], 12, &prms);
+        } else if (*ser_size <= NBBITS_9k)
+        {
+            ACELP_4t64_flt(dn, cn, h2, code, y2, 20, *ser_size, indice);
+
+            Parm_serial(indice[0], 5, &prms);
+            Parm_serial(indice[1], 5, &prms);
+            Parm_serial(indice[2], 5, &prms);
+            Parm_serial(indice[3], 5, &prms);
+        } else if (*ser_size <= NBBITS_12k)
+        {
+            ACELP_4t64_flt(dn, cn, h2, code, y2, 36, *ser_size, indice);
+
+            Parm_serial(indice[0], 9, &prms);
+            Parm_serial(indice[1], 9, &prms);
+            Parm_serial(indice[2], 9, &prms);
+            Parm_serial(indice[3], 9, &prms);
+        } else if (*ser_size <= NBBITS_14k)
+        {
+            ACELP_4t64_flt(dn, cn, h2, code, y2, 44, *ser_size, indice);
+
+            Parm_serial(indice[0], 13, &prms);
+            Parm_serial(indice[1], 13, &prms);
+            Parm_serial(indice[2], 9, &prms);
+            Parm_serial(indice[3], 9, &prms);
+        } else if (*ser_size <= NBBITS_16k)
+        {
+            ACELP_4t64_flt(dn, cn, h2, code, y2, 52, *ser_size, indice);
+
+            Parm_serial(indice[0], 13, &prms);
+            Parm_serial(indice[1], 13, &prms);
+            Parm_serial(indice[2], 13, &prms);
+            Parm_serial(indice[3], 13, &prms);
+        } else if (*ser_size <= NBBITS_18k)
+        {
+            ACELP_4t64_flt(dn, cn, h2, code, y2, 64, *ser_size, indice);
+
+            Parm_serial(indice[0], 2, &prms);
+            Parm_serial(indice[1], 2, &prms);
+            Parm_serial(indice[2], 2, &prms);
+            Parm_serial(indice[3], 2, &prms);
+            Parm_serial(indice[4], 14, &prms);
+            Parm_serial(indice[5], 14, &prms);
+            Parm_serial(indice[6], 14, &prms);
+            Parm_serial(indice[7], 14, &prms);
+        } else if (*ser_size <= NBBITS_20k)
+        {
+            ACELP_4t64_flt(dn, cn, h2, code, y2, 72, *ser_size, indice);
+
+            Parm_serial(indice[0], 10, &prms);
+            Parm_serial(indice[1], 10, &prms);
+            Parm_serial(indice[2], 2, &prms);
+            Parm_serial(indice[3], 2, &prms);
+            Parm_serial(indice[4], 10, &prms);
+            Parm_serial(indice[5], 10, &prms);
+            Parm_serial(indice[6], 14, &prms);
+            Parm_serial(indice[7], 14, &prms);
+        } else
+        {
+            ACELP_4t64_flt(dn, cn, h2, code, y2, 88, *ser_size, indice);
+
+            Parm_serial(indice[0], 11, &prms);
+            Parm_serial(indice[1], 11, &prms);
+            Parm_serial(indice[2], 11, &prms);
+            Parm_serial(indice[3], 11, &prms);
+            Parm_serial(indice[4], 11, &prms);
+            Parm_serial(indice[5], 11, &prms);
+            Parm_serial(indice[6], 11, &prms);
+            Parm_serial(indice[7], 11, &prms);
+        }
+
+        /*-------------------------------------------------------*
+         * - Add the fixed-gain pitch contribution to code[].    *
+         *-------------------------------------------------------*/
+
+        tmp = 0.0f;
+        Preemph_flt(code, st->tilt_code, L_SUBFR, &tmp);
+
+        Pit_shrp_flt(code, T0, PIT_SHARP_FLT, L_SUBFR);
+
+        /*----------------------------------------------------------*
+         *  - Compute the fixed codebook gain                       *
+         *  - quantize fixed codebook gain                          *
+         *----------------------------------------------------------*/
+
+        if (*ser_size <= NBBITS_9k)
+        {
+            index = Q_gain2_flt(xn, y1, y2, code, g_coeff, L_SUBFR, 6,
+                &gain_pit, &gain_code, clip_gain, st->qua_gain);
+            Parm_serial(index, 6, &prms);
+        } else
+        {
+            index = Q_gain2_flt(xn, y1, y2, code, g_coeff, L_SUBFR, 7,
+                &gain_pit, &gain_code, clip_gain, st->qua_gain);
+            Parm_serial(index, 7, &prms);
+        }
+
+        /* test quantized gain of pitch for pitch clipping algorithm */
+        Gp_clip_test_gain_pit(*ser_size, (Word16) (gain_pit * 16384.0f + 0.5f), st->gp_clip);
+
+        /*----------------------------------------------------------*
+         * Update parameters for the next subframe.                 *
+         * - tilt of code: 0.0 (unvoiced) to 0.5 (voiced)           *
+         *----------------------------------------------------------*/
+
+        voice_fac = voice_factor_flt(&exc[i_subfr], gain_pit, code, gain_code, L_SUBFR);
+
+        st->tilt_code = 0.25f * voice_fac + 0.25f;
+
+        /*------------------------------------------------------*
+         * - Update filter's memory "mem_w0" for finding the    *
+         *   target vector in the next subframe.                *
+         * - Find the total excitation                          *
+         * - Find synthesis speech to update mem_syn[].         *
+         *------------------------------------------------------*/
+
+        st->mem_w0 = xn[L_SUBFR - 1] - gain_pit * y1[L_SUBFR - 1] - gain_code * y2[L_SUBFR - 1];
+
+        if (*ser_size >= NBBITS_24k)
+            for (i = 0; i < L_SUBFR; i++)
+                exc2[i] = exc[i_subfr + i];
+
+        for (i = 0; i < L_SUBFR; i++)
+        {
+            exc[i + i_subfr] = gain_pit * exc[i + i_subfr] + gain_code * code[i];
+        }
+
+        Syn_filt_flt(p_Aq, M, &exc[i_subfr], synth, L_SUBFR, st->mem_syn, 1);
+
+        if (*ser_size >= NBBITS_24k)
+        {
+            /*------------------------------------------------------------*
+             * noise enhancer                                             *
+             * ~~~~~~~~~~~~~~                                             *
+             * - Enhance excitation on noise. (modify gain of code)       *
+             *   If signal is noisy and LPC filter is stable, move gain   *
+             *   of code 1.5 dB toward gain of code threshold.            *
+             *   This decrease by 3 dB noise energy variation.            *
+             *------------------------------------------------------------*/
+
+            fac = stab_fac * 0.5f * (1.0f - voice_fac);    /* 1=unvoiced, 0=voiced */
+
+            tmp = gain_code;
+            if (tmp < st->gc_thres)
+            {
+                tmp *= 1.19f;
+                if (tmp > st->gc_thres)
+                {
+                    tmp = st->gc_thres;
+                }
+            } else
+            {
+                tmp *= 0.84f;
+                if (tmp < st->gc_thres)
+                {
+                    tmp = st->gc_thres;
+                }
+            }
+            st->gc_thres = tmp;
+
+            gc_enh = gain_code * (1.0f - fac) + tmp * fac;
+
+            /*------------------------------------------------------------*
+             * pitch enhancer                                             *
+             * ~~~~~~~~~~~~~~                                             *
+             * - Enhance excitation on voice. (HP filtering of code)      *
+             *   On voiced signal, filtering of code by a smooth fir HP   *
+             *   filter to decrease energy of code in low frequency.      *
+             *------------------------------------------------------------*/
+
+            tmp = 0.125f * voice_fac + 0.125f;     /* 0.25=voiced, 0=unvoiced */
+
+            code2[0] = code[0] - tmp * code[1];
+            for (i = 1; i < L_SUBFR - 1; i++)
+            {
+                code2[i] = code[i] - tmp * (code[i + 1] + code[i - 1]);
+            }
+            code2[L_SUBFR - 1] = code[L_SUBFR - 1] - tmp * code[L_SUBFR - 2];
+
+            /* build excitation */
+
+            for (i = 0; i < L_SUBFR; i++)
+            {
+                exc2[i] = gain_pit * exc2[i] + gc_enh * code2[i];
+            }
+
+            corr_gain = synthesis_flt(p_Aq, exc2, &speech16k[i_subfr * 5 / 4], st);
+            Parm_serial(corr_gain, 4, &prms);
+        }
+        p_A += (M + 1);
+        p_Aq += (M + 1);
+
+    }                                      /* end of subframe loop */
+
+    /*--------------------------------------------------*
+     * Update signal for next frame.                    *
+     * -> save past of speech[], wsp[] and exc[].       *
+     *--------------------------------------------------*/
+
+    for (i = 0; i < L_TOTAL - L_FRAME; i++)
+        st->old_speech[i] = old_speech[L_FRAME + i];
+    for (i = 0; i < PIT_MAX / OPL_DECIM; i++)
+        st->old_wsp[i] = old_wsp[L_FRAME / OPL_DECIM + i];
+    for (i = 0; i < PIT_MAX + L_INTERPOL; i++)
+        st->old_exc[i] = old_exc[L_FRAME + i];
+
+    return;
+}
+
+/*-----------------------------------------------------*
+ * Function synthesis_flt()                            *
+ *                                                     *
+ * Synthesis of signal at 12.8kHz and estimation of    *
+ * the HF gain index (only sent at 23.85 kbit/s).      *
+ *-----------------------------------------------------*/
+
+static Word16 synthesis_flt(
+     Float Aq[],                           /* A(z)  : quantized Az               */
+     Float exc[],                          /* (i)   : excitation at 12kHz        */
+     Word16 synth16k[],                    /* (i)   : 16kHz input speech         */
+     Coder_State_flt * st                  /* (i/o) : State structure            */
+)
+{
+    Word16 i, HP_gain_ind;
+    Float fac, tmp, ener, ener_hf, r0, r1;
+    Float synth[L_SUBFR];
+    Float HF[L_SUBFR16k];                  /* High Frequency vector      */
+    Float HF_SP[L_SUBFR16k];               /* High Frequency vector (from original signal) */
+    Float Ap[M + 1];
+    Float HP_est_gain, HP_calc_gain, HP_corr_gain, dist, dist_min;
+
+    /*------------------------------------------------------------*
+     * speech synthesis                                           *
+     * - Find synthesis speech corresponding to exc2[].           *
+     * - Perform fixed deemphasis and hp 50hz filtering.          *
+     *------------------------------------------------------------*/
+
+    Syn_filt_flt(Aq, M, exc, synth, L_SUBFR, st->mem_syn2, 1);
+    Deemph_flt(synth, PREEMPH_FAC_FLT, L_SUBFR, &(st->mem_deemph));
+    HP50_12k8_flt(synth, L_SUBFR, st->mem_sig_out);
+
+    /* Original speech signal as reference for high band gain quantisation */
+    Word16_to_flt(synth16k, HF_SP, L_SUBFR16k);
+
+    /*------------------------------------------------------*
+     * HF noise synthesis                                   *
+     * - Generate HF noise between 5.5 and 7.5 kHz.         *
+     * - Set energy of noise to energy of excitation.       *
+     *------------------------------------------------------*/
+
+    for (i = 0; i < L_SUBFR16k; i++)
+    {
+        HF[i] = (Float) Random(&(st->seed2)) * 0.125f;
+    }
+
+    ener = Dot_product_flt(exc, exc, L_SUBFR) + 0.01f;
+    ener_hf = Dot_product_flt(HF, HF, L_SUBFR16k) + 0.01f;
+    tmp = (Float) sqrt(ener / ener_hf);
+
+    for (i = 0; i < L_SUBFR16k; i++)
+    {
+        HF[i] *= tmp;
+    }
+
+    /* find tilt of synthesis speech (tilt: 1=voiced, -1=unvoiced) */
+
+    HP400_12k8_flt(synth, L_SUBFR, st->mem_hp400);
+
+    r0 = 1.0f + Dot_product_flt(synth, synth, L_SUBFR);
+    r1 = 1.0f;
+    for (i = 1; i < L_SUBFR; i++)
+        r1 += synth[i] * synth[i - 1];
+
+    if (r1 > 0.0f)
+    {
+        fac = r1 / r0;
+    } else
+    {
+        fac = 0.0f;
+    }
+
+    /* modify energy of white noise according to synthesis tilt */
+    if (st->vad_hist > 0)
+    {
+        HP_est_gain = 1.25f * (1.0f - fac);
+    } else
+    {
+        HP_est_gain = 1.0f - fac;
+    }
+    if (HP_est_gain < 0.1f)
+    {
+        HP_est_gain = 0.1f;
+    }
+    /* synthesis of noise: 4.8kHz..5.6kHz --> 6kHz..7kHz */
+    Weight_a_flt(Aq, Ap, 0.6f, M);
+    Syn_filt_flt(Ap, M, HF, HF, L_SUBFR16k, st->mem_syn_hf, 1);
+
+    /* noise High Pass filtering (1ms of delay) */
+    Filt_6k_7k_flt(HF, L_SUBFR16k, st->mem_hf);
+
+    /* filtering of the original signal */
+    Filt_6k_7k_flt(HF_SP, L_SUBFR16k, st->mem_hf2);
+
+    /* check the gain difference */
+    ener = Dot_product_flt(HF_SP, HF_SP, L_SUBFR16k) + 0.01f;
+    ener_hf = Dot_product_flt(HF, HF, L_SUBFR16k) + 0.01f;
+    HP_calc_gain = (Float) sqrt(ener / ener_hf);
+
+    /* st->gain_alpha *= st->dtx_encSt->dtxHangoverCount/7 */
+    st->gain_alpha *= (Float) st->dtx_encSt->dtxHangoverCount / 7.0f;
+
+    if (st->dtx_encSt->dtxHangoverCount > 6)
+        st->gain_alpha = 1.0f;
+
+    HP_corr_gain = HP_calc_gain * st->gain_alpha + (1.0f - st->gain_alpha) * HP_est_gain;
+
+    /* Quantise the correction gain */
+    dist_min = 1.0e30f;
+    HP_gain_ind = 0;
+    for (i = 0; i < 16; i++)
+    {
+        tmp = HP_corr_gain - (Float) HP_gain[i] * (1.0f / 16384.0f);
+        dist = tmp * tmp;
+        if (dist_min > dist)
+        {
+            dist_min = dist;
+            HP_gain_ind = i;
+        }
+    }
+
+    /* return the quantised gain index when using the highest mode, otherwise zero */
+    return (HP_gain_ind);
+}
@@ -0,0 +1,58 @@
+/*--------------------------------------------------------------------------*
+ *                         COD_FLT.H                                        *
+ *--------------------------------------------------------------------------*
+ *       Static memory in the floating-point encoder                        *
+ *--------------------------------------------------------------------------*/
+
+#include "cnst.h"                          /* coder constant parameters */
+
+#include "wb_vad.h"
+#include "dtx.h"
+
+typedef struct
+{
+    Float mem_decim[2 * L_FILT16k];        /* speech decimated filter memory */
+    Float mem_sig_in[4];                   /* hp50 filter memory */
+    Float mem_preemph;                     /* speech preemph filter memory */
+    Float old_speech[L_TOTAL - L_FRAME];   /* old speech vector at 12.8kHz */
+    Float old_wsp[PIT_MAX / OPL_DECIM];    /* old decimated weighted speech vector */
+    Float old_exc[PIT_MAX + L_INTERPOL];   /* old excitation vector */
+    Float mem_levinson[M + 1];             /* levinson routine memory */
+    Float ispold[M];                       /* old isp (immittance spectral pairs) */
+    Float ispold_q[M];                     /* quantized old isp */
+    Word16 past_isfq[M];                   /* past isf quantizer */
+    Float mem_wsp;                         /* wsp vector memory */
+    Float mem_decim2[3];                   /* wsp decimation filter memory */
+    Float mem_w0;                          /* target vector memory */
+    Float mem_syn[M];                      /* synthesis memory */
+    Float tilt_code;                       /* tilt of code */
+    Word16 gp_clip[2];                     /* gain of pitch clipping memory */
+    Float qua_gain[4];                     /* gain quantizer memory */
+
+    Word16 old_T0_med;
+    Float ol_gain;
+    Float ada_w;
+    Word16 ol_wght_flg;
+    Word16 old_ol_lag[5];
+    Float hp_wsp_mem[6];
+    Float old_hp_wsp[L_FRAME / OPL_DECIM + (PIT_MAX / OPL_DECIM)];
+    VadVars *vadSt;
+    dtx_encState *dtx_encSt;
+    Word16 first_frame;
+
+    Word16 isfold[M];                      /* old isf (frequency domain) */
+    Float gc_thres;                        /* threshold for noise enhancer */
+    Float mem_syn2[M];                     /* modified synthesis memory */
+    Float mem_deemph;                      /* speech deemph filter memory */
+    Float mem_sig_out[4];                  /* hp50 filter memory for synthesis */
+    Float mem_hp400[4];                    /* hp400 filter memory for synthesis */
+    Float mem_syn_hf[M];                   /* HF synthesis memory */
+    Float mem_hf[2 * L_FILT16k];           /* HF band-pass filter memory */
+    Float mem_hf2[2 * L_FILT16k];          /* HF band-pass filter memory */
+    Word16 seed2;                          /* random memory for HF generation */
+    Word16 vad_hist;
+
+    Float gain_alpha;
+    Word16 dtx_skip;                       /* DTX_SKIP_xxx: work left out in the next DTX frame */
+
+} Coder_State_flt;
@@ -24,32 +24,59 @@
 #include "bits.h"
 #include "count.h"
 #include "main.h"
+#include "transrate.h"
+#include "taskgrp.h"
+#include "cpu_disp.h"
+#include "ratectl.h"
+#include "rom_tab.h"
 
 
-/* LPC interpolation coef {0.45, 0.8, 0.96, 1.0}; in Q15 */
-static Word16 interpol_frac[NB_SUBFR] = {14746, 26214, 31457, 32767};
-
-/* isp tables for initialization */
-
-static Word16 isp_init[M] =
+/* High Band encoding */
+static const Word16 HP_gain[16] =
 {
-   32138, 30274, 27246, 23170, 18205, 12540, 6393, 0,
-   -6393, -12540, -18205, -23170, -27246, -30274, -32138, 1475
+   3624, 4673, 5597, 6479, 7425, 8378, 9324, 10264,
+   11210, 12206, 13391, 14844, 16770, 19655, 24289, 32728
 };
 
-static Word16 isf_init[M] =
+/* Algebraic codebook of each mode: specialized search, index and gain bits */
+typedef struct
 {
-   1024, 2048, 3072, 4096, 5120, 6144, 7168, 8192,
-   9216, 10240, 11264, 12288, 13312, 14336, 15360, 3840
-};
+    void (*search) (Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 index[],
+         Task_Group * grp);
+    Word16 nb_ind;                         /* number of codebook indices          */
+    Word16 ind_bits[8];                    /* bits of each codebook index         */
+    Word16 gain_bits;                      /* bits of the gain quantizer (Q_gain2) */
+} Cb_mode;
+
+/* 2 pulses: a single search, no iterations to share */
+static void ACELP_2t64_grp(Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 index[],
+     Task_Group * grp)
+{
+    ACELP_2t64_fx(dn, cn, H, code, y, index);
+    return;
+}
 
-/* High Band encoding */
-static const Word16 HP_gain[16] =
+static const Cb_mode cb_mode[MODE_24k + 1] =
 {
-   3624, 4673, 5597, 6479, 7425, 8378, 9324, 10264,
-   11210, 12206, 13391, 14844, 16770, 19655, 24289, 32728
+    {ACELP_2t64_grp,    1, {12},                             6},    /* 6.60k  */
+    {ACELP_4t64_9k_fx,  4, {5, 5, 5, 5},                     6},    /* 8.85k  */
+    {ACELP_4t64_12k_fx, 4, {9, 9, 9, 9},                     7},    /* 12.65k */
+    {ACELP_4t64_14k_fx, 4, {13, 13, 9, 9},                   7},    /* 14.25k */
+    {ACELP_4t64_16k_fx, 4, {13, 13, 13, 13},                 7},    /* 15.85k */
+    {ACELP_4t64_18k_fx, 8, {2, 2, 2, 2, 14, 14, 14, 14},     7},    /* 18.25k */
+    {ACELP_4t64_20k_fx, 8, {10, 10, 2, 2, 10, 10, 14, 14},   7},    /* 19.85k */
+    {ACELP_4t64_23k_fx, 8, {11, 11, 11, 11, 11, 11, 11, 11}, 7},    /* 23.05k */
+    {ACELP_4t64_24k_fx, 8, {11, 11, 11, 11, 11, 11, 11, 11}, 7}     /* 23.85k */
 };
 
+static Word16 scale_Q_new(Word16 max, Word16 * exp, Coder_State * st);
+
+static Word16 weight_trans(Word16 speech[], Word16 isf[], Word16 A[], Coder_State * st);
+
+static void coder_acelp(Word16 mode, Word16 speech[], Word16 A[], Word16 isf[], Word16 exc[],
+     Word16 Q_new, Word16 shift, Word16 T_op, Word16 T_op2, Word16 vad_flag,
+     Word16 prms[], Word16 speech16k[], Coder_State * st);
+
 static Word16 synthesis(
      Word16 Aq[],                          /* A(z)  : quantized Az               */
      Word16 exc[],                         /* (i)   : excitation at 12kHz        */
@@ -69,6 +96,7 @@ void Init_coder(void **spe_state)
     Coder_State *st;
 
     *spe_state = NULL;
+    Disp_init();                           /* kernels of the CPU */
 
     /*-------------------------------------------------------------------------*
      * Memory allocation for coder state.                                      *
@@ -79,11 +107,9 @@ void Init_coder(void **spe_state)
         printf("Can not malloc Coder_State structure!\n");
         return;
     }
-    st->vadSt = NULL;                      move16();
-    st->dtx_encSt = NULL;                  move16();
-
-    wb_vad_init(&(st->vadSt));
-    dtx_enc_init(&(st->dtx_encSt), isf_init);
+    st->dtx_skip = DTX_SKIP_NONE;          move16();
+    st->search_grp = NULL;
+    st->rate = NULL;
 
     Reset_encoder((void *) st, 1);
 
@@ -175,16 +201,88 @@ void Reset_encoder(void *st, Word16 reset_all)
 
         cod_state->vad_hist = 0;
 
-        wb_vad_reset(cod_state->vadSt);
-        dtx_enc_reset(cod_state->dtx_encSt, isf_init);
+        wb_vad_reset(&(cod_state->vadSt));
+        dtx_enc_reset(&(cod_state->dtx_encSt), isf_init);
     }
     return;
 }
 
+/*-----------------------------------------------------------------*
+ *   Funtion  Set_encoder_dtx_skip                                 *
+ *            ~~~~~~~~~~~~~~~~~~~~                                 *
+ *   ->Work left out if the next frame is a DTX frame (MRDTX).     *
+ *     Set by the caller when the frame would not be transmitted   *
+ *     (TX_NO_DATA, see Tx_dtx_no_data()):                         *
+ *     DTX_SKIP_SYN: the synthesis only feeds the HF gain          *
+ *       estimator memory, it is not needed if 23.85k is never     *
+ *       used.                                                     *
+ *     DTX_SKIP_SID: same and the SID parameters are not computed  *
+ *       either (bitstream formats without NO_DATA payload).       *
+ *     VAD, DTX history and filter memories are always updated.    *
+ *-----------------------------------------------------------------*/
+
+void Set_encoder_dtx_skip(void *spe_state, Word16 skip)
+{
+    ((Coder_State *) spe_state)->dtx_skip = skip;
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Set_encoder_search                                   *
+ *            ~~~~~~~~~~~~~~~~~~                                   *
+ *   ->Task group (taskgrp.h) on which the iterations of the       *
+ *     algebraic codebook search run together; NULL (default):     *
+ *     in turn. Same bitstream. The group belongs to the caller,   *
+ *     it is not closed by Close_coder() and must not be used by   *
+ *     another encoder at the same time.                           *
+ *-----------------------------------------------------------------*/
+
+void Set_encoder_search(void *spe_state, void *grp)
+{
+    ((Coder_State *) spe_state)->search_grp = (Task_Group *) grp;
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Set_encoder_rate                                     *
+ *            ~~~~~~~~~~~~~~~~                                     *
+ *   ->Rate controller (ratectl.h) choosing the mode of each frame *
+ *     for a target bit rate, the mode given to coder() is not     *
+ *     used; NULL (default): the mode given to coder(). The        *
+ *     controller belongs to the caller, it is not closed by       *
+ *     Close_coder() and must not be used by another encoder.      *
+ *-----------------------------------------------------------------*/
+
+void Set_encoder_rate(void *spe_state, void *rate)
+{
+    ((Coder_State *) spe_state)->rate = (Rate_State *) rate;
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Copy_coder                                           *
+ *            ~~~~~~~~~~                                           *
+ *   ->Copies the state of an encoder into another encoder (also   *
+ *     VAD and DTX states): both continue the same bitstream.      *
+ *-----------------------------------------------------------------*/
+
+void Copy_coder(void *dst_state, void *src_state)
+{
+    Task_Group *grp;
+    Rate_State *rate;
+
+    /* the task group and the rate controller are not part of the bitstream state */
+    grp = ((Coder_State *) dst_state)->search_grp;
+    rate = ((Coder_State *) dst_state)->rate;
+    *((Coder_State *) dst_state) = *((Coder_State *) src_state);
+    ((Coder_State *) dst_state)->search_grp = grp;
+    ((Coder_State *) dst_state)->rate = rate;
+
+    return;
+}
+
 void Close_coder(void *spe_state)
 {
-    wb_vad_exit(&(((Coder_State *) spe_state)->vadSt));
-    dtx_enc_exit(&(((Coder_State *) spe_state)->dtx_encSt));
     free(spe_state);
 
     return;
@@ -206,72 +304,70 @@ void coder(
      Word16 allow_dtx                      /* input :  DTX ON/OFF                            */
 )
 {
+    Cod_Frame frame;
 
-    /* Coder states */
-    Coder_State *st;
+    coder_front(mode, speech16k, allow_dtx, &frame, (Coder_State *) spe_state);
+    coder_back(&frame, speech16k, prms, (Coder_State *) spe_state);
+
+    *ser_size = frame.ser_size;
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  coder_front                                          *
+ *            ~~~~~~~~~~~                                          *
+ *   ->Front end of coder(): decimation, pre-processing, VAD and   *
+ *     DTX decision, LP analysis and open-loop pitch. The frame    *
+ *     for coder_back() is in f.                                   *
+ *-----------------------------------------------------------------*/
+
+void coder_front(
+     Word16 * mode,                        /* i/o   :  used mode (MRDTX at output if DTX)    */
+     Word16 speech16k[],                   /* input :  320 new speech samples (at 16 kHz)    */
+     Word16 allow_dtx,                     /* input :  DTX ON/OFF                            */
+     Cod_Frame * f,                        /* output:  frame for coder_back()                */
+     Coder_State * st                      /* i/o   :  State structure                       */
+)
+{
 
     /* Speech vector */
-    Word16 old_speech[L_TOTAL];
-    Word16 *new_speech, *speech, *p_window;
+    Word16 *old_speech, *new_speech, *speech, *p_window;
 
     /* Weighted speech vector */
     Word16 old_wsp[L_FRAME + (PIT_MAX / OPL_DECIM)];
     Word16 *wsp;
 
-    /* Excitation vector */
-    Word16 old_exc[(L_FRAME + 1) + PIT_MAX + L_INTERPOL];
-    Word16 *exc;
-
     /* LPC coefficients */
 
     Word16 r_h[M + 1], r_l[M + 1];         /* Autocorrelations of windowed speech  */
     Word16 rc[M];                          /* Reflection coefficients.             */
     Word16 Ap[M + 1];                      /* A(z) with spectral expansion         */
     Word16 ispnew[M];                      /* immittance spectral pairs at 4nd sfr */
-    Word16 ispnew_q[M];                    /* quantized ISPs at 4nd subframe       */
-    Word16 isf[M];                         /* ISF (frequency domain) at 4nd sfr    */
-    Word16 *p_A, *p_Aq;                    /* ptr to A(z) for the 4 subframes      */
-    Word16 A[NB_SUBFR * (M + 1)];          /* A(z) unquantized for the 4 subframes */
-    Word16 Aq[NB_SUBFR * (M + 1)];         /* A(z)   quantized for the 4 subframes */
+    Word16 *isf;                           /* ISF (frequency domain) at 4nd sfr    */
+    Word16 *p_A;                           /* ptr to A(z) for the 4 subframes      */
+    Word16 *A;                             /* A(z) unquantized for the 4 subframes */
 
     /* Other vectors */
 
-    Word16 xn[L_SUBFR];                    /* Target vector for pitch search     */
-    Word16 xn2[L_SUBFR];                   /* Target vector for codebook search  */
-    Word16 dn[L_SUBFR];                    /* Correlation between xn2 and h1     */
-    Word16 cn[L_SUBFR];                    /* Target vector in residual domain   */
-
-    Word16 h1[L_SUBFR];                    /* Impulse response vector            */
-    Word16 h2[L_SUBFR];                    /* Impulse response vector            */
-    Word16 code[L_SUBFR];                  /* Fixed codebook excitation          */
-    Word16 y1[L_SUBFR];                    /* Filtered adaptive excitation       */
-    Word16 y2[L_SUBFR];                    /* Filtered adaptive excitation       */
-    Word16 error[M + L_SUBFR];             /* error of quantization              */
-    Word16 synth[L_SUBFR];                 /* 12.8kHz synthesis vector           */
-    Word16 exc2[L_FRAME];                  /* excitation vector                  */
+    Word16 code[L_SUBFR];                  /* decimation filter memory           */
+    Word16 error[M + L_SUBFR];             /* zero padding for decimation        */
     Word16 buf[L_FRAME];                   /* VAD buffer                         */
 
     /* Scalars */
 
-    Word16 i, j, i_subfr, select, pit_flag, clip_gain, vad_flag;
-    Word16 codec_mode;
-    Word16 T_op, T_op2, T0, T0_min, T0_max, T0_frac, index;
-    Word16 gain_pit, gain_code, g_coeff[4], g_coeff2[4];
-    Word16 tmp, gain1, gain2, exp, Q_new, mu, shift, max;
-    Word16 voice_fac;
-    Word16 indice[8];
-
-    Word32 L_tmp, L_gain_code, L_max;
-
-    Word16 code2[L_SUBFR];                 /* Fixed codebook excitation  */
-    Word16 stab_fac, fac, gain_code_lo;
+    Word16 i, i_subfr, vad_flag;
+    Word16 T_op, T_op2;
+    Word16 tmp, exp, Q_new, mu, shift, max;
 
-    Word16 corr_gain;
+    Word32 L_tmp, L_max;
 
-    st = (Coder_State *) spe_state;
+    old_speech = f->old_speech;
+    A = f->A;
+    isf = f->isf;
 
-    *ser_size = nb_of_bits[*mode];         move16();
-    codec_mode = *mode;                    move16();
+    f->ser_size = nb_of_bits[*mode];       move16();
+    f->codec_mode = *mode;                 move16();
 
     /*--------------------------------------------------------------------------*
      *          Initialize pointers to speech vector.                           *
@@ -293,14 +389,12 @@ void coder(
     speech = old_speech + L_TOTAL - L_FRAME - L_NEXT;   move16();  /* Present frame  */
     p_window = old_speech + L_TOTAL - L_WINDOW; move16();
 
-    exc = old_exc + PIT_MAX + L_INTERPOL;  move16();
     wsp = old_wsp + (PIT_MAX / OPL_DECIM); move16();
 
     /* copy coder memory state into working space (internal memory for DSP) */
 
     Copy(st->old_speech, old_speech, L_TOTAL - L_FRAME);
     Copy(st->old_wsp, old_wsp, PIT_MAX / OPL_DECIM);
-    Copy(st->old_exc, old_exc, PIT_MAX + L_INTERPOL);
 
     /*---------------------------------------------------------------*
      * Down sampling signal from 16kHz to 12.8kHz                    *
@@ -355,40 +449,7 @@ void coder(
     /* get scaling factor for new and previous samples */
     /* limit scaling to Q_MAX to keep dynamic for ringing in low signal */
     /* limit scaling to Q_MAX also to avoid a[0]<1 in syn_filt_32 */
-    tmp = extract_h(L_max);
-    test();
-    if (tmp == 0)
-    {
-        shift = Q_MAX;                     move16();
-    } else
-    {
-        shift = sub(norm_s(tmp), 1);
-        test();
-        if (shift < 0)
-        {
-            shift = 0;                     move16();
-        }
-        test();
-        if (sub(shift, Q_MAX) > 0)
-        {
-            shift = Q_MAX;                 move16();
-        }
-    }
-    Q_new = shift;                         move16();
-    test();
-    if (sub(Q_new, st->Q_max[0]) > 0)
-    {
-        Q_new = st->Q_max[0];              move16();
-    }
-    test();
-    if (sub(Q_new, st->Q_max[1]) > 0)
-    {
-        Q_new = st->Q_max[1];              move16();
-    }
-    exp = sub(Q_new, st->Q_old);
-    st->Q_old = Q_new;                     move16();
-    st->Q_max[1] = st->Q_max[0];           move16();
-    st->Q_max[0] = shift;                  move16();
+    Q_new = scale_Q_new(extract_h(L_max), &exp, st);
 
     /* preemphasis with scaling (L_FRAME+L_FILT) */
 
@@ -412,12 +473,12 @@ void coder(
     /* scale previous samples and memory */
 
     Scale_sig(old_speech, L_TOTAL - L_FRAME - L_FILT, exp);
-    Scale_sig(old_exc, PIT_MAX + L_INTERPOL, exp);
 
-    Scale_sig(st->mem_syn, M, exp);
     Scale_sig(st->mem_decim2, 3, exp);
     Scale_sig(&(st->mem_wsp), 1, exp);
-    Scale_sig(&(st->mem_w0), 1, exp);
+
+    /* the excitation and the memories of the subframe loop are scaled by coder_back() */
+    f->exp = exp;                          move16();
 
     /*------------------------------------------------------------------------*
      *  Call VAD                                                              *
@@ -429,7 +490,7 @@ void coder(
 
     Scale_sig(buf, L_FRAME, sub(1, Q_new));
 
-    vad_flag = wb_vad(st->vadSt, buf);
+    vad_flag = wb_vad(&(st->vadSt), buf);
     if (vad_flag == 0)
     {
         st->vad_hist = add(st->vad_hist, 1);        move16();
@@ -443,15 +504,10 @@ void coder(
     if (allow_dtx != 0)
     {
         /* Note that mode may change here */
-        tx_dtx_handler(st->dtx_encSt, vad_flag, mode);
-        *ser_size = nb_of_bits[*mode]; move16();
+        tx_dtx_handler(&(st->dtx_encSt), vad_flag, mode);
+        f->ser_size = nb_of_bits[*mode];   move16();
     }
 
-    test();
-    if (sub(*mode, MRDTX) != 0)
-    {
-        Parm_serial(vad_flag, 1, &prms);
-    }
     /*------------------------------------------------------------------------*
      *  Perform LPC analysis                                                  *
      *  ~~~~~~~~~~~~~~~~~~~~                                                  *
@@ -479,8 +535,17 @@ void coder(
     /* Convert ISPs to frequency domain 0..6400 */
     Isp_isf(ispnew, isf, M);
 
+    /* source-controlled rate: mode of the frame (see Set_encoder_rate()) */
+    test();
+    if (st->rate != NULL)
+    {
+        *mode = Rate_mode(st->rate, *mode, vad_flag, buf, isf, rc[0], st->ol_gain);
+        f->ser_size = nb_of_bits[*mode];   move16();
+        f->codec_mode = st->rate->mode;    move16();  /* last speech mode if DTX */
+    }
+
     /* check resonance for pitch clipping algorithm */
-    Gp_clip_test_isf(*ser_size, isf, st->gp_clip);
+    Gp_clip_test_isf(f->ser_size, isf, st->gp_clip);
 
     /*----------------------------------------------------------------------*
      *  Perform PITCH_OL analysis                                           *
@@ -543,7 +608,7 @@ void coder(
     /* Find open loop pitch lag for whole speech frame */
 
     test();
-    if (sub(*ser_size, NBBITS_7k) == 0)
+    if (sub(f->ser_size, NBBITS_7k) == 0)
     {
         /* Find open loop pitch lag for whole speech frame */
         T_op = Pitch_med_ol(wsp, PIT_MIN / OPL_DECIM, PIT_MAX / OPL_DECIM,
@@ -571,12 +636,12 @@ void coder(
     else
         st->ol_wght_flg = 1;
 
-    wb_vad_tone_detection(st->vadSt, st->ol_gain);
+    wb_vad_tone_detection(&(st->vadSt), st->ol_gain);
 
     T_op *= OPL_DECIM;                     move16();
 
     test();
-    if (sub(*ser_size, NBBITS_7k) != 0)
+    if (sub(f->ser_size, NBBITS_7k) != 0)
     {
         /* Find open loop pitch lag for second 1/2 frame */
         T_op2 = Pitch_med_ol(wsp + ((L_FRAME / 2) / OPL_DECIM), PIT_MIN / OPL_DECIM, PIT_MAX / OPL_DECIM,
@@ -598,7 +663,7 @@ void coder(
         else
             st->ol_wght_flg = 1;
 
-        wb_vad_tone_detection(st->vadSt, st->ol_gain);
+        wb_vad_tone_detection(&(st->vadSt), st->ol_gain);
 
         T_op2 *= OPL_DECIM;                move16();
 
@@ -607,20 +672,76 @@ void coder(
         T_op2 = T_op;                      move16();
     }
 
+    f->mode = *mode;                       move16();
+    f->vad_flag = vad_flag;                move16();
+    f->Q_new = Q_new;                      move16();
+    f->shift = shift;                      move16();
+    f->T_op = T_op;                        move16();
+    f->T_op2 = T_op2;                      move16();
+
+    /*--------------------------------------------------*
+     * Update signal for next frame.                    *
+     * -> save past of speech[] and wsp[].              *
+     *--------------------------------------------------*/
+
+    Copy(&old_speech[L_FRAME], st->old_speech, L_TOTAL - L_FRAME);
+    Copy(&old_wsp[L_FRAME / OPL_DECIM], st->old_wsp, PIT_MAX / OPL_DECIM);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  coder_back                                           *
+ *            ~~~~~~~~~~                                           *
+ *   ->Coding of the frame analysed by coder_front(): comfort      *
+ *     noise (DTX) or ACELP. Only uses the parts of the state      *
+ *     which coder_front() does not write, except gp_clip[0],      *
+ *     vad_hist and the DTX hangover count (see cod_pipe.c).       *
+ *-----------------------------------------------------------------*/
+
+void coder_back(
+     Cod_Frame * f,                        /* input :  frame from coder_front()              */
+     Word16 speech16k[],                   /* input :  320 speech samples of the frame       */
+     Word16 prms[],                        /* output:  output parameters                     */
+     Coder_State * st                      /* i/o   :  State structure                       */
+)
+{
+    Word16 *speech;
+
+    /* Excitation vector */
+    Word16 old_exc[(L_FRAME + 1) + PIT_MAX + L_INTERPOL];
+    Word16 *exc;
+
+    Word16 ispnew_q[M];                    /* quantized ISPs at 4nd subframe       */
+    Word16 Aq[NB_SUBFR * (M + 1)];         /* A(z)   quantized for the 4 subframes */
+    Word16 exc2[L_FRAME];                  /* excitation vector                  */
+
+    Word16 i, i_subfr;
+    Word32 L_tmp;
+
+    speech = f->old_speech + L_TOTAL - L_FRAME - L_NEXT;
+    exc = old_exc + PIT_MAX + L_INTERPOL;  move16();
+
+    Copy(st->old_exc, old_exc, PIT_MAX + L_INTERPOL);
+
+    /* scaling of the frame (see coder_front()) */
+    Scale_sig(old_exc, PIT_MAX + L_INTERPOL, f->exp);
+    Scale_sig(st->mem_syn, M, f->exp);
+    Scale_sig(&(st->mem_w0), 1, f->exp);
 
     /*----------------------------------------------------------------------*
      *                              DTX-CNG                                 *
      *----------------------------------------------------------------------*/
 
     test();
-    if (sub(*mode, MRDTX) == 0)            /* CNG mode */
+    if (sub(f->mode, MRDTX) == 0)          /* CNG mode */
     {
         /* Buffer isf's and energy */
-        Residu(&A[3 * (M + 1)], M, speech, exc, L_FRAME);
+        Residu(&(f->A[3 * (M + 1)]), M, speech, exc, L_FRAME);
 
         for (i = 0; i < L_FRAME; i++)
         {
-            exc2[i] = shr(exc[i], Q_new);  move16();
+            exc2[i] = shr(exc[i], f->Q_new); move16();
         }
 
         L_tmp = 0;                         move32();
@@ -628,43 +749,403 @@ void coder(
             L_tmp = L_mac(L_tmp, exc2[i], exc2[i]);
         L_tmp = L_shr(L_tmp, 1);
 
-        dtx_buffer(st->dtx_encSt, isf, L_tmp, codec_mode);
+        dtx_buffer(&(st->dtx_encSt), f->isf, L_tmp, f->codec_mode);
 
-        /* Quantize and code the ISFs */
-        dtx_enc(st->dtx_encSt, isf, exc2, &prms);
-
-        /* Convert ISFs to the cosine domain */
-        Isf_isp(isf, ispnew_q, M);
-        Isp_Az(ispnew_q, Aq, M, 0);
-
-        for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+        test();
+        if (sub(st->dtx_skip, DTX_SKIP_SID) < 0)
         {
-            corr_gain = synthesis(Aq, &exc2[i_subfr], 0, &speech16k[i_subfr * 5 / 4], st);
+            /* Quantize and code the ISFs */
+            dtx_enc(&(st->dtx_encSt), f->isf, exc2, &prms);
+        } else
+        {
+            dtx_enc_skip(&(st->dtx_encSt));
         }
-        Copy(isf, st->isfold, M);
 
+        test();
+        if (st->dtx_skip == DTX_SKIP_NONE)
+        {
+            /* Convert ISFs to the cosine domain */
+            Isf_isp(f->isf, ispnew_q, M);
+            Isp_Az(ispnew_q, Aq, M, 0);
+
+            for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+            {
+                synthesis(Aq, &exc2[i_subfr], 0, &speech16k[i_subfr * 5 / 4], st);
+            }
+        }
+        Copy(f->isf, st->isfold, M);
 
         /* reset speech coder memories */
         Reset_encoder(st, 0);
 
-        /*--------------------------------------------------*
-         * Update signal for next frame.                    *
-         * -> save past of speech[] and wsp[].              *
-         *--------------------------------------------------*/
-
-        Copy(&old_speech[L_FRAME], st->old_speech, L_TOTAL - L_FRAME);
-        Copy(&old_wsp[L_FRAME / OPL_DECIM], st->old_wsp, PIT_MAX / OPL_DECIM);
-
         return;
     }
+
     /*----------------------------------------------------------------------*
      *                               ACELP                                  *
      *----------------------------------------------------------------------*/
 
+    Parm_serial(f->vad_flag, 1, &prms);
+
+    coder_acelp(f->mode, speech, f->A, f->isf, exc, f->Q_new, f->shift, f->T_op, f->T_op2, f->vad_flag, prms, speech16k, st);
+
+    /*--------------------------------------------------*
+     * Update excitation for next frame.                *
+     *--------------------------------------------------*/
+
+    Copy(&old_exc[L_FRAME], st->old_exc, PIT_MAX + L_INTERPOL);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  coder_trans                                          *
+ *            ~~~~~~~~~~~                                          *
+ *   ->Coding of a decoded frame (transrating, see transrate.c).   *
+ *     The front-end of coder() is left out: no decimation, LPC    *
+ *     analysis, VAD or open-loop pitch search. The weighting      *
+ *     filter is interpolated from the decoded ISFs, which are     *
+ *     requantized for this mode, and the closed-loop pitch        *
+ *     search is centered on the decoded pitch lags.               *
+ *     Past speech is kept in old_speech[0..M-1].                  *
+ *-----------------------------------------------------------------*/
+
+void coder_trans(
+     Word16 mode,                          /* input :  used mode (below 23.85k)              */
+     Trans_Parm * parm,                    /* input :  decoded frame                         */
+     Word16 prms[],                        /* output:  output parameters                     */
+     void *spe_state                       /* i/o   :  State structure                       */
+)
+{
+    Coder_State *st;
+
+    Word16 old_speech[M + L_FRAME];
+    Word16 *speech;
+    Word16 old_exc[(L_FRAME + 1) + PIT_MAX + L_INTERPOL];
+    Word16 *exc;
+
+    Word16 isf[M];                         /* ISF (frequency domain) at 4nd sfr    */
+    Word16 A[NB_SUBFR * (M + 1)];          /* A(z) unquantized for the 4 subframes */
+
+    Word16 i, tmp, max, exp, Q_new, shift;
+
+    st = (Coder_State *) spe_state;
+
+    speech = old_speech + M;               move16();
+    exc = old_exc + PIT_MAX + L_INTERPOL;  move16();
+
+    Copy(st->old_speech, old_speech, M);
+    Copy(parm->speech, speech, L_FRAME);
+    Copy(st->old_exc, old_exc, PIT_MAX + L_INTERPOL);
+
+    /* scaling of the new frame and of the memories (see coder()) */
+
+    max = 0;                               move16();
+    for (i = 0; i < L_FRAME; i++)
+    {
+        tmp = abs_s(speech[i]);
+        test();
+        if (sub(tmp, max) > 0)
+        {
+            max = tmp;                     move16();
+        }
+    }
+    Q_new = scale_Q_new(max, &exp, st);
+
+    Scale_sig(speech, L_FRAME, Q_new);
+    Scale_sig(old_speech, M, exp);
+    Scale_sig(old_exc, PIT_MAX + L_INTERPOL, exp);
+
+    Scale_sig(st->mem_syn, M, exp);
+    Scale_sig(&(st->mem_wsp), 1, exp);
+    Scale_sig(&(st->mem_w0), 1, exp);
+
+    Parm_serial(parm->vad_flag, 1, &prms);
+
+    Copy(parm->isf, isf, M);
+    shift = weight_trans(speech, isf, A, st);
+
+    Gp_clip_test_isf(nb_of_bits[mode], isf, st->gp_clip);
+
+    coder_acelp(mode, speech, A, isf, exc, Q_new, shift, parm->T0[0], parm->T0[2], parm->vad_flag, prms, NULL, st);
+
+    Copy(&speech[L_FRAME - M], st->old_speech, M);
+    Copy(&old_exc[L_FRAME], st->old_exc, PIT_MAX + L_INTERPOL);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  coder_trans_update                                   *
+ *            ~~~~~~~~~~~~~~~~~~                                   *
+ *   ->Update of the encoder of the transrater on a frame passed   *
+ *     through unchanged (transrate.c): the far-end decoder        *
+ *     decodes the received bits, so the memories of the          *
+ *     closed-loop analysis are set to those of the decoder        *
+ *     (excitation, synthesis, ISF and gain predictors, tilt) and  *
+ *     the weighting filter runs on the decoded frame.             *
+ *-----------------------------------------------------------------*/
+
+void coder_trans_update(
+     Word16 mode,                          /* input :  mode of the received frame            */
+     Trans_Parm * parm,                    /* input :  decoded frame                         */
+     void *spe_state                       /* i/o   :  State structure                       */
+)
+{
+    Coder_State *st;
+
+    Word16 old_speech[M + L_FRAME];
+    Word16 *speech;
+    Word16 isf[M];                         /* ISF (frequency domain) at 4nd sfr    */
+    Word16 A[NB_SUBFR * (M + 1)];          /* A(z) unquantized for the 4 subframes */
+
+    Word16 i, tmp, max, exp, Q_new;
+
+    st = (Coder_State *) spe_state;
+
+    speech = old_speech + M;               move16();
+
+    Copy(st->old_speech, old_speech, M);
+    Copy(parm->speech, speech, L_FRAME);
+
+    max = 0;                               move16();
+    for (i = 0; i < L_FRAME; i++)
+    {
+        tmp = abs_s(speech[i]);
+        test();
+        if (sub(tmp, max) > 0)
+        {
+            max = tmp;                     move16();
+        }
+    }
+    Q_new = scale_Q_new(max, &exp, st);
+
+    Scale_sig(speech, L_FRAME, Q_new);
+    Scale_sig(old_speech, M, exp);
+    Scale_sig(&(st->mem_wsp), 1, exp);
+
+    Copy(parm->isf, isf, M);
+    weight_trans(speech, isf, A, st);
+
+    Gp_clip_test_isf(nb_of_bits[mode], isf, st->gp_clip);
+
+    /* the decoded frame is the synthesis: no weighted error */
+
+    Copy(&speech[L_FRAME - M], st->old_speech, M);
+    Copy(&speech[L_FRAME - M], st->mem_syn, M);
+    st->mem_w0 = 0;                        move16();
+
+    /* memories of the decoder, excitation in the scale of speech[] */
+
+    Copy(parm->old_exc, st->old_exc, PIT_MAX + L_INTERPOL);
+    Scale_sig(st->old_exc, PIT_MAX + L_INTERPOL, sub(Q_new, parm->Q_exc));
+
+    Isf_isp(isf, st->ispold_q, M);
+    Copy(isf, st->isfold, M);
+    Copy(parm->past_isfq, st->past_isfq, M);
+    Copy(parm->past_qua_en, st->qua_gain, 4);
+    st->tilt_code = parm->tilt_code;       move16();
+    st->first_frame = 0;                   move16();
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  weight_trans                                         *
+ *            ~~~~~~~~~~~~                                         *
+ *   ->Weighting filter of a decoded frame (transrating): A(z) of  *
+ *     the 4 subframes interpolated from the decoded ISFs, and the *
+ *     scaling of the targets from the weighted speech (see        *
+ *     coder()). Returns the shift of the targets.                 *
+ *-----------------------------------------------------------------*/
+
+static Word16 weight_trans(
+     Word16 speech[],                      /* input :  speech of the frame, scaled by Q_new  */
+     Word16 isf[],                         /* input :  decoded ISF at 4nd sfr                */
+     Word16 A[],                           /* output:  A(z) unquantized for the 4 subframes  */
+     Coder_State * st                      /* i/o   :  State structure                       */
+)
+{
+    Word16 wsp[L_FRAME];
+    Word16 Ap[M + 1];                      /* A(z) with spectral expansion         */
+    Word16 ispnew[M];                      /* immittance spectral pairs at 4nd sfr */
+    Word16 *p_A;                           /* ptr to A(z) for the 4 subframes      */
+    Word16 i, i_subfr, tmp, max, shift;
+
+    /* A(z) of the weighting filter from the decoded ISFs */
+
+    Isf_isp(isf, ispnew, M);
+    Int_isp(st->ispold, ispnew, interpol_frac, A);
+    Copy(ispnew, st->ispold, M);
+
+    /* scaling of the targets from the weighted speech (see coder()) */
+
+    p_A = A;                               move16();
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        Weight_a(p_A, Ap, GAMMA1, M);
+        Residu(Ap, M, &speech[i_subfr], &wsp[i_subfr], L_SUBFR);
+        p_A += (M + 1);                    move16();
+    }
+    Deemph2(wsp, TILT_FAC, L_FRAME, &(st->mem_wsp));
+
+    max = 0;                               move16();
+    for (i = 0; i < L_FRAME; i++)
+    {
+        tmp = abs_s(wsp[i]);
+        test();
+        if (sub(tmp, max) > 0)
+        {
+            max = tmp;                     move16();
+        }
+    }
+    tmp = st->old_wsp_max;                 move16();
+    test();
+    if (sub(max, tmp) > 0)
+    {
+        tmp = max;                         move16();
+    }
+    st->old_wsp_max = max;                 move16();
+
+    shift = sub(norm_s(tmp), 3);
+    test();
+    if (shift > 0)
+    {
+        shift = 0;                         move16();
+    }
+
+    return (shift);
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  scale_Q_new                                          *
+ *            ~~~~~~~~~~~                                          *
+ *   ->Scaling of the new frame (Q_new) from its maximum value     *
+ *     and the maximum of the 2 previous frames.                   *
+ *     Returns Q_new; exp is the rescaling of the past signals.    *
+ *-----------------------------------------------------------------*/
+
+static Word16 scale_Q_new(
+     Word16 max,                           /* input :  maximum of the new samples (x 0.5)    */
+     Word16 * exp,                         /* output:  Q_new - Q_old                         */
+     Coder_State * st                      /* i/o   :  State structure                       */
+)
+{
+    Word16 shift, Q_new;
+
+    test();
+    if (max == 0)
+    {
+        shift = Q_MAX;                     move16();
+    } else
+    {
+        shift = sub(norm_s(max), 1);
+        test();
+        if (shift < 0)
+        {
+            shift = 0;                     move16();
+        }
+        test();
+        if (sub(shift, Q_MAX) > 0)
+        {
+            shift = Q_MAX;                 move16();
+        }
+    }
+    Q_new = shift;                         move16();
+    test();
+    if (sub(Q_new, st->Q_max[0]) > 0)
+    {
+        Q_new = st->Q_max[0];              move16();
+    }
+    test();
+    if (sub(Q_new, st->Q_max[1]) > 0)
+    {
+        Q_new = st->Q_max[1];              move16();
+    }
+    *exp = sub(Q_new, st->Q_old);
+    st->Q_old = Q_new;                     move16();
+    st->Q_max[1] = st->Q_max[0];           move16();
+    st->Q_max[0] = shift;                  move16();
+
+    return (Q_new);
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  coder_acelp                                          *
+ *            ~~~~~~~~~~~                                          *
+ *   ->ACELP coding of a speech frame: ISF quantization and        *
+ *     closed-loop search of the 4 subframes.                      *
+ *     speech[] and exc[] are scaled by Q_new, A[] is the          *
+ *     unquantized A(z) of the 4 subframes and the pitch search    *
+ *     of the 1st and 3rd subframes is centered on T_op and T_op2. *
+ *-----------------------------------------------------------------*/
+
+static void coder_acelp(
+     Word16 mode,                          /* input :  used mode (not MRDTX)                 */
+     Word16 speech[],                      /* input :  speech of the frame (with past)       */
+     Word16 A[],                           /* input :  A(z) unquantized for the 4 subframes  */
+     Word16 isf[],                         /* i/o   :  ISF at 4nd sfr (quantized at output)  */
+     Word16 exc[],                         /* i/o   :  excitation of the frame (with past)   */
+     Word16 Q_new,                         /* input :  scaling of speech[] and exc[]         */
+     Word16 shift,                         /* input :  12 bits scaling of the targets        */
+     Word16 T_op,                          /* input :  open loop pitch lag of 1st half       */
+     Word16 T_op2,                         /* input :  open loop pitch lag of 2nd half       */
+     Word16 vad_flag,                      /* input :  VAD decision                          */
+     Word16 prms[],                        /* output:  output parameters (after VAD flag)    */
+     Word16 speech16k[],                   /* output:  16kHz synthesis (23.85k HF gain only) */
+     Coder_State * st                      /* i/o   :  State structure                       */
+)
+{
+    /* LPC coefficients */
+
+    Word16 Ap[M + 1];                      /* A(z) with spectral expansion         */
+    Word16 ispnew_q[M];                    /* quantized ISPs at 4nd subframe       */
+    Word16 *p_A, *p_Aq;                    /* ptr to A(z) for the 4 subframes      */
+    Word16 Aq[NB_SUBFR * (M + 1)];         /* A(z)   quantized for the 4 subframes */
+
+    /* Other vectors */
+
+    Word16 xn[L_SUBFR];                    /* Target vector for pitch search     */
+    Word16 xn2[L_SUBFR];                   /* Target vector for codebook search  */
+    Word16 dn[L_SUBFR];                    /* Correlation between xn2 and h1     */
+    Word16 cn[L_SUBFR];                    /* Target vector in residual domain   */
+
+    Word16 h1[L_SUBFR];                    /* Impulse response vector            */
+    Word16 h2[L_SUBFR];                    /* Impulse response vector            */
+    Word16 code[L_SUBFR];                  /* Fixed codebook excitation          */
+    Word16 y1[L_SUBFR];                    /* Filtered adaptive excitation       */
+    Word16 y2[L_SUBFR];                    /* Filtered adaptive excitation       */
+    Word16 error[M + L_SUBFR];             /* error of quantization              */
+    Word16 synth[L_SUBFR];                 /* 12.8kHz synthesis vector           */
+    Word16 exc2[L_FRAME];                  /* excitation vector                  */
+
+    /* Scalars */
+
+    Word16 i, j, i_subfr, select, pit_flag, clip_gain;
+    Word16 ser_size;
+    Word16 T0, T0_min, T0_max, T0_frac, index;
+    Word16 gain_pit, gain_code, g_coeff[4], g_coeff2[4];
+    Word16 tmp, gain1, gain2;
+    Word16 voice_fac;
+    Word16 indice[8];
+
+    Word32 L_tmp, L_gain_code;
+
+    Word16 code2[L_SUBFR];                 /* Fixed codebook excitation  */
+    Word16 stab_fac, fac, gain_code_lo;
+
+    Word16 corr_gain;
+    const Cb_mode *cb;
+
+    ser_size = nb_of_bits[mode];           move16();
+
+    /* codebook search and bit allocation of this mode, fixed for the whole frame */
+    cb = &cb_mode[mode];                   move16();
+
     /* Quantize and code the ISFs */
 
     test();
-    if (sub(*ser_size, NBBITS_7k) <= 0)
+    if (sub(ser_size, NBBITS_7k) <= 0)
     {
         Qpisf_2s_36b(isf, isf, st->past_isfq, indice, 4);
 
@@ -746,7 +1227,7 @@ void coder(
             L_tmp = L_mac(L_tmp, exc2[i], exc2[i]);
         L_tmp = L_shr(L_tmp, 1);
 
-        dtx_buffer(st->dtx_encSt, isf, L_tmp, codec_mode);
+        dtx_buffer(&(st->dtx_encSt), isf, L_tmp, mode);
     }
     /* range for closed loop pitch search in 1st subframe */
 
@@ -791,7 +1272,7 @@ void coder(
     {
         pit_flag = i_subfr;                move16();
         test();test();
-        if ((sub(i_subfr, 2 * L_SUBFR) == 0) && (sub(*ser_size, NBBITS_7k) > 0))
+        if ((sub(i_subfr, 2 * L_SUBFR) == 0) && (sub(ser_size, NBBITS_7k) > 0))
         {
             pit_flag = 0;                  move16();
 
@@ -894,7 +1375,7 @@ void coder(
         /* find closed loop fractional pitch  lag */
 
         test();
-        if (sub(*ser_size, NBBITS_9k) <= 0)
+        if (sub(ser_size, NBBITS_9k) <= 0)
         {
             T0 = Pitch_fr4(&exc[i_subfr], xn, h1, T0_min, T0_max, &T0_frac,
                 pit_flag, PIT_MIN, PIT_FR1_8b, L_SUBFR);
@@ -1014,7 +1495,7 @@ void coder(
          * Gain clipping test to avoid unstable synthesis on frame erasure *
          *-----------------------------------------------------------------*/
 
-        clip_gain = Gp_clip(*ser_size, st->gp_clip);
+        clip_gain = Gp_clip(ser_size, st->gp_clip);
 
         /*-----------------------------------------------------------------*
          * - find unity gain pitch excitation (adaptive codebook entry)    *
@@ -1027,7 +1508,7 @@ void coder(
 
         Pred_lt4(&exc[i_subfr], T0, T0_frac, L_SUBFR + 1);
         test();
-        if (sub(*ser_size, NBBITS_9k) > 0)
+        if (sub(ser_size, NBBITS_9k) > 0)
         {
             Convolve(&exc[i_subfr], h1, y1, L_SUBFR);
             gain1 = G_pitch(xn, y1, g_coeff, L_SUBFR);
@@ -1078,7 +1559,7 @@ void coder(
 
         select = 0;                        move16();
         test();
-        if (sub(*ser_size, NBBITS_9k) > 0)
+        if (sub(ser_size, NBBITS_9k) > 0)
         {
             L_tmp = 0L;                    move32();
             for (i = 0; i < L_SUBFR; i++)
@@ -1135,80 +1616,11 @@ void coder(
 
         cor_h_x(h2, xn2, dn);
 
-        test();test();test();test();test();test();test();
-        if (sub(*ser_size, NBBITS_7k) <= 0)
-        {
-            ACELP_2t64_fx(dn, cn, h2, code, y2, indice);
-
-            Parm_serial(indice[0], 12, &prms);
-        } else if (sub(*ser_size, NBBITS_9k) <= 0)
-        {
-            ACELP_4t64_fx(dn, cn, h2, code, y2, 20, *ser_size, indice);
-
-            Parm_serial(indice[0], 5, &prms);
-            Parm_serial(indice[1], 5, &prms);
-            Parm_serial(indice[2], 5, &prms);
-            Parm_serial(indice[3], 5, &prms);
-        } else if (sub(*ser_size, NBBITS_12k) <= 0)
-        {
-            ACELP_4t64_fx(dn, cn, h2, code, y2, 36, *ser_size, indice);
-
-            Parm_serial(indice[0], 9, &prms);
-            Parm_serial(indice[1], 9, &prms);
-            Parm_serial(indice[2], 9, &prms);
-            Parm_serial(indice[3], 9, &prms);
-        } else if (sub(*ser_size, NBBITS_14k) <= 0)
-        {
-            ACELP_4t64_fx(dn, cn, h2, code, y2, 44, *ser_size, indice);
-
-            Parm_serial(indice[0], 13, &prms);
-            Parm_serial(indice[1], 13, &prms);
-            Parm_serial(indice[2], 9, &prms);
-            Parm_serial(indice[3], 9, &prms);
-        } else if (sub(*ser_size, NBBITS_16k) <= 0)
-        {
-            ACELP_4t64_fx(dn, cn, h2, code, y2, 52, *ser_size, indice);
+        cb->search(dn, cn, h2, code, y2, indice, st->search_grp);
 
-            Parm_serial(indice[0], 13, &prms);
-            Parm_serial(indice[1], 13, &prms);
-            Parm_serial(indice[2], 13, &prms);
-            Parm_serial(indice[3], 13, &prms);
-        } else if (sub(*ser_size, NBBITS_18k) <= 0)
-        {
-            ACELP_4t64_fx(dn, cn, h2, code, y2, 64, *ser_size, indice);
-
-            Parm_serial(indice[0], 2, &prms);
-            Parm_serial(indice[1], 2, &prms);
-            Parm_serial(indice[2], 2, &prms);
-            Parm_serial(indice[3], 2, &prms);
-            Parm_serial(indice[4], 14, &prms);
-            Parm_serial(indice[5], 14, &prms);
-            Parm_serial(indice[6], 14, &prms);
-            Parm_serial(indice[7], 14, &prms);
-        } else if (sub(*ser_size, NBBITS_20k) <= 0)
+        for (i = 0; i < cb->nb_ind; i++)
         {
-            ACELP_4t64_fx(dn, cn, h2, code, y2, 72, *ser_size, indice);
-
-            Parm_serial(indice[0], 10, &prms);
-            Parm_serial(indice[1], 10, &prms);
-            Parm_serial(indice[2], 2, &prms);
-            Parm_serial(indice[3], 2, &prms);
-            Parm_serial(indice[4], 10, &prms);
-            Parm_serial(indice[5], 10, &prms);
-            Parm_serial(indice[6], 14, &prms);
-            Parm_serial(indice[7], 14, &prms);
-        } else
-        {
-            ACELP_4t64_fx(dn, cn, h2, code, y2, 88, *ser_size, indice);
-
-            Parm_serial(indice[0], 11, &prms);
-            Parm_serial(indice[1], 11, &prms);
-            Parm_serial(indice[2], 11, &prms);
-            Parm_serial(indice[3], 11, &prms);
-            Parm_serial(indice[4], 11, &prms);
-            Parm_serial(indice[5], 11, &prms);
-            Parm_serial(indice[6], 11, &prms);
-            Parm_serial(indice[7], 11, &prms);
+            Parm_serial(indice[i], cb->ind_bits[i], &prms);
         }
 
         /*-------------------------------------------------------*
@@ -1225,21 +1637,12 @@ void coder(
          *  - quantize fixed codebook gain                          *
          *----------------------------------------------------------*/
 
-        test();
-        if (sub(*ser_size, NBBITS_9k) <= 0)
-        {
-            index = Q_gain2(xn, y1, add(Q_new, shift), y2, code, g_coeff, L_SUBFR, 6,
-                &gain_pit, &L_gain_code, clip_gain, st->qua_gain);
-            Parm_serial(index, 6, &prms);
-        } else
-        {
-            index = Q_gain2(xn, y1, add(Q_new, shift), y2, code, g_coeff, L_SUBFR, 7,
-                &gain_pit, &L_gain_code, clip_gain, st->qua_gain);
-            Parm_serial(index, 7, &prms);
-        }
+        index = Q_gain2(xn, y1, add(Q_new, shift), y2, code, g_coeff, L_SUBFR, cb->gain_bits,
+            &gain_pit, &L_gain_code, clip_gain, st->qua_gain);
+        Parm_serial(index, cb->gain_bits, &prms);
 
         /* test quantized gain of pitch for pitch clipping algorithm */
-        Gp_clip_test_gain_pit(*ser_size, gain_pit, st->gp_clip);
+        Gp_clip_test_gain_pit(ser_size, gain_pit, st->gp_clip);
 
         L_tmp = L_shl(L_gain_code, Q_new); /* saturation can occur here */
         gain_code = round(L_tmp);          /* scaled gain_code with Qnew */
@@ -1276,7 +1679,7 @@ void coder(
         L_tmp = L_shl(L_tmp, sub(1, shift));
         st->mem_w0 = round(L_tmp);         move16();
 
-        if (sub(*ser_size, NBBITS_24k) >= 0)
+        if (sub(ser_size, NBBITS_24k) >= 0)
             Copy(&exc[i_subfr], exc2, L_SUBFR);
 
         for (i = 0; i < L_SUBFR; i++)
@@ -1291,7 +1694,7 @@ void coder(
 
         Syn_filt(p_Aq, M, &exc[i_subfr], synth, L_SUBFR, st->mem_syn, 1);
 
-        if (sub(*ser_size, NBBITS_24k) >= 0)
+        if (sub(ser_size, NBBITS_24k) >= 0)
         {
             /*------------------------------------------------------------*
              * phase dispersion to enhance noise in low bit rate          *
@@ -1386,18 +1789,10 @@ void coder(
 
     }                                      /* end of subframe loop */
 
-    /*--------------------------------------------------*
-     * Update signal for next frame.                    *
-     * -> save past of speech[], wsp[] and exc[].       *
-     *--------------------------------------------------*/
-
-    Copy(&old_speech[L_FRAME], st->old_speech, L_TOTAL - L_FRAME);
-    Copy(&old_wsp[L_FRAME / OPL_DECIM], st->old_wsp, PIT_MAX / OPL_DECIM);
-    Copy(&old_exc[L_FRAME], st->old_exc, PIT_MAX + L_INTERPOL);
-
     return;
 }
 
+
 /*-----------------------------------------------------*
  * Function synthesis()                                *
  *                                                     *
@@ -1590,12 +1985,12 @@ static Word16 synthesis(
     L_tmp = L_shl(L_tmp, exp);             /* L_tmp, L_tmp in Q31 */
     HP_calc_gain = extract_h(L_tmp);       /* tmp = sqrt(ener_input/ener_hf) */
 
-    /* st->gain_alpha *= st->dtx_encSt->dtxHangoverCount/7 */
-    L_tmp = L_shl(L_mult(st->dtx_encSt->dtxHangoverCount, 4681), 15);
+    /* st->gain_alpha *= st->dtx_encSt.dtxHangoverCount/7 */
+    L_tmp = L_shl(L_mult(st->dtx_encSt.dtxHangoverCount, 4681), 15);
     st->gain_alpha = mult(st->gain_alpha, extract_h(L_tmp));
 
     test();
-    if (sub(st->dtx_encSt->dtxHangoverCount, 6) > 0)
+    if (sub(st->dtx_encSt.dtxHangoverCount, 6) > 0)
         st->gain_alpha = 32767;
     HP_est_gain = shr(HP_est_gain, 1);     /* From Q15 to Q14 */
     HP_corr_gain = add(mult(HP_calc_gain, st->gain_alpha), mult(sub(32767, st->gain_alpha), HP_est_gain));
@@ -9,30 +9,36 @@
 #include "wb_vad.h"
 #include "dtx.h"
 
+/*--------------------------------------------------------------------------*
+ * The fields are grouped by the part of coder() that uses them, in the     *
+ * order of processing, so that a frame reads the state sequentially and    *
+ * does not load the cache lines of the parts it does not run: the 23.85k   *
+ * HF gain estimator and the DTX history are at the end. The VAD and DTX    *
+ * states are part of the structure: one memory block per channel.          *
+ *--------------------------------------------------------------------------*/
+
 typedef struct
 {
+    /* pre-processing, LP analysis: every frame */
     Word16 mem_decim[2 * L_FILT16k];       /* speech decimated filter memory */
     Word16 mem_sig_in[6];                  /* hp50 filter memory */
     Word16 mem_preemph;                    /* speech preemph filter memory */
+    Word16 first_frame;
     Word16 old_speech[L_TOTAL - L_FRAME];  /* old speech vector at 12.8kHz */
-    Word16 old_wsp[PIT_MAX / OPL_DECIM];   /* old decimated weighted speech vector */
-    Word16 old_exc[PIT_MAX + L_INTERPOL];  /* old excitation vector */
     Word16 mem_levinson[M + 2];            /* levinson routine memory */
-    Word16 ispold[M];                      /* old isp (immittance spectral pairs) */
-    Word16 ispold_q[M];                    /* quantized old isp */
-    Word16 past_isfq[M];                   /* past isf quantizer */
+    Word16 Q_old;                          /* old scaling factor */
+    Word16 Q_max[2];                       /* old maximum scaling factor */
+    Word16 vad_hist;
+    struct Rate_State *rate;               /* mode of each frame for a target bit rate, NULL: given */
+    Word16 dtx_skip;                       /* DTX_SKIP_xxx: work left out in the next DTX frame */
+    VadVars vadSt;                         /* VAD state */
+
+    /* weighted speech, open-loop pitch: every frame */
     Word16 mem_wsp;                        /* wsp vector memory */
     Word16 mem_decim2[3];                  /* wsp decimation filter memory */
-    Word16 mem_w0;                         /* target vector memory */
-    Word16 mem_syn[M];                     /* synthesis memory */
-    Word16 tilt_code;                      /* tilt of code */
+    Word16 old_wsp[PIT_MAX / OPL_DECIM];   /* old decimated weighted speech vector */
     Word16 old_wsp_max;                    /* old wsp maximum value */
     Word16 old_wsp_shift;                  /* old wsp shift */
-    Word16 Q_old;                          /* old scaling factor */
-    Word16 Q_max[2];                       /* old maximum scaling factor */
-    Word16 gp_clip[2];                     /* gain of pitch clipping memory */
-    Word16 qua_gain[4];                    /* gain quantizer memory */
-
     Word16 old_T0_med;
     Word16 ol_gain;
     Word16 ada_w;
@@ -40,24 +46,58 @@ typedef struct
     Word16 old_ol_lag[5];
     Word16 hp_wsp_mem[9];
     Word16 old_hp_wsp[L_FRAME / OPL_DECIM + (PIT_MAX / OPL_DECIM)];
-    VadVars *vadSt;
-    dtx_encState *dtx_encSt;
-    Word16 first_frame;
 
+    /* ISF quantization, subframe loop: speech frames */
+    Word16 ispold[M];                      /* old isp (immittance spectral pairs) */
+    Word16 ispold_q[M];                    /* quantized old isp */
+    Word16 past_isfq[M];                   /* past isf quantizer */
     Word16 isfold[M];                      /* old isf (frequency domain) */
+    Word16 old_exc[PIT_MAX + L_INTERPOL];  /* old excitation vector */
+    Word16 mem_syn[M];                     /* synthesis memory */
+    Word16 mem_w0;                         /* target vector memory */
+    Word16 tilt_code;                      /* tilt of code */
+    Word16 gp_clip[2];                     /* gain of pitch clipping memory */
+    Word16 qua_gain[4];                    /* gain quantizer memory */
+    struct Task_Group *search_grp;         /* codebook search iterations together, NULL: in turn */
+
+    /* HF gain estimator (synthesis()): 23.85k and DTX frames only */
     Word32 L_gc_thres;                     /* threshold for noise enhancer */
     Word16 mem_syn_hi[M];                  /* modified synthesis memory (MSB) */
     Word16 mem_syn_lo[M];                  /* modified synthesis memory (LSB) */
     Word16 mem_deemph;                     /* speech deemph filter memory */
+    Word16 seed2;                          /* random memory for HF generation */
     Word16 mem_sig_out[6];                 /* hp50 filter memory for synthesis */
     Word16 mem_hp400[6];                   /* hp400 filter memory for synthesis */
-    Word16 mem_oversamp[2 * L_FILT];       /* synthesis oversampled filter memory */
     Word16 mem_syn_hf[M];                  /* HF synthesis memory */
     Word16 mem_hf[2 * L_FILT16k];          /* HF band-pass filter memory */
     Word16 mem_hf2[2 * L_FILT16k];         /* HF band-pass filter memory */
-    Word16 seed2;                          /* random memory for HF generation */
-    Word16 vad_hist;
-
     Word16 gain_alpha;
 
+    /* DTX: history of the ISF and energy (allow_dtx only) */
+    dtx_encState dtx_encSt;
+
 } Coder_State;
+
+/*--------------------------------------------------------------------------*
+ * coder() runs in two stages: coder_front() (pre-processing, VAD, LP       *
+ * analysis, open-loop pitch) and coder_back() (DTX or ISF quantization and *
+ * subframe loop). Cod_Frame is what the first stage passes to the second.  *
+ *--------------------------------------------------------------------------*/
+
+typedef struct
+{
+    Word16 mode;                           /* used mode (MRDTX if DTX)           */
+    Word16 codec_mode;                     /* mode asked by the application      */
+    Word16 ser_size;                       /* bit rate of the used mode          */
+    Word16 vad_flag;
+    Word16 old_speech[L_TOTAL];            /* speech at 12.8kHz with its past    */
+    Word16 A[NB_SUBFR * (M + 1)];          /* A(z) unquantized, 4 subframes      */
+    Word16 isf[M];                         /* ISF at 4th subframe                */
+    Word16 Q_new;                          /* scaling of the speech              */
+    Word16 exp;                            /* rescaling of the past excitation   */
+    Word16 shift;                          /* scaling of the weighted speech     */
+    Word16 T_op, T_op2;                    /* open-loop pitch lags               */
+} Cod_Frame;
+
+void coder_front(Word16 * mode, Word16 speech16k[], Word16 allow_dtx, Cod_Frame * f, Coder_State * st);
+void coder_back(Cod_Frame * f, Word16 speech16k[], Word16 prms[], Coder_State * st);
@@ -0,0 +1,306 @@
+/*------------------------------------------------------------------------*
+ *                         COD_PIPE.C                                     *
+ *------------------------------------------------------------------------*
+ * Pipelined encoder: one stream on two threads                           *
+ *                                                                        *
+ * coder() is split in coder_front() (pre-processing, VAD, LP analysis,   *
+ * open-loop pitch) and coder_back() (ISF quantization and subframe loop, *
+ * or comfort noise). The front stage of frame n+1 does not depend on the *
+ * back stage of frame n, so the calling thread runs the front stage of   *
+ * the new frame while a second thread runs the back stage of the frame   *
+ * before: the output is one frame late and the time per frame is that   *
+ * of the longer stage instead of the sum of the two.                     *
+ *                                                                        *
+ * Each stage has its own copy of the state (Coder_State). The two copies *
+ * are disjoint in what they use, except three values written by the      *
+ * front stage and read by the back stage, passed with the frame:         *
+ *   - gp_clip[0] (ISF distance of the pitch gain clipping)               *
+ *   - vad_hist and the DTX hangover count (HF gain of synthesis())       *
+ * and the resets: the comfort noise reset and the homing reset are done  *
+ * on both copies, at the same point of the stream.                       *
+ *                                                                        *
+ * The output is bit-exact with coder(). The DTX frames are always fully  *
+ * processed (DTX_SKIP_NONE): the frame written when a frame is encoded   *
+ * is not known before.                                                   *
+ *------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) && (WMOPS == 0)
+#define POSIX_PIPE                         /* else (or with the counters): one thread */
+#include <pthread.h>
+#endif
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "acelp.h"
+#include "cnst.h"
+#include "main.h"
+#include "bits.h"
+#include "count.h"
+#include "cod_main.h"
+
+typedef struct
+{
+    Cod_Frame f;                           /* front stage output                  */
+    Word16 speech16k[L_FRAME16k];          /* input frame (HF gain of 23.85k)     */
+    Word16 gp_clip0;                       /* front stage state read by the back  */
+    Word16 vad_hist;
+    Word16 dtx_hangover;
+    Word16 reset;                          /* homing frame: reset after the frame */
+    Word16 prms[NB_BITS_MAX];              /* back stage output                   */
+    Word16 ser_size;
+} Pipe_Slot;
+
+typedef struct
+{
+    Coder_State *front;                    /* state of the calling thread         */
+    Coder_State *back;                     /* state of the back stage             */
+    Pipe_Slot slot[2];                     /* frames n and n-1                    */
+    Word16 next;                           /* slot of the next frame              */
+    Word16 busy;                           /* a frame is in the back stage        */
+#ifdef POSIX_PIPE
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    Word16 todo;                           /* slot given to the thread, -1: none  */
+    Word16 quit;
+#endif
+} Pipe_State;
+
+static void Back_stage(Pipe_State * st, Pipe_Slot * s)
+{
+    st->back->gp_clip[0] = s->gp_clip0;
+    st->back->vad_hist = s->vad_hist;
+    st->back->dtx_encSt.dtxHangoverCount = s->dtx_hangover;
+
+    coder_back(&(s->f), s->speech16k, s->prms, st->back);
+    s->ser_size = s->f.ser_size;
+
+    if (s->reset != 0)
+    {
+        Reset_encoder(st->back, 1);
+    }
+
+    return;
+}
+
+#ifdef POSIX_PIPE
+static void *Back_thread(void *arg)
+{
+    Pipe_State *st = (Pipe_State *) arg;
+    Word16 s;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&(st->lock));
+        while ((st->todo < 0) && (st->quit == 0))
+        {
+            pthread_cond_wait(&(st->cond), &(st->lock));
+        }
+        s = st->todo;
+        pthread_mutex_unlock(&(st->lock));
+
+        if (s < 0)
+        {
+            break;
+        }
+        Back_stage(st, &(st->slot[s]));
+
+        pthread_mutex_lock(&(st->lock));
+        st->todo = -1;
+        pthread_cond_broadcast(&(st->cond));
+        pthread_mutex_unlock(&(st->lock));
+    }
+
+    return NULL;
+}
+#endif
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_coder_pipe                                      *
+ *            ~~~~~~~~~~~~~~~                                      *
+ *   ->Two encoder states and the thread of the back stage.        *
+ *-----------------------------------------------------------------*/
+
+void Init_coder_pipe(void **spe_state)
+{
+    Pipe_State *st;
+    void *front, *back;
+
+    *spe_state = NULL;
+
+    if ((st = (Pipe_State *) malloc(sizeof(Pipe_State))) == NULL)
+    {
+        printf("Can not malloc Pipe_State structure!\n");
+        return;
+    }
+    Init_coder(&front);
+    Init_coder(&back);
+    if ((front == NULL) || (back == NULL))
+    {
+        if (front != NULL)
+            Close_coder(front);
+        if (back != NULL)
+            Close_coder(back);
+        free(st);
+        return;
+    }
+    st->front = (Coder_State *) front;
+    st->back = (Coder_State *) back;
+    st->next = 0;
+    st->busy = 0;
+
+#ifdef POSIX_PIPE
+    st->todo = -1;
+    st->quit = 0;
+    pthread_mutex_init(&(st->lock), NULL);
+    pthread_cond_init(&(st->cond), NULL);
+    if (pthread_create(&(st->thread), NULL, Back_thread, st) != 0)
+    {
+        printf("Can not create the encoder thread!\n");
+        pthread_cond_destroy(&(st->cond));
+        pthread_mutex_destroy(&(st->lock));
+        Close_coder(front);
+        Close_coder(back);
+        free(st);
+        return;
+    }
+#endif
+    *spe_state = (void *) st;
+
+    return;
+}
+
+void Close_coder_pipe(void *spe_state)
+{
+    Pipe_State *st = (Pipe_State *) spe_state;
+
+#ifdef POSIX_PIPE
+    pthread_mutex_lock(&(st->lock));
+    while (st->todo >= 0)
+    {
+        pthread_cond_wait(&(st->cond), &(st->lock));
+    }
+    st->quit = 1;
+    pthread_cond_broadcast(&(st->cond));
+    pthread_mutex_unlock(&(st->lock));
+    pthread_join(st->thread, NULL);
+    pthread_cond_destroy(&(st->cond));
+    pthread_mutex_destroy(&(st->lock));
+#endif
+    Close_coder(st->front);
+    Close_coder(st->back);
+    free(st);
+
+    return;
+}
+
+/* task group of the codebook search: used by the back stage only */
+void Set_coder_pipe_search(void *spe_state, void *grp)
+{
+    Set_encoder_search(((Pipe_State *) spe_state)->back, grp);
+
+    return;
+}
+
+/* rate controller: the mode is chosen by the front stage */
+void Set_coder_pipe_rate(void *spe_state, void *rate)
+{
+    Set_encoder_rate(((Pipe_State *) spe_state)->front, rate);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  coder_pipe                                           *
+ *            ~~~~~~~~~~                                           *
+ *   ->Encodes a frame with a delay of one frame: the front stage  *
+ *     of speech16k runs, then the output of the frame before is   *
+ *     returned and its back stage is started. speech16k = NULL    *
+ *     flushes the last frame.                                     *
+ *                                                                 *
+ *   Return 1 if prms, *mode and *ser_size hold a frame, else 0    *
+ *   (first frame, or flush of an empty pipe).                     *
+ *-----------------------------------------------------------------*/
+
+Word16 coder_pipe(
+     Word16 * mode,                        /* i/o   :  mode of the new frame / used mode of the output */
+     Word16 speech16k[],                   /* input :  320 new speech samples, NULL: flush             */
+     Word16 prms[],                        /* output:  output parameters                               */
+     Word16 * ser_size,                    /* output:  bit rate of the used mode                       */
+     void *spe_state,                      /* i/o   :  State structure                                 */
+     Word16 allow_dtx,                     /* input :  DTX ON/OFF                                      */
+     Word16 reset                          /* input :  homing frame: reset after it                    */
+)
+{
+    Pipe_State *st = (Pipe_State *) spe_state;
+    Pipe_Slot *s, *prev;
+    Word16 i, out;
+
+    s = &(st->slot[st->next]);
+    prev = &(st->slot[1 - st->next]);
+
+    /* front stage of the new frame, while the frame before is in the back stage */
+    if (speech16k != NULL)
+    {
+        Copy(speech16k, s->speech16k, L_FRAME16k);
+        s->f.mode = *mode;
+        coder_front(&(s->f.mode), s->speech16k, allow_dtx, &(s->f), st->front);
+
+        s->gp_clip0 = st->front->gp_clip[0];
+        s->vad_hist = st->front->vad_hist;
+        s->dtx_hangover = st->front->dtx_encSt.dtxHangoverCount;
+        s->reset = reset;
+
+        /* the resets done by coder() and the caller after the frame */
+        if (sub(s->f.mode, MRDTX) == 0)
+        {
+            Reset_encoder(st->front, 0);
+        }
+        if (reset != 0)
+        {
+            Reset_encoder(st->front, 1);
+        }
+    }
+
+    /* output of the frame before */
+    out = 0;
+    if (st->busy != 0)
+    {
+#ifdef POSIX_PIPE
+        pthread_mutex_lock(&(st->lock));
+        while (st->todo >= 0)
+        {
+            pthread_cond_wait(&(st->cond), &(st->lock));
+        }
+        pthread_mutex_unlock(&(st->lock));
+#endif
+        *mode = prev->f.mode;
+        *ser_size = prev->ser_size;
+        for (i = 0; i < prev->ser_size; i++)
+        {
+            prms[i] = prev->prms[i];
+        }
+        st->busy = 0;
+        out = 1;
+    }
+
+    /* back stage of the new frame */
+    if (speech16k != NULL)
+    {
+#ifdef POSIX_PIPE
+        pthread_mutex_lock(&(st->lock));
+        st->todo = st->next;
+        pthread_cond_broadcast(&(st->cond));
+        pthread_mutex_unlock(&(st->lock));
+#else
+        Back_stage(st, s);
+#endif
+        st->busy = 1;
+        st->next = (Word16) (1 - st->next);
+    }
+
+    return out;
+}
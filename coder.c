@@ -17,16 +17,30 @@
 #include "bits.h"
 #include "count.h"
 #include "cod_main.h"
+#include "pcm_io.h"
+#include "rtp_pl.h"
+#include "taskgrp.h"
+#include "cpu_disp.h"
+#include "ratectl.h"
+#include "runstat.h"
 
 /*-----------------------------------------------------------------*
  * CODER.C                                                         *
  * ~~~~~~~~~~                                                      *
  * Main program of the AMR WB ACELP wideband coder.                *
  *                                                                 *
- *    Usage : coder (-dtx) (-itu | -mime) mode speech_file  bitstream_file *
+ *    Usage : coder (-dtx) (-float | -pipe) (-j n) (-cpu level)    *
+ *                  (-itu | -mime | -rtp | -rtpoa)                 *
+ *                  (-fpp n) (-ill L) (-cmr n) (-alaw | -ulaw)     *
+ *                  (-wav)                                         *
+ *                  mode speech_file  bitstream_file               *
+ *                                                                 *
+ *    mode: 0..8, -modefile file or -rate kbps[:frames]            *
  *                                                                 *
  *    Format for speech_file:                                      *
  *      Speech is read from a binary file of 16 bits data.         *
+ *      -alaw / -ulaw: 8 bits G.711 A-law / mu-law data.           *
+ *      -wav: RIFF/WAVE file (16 bits, A-law or mu-law, 16 kHz).   *
  *                                                                 *
  *    Format for bitstream_file (default):                         *
  *																   *
@@ -48,9 +62,29 @@
  *    if option -mime defined:                         		       *
  *        AMR-WB MIME/storage format, see RFC 3267 (sections 5.1 and 5.3) for details *
  *                                                                 *
+ *    if option -rtp or -rtpoa defined:                            *
+ *        AMR-WB RTP payloads, see RFC 4867 (bandwidth-efficient   *
+ *        or octet-aligned mode), each one preceded by 1 word      *
+ *        (2-byte, big endian) for the payload size                *
+ *        -fpp n: n frames per packet                              *
+ *        -ill L: interleaving, groups of L+1 packets (-rtpoa)     *
+ *        -cmr n: codec mode request n (0..8) in each packet       *
+ *                (default 15: no mode request)                    *
+ *                                                                 *
  *    mode = 0..8 (bit rate = 6.60 to 23.85 k)                     *
+ *    -modefile file: mode of each frame read from file            *
+ *    -rate kbps[:frames]: mode of each frame chosen by the        *
+ *            encoder for an average of kbps (6.60 to 23.85)       *
+ *            over a window of frames (default 50, ratectl.c)      *
  *                                                                 *
  *    -dtx if DTX is ON                                            *
+ *    -float: use the floating-point encoder (cod_flt.c)           *
+ *    -pipe: pipelined encoder on two threads (cod_pipe.c)         *
+ *    -j n: n threads for the codebook search iterations           *
+ *    -cpu level: kernels of level ref, c, sse4.1, avx2, avx512bw  *
+ *            or auto (cpu_disp.c), listed on stderr               *
+ *    -stats file: frame times, real-time factor, frame types and  *
+ *            VAD activity written to file as JSON (runstat.c)     *
  *-----------------------------------------------------------------*/
 
 
@@ -65,11 +99,23 @@ int main(int argc, char *argv[])
 
     Word16 coding_mode = 0, nb_bits, allow_dtx, mode_file, mode = 0, i;
     Word16 bitstreamformat;
+    Word16 pcm_format, pcm_wav;
+    Word16 rtp_fpp, rtp_ill, rtp_cmr;
     Word16 reset_flag;
+    Word16 flt_engine, dtx_skip;
+    Word16 pipe, pipe_mode, pipe_out, out_mode = 0;
+    Word16 search_threads, cpu_report;
+    Word16 rate_win;
+    double rate_kbps;
     long frame;
 
     void *st;
     TX_State *tx_state;
+    PCM_State *pcm_state;
+    Task_Group *search_grp = NULL;
+    Rate_State *rate_ctl = NULL;
+    Run_State *run_st;
+    FILE *f_stats = NULL;                  /* File of the run statistics (JSON)     */
 
     fprintf(stderr, "\n");
 	fprintf(stderr, " ==================================================================================================\n");
@@ -81,12 +127,14 @@ int main(int argc, char *argv[])
      * Open speech file and result file (output serial bit stream)             *
      *-------------------------------------------------------------------------*/
 
-    if ((argc < 4) || (argc > 6))
+    if ((argc < 4) || (argc > 22))
     {
-        fprintf(stderr, "Usage : coder  (-dtx) (-itu | -mime) mode speech_file  bitstream_file\n");
+        fprintf(stderr, "Usage : coder  (-dtx) (-float | -pipe) (-j n) (-cpu level) (-stats file) (-itu | -mime | -rtp | -rtpoa) (-fpp n) (-ill L) (-cmr n) (-alaw | -ulaw) (-wav) mode speech_file  bitstream_file\n");
         fprintf(stderr, "\n");
         fprintf(stderr, "Format for speech_file:\n");
         fprintf(stderr, "  Speech is read form a binary file of 16 bits data.\n");
+        fprintf(stderr, "  if option -alaw or -ulaw defined: 8 bits G.711 A-law or mu-law data.\n");
+        fprintf(stderr, "  if option -wav defined: RIFF/WAVE file, mono 16 kHz, 16 bits PCM, A-law or mu-law.\n");
         fprintf(stderr, "\n");
         fprintf(stderr, "Format for bitstream_file (default):\n");
         fprintf(stderr, "  One word (2-byte) to indicate type of frame type.\n");
@@ -102,14 +150,28 @@ int main(int argc, char *argv[])
         fprintf(stderr, "  if option -mime defined:\n");
 		fprintf(stderr, "  AMR-WB MIME/storage format, see RFC 3267 (sections 5.1 and 5.3) for details.\n");
         fprintf(stderr, "\n");
+        fprintf(stderr, "  if option -rtp or -rtpoa defined:\n");
+		fprintf(stderr, "  AMR-WB RTP payloads, see RFC 4867 (bandwidth-efficient or octet-aligned mode).\n");
+		fprintf(stderr, "  One word (2-byte, big endian) for payload size, then the payload, per packet.\n");
+		fprintf(stderr, "  -fpp n: n frames per packet (default 1)\n");
+		fprintf(stderr, "  -ill L: interleaving with groups of L+1 packets (octet-aligned only)\n");
+		fprintf(stderr, "  -cmr n: codec mode request n (0 to 8) in each packet (default 15: none)\n");
+        fprintf(stderr, "\n");
         fprintf(stderr, "mode: 0 to 8 (9 bits rates) or\n");
-        fprintf(stderr, "      -modefile filename\n");
+        fprintf(stderr, "      -modefile filename or\n");
+        fprintf(stderr, "      -rate kbps[:frames] (mode of each frame chosen for an average of kbps\n");
+        fprintf(stderr, "       over a window of frames, default %d)\n", RATE_WIN_DEF);
         fprintf(stderr, " ===================================================================\n");
         fprintf(stderr, " mode   :  (0)  (1)   (2)   (3)   (4)   (5)   (6)   (7)   (8)     \n");
         fprintf(stderr, " bitrate: 6.60 8.85 12.65 14.25 15.85 18.25 19.85 23.05 23.85 kbit/s\n");
         fprintf(stderr, " ===================================================================\n");
         fprintf(stderr, "\n");
         fprintf(stderr, "-dtx if DTX is ON, default is OFF\n");
+        fprintf(stderr, "-float: floating-point encoder (same bitstream, not bit-exact)\n");
+        fprintf(stderr, "-pipe: pipelined encoder, analysis and subframe search on two threads\n");
+        fprintf(stderr, "-j n: iterations of the codebook search on n threads (same bitstream)\n");
+        fprintf(stderr, "-cpu level: kernels of level ref, c, sse4.1, avx2, avx512bw or auto (same bitstream)\n");
+        fprintf(stderr, "-stats file: frame times (p50/p99/max), real-time factor, frame types and VAD activity, as JSON\n");
         fprintf(stderr, "\n");
         exit(0);
     }
@@ -121,6 +183,53 @@ int main(int argc, char *argv[])
         argv++;
     }
 
+    flt_engine = 0;
+    if (strcmp(argv[1], "-float") == 0)
+    {
+        flt_engine = 1;
+        argv++;
+        fprintf(stderr, "Floating-point encoder\n");
+    }
+
+    pipe = 0;
+    if ((flt_engine == 0) && (strcmp(argv[1], "-pipe") == 0))
+    {
+        pipe = 1;
+        argv++;
+        fprintf(stderr, "Pipelined encoder\n");
+    }
+
+    search_threads = 1;
+    if ((flt_engine == 0) && (strcmp(argv[1], "-j") == 0))
+    {
+        search_threads = (Word16)atoi(argv[2]);
+        argv += 2;
+        fprintf(stderr, "Codebook search on %d threads\n", search_threads);
+    }
+
+    cpu_report = 0;
+    if (strcmp(argv[1], "-cpu") == 0)
+    {
+        if (Disp_force(argv[2]) != 0)
+        {
+            fprintf(stderr, "Kernels %s: unknown level or not supported by the CPU\n", argv[2]);
+            exit(0);
+        }
+        cpu_report = 1;
+        argv += 2;
+    }
+
+    if (strcmp(argv[1], "-stats") == 0)
+    {
+        if ((f_stats = fopen(argv[2], "w")) == NULL)
+        {
+            fprintf(stderr, "Error opening statistics file  %s !!\n", argv[2]);
+            exit(0);
+        }
+        fprintf(stderr, "Run statistics file:  %s\n", argv[2]);
+        argv += 2;
+    }
+
 	bitstreamformat = 0;
     if (strcmp(argv[1], "-itu") == 0)
 	{
@@ -134,12 +243,61 @@ int main(int argc, char *argv[])
 			bitstreamformat = 2;
 			argv++;
 			fprintf(stderr, "Input bitstream format: MIME\n");
+		} else if (strcmp(argv[1], "-rtp") == 0)
+		{
+			bitstreamformat = 3;
+			argv++;
+			fprintf(stderr, "Input bitstream format: RTP payload (bandwidth-efficient)\n");
+		} else if (strcmp(argv[1], "-rtpoa") == 0)
+		{
+			bitstreamformat = 4;
+			argv++;
+			fprintf(stderr, "Input bitstream format: RTP payload (octet-aligned)\n");
 		} else
 		{
 			fprintf(stderr, "Input bitstream format: Default\n");
 		}
     }
 
+    rtp_fpp = 1;
+    if (strcmp(argv[1], "-fpp") == 0)
+    {
+        rtp_fpp = (Word16)atoi(argv[2]);
+        argv += 2;
+    }
+
+    rtp_ill = 0;
+    if (strcmp(argv[1], "-ill") == 0)
+    {
+        rtp_ill = (Word16)atoi(argv[2]);
+        argv += 2;
+    }
+
+    rtp_cmr = RTP_NO_CMR;
+    if (strcmp(argv[1], "-cmr") == 0)
+    {
+        rtp_cmr = (Word16)atoi(argv[2]);
+        argv += 2;
+    }
+
+    pcm_format = PCM_LINEAR;
+    if (strcmp(argv[1], "-alaw") == 0)
+    {
+        pcm_format = PCM_ALAW;
+        argv++;
+    } else if (strcmp(argv[1], "-ulaw") == 0)
+    {
+        pcm_format = PCM_ULAW;
+        argv++;
+    }
+
+    pcm_wav = 0;
+    if (strcmp(argv[1], "-wav") == 0)
+    {
+        pcm_wav = 1;
+        argv++;
+    }
+
     mode_file = 0;
     if (strcmp(argv[1], "-modefile") == 0)
     {
@@ -151,6 +309,26 @@ int main(int argc, char *argv[])
             exit(0);
         }
         fprintf(stderr, "Mode file:  %s\n", argv[1]);
+    } else if (strcmp(argv[1], "-rate") == 0)
+    {
+        argv++;
+        rate_win = RATE_WIN_DEF;
+        if ((sscanf(argv[1], "%lf:%hd", &rate_kbps, &rate_win) < 1) || (rate_kbps < nb_of_bits[MODE_7k] / 20.0) || (rate_kbps > 23.85))
+        {
+            fprintf(stderr, " error in bit rate %s: use 6.60 to 23.85 kbit/s\n", argv[1]);
+            exit(0);
+        }
+        if (flt_engine)
+        {
+            fprintf(stderr, " -rate: fixed-point encoder only\n");
+            exit(0);
+        }
+        if (Init_ratectl(&rate_ctl, (Word16) (rate_kbps * 20.0 + 0.5), rate_win) != 0)
+        {
+            exit(0);
+        }
+        mode = rate_ctl->mode;
+        fprintf(stderr, "Rate control: %.2f kbit/s over %d frames\n", rate_kbps, rate_win);
     } else
     {
         mode = (Word16)atoi(argv[1]);
@@ -168,6 +346,19 @@ int main(int argc, char *argv[])
         exit(0);
     }
     fprintf(stderr, "Input speech file:  %s\n", argv[2]);
+    Blk_buffer(f_speech);
+
+    if (Init_read_pcm(&pcm_state, f_speech, pcm_format, pcm_wav) != 0)
+    {
+        fprintf(stderr, "Error reading input file  %s !!\n", argv[2]);
+        exit(0);
+    }
+    if (pcm_state->format == PCM_ALAW)
+        fprintf(stderr, "Input speech format: G.711 A-law%s\n", pcm_wav ? " (WAV)" : "");
+    else if (pcm_state->format == PCM_ULAW)
+        fprintf(stderr, "Input speech format: G.711 mu-law%s\n", pcm_wav ? " (WAV)" : "");
+    else if (pcm_wav)
+        fprintf(stderr, "Input speech format: 16 bits PCM (WAV)\n");
 
     if ((f_serial = fopen(argv[3], "wb")) == NULL)
     {
@@ -175,13 +366,60 @@ int main(int argc, char *argv[])
         exit(0);
     }
     fprintf(stderr, "Output bitstream file:  %s\n", argv[3]);
+    Blk_buffer(f_serial);
 
     /*-------------------------------------------------------------------------*
      * Initialisation                                                          *
      *-------------------------------------------------------------------------*/
 
-    Init_coder(&st);                       /* Initialize the coder */
+    if (flt_engine)
+        Init_coder_flt(&st);               /* Initialize the floating-point coder */
+    else if (pipe)
+        Init_coder_pipe(&st);              /* Initialize the pipelined coder */
+    else
+        Init_coder(&st);                   /* Initialize the coder */
+    if (st == NULL)
+    {
+        exit(0);
+    }
+    if (search_threads > 1)
+    {
+        if (Init_taskgrp(&search_grp, search_threads) != 0)
+        {
+            exit(0);
+        }
+        if (pipe)
+            Set_coder_pipe_search(st, search_grp);
+        else
+            Set_encoder_search(st, search_grp);
+    }
+    if (rate_ctl != NULL)
+    {
+        if (pipe)
+            Set_coder_pipe_rate(st, rate_ctl);
+        else
+            Set_encoder_rate(st, rate_ctl);
+    }
+    if (cpu_report)
+    {
+        Disp_report(stderr);
+    }
     Init_write_serial(&tx_state);
+    if (bitstreamformat >= 3)
+    {
+        if (Init_rtp(&tx_state->rtp, (Word16) (bitstreamformat == 4), rtp_fpp, rtp_ill) != 0)
+        {
+            exit(0);
+        }
+        if (Set_rtp_cmr(tx_state->rtp, rtp_cmr) != 0)
+        {
+            exit(0);
+        }
+    }
+    if (Init_runstat(&run_st, "coder", (Word16) (f_stats != NULL)) != 0)
+    {
+        exit(0);
+    }
     Init_WMOPS_counter();                  /* for complexity calculation */
 
     /*---------------------------------------------------------------------------*
@@ -202,7 +440,7 @@ int main(int argc, char *argv[])
 
     frame = 0;
 
-    while (fread(signal, sizeof(Word16), L_FRAME16k, f_speech) == L_FRAME16k)
+    while (Read_pcm(f_speech, signal, L_FRAME16k, pcm_state) == L_FRAME16k)
     {
         Reset_WMOPS_counter();
 
@@ -225,7 +463,7 @@ int main(int argc, char *argv[])
         coding_mode = mode;
 
         frame++;
-        fprintf(stderr, " Frames processed: %hd\r", frame);
+        Run_progress(stderr, run_st, "Frames processed", frame, 0);
 
         /* check for homing frame */
         reset_flag = encoder_homing_frame_test(signal);
@@ -235,22 +473,113 @@ int main(int argc, char *argv[])
             signal[i] = (Word16) (signal[i] & 0xfffC);      logic16(); move16();
         }
 
-        coder(&coding_mode, signal, prms, &nb_bits, st, allow_dtx);
+        /* if this frame becomes a DTX frame that is not transmitted, skip  */
+        /* the work which cannot reach the bitstream: the synthesis only    */
+        /* feeds the HF gain of 23.85k, the SID parameters of NO_DATA       */
+        /* frames are only written in the default format                    */
+        dtx_skip = DTX_SKIP_NONE;
+        if ((allow_dtx != 0) && (mode_file == 0) && (rate_ctl == NULL) && (pipe == 0) && (mode != MODE_24k) &&
+            Tx_dtx_no_data(tx_state))
+        {
+            dtx_skip = (Word16) ((bitstreamformat == 0) ? DTX_SKIP_SYN : DTX_SKIP_SID);
+        }
+
+        if (pipe)
+        {
+            /* the frame written is the one before (and its mode) */
+            pipe_mode = mode;
+            Run_start(run_st);
+            pipe_out = coder_pipe(&pipe_mode, signal, prms, &nb_bits, st, allow_dtx, reset_flag);
+            Run_stop(run_st);
+            if (pipe_out != 0)
+            {
+                if ((rate_ctl != NULL) && (pipe_mode != MRDTX))
+                    out_mode = pipe_mode;  /* mode chosen for the frame */
+                Write_serial(f_serial, prms, pipe_mode, out_mode, tx_state, bitstreamformat);
+                Run_frame_tx(run_st, tx_state->prev_ft, pipe_mode, prms);
+            }
+            if (rate_ctl == NULL)
+                out_mode = mode;
+            continue;
+        }
+
+        Run_start(run_st);
+        if (flt_engine)
+        {
+            Set_encoder_dtx_skip_flt(st, dtx_skip);
+            coder_flt(&coding_mode, signal, prms, &nb_bits, st, allow_dtx);
+        } else
+        {
+            Set_encoder_dtx_skip(st, dtx_skip);
+            coder(&coding_mode, signal, prms, &nb_bits, st, allow_dtx);
+        }
+        Run_stop(run_st);
+        if ((rate_ctl != NULL) && (coding_mode != MRDTX))
+        {
+            mode = coding_mode;            /* mode chosen for the frame */
+        }
 
         Write_serial(f_serial, prms, coding_mode, mode, tx_state, bitstreamformat);
+        Run_frame_tx(run_st, tx_state->prev_ft, coding_mode, prms);
 
         WMOPS_output((Word16) (coding_mode == MRDTX));
 
         /* perform homing if homing frame was detected at encoder input */
         if (reset_flag != 0)
         {
-            Reset_encoder(st, 1);
+            if (flt_engine)
+                Reset_encoder_flt(st, 1);
+            else
+                Reset_encoder(st, 1);
         }
     }
 
+    /* last frame of the pipelined coder */
+    if (pipe)
+    {
+        Run_start(run_st);
+        pipe_out = coder_pipe(&pipe_mode, NULL, prms, &nb_bits, st, allow_dtx, 0);
+        Run_stop(run_st);
+        if (pipe_out != 0)
+        {
+            if ((rate_ctl != NULL) && (pipe_mode != MRDTX))
+                out_mode = pipe_mode;
+            Write_serial(f_serial, prms, pipe_mode, out_mode, tx_state, bitstreamformat);
+            Run_frame_tx(run_st, tx_state->prev_ft, pipe_mode, prms);
+        }
+    }
+    Run_progress(stderr, run_st, "Frames processed", frame, 1);
+
+    /* send the packets of an incomplete RTP frame group */
+    if (bitstreamformat >= 3)
+    {
+        Flush_rtp(f_serial, tx_state->rtp);
+    }
+
     /* free allocated memory */
-    Close_coder(st);
+    if (flt_engine)
+        Close_coder_flt(st);
+    else if (pipe)
+        Close_coder_pipe(st);
+    else
+        Close_coder(st);
+    if (search_grp != NULL)
+    {
+        Close_taskgrp(search_grp);
+    }
+    if (rate_ctl != NULL)
+    {
+        Rate_report(stderr, rate_ctl);
+        Close_ratectl(rate_ctl);
+    }
+    if (f_stats != NULL)
+    {
+        Run_report(f_stats, run_st);
+        fclose(f_stats);
+    }
+    Close_runstat(run_st);
     Close_write_serial(tx_state);
+    Close_read_pcm(pcm_state);
     fclose(f_speech);
     fclose(f_serial);
     if (f_mode != NULL)
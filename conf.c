@@ -0,0 +1,309 @@
+/*------------------------------------------------------------------------*
+ *                         CONF.C                                         *
+ *------------------------------------------------------------------------*
+ * Conference bridge: decode once, mix-minus, shared encoding             *
+ *                                                                        *
+ * Each participant sends one stream and receives the sum of the other    *
+ * active talkers, coded in its own mode:                                 *
+ *                                                                        *
+ *  - every received frame is decoded once. Comfort noise is not          *
+ *    synthesized and the participants which are not talking (DTX, VAD   *
+ *    flag not set, see Decoder_active()) are left out of the mix.        *
+ *  - the talkers are summed once; a talker receives the sum minus its    *
+ *    own speech, the other participants receive the sum (mix-minus,      *
+ *    O(N) additions per sample).                                         *
+ *  - the participants receiving the same mix in the same mode share one  *
+ *    encoder: typically all the listeners, while each talker has its     *
+ *    own. When a participant leaves a group, it takes a copy of the      *
+ *    encoder of the group, so its bitstream continues without a break.   *
+ *    When it joins a group, it takes the encoder of the group, whose     *
+ *    memories are not those of its far-end decoder: the first frames     *
+ *    after a merge are decoded with a discontinuity.                     *
+ *------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "cnst.h"
+#include "bits.h"
+#include "dtx.h"
+#include "main.h"
+#include "count.h"
+#include "conf.h"
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_conf                                            *
+ *            ~~~~~~~~~                                            *
+ *   ->Initialization of the decoders and encoders of a bridge.    *
+ *-----------------------------------------------------------------*/
+
+Word16 Init_conf(Conf_State ** state, Word16 nb_party, Word16 mode[], Word16 allow_dtx)
+{
+    Conf_State *st;
+    Word16 p;
+
+    *state = NULL;
+
+    if ((nb_party < 1) || (nb_party > CONF_MAX))
+    {
+        fprintf(stderr, "Init_conf: 1 to %d participants\n", CONF_MAX);
+        return -1;
+    }
+    if ((st = (Conf_State *) malloc(sizeof(Conf_State))) == NULL)
+    {
+        fprintf(stderr, "Init_conf: can not malloc state structure\n");
+        return -1;
+    }
+    st->nb_party = nb_party;
+    st->allow_dtx = allow_dtx;
+
+    for (p = 0; p < nb_party; p++)
+    {
+        st->dec_state[p] = NULL;
+        st->encoder[p].state = NULL;
+    }
+    for (p = 0; p < nb_party; p++)
+    {
+        Init_decoder(&(st->dec_state[p]));
+        Init_coder(&(st->encoder[p].state));
+        if ((st->dec_state[p] == NULL) || (st->encoder[p].state == NULL))
+        {
+            fprintf(stderr, "Init_conf: can not init decoder/encoder\n");
+            Close_conf(st);
+            return -1;
+        }
+        Set_decoder_cng_skip(st->dec_state[p], 1);
+
+        st->mode[p] = mode[p];
+
+        /* all the participants start with the first encoder */
+        st->enc[p] = 0;
+        st->encoder[p].refs = 0;
+        st->encoder[p].mask = 0;
+        st->encoder[p].mode = mode[0];
+    }
+    st->encoder[0].refs = nb_party;
+    st->active = 0;
+
+    st->stats.frames = 0;
+    st->stats.talkers = 0;
+    st->stats.silent = 0;
+    st->stats.encoded = 0;
+    st->stats.sent = 0;
+
+    *state = st;
+
+    return 0;
+}
+
+void Close_conf(Conf_State * st)
+{
+    Word16 p;
+
+    for (p = 0; p < st->nb_party; p++)
+    {
+        if (st->dec_state[p] != NULL)
+        {
+            Close_decoder(st->dec_state[p]);
+        }
+        if (st->encoder[p].state != NULL)
+        {
+            Close_coder(st->encoder[p].state);
+        }
+    }
+    free(st);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Conference                                           *
+ *            ~~~~~~~~~~                                           *
+ *   ->Processes one frame of all the participants.                *
+ *-----------------------------------------------------------------*/
+
+void Conference(
+     Conf_State * st,                      /* i/o : State structure                          */
+     Word16 prms_in[][NB_BITS_MAX],        /* i   : received frame of each participant       */
+     Word16 mode_in[],                     /* i   : mode of the received frames              */
+     Word16 frame_type[],                  /* i   : RX frame type of the received frames     */
+     Word16 prms_out[][NB_BITS_MAX],       /* o   : frame sent to each participant           */
+     Word16 coding_mode[]                  /* o   : coder() mode (or MRDTX) of the sent frame */
+)
+{
+    Word16 i, p, m, e, s, frame_length, ser_size;
+    Word16 group[CONF_MAX], slot[CONF_MAX];
+    Word16 speech[L_FRAME16k];
+    Word32 mask[CONF_MAX];
+    Word32 L_sum[L_FRAME16k];
+    Conf_Enc *enc;
+
+    /*--------------------------------------------------------------*
+     * Decoding, sum of the talkers                                 *
+     *--------------------------------------------------------------*/
+
+    st->active = 0;                        move32();
+    for (i = 0; i < L_FRAME16k; i++)
+    {
+        L_sum[i] = 0;                      move32();
+    }
+    for (p = 0; p < st->nb_party; p++)
+    {
+        decoder(mode_in[p], prms_in[p], st->synth[p], &frame_length, st->dec_state[p], frame_type[p]);
+
+        test();
+        if (Decoder_active(st->dec_state[p]) == 0)
+        {
+            st->stats.silent++;
+            continue;
+        }
+        st->active |= 1L << p;             logic32();
+        st->stats.talkers++;
+
+        for (i = 0; i < L_FRAME16k; i++)
+        {
+            L_sum[i] = L_add(L_sum[i], L_deposit_l(st->synth[p][i]));   move32();
+        }
+    }
+
+    /*--------------------------------------------------------------*
+     * Mix of each participant: the talkers except itself.         *
+     * Groups of participants with the same mix and mode.           *
+     *--------------------------------------------------------------*/
+
+    for (p = 0; p < st->nb_party; p++)
+    {
+        mask[p] = st->active & ~(1L << p); logic32(); move32();
+        group[p] = -1;                     move16();
+        slot[p] = -1;                      move16();
+        st->encoder[p].leader = -1;        move16();
+    }
+    for (p = 0; p < st->nb_party; p++)
+    {
+        test();
+        if (group[p] >= 0)
+        {
+            continue;
+        }
+
+        /* the group keeps an encoder of its members, preferably */
+        /* one which already coded the same mix in the same mode */
+
+        s = -1;                            move16();
+        for (m = p; m < st->nb_party; m++)
+        {
+            test();test();test();
+            if ((group[m] >= 0) || (L_sub(mask[m], mask[p]) != 0) || (sub(st->mode[m], st->mode[p]) != 0))
+            {
+                continue;
+            }
+            group[m] = p;                  move16();
+
+            e = st->enc[m];                move16();
+            test();
+            if (st->encoder[e].leader >= 0)
+            {
+                continue;
+            }
+            test();test();test();test();
+            if ((s < 0) || ((L_sub(st->encoder[e].mask, mask[p]) == 0) && (sub(st->encoder[e].mode, st->mode[p]) == 0) &&
+                    ((L_sub(st->encoder[s].mask, mask[p]) != 0) || (sub(st->encoder[s].mode, st->mode[p]) != 0))))
+            {
+                s = e;                     move16();
+            }
+        }
+        test();
+        if (s >= 0)
+        {
+            st->encoder[s].leader = p;     move16();
+        }
+        slot[p] = s;                       move16();
+    }
+
+    /* groups whose encoders are all taken by other groups: a free */
+    /* encoder continues the bitstream of the leader's encoder     */
+
+    for (p = 0; p < st->nb_party; p++)
+    {
+        test();test();
+        if ((group[p] != p) || (slot[p] >= 0))
+        {
+            continue;
+        }
+        for (s = 0; st->encoder[s].leader >= 0; s++)
+        {
+            test();
+        }
+        Copy_coder(st->encoder[s].state, st->encoder[st->enc[p]].state);
+        st->encoder[s].leader = p;         move16();
+        slot[p] = s;                       move16();
+    }
+
+    for (p = 0; p < st->nb_party; p++)
+    {
+        st->encoder[p].refs = 0;           move16();
+    }
+    for (p = 0; p < st->nb_party; p++)
+    {
+        st->enc[p] = slot[group[p]];       move16();
+        st->encoder[st->enc[p]].refs++;
+    }
+
+    /*--------------------------------------------------------------*
+     * Encoding: once per group                                     *
+     *--------------------------------------------------------------*/
+
+    for (s = 0; s < st->nb_party; s++)
+    {
+        enc = &(st->encoder[s]);
+        test();
+        if (enc->leader < 0)
+        {
+            continue;
+        }
+        p = enc->leader;                   move16();
+
+        test();
+        if (L_sub(mask[p], st->active) == 0)
+        {
+            for (i = 0; i < L_FRAME16k; i++)
+            {
+                speech[i] = round(L_shl(L_sum[i], 16)); move16();
+            }
+        } else
+        {
+            for (i = 0; i < L_FRAME16k; i++)
+            {
+                speech[i] = round(L_shl(L_sub(L_sum[i], L_deposit_l(st->synth[p][i])), 16)); move16();
+            }
+        }
+        for (i = 0; i < L_FRAME16k; i++)   /* Delete the 2 LSBs (14-bit input) */
+        {
+            speech[i] = (Word16) (speech[i] & 0xfffC);      logic16(); move16();
+        }
+
+        enc->coding_mode = st->mode[p];    move16();
+        Set_encoder_dtx_skip(enc->state, DTX_SKIP_NONE);
+        coder(&(enc->coding_mode), speech, enc->prms, &ser_size, enc->state, st->allow_dtx);
+
+        enc->mask = mask[p];               move32();
+        enc->mode = st->mode[p];           move16();
+        st->stats.encoded++;
+    }
+
+    for (p = 0; p < st->nb_party; p++)
+    {
+        enc = &(st->encoder[st->enc[p]]);
+        coding_mode[p] = enc->coding_mode; move16();
+        for (i = 0; i < NB_BITS_MAX; i++)
+        {
+            prms_out[p][i] = enc->prms[i]; move16();
+        }
+    }
+    st->stats.frames++;
+    st->stats.sent += st->nb_party;
+
+    return;
+}
@@ -0,0 +1,66 @@
+/*--------------------------------------------------------------------------*
+ *                         CONF.H                                           *
+ *--------------------------------------------------------------------------*
+ *       Conference bridge: decode once, mix-minus, shared encoding         *
+ *--------------------------------------------------------------------------*/
+
+#ifndef conf_h
+#define conf_h
+
+#include "typedef.h"
+#include "cnst.h"
+#include "bits.h"
+
+#define CONF_MAX          16               /* max participants (bits of a Word32 mask) */
+
+typedef struct
+{
+    Word32 frames;                         /* frames mixed                             */
+    Word32 talkers;                        /* sum of the active talkers                */
+    Word32 silent;                         /* decoded frames without synthesis (CN)    */
+    Word32 encoded;                        /* coder() calls                            */
+    Word32 sent;                           /* frames sent (participants x frames)      */
+} Conf_Stats;
+
+typedef struct
+{
+    void *state;                           /* coder() state                            */
+    Word16 refs;                           /* participants receiving this encoder      */
+    Word16 leader;                         /* participant of the mix encoded, -1: free */
+    Word32 mask;                           /* talkers of the last mix encoded          */
+    Word16 mode;                           /* mode of the last mix encoded             */
+    Word16 coding_mode;                    /* coder() output: mode or MRDTX            */
+    Word16 prms[NB_BITS_MAX];
+} Conf_Enc;
+
+typedef struct
+{
+    Word16 nb_party;
+    Word16 allow_dtx;
+
+    /* one decoder per participant */
+    void *dec_state[CONF_MAX];
+    Word16 synth[CONF_MAX][L_FRAME16k];
+    Word32 active;                         /* talkers of the current frame (mask)      */
+
+    /* encoders, shared by the participants receiving the same mix */
+    Word16 mode[CONF_MAX];                 /* mode sent to each participant            */
+    Word16 enc[CONF_MAX];                  /* encoder of each participant              */
+    Conf_Enc encoder[CONF_MAX];
+
+    Conf_Stats stats;
+} Conf_State;
+
+Word16 Init_conf(Conf_State ** st, Word16 nb_party, Word16 mode[], Word16 allow_dtx);
+void Close_conf(Conf_State * st);
+
+void Conference(
+     Conf_State * st,                      /* i/o : State structure                          */
+     Word16 prms_in[][NB_BITS_MAX],        /* i   : received frame of each participant       */
+     Word16 mode_in[],                     /* i   : mode of the received frames              */
+     Word16 frame_type[],                  /* i   : RX frame type of the received frames     */
+     Word16 prms_out[][NB_BITS_MAX],       /* o   : frame sent to each participant           */
+     Word16 coding_mode[]                  /* o   : coder() mode (or MRDTX) of the sent frame */
+);
+
+#endif
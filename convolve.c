@@ -9,8 +9,9 @@
 #include "typedef.h"
 #include "basic_op.h"
 #include "count.h"
+#include "cpu_disp.h"
 
-void Convolve(
+void Convolve_ref(
      Word16 x[],                           /* (i)        : input vector                           */
      Word16 h[],                           /* (i) Q15    : impulse response                       */
      Word16 y[],                           /* (o) 12 bits: output vector                          */
@@ -31,3 +32,20 @@ void Convolve(
 
     return;
 }
+
+/* the variant of the CPU (cpu_disp.c), the reference with the counters */
+void Convolve(
+     Word16 x[],                           /* (i)        : input vector                           */
+     Word16 h[],                           /* (i) Q15    : impulse response                       */
+     Word16 y[],                           /* (o) 12 bits: output vector                          */
+     Word16 L                              /* (i)        : vector size                            */
+)
+{
+#if (WMOPS == 0)
+    disp_kern->convolve(x, h, y, L);
+#else
+    Convolve_ref(x, h, y, L);
+#endif
+
+    return;
+}
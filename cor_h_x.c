@@ -10,13 +10,14 @@
 #include "basic_op.h"
 #include "math_op.h"
 #include "count.h"
+#include "cpu_disp.h"
 
 #define L_SUBFR   64
 #define NB_TRACK  4
 #define STEP      4
 
 
-void cor_h_x(
+void cor_h_x_ref(
      Word16 h[],                           /* (i) Q12 : impulse response of weighted synthesis filter */
      Word16 x[],                           /* (i) Q0  : target vector                                 */
      Word16 dn[]                           /* (o) <12bit : correlation between target and h[]         */
@@ -64,3 +65,18 @@ void cor_h_x(
 
     return;
 }
+
+void cor_h_x(
+     Word16 h[],                           /* (i) Q12 : impulse response of weighted synthesis filter */
+     Word16 x[],                           /* (i) Q0  : target vector                                 */
+     Word16 dn[]                           /* (o) <12bit : correlation between target and h[]         */
+)
+{
+#if (WMOPS == 0)
+    disp_kern->cor_h_x(h, x, dn);
+#else
+    cor_h_x_ref(h, x, dn);
+#endif
+
+    return;
+}
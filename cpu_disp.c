@@ -0,0 +1,178 @@
+/*------------------------------------------------------------------------*
+ *                         CPU_DISP.C                                     *
+ *------------------------------------------------------------------------*
+ * Run-time selection of the kernels                                      *
+ *                                                                        *
+ * Levels:                                                                *
+ *   ref       the basic operators (the reference code)                  *
+ *   c         native integer arithmetic, portable C                      *
+ *   sse4.1    the same, compiled for SSE4.1   (x86)                      *
+ *   avx2      the same, compiled for AVX2     (x86)                      *
+ *   avx512bw  the same, compiled for AVX-512BW (x86)                     *
+ *                                                                        *
+ * All the levels give the same output (see KERN_FX.INC). The kernels     *
+ * are bound once, by Init_coder() or Init_decoder(), to the best level   *
+ * of the CPU or to the level named by the environment variable          *
+ * AMRWB_CPU; Disp_force() sets it before (option -cpu of the programs). *
+ * Until then, the reference is used. Binding from several threads gives *
+ * the same table.                                                        *
+ *                                                                        *
+ * Syn_filt() (recursive) and the algebraic codebook searches (data       *
+ * dependent branches) have no variant: they are the reference at all     *
+ * the levels. Fir_sym31() (util.c) and the double precision operators   *
+ * (oper_32b.c) use native arithmetic whenever complexity is not counted, *
+ * whatever the level: they are chosen at compile time.                   *
+ *------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typedef.h"
+#include "cpu_disp.h"
+
+static const Disp_Kernels disp_ref =
+{
+    "ref",
+    Convolve_ref,
+    Residu_ref,
+    cor_h_x_ref,
+    Autocorr_ref,
+    Dot_product12_ref,
+    VQ_stage1_ref
+};
+
+#if (WMOPS == 0)
+extern const Disp_Kernels disp_c;          /* kern_fx.c */
+#ifdef DISP_X86
+extern const Disp_Kernels disp_sse41, disp_avx2, disp_avx512bw;
+#endif
+#endif
+
+/* tables of the levels, NULL: not built */
+static const Disp_Kernels *const disp_table[DISP_NB_LEVELS] =
+{
+    &disp_ref,
+#if (WMOPS == 0)
+    &disp_c,
+#ifdef DISP_X86
+    &disp_sse41,
+    &disp_avx2,
+    &disp_avx512bw
+#else
+    NULL, NULL, NULL
+#endif
+#else
+    NULL, NULL, NULL, NULL
+#endif
+};
+
+static const char *const disp_name[DISP_NB_LEVELS] =
+{
+    "ref", "c", "sse4.1", "avx2", "avx512bw"
+};
+
+const Disp_Kernels *disp_kern = &disp_ref;
+static Word16 disp_bound = 0;
+
+/* best level built and supported by the CPU */
+static Word16 Disp_detect(void)
+{
+#if (WMOPS == 0)
+#ifdef DISP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw"))
+        return DISP_AVX512BW;
+    if (__builtin_cpu_supports("avx2"))
+        return DISP_AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return DISP_SSE41;
+#endif
+    return DISP_C;
+#else
+    return DISP_REF;                       /* the complexity is the one of the reference */
+#endif
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Disp_force                                           *
+ *            ~~~~~~~~~~                                           *
+ *   ->Binds the kernels to a level: "ref", "c", "sse4.1", "avx2", *
+ *     "avx512bw" or "auto" (the best level of the CPU).           *
+ *     A level above the one of the CPU is refused.                *
+ *-----------------------------------------------------------------*/
+
+Word16 Disp_force(const char *level)
+{
+    Word16 i, best;
+
+    best = Disp_detect();
+    if (strcmp(level, "auto") == 0)
+    {
+        i = best;
+    } else
+    {
+        for (i = 0; i < DISP_NB_LEVELS; i++)
+        {
+            if (strcmp(level, disp_name[i]) == 0)
+                break;
+        }
+        if ((i >= DISP_NB_LEVELS) || (i > best) || (disp_table[i] == NULL))
+        {
+            return -1;
+        }
+    }
+    disp_kern = disp_table[i];
+    disp_bound = 1;
+
+    return 0;
+}
+
+void Disp_init(void)
+{
+    const char *env;
+
+    if (disp_bound != 0)
+    {
+        return;
+    }
+    env = getenv("AMRWB_CPU");
+    if ((env != NULL) && (Disp_force(env) == 0))
+    {
+        return;
+    }
+    if (env != NULL)
+    {
+        fprintf(stderr, "AMRWB_CPU=%s: unknown level or not supported by the CPU\n", env);
+    }
+    Disp_force("auto");
+
+    return;
+}
+
+void Disp_report(FILE * fp)
+{
+    const char *v = disp_kern->level;
+
+    fprintf(fp, "Kernels: %s (CPU: %s)\n", v, disp_name[Disp_detect()]);
+    fprintf(fp, "  Autocorr       %s\n", v);
+    fprintf(fp, "  Residu         %s\n", v);
+    fprintf(fp, "  Convolve       %s\n", v);
+    fprintf(fp, "  cor_h_x        %s\n", v);
+    fprintf(fp, "  Dot_product12  %s\n", v);
+    fprintf(fp, "  VQ_stage1      %s\n", v);
+    fprintf(fp, "  Syn_filt       ref (recursive filter)\n");
+    fprintf(fp, "  ACELP search   ref (data-dependent search)\n");
+#if (WMOPS == 0)
+    fprintf(fp, "  Fir_sym31      native (compile time)\n");
+#else
+    fprintf(fp, "  Fir_sym31      ref (complexity counted)\n");
+#endif
+#if (WMOPS == 0) && defined(maxWord64)
+    fprintf(fp, "  oper_32b       native (compile time)\n");
+#else
+    fprintf(fp, "  oper_32b       ref\n");
+#endif
+
+    return;
+}
@@ -0,0 +1,52 @@
+/*--------------------------------------------------------------------------*
+ *                         CPU_DISP.H                                       *
+ *--------------------------------------------------------------------------*
+ *       Run-time selection of the kernels for the instruction set          *
+ *--------------------------------------------------------------------------*/
+
+#ifndef cpu_disp_h
+#define cpu_disp_h
+
+#include <stdio.h>
+#include "typedef.h"
+
+/* levels: the reference (basic operators), portable C, x86 extensions */
+#define DISP_REF       0
+#define DISP_C         1
+#define DISP_SSE41     2
+#define DISP_AVX2      3
+#define DISP_AVX512BW  4
+#define DISP_NB_LEVELS 5
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DISP_X86                           /* variants for the x86 extensions */
+#endif
+
+typedef struct
+{
+    const char *level;                     /* name of the level                      */
+    void (*convolve) (Word16 x[], Word16 h[], Word16 y[], Word16 L);
+    void (*residu) (Word16 a[], Word16 m, Word16 x[], Word16 y[], Word16 lg);
+    void (*cor_h_x) (Word16 h[], Word16 x[], Word16 dn[]);
+    void (*autocorr) (Word16 x[], Word16 m, Word16 r_h[], Word16 r_l[]);
+    Word32 (*dot_product12) (Word16 x[], Word16 y[], Word16 lg, Word16 * exp);
+    void (*vq_stage1) (Word16 * x, const Word16 * dico, Word16 dim, Word16 dico_size, Word16 * index, Word16 surv);
+} Disp_Kernels;
+
+extern const Disp_Kernels *disp_kern;      /* kernels in use (reference until bound) */
+
+void Disp_init(void);                      /* binds the kernels once: AMRWB_CPU or the CPU */
+Word16 Disp_force(                         /* Return 0 if ok, -1 if unknown or not supported */
+     const char *level                     /* i   : level name, "auto": detected level  */
+);
+void Disp_report(FILE * fp);               /* level and variant of each kernel          */
+
+/* reference kernels (the results of all the variants are the same) */
+void Convolve_ref(Word16 x[], Word16 h[], Word16 y[], Word16 L);
+void Residu_ref(Word16 a[], Word16 m, Word16 x[], Word16 y[], Word16 lg);
+void cor_h_x_ref(Word16 h[], Word16 x[], Word16 dn[]);
+void Autocorr_ref(Word16 x[], Word16 m, Word16 r_h[], Word16 r_l[]);
+Word32 Dot_product12_ref(Word16 x[], Word16 y[], Word16 lg, Word16 * exp);
+void VQ_stage1_ref(Word16 * x, const Word16 * dico, Word16 dim, Word16 dico_size, Word16 * index, Word16 surv);
+
+#endif
@@ -12,8 +12,7 @@
 #include "cnst.h"
 #include "acelp.h"
 #include "count.h"
-
-#include "q_gain2.tab"
+#include "rom_tab.h"
 
 #define MEAN_ENER    30
 #define PRED_ORDER   4
@@ -27,8 +26,7 @@ const Word16 pdown_usable[7] = {32767, 32113, 31457, 24576, 7537, 1638, 328};
 const Word16 cdown_usable[7] = {32767, 32113, 32113, 32113, 32113, 32113, 22938};
 
 
-/* MA prediction coeff ={0.5, 0.4, 0.3, 0.2} in Q13 */
-static Word16 pred[PRED_ORDER] = {4096, 3277, 2458, 1638};
+/* MA prediction coeff ={0.5, 0.4, 0.3, 0.2} in Q13: pred_gain[] of rom_tab.c */
 
 void Init_D_gain2(
      Word16 * mem                          /* output  :static memory (4 words)      */
@@ -79,7 +77,8 @@ void D_gain2(
      Word16 * mem                          /* (i/o)   : static memory (4 words)     */
 )
 {
-    Word16 *p, *past_gain_pit, *past_gain_code, *past_qua_en, *gbuf, *pbuf, *prev_gc;
+    const Word16 *p;
+    Word16 *past_gain_pit, *past_gain_code, *past_qua_en, *gbuf, *pbuf, *prev_gc;
     Word16 *pbuf2, *seed;
     Word16 i, tmp, exp, frac, gcode0, exp_gcode0, qua_ener, gcode_inov;
     Word16 g_code;
@@ -189,10 +188,10 @@ void D_gain2(
 
     L_tmp = L_deposit_h(MEAN_ENER);        /* MEAN_ENER in Q16 */
     L_tmp = L_shl(L_tmp, 8);               /* From Q16 to Q24 */
-    L_tmp = L_mac(L_tmp, pred[0], past_qua_en[0]);      /* Q13*Q10 -> Q24 */
-    L_tmp = L_mac(L_tmp, pred[1], past_qua_en[1]);      /* Q13*Q10 -> Q24 */
-    L_tmp = L_mac(L_tmp, pred[2], past_qua_en[2]);      /* Q13*Q10 -> Q24 */
-    L_tmp = L_mac(L_tmp, pred[3], past_qua_en[3]);      /* Q13*Q10 -> Q24 */
+    L_tmp = L_mac(L_tmp, pred_gain[0], past_qua_en[0]);      /* Q13*Q10 -> Q24 */
+    L_tmp = L_mac(L_tmp, pred_gain[1], past_qua_en[1]);      /* Q13*Q10 -> Q24 */
+    L_tmp = L_mac(L_tmp, pred_gain[2], past_qua_en[2]);      /* Q13*Q10 -> Q24 */
+    L_tmp = L_mac(L_tmp, pred_gain[3], past_qua_en[3]);      /* Q13*Q10 -> Q24 */
 
     gcode0 = extract_h(L_tmp);             /* From Q24 to Q8  */
 
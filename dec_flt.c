@@ -0,0 +1,980 @@
+/*------------------------------------------------------------------------*
+ *                         DEC_FLT.C                                      *
+ *------------------------------------------------------------------------*
+ * Performs the main decoder routine in floating point                    *
+ *------------------------------------------------------------------------*/
+
+/*___________________________________________________________________________
+ |                                                                           |
+ | Floating-point version of dec_main.c.                                     |
+ |                                                                           |
+ | The bitstream parsing, the ISF and gain dequantizers, the algebraic code  |
+ | (kept in Q9 so that the gain decoder sees the same vector), the frame     |
+ | erasure concealment and the DTX state machine are the fixed-point         |
+ | routines. The excitation, the enhancers, the LP synthesis and the HF      |
+ | extension are computed in floating point without any dynamic scaling.     |
+ |___________________________________________________________________________|
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "typedef.h"
+#include "cnst.h"
+#include "acelp.h"
+#include "dec_flt.h"
+#include "bits.h"
+#include "main.h"
+#include "flt_lib.h"
+#include "rom_tab.h"
+
+#define PREEMPH_FAC_FLT  0.68f             /* preemphasis factor                    */
+
+/* LPC interpolation coef */
+static const Float interpol_frac_flt[NB_SUBFR] = {0.45f, 0.8f, 0.96f, 1.0f};
+
+/* High Band encoding (Q14) */
+static const Word16 HP_gain[16] =
+{
+   3624, 4673, 5597, 6479, 7425, 8378, 9324, 10264,
+   11210, 12206, 13391, 14844, 16770, 19655, 24289, 32728
+};
+
+static void synthesis_flt(
+     Float Aq[],                           /* A(z)  : quantized Az               */
+     Float exc[],                          /* (i)   : excitation at 12kHz        */
+     Word16 synth16k[],                    /* (o)   : 16kHz synthesis signal     */
+     Word16 prms,                          /* (i)   : parameter                  */
+     Word16 HfIsf[],
+     Word16 nb_bits,
+     Word16 newDTXState,
+     Decoder_State_flt * st,               /* (i/o) : State structure            */
+     Word16 bfi                            /* (i)   : bad frame indicator        */
+);
+
+/* HfIsf[] = isf_old[]*(1-frac) + isf[]*frac, rounded as in dec_main.c */
+static void Int_HfIsf(Word16 isf_old[], Word16 isf[], Word16 frac, Word16 HfIsf[])
+{
+    Word16 i;
+    Word32 L_tmp;
+
+    for (i = 0; i < M; i++)
+    {
+        L_tmp = ((Word32) isf_old[i] * (32767 - frac) + (Word32) isf[i] * frac) << 1;
+        HfIsf[i] = (Word16) ((L_tmp + 0x8000L) >> 16);
+    }
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_decoder_flt                                     *
+ *            ~~~~~~~~~~~~~~~~                                     *
+ *   ->Initialization of variables for the floating-point decoder. *
+ *-----------------------------------------------------------------*/
+
+void Init_decoder_flt(void **spd_state)
+{
+    /* Decoder states */
+    Decoder_State_flt *st;
+
+    *spd_state = NULL;
+
+    /*-------------------------------------------------------------------------*
+     * Memory allocation for coder state.                                      *
+     *-------------------------------------------------------------------------*/
+
+    if ((st = (Decoder_State_flt *) malloc(sizeof(Decoder_State_flt))) == NULL)
+    {
+        printf("Can not malloc Decoder_State_flt structure!\n");
+        return;
+    }
+    st->dtx_decSt = NULL;
+    dtx_dec_init(&st->dtx_decSt, isf_init);
+    st->hf_bypass = 0;
+
+    Reset_decoder_flt((void *) st, 1);
+
+    *spd_state = (void *) st;
+
+    return;
+}
+
+void Reset_decoder_flt(void *st, Word16 reset_all)
+{
+    Word16 i;
+
+    Decoder_State_flt *dec_state;
+
+    dec_state = (Decoder_State_flt *) st;
+
+    for (i = 0; i < PIT_MAX + L_INTERPOL; i++)
+        dec_state->old_exc[i] = 0.0f;
+    for (i = 0; i < M; i++)
+        dec_state->past_isfq[i] = 0;
+
+    dec_state->old_T0_frac = 0;            /* old pitch value = 64.0 */
+    dec_state->old_T0 = 64;
+    dec_state->first_frame = 1;
+    dec_state->gc_thres = 0.0f;
+    dec_state->tilt_code = 0;
+
+    for (i = 0; i < 8; i++)
+        dec_state->disp_mem[i] = 0.0f;
+
+    if (reset_all != 0)
+    {
+        /* routines initialization */
+
+        Init_D_gain2(dec_state->dec_gain);
+        for (i = 0; i < 2 * L_FILT; i++)
+            dec_state->mem_oversamp[i] = 0.0f;
+        for (i = 0; i < 4; i++)
+        {
+            dec_state->mem_sig_out[i] = 0.0f;
+            dec_state->mem_hp400[i] = 0.0f;
+        }
+        for (i = 0; i < 2 * L_FILT16k; i++)
+        {
+            dec_state->mem_hf[i] = 0.0f;
+            dec_state->mem_hf3[i] = 0.0f;
+        }
+        Init_Lagconc(dec_state->lag_hist);
+
+        /* isp initialization */
+
+        for (i = 0; i < M; i++)
+        {
+            dec_state->ispold[i] = (Float) isp_init[i] / 32768.0f;
+            dec_state->isfold[i] = isf_init[i];
+        }
+        for (i = 0; i < L_MEANBUF * M; i++)
+            dec_state->isf_buf[i] = isf_init[i % M];
+
+        /* variable initialization */
+
+        dec_state->mem_deemph = 0.0f;
+
+        dec_state->seed = 21845;           /* init random with 21845 */
+        dec_state->seed2 = 21845;
+        dec_state->seed3 = 21845;
+
+        dec_state->state = 0;
+        dec_state->prev_bfi = 0;
+
+        /* Static vectors to zero */
+
+        for (i = 0; i < M16k; i++)
+            dec_state->mem_syn_hf[i] = 0.0f;
+        for (i = 0; i < M; i++)
+            dec_state->mem_syn2[i] = 0.0f;
+
+        dtx_dec_reset(dec_state->dtx_decSt, isf_init);
+        dec_state->vad_hist = 0;
+
+    }
+    return;
+}
+
+/* Low-power decoding without the 6.4-7kHz band, see Set_decoder_hf_bypass() */
+
+void Set_decoder_hf_bypass_flt(void *spd_state, Word16 bypass)
+{
+    ((Decoder_State_flt *) spd_state)->hf_bypass = bypass;
+    return;
+}
+
+void Close_decoder_flt(void *spd_state)
+{
+    dtx_dec_exit(&(((Decoder_State_flt *) spd_state)->dtx_decSt));
+    free(spd_state);
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion decoder_flt                                           *
+ *           ~~~~~~~~~~~                                           *
+ *   ->Main floating-point decoder routine (same interface as      *
+ *     decoder()).                                                 *
+ *-----------------------------------------------------------------*/
+
+void decoder_flt(
+     Word16 mode,                          /* input : used mode                     */
+     Word16 prms[],                        /* input : parameter vector              */
+     Word16 synth16k[],                    /* output: synthesis speech              */
+     Word16 * frame_length,                /* output:  lenght of the frame          */
+     void *spd_state,                      /* i/o   : State structure               */
+     Word16 frame_type                     /* input : received frame type           */
+)
+{
+
+    /* Decoder states */
+    Decoder_State_flt *st;
+
+    /* Excitation vector */
+    Float old_exc[(L_FRAME + 1) + PIT_MAX + L_INTERPOL];
+    Float *exc;
+
+    /* LPC coefficients */
+
+    Float *p_Aq;                           /* ptr to A(z) for the 4 subframes      */
+    Float Aq[NB_SUBFR * (M + 1)];          /* A(z)   quantized for the 4 subframes */
+    Float ispnew[M];                       /* immittance spectral pairs at 4nd sfr */
+    Word16 isf[M];                         /* ISF (frequency domain) at 4nd sfr    */
+    Word16 code[L_SUBFR];                  /* algebraic codevector (Q9)            */
+    Float code_f[L_SUBFR];                 /* algebraic codevector                 */
+    Float code2[L_SUBFR];                  /* algebraic codevector                 */
+    Float exc2[L_FRAME];                   /* excitation vector                    */
+    Word16 exc2_16[L_FRAME];               /* CN excitation / excitation for DTX   */
+
+    Float fac, stab_fac, voice_fac, s, tmp;
+    Word32 L_gain_code;
+
+    /* Scalars */
+
+    Word16 i, j, i_subfr, index, ind[8], tmp16;
+    Word16 T0, T0_frac, pit_flag, T0_max, select, T0_min = 0;
+    Word16 gain_pit16;
+    Float gain_pit, gain_code, gc_enh;
+    Word16 newDTXState, bfi, unusable_frame, nb_bits;
+    Word16 vad_flag;
+    Float pit_sharp;
+    Float excp[L_SUBFR];
+    Word16 isf_tmp[M];
+    Word16 HfIsf[M16k];
+
+    Word16 corr_gain = 0;
+
+    st = (Decoder_State_flt *) spd_state;
+
+    /* mode verification */
+
+    nb_bits = nb_of_bits[mode];
+
+    *frame_length = L_FRAME16k;
+
+    /* find the new  DTX state  SPEECH OR DTX */
+    newDTXState = rx_dtx_handler(st->dtx_decSt, frame_type);
+
+    if (newDTXState != SPEECH)
+    {
+        dtx_dec(st->dtx_decSt, exc2_16, newDTXState, isf, &prms);
+    }
+    /* SPEECH action state machine  */
+    if ((frame_type == RX_SPEECH_BAD) ||
+        (frame_type == RX_SPEECH_PROBABLY_DEGRADED))
+    {
+        /* bfi only for lsf, gains and pitch period */
+        bfi = 1;
+        unusable_frame = 0;
+    } else if ((frame_type == RX_NO_DATA) ||
+               (frame_type == RX_SPEECH_LOST))
+    {
+        /* bfi for all index, bits are not usable */
+        bfi = 1;
+        unusable_frame = 1;
+    } else
+    {
+        bfi = 0;
+        unusable_frame = 0;
+    }
+    if (bfi != 0)
+    {
+        st->state = (Word16) (st->state + 1);
+        if (st->state > 6)
+        {
+            st->state = 6;
+        }
+    } else
+    {
+        st->state = (Word16) (st->state >> 1);
+    }
+
+    /* first speech frame after CNI period: see dec_main.c */
+    if (st->dtx_decSt->dtxGlobalState == DTX)
+    {
+        st->state = 5;
+        st->prev_bfi = 0;
+    } else if (st->dtx_decSt->dtxGlobalState == DTX_MUTE)
+    {
+        st->state = 5;
+        st->prev_bfi = 1;
+    }
+    if (newDTXState == SPEECH)
+    {
+        vad_flag = Serial_parm(1, &prms);
+        if (bfi == 0)
+        {
+            if (vad_flag == 0)
+            {
+                st->vad_hist = (Word16) (st->vad_hist + 1);
+                st->dtx_decSt->dtx_vad_hist = (Word16) (st->dtx_decSt->dtx_vad_hist + 1);
+            } else
+            {
+                st->vad_hist = 0;
+                st->dtx_decSt->dtx_vad_hist = 0;
+            }
+        }
+        else if (st->dtx_decSt->dtx_vad_hist > 0)
+        {
+            st->dtx_decSt->dtx_vad_hist = (Word16) (st->dtx_decSt->dtx_vad_hist + 1);
+        }
+    }
+    /*----------------------------------------------------------------------*
+     *                              DTX-CNG                                 *
+     *----------------------------------------------------------------------*/
+
+    if (newDTXState != SPEECH)             /* CNG mode */
+    {
+        /* Convert ISFs to the cosine domain */
+        Isf_isp_flt(isf, ispnew, M);
+        Isp_Az_flt(ispnew, Aq, M);
+
+        Word16_to_flt(exc2_16, exc2, L_FRAME);
+
+        for (i = 0; i < M; i++)
+            isf_tmp[i] = st->isfold[i];
+
+        for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+        {
+            Int_HfIsf(isf_tmp, isf, interpol_frac[i_subfr >> 6], HfIsf);
+            synthesis_flt(Aq, &exc2[i_subfr], &synth16k[i_subfr * 5 / 4], (short) 1, HfIsf, nb_bits, newDTXState, st, bfi);
+        }
+
+        /* reset speech coder memories */
+        Reset_decoder_flt(st, 0);
+
+        for (i = 0; i < M; i++)
+            st->isfold[i] = isf[i];
+
+        st->prev_bfi = bfi;
+        st->dtx_decSt->dtxGlobalState = newDTXState;
+
+        return;
+    }
+    /*----------------------------------------------------------------------*
+     *                               ACELP                                  *
+     *----------------------------------------------------------------------*/
+
+    /* copy coder memory state into working space */
+    for (i = 0; i < PIT_MAX + L_INTERPOL; i++)
+        old_exc[i] = st->old_exc[i];
+    exc = old_exc + PIT_MAX + L_INTERPOL;
+
+    /* Decode the ISFs */
+
+    if (nb_bits <= NBBITS_7k)
+    {
+        ind[0] = Serial_parm(8, &prms);
+        ind[1] = Serial_parm(8, &prms);
+        ind[2] = Serial_parm(7, &prms);
+        ind[3] = Serial_parm(7, &prms);
+        ind[4] = Serial_parm(6, &prms);
+
+        Dpisf_2s_36b(ind, isf, st->past_isfq, st->isfold, st->isf_buf, bfi, 1);
+    } else
+    {
+        ind[0] = Serial_parm(8, &prms);
+        ind[1] = Serial_parm(8, &prms);
+        ind[2] = Serial_parm(6, &prms);
+        ind[3] = Serial_parm(7, &prms);
+        ind[4] = Serial_parm(7, &prms);
+        ind[5] = Serial_parm(5, &prms);
+        ind[6] = Serial_parm(5, &prms);
+
+        Dpisf_2s_46b(ind, isf, st->past_isfq, st->isfold, st->isf_buf, bfi, 1);
+    }
+
+    /* Convert ISFs to the cosine domain */
+    Isf_isp_flt(isf, ispnew, M);
+
+    if (st->first_frame != 0)
+    {
+        st->first_frame = 0;
+        for (i = 0; i < M; i++)
+            st->ispold[i] = ispnew[i];
+    }
+    /* Find the interpolated ISPs and convert to a[] for all subframes */
+    Int_isp_flt(st->ispold, ispnew, interpol_frac_flt, Aq);
+
+    /* update ispold[] for the next frame */
+    for (i = 0; i < M; i++)
+        st->ispold[i] = ispnew[i];
+
+    /* Check stability on isf : distance between old isf and current isf */
+
+    s = 0.0f;
+    for (i = 0; i < M - 1; i++)
+    {
+        tmp = (Float) (isf[i] - st->isfold[i]);
+        s += tmp * tmp;
+    }
+    s *= (1.0f / 128.0f);                  /* same scale as dec_main.c */
+    if (s > 32767.0f)
+        s = 32767.0f;
+
+    stab_fac = 2.0f * (20480.0f - 0.8f * s) / 32768.0f;     /* 1.25 - distance */
+    if (stab_fac < 0.0f)
+        stab_fac = 0.0f;
+    if (stab_fac > 1.0f)
+        stab_fac = 1.0f;
+
+    for (i = 0; i < M; i++)
+    {
+        isf_tmp[i] = st->isfold[i];
+        st->isfold[i] = isf[i];
+    }
+
+    /*------------------------------------------------------------------------*
+     *          Loop for every subframe in the analysis frame                 *
+     *------------------------------------------------------------------------*/
+
+    p_Aq = Aq;                             /* pointer to interpolated LPC parameters */
+
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        pit_flag = i_subfr;
+        if ((i_subfr == 2 * L_SUBFR) && (nb_bits > NBBITS_7k))
+        {
+            pit_flag = 0;
+        }
+        /*-------------------------------------------------*
+         * - Decode pitch lag                              *
+         * Lag indeces received also in case of BFI,       *
+         * so that the parameter pointer stays in sync.    *
+         *-------------------------------------------------*/
+
+        if (pit_flag == 0)
+        {
+            if (nb_bits <= NBBITS_9k)
+            {
+                index = Serial_parm(8, &prms);
+                if (index < (PIT_FR1_8b - PIT_MIN) * 2)
+                {
+                    T0 = (Word16) (PIT_MIN + (index >> 1));
+                    T0_frac = (Word16) ((index - ((T0 - PIT_MIN) << 1)) << 1);
+                } else
+                {
+                    T0 = (Word16) (index + PIT_FR1_8b - ((PIT_FR1_8b - PIT_MIN) * 2));
+                    T0_frac = 0;
+                }
+            } else
+            {
+                index = Serial_parm(9, &prms);
+                if (index < (PIT_FR2 - PIT_MIN) * 4)
+                {
+                    T0 = (Word16) (PIT_MIN + (index >> 2));
+                    T0_frac = (Word16) (index - ((T0 - PIT_MIN) << 2));
+                } else if (index < (((PIT_FR2 - PIT_MIN) * 4) + ((PIT_FR1_9b - PIT_FR2) * 2)))
+                {
+                    index = (Word16) (index - (PIT_FR2 - PIT_MIN) * 4);
+                    T0 = (Word16) (PIT_FR2 + (index >> 1));
+                    T0_frac = (Word16) ((index - ((T0 - PIT_FR2) << 1)) << 1);
+                } else
+                {
+                    T0 = (Word16) (index + (PIT_FR1_9b - ((PIT_FR2 - PIT_MIN) * 4) - ((PIT_FR1_9b - PIT_FR2) * 2)));
+                    T0_frac = 0;
+                }
+            }
+
+            /* find T0_min and T0_max for subframe 2 and 4 */
+
+            T0_min = (Word16) (T0 - 8);
+            if (T0_min < PIT_MIN)
+            {
+                T0_min = PIT_MIN;
+            }
+            T0_max = (Word16) (T0_min + 15);
+            if (T0_max > PIT_MAX)
+            {
+                T0_max = PIT_MAX;
+                T0_min = (Word16) (T0_max - 15);
+            }
+        } else
+        {                                  /* if subframe 2 or 4 */
+            if (nb_bits <= NBBITS_9k)
+            {
+                index = Serial_parm(5, &prms);
+                T0 = (Word16) (T0_min + (index >> 1));
+                T0_frac = (Word16) ((index - ((T0 - T0_min) << 1)) << 1);
+            } else
+            {
+                index = Serial_parm(6, &prms);
+                T0 = (Word16) (T0_min + (index >> 2));
+                T0_frac = (Word16) (index - ((T0 - T0_min) << 2));
+            }
+        }
+
+        /* check BFI after pitch lag decoding */
+
+        if (bfi != 0)                      /* if frame erasure */
+        {
+            lagconc(&(st->dec_gain[17]), st->lag_hist, &T0, &(st->old_T0), &(st->seed3), unusable_frame);
+            T0_frac = 0;
+        }
+        /*-------------------------------------------------*
+         * - Find the pitch gain, the interpolation filter *
+         *   and the adaptive codebook vector.             *
+         *-------------------------------------------------*/
+
+        Pred_lt4_flt(&exc[i_subfr], T0, T0_frac, L_SUBFR + 1);
+
+        if (unusable_frame)
+        {
+            select = 1;
+        } else
+        {
+            if (nb_bits <= NBBITS_9k)
+            {
+                select = 0;
+            } else
+            {
+                select = Serial_parm(1, &prms);
+            }
+        }
+
+        if (select == 0)
+        {
+            /* find pitch excitation with lp filter */
+            for (i = 0; i < L_SUBFR; i++)
+            {
+                code2[i] = 0.18f * exc[i - 1 + i_subfr] + 0.64f * exc[i + i_subfr]
+                    + 0.18f * exc[i + 1 + i_subfr];
+            }
+            for (i = 0; i < L_SUBFR; i++)
+                exc[i + i_subfr] = code2[i];
+        }
+        /*-------------------------------------------------------*
+         * - Decode innovative codebook.                         *
+         * - Add the fixed-gain pitch contribution to code[].    *
+         *-------------------------------------------------------*/
+
+        if (unusable_frame != 0)
+        {
+            /* the innovative code doesn't need to be scaled (see Q_gain2) */
+            for (i = 0; i < L_SUBFR; i++)
+            {
+                code[i] = (Word16) (Random(&(st->seed)) >> 3);
+            }
+        } else if (nb_bits <= NBBITS_7k)
+        {
+            ind[0] = Serial_parm(12, &prms);
+            DEC_ACELP_2t64_fx(ind[0], code);
+        } else if (nb_bits <= NBBITS_9k)
+        {
+            for (i = 0; i < 4; i++)
+            {
+                ind[i] = Serial_parm(5, &prms);
+            }
+            DEC_ACELP_4t64_fx(ind, 20, code);
+        } else if (nb_bits <= NBBITS_12k)
+        {
+            for (i = 0; i < 4; i++)
+            {
+                ind[i] = Serial_parm(9, &prms);
+            }
+            DEC_ACELP_4t64_fx(ind, 36, code);
+        } else if (nb_bits <= NBBITS_14k)
+        {
+            ind[0] = Serial_parm(13, &prms);
+            ind[1] = Serial_parm(13, &prms);
+            ind[2] = Serial_parm(9, &prms);
+            ind[3] = Serial_parm(9, &prms);
+            DEC_ACELP_4t64_fx(ind, 44, code);
+        } else if (nb_bits <= NBBITS_16k)
+        {
+            for (i = 0; i < 4; i++)
+            {
+                ind[i] = Serial_parm(13, &prms);
+            }
+            DEC_ACELP_4t64_fx(ind, 52, code);
+        } else if (nb_bits <= NBBITS_18k)
+        {
+            for (i = 0; i < 4; i++)
+            {
+                ind[i] = Serial_parm(2, &prms);
+            }
+            for (i = 4; i < 8; i++)
+            {
+                ind[i] = Serial_parm(14, &prms);
+            }
+            DEC_ACELP_4t64_fx(ind, 64, code);
+        } else if (nb_bits <= NBBITS_20k)
+        {
+            ind[0] = Serial_parm(10, &prms);
+            ind[1] = Serial_parm(10, &prms);
+            ind[2] = Serial_parm(2, &prms);
+            ind[3] = Serial_parm(2, &prms);
+            ind[4] = Serial_parm(10, &prms);
+            ind[5] = Serial_parm(10, &prms);
+            ind[6] = Serial_parm(14, &prms);
+            ind[7] = Serial_parm(14, &prms);
+            DEC_ACELP_4t64_fx(ind, 72, code);
+        } else
+        {
+            for (i = 0; i < 4; i++)
+            {
+                ind[i] = Serial_parm(11, &prms);
+            }
+            for (i = 4; i < 8; i++)
+            {
+                ind[i] = Serial_parm(11, &prms);
+            }
+            DEC_ACELP_4t64_fx(ind, 88, code);
+        }
+
+        tmp16 = 0;
+        Preemph(code, st->tilt_code, L_SUBFR, &tmp16);
+
+        tmp16 = T0;
+        if (T0_frac > 2)
+        {
+            tmp16 = (Word16) (tmp16 + 1);
+        }
+        Pit_shrp(code, tmp16, PIT_SHARP, L_SUBFR);
+
+        /*-------------------------------------------------*
+         * - Decode codebooks gains.                       *
+         *-------------------------------------------------*/
+
+        if (nb_bits <= NBBITS_9k)
+        {
+            index = Serial_parm(6, &prms); /* codebook gain index */
+
+            D_gain2(index, 6, code, L_SUBFR, &gain_pit16, &L_gain_code, bfi, st->prev_bfi, st->state, unusable_frame, st->vad_hist, st->dec_gain);
+        } else
+        {
+            index = Serial_parm(7, &prms); /* codebook gain index */
+
+            D_gain2(index, 7, code, L_SUBFR, &gain_pit16, &L_gain_code, bfi, st->prev_bfi, st->state, unusable_frame, st->vad_hist, st->dec_gain);
+        }
+        gain_pit = (Float) gain_pit16 * (1.0f / 16384.0f);
+        gain_code = (Float) L_gain_code * (1.0f / 65536.0f);
+
+        for (i = 0; i < L_SUBFR; i++)
+            code_f[i] = (Float) code[i] * (1.0f / 512.0f);
+
+        /*----------------------------------------------------------*
+         * Update parameters for the next subframe.                 *
+         * - tilt of code: 0.0 (unvoiced) to 0.5 (voiced)           *
+         *----------------------------------------------------------*/
+
+        if (bfi == 0)
+        {
+            /* LTP-Lag history update */
+            for (i = 4; i > 0; i--)
+            {
+                st->lag_hist[i] = st->lag_hist[i - 1];
+            }
+            st->lag_hist[0] = T0;
+
+            st->old_T0 = T0;
+            st->old_T0_frac = 0;           /* Remove fraction in case of BFI */
+        }
+
+        /* post processing of excitation elements */
+
+        if (nb_bits <= NBBITS_9k)
+        {
+            pit_sharp = gain_pit;
+            if (pit_sharp > 1.0f)
+                pit_sharp = 1.0f;
+
+            if (gain_pit > 0.5f)
+            {
+                for (i = 0; i < L_SUBFR; i++)
+                {
+                    excp[i] = exc[i + i_subfr] * pit_sharp * gain_pit * (1.0f / 32.0f);
+                }
+            }
+        } else
+        {
+            pit_sharp = 0.0f;
+        }
+
+        voice_fac = voice_factor_flt(&exc[i_subfr], gain_pit, code_f, gain_code, L_SUBFR);
+
+        /* tilt of code for next subframe: 0.5=voiced, 0=unvoiced */
+
+        tmp = voice_fac * 8192.0f + 8192.0f;
+        Flt_to_word16(&tmp, &(st->tilt_code), 1);
+
+        /*-------------------------------------------------------*
+         * - Find the total excitation.                          *
+         * - Find synthesis speech corresponding to exc[].       *
+         *-------------------------------------------------------*/
+
+        for (i = 0; i < L_SUBFR; i++)
+            exc2[i] = exc[i + i_subfr];
+
+        for (i = 0; i < L_SUBFR; i++)
+        {
+            exc[i + i_subfr] = gain_pit * exc[i + i_subfr] + gain_code * code_f[i];
+        }
+
+        /*------------------------------------------------------------*
+         * phase dispersion to enhance noise in low bit rate          *
+         *------------------------------------------------------------*/
+
+        if (nb_bits <= NBBITS_7k)
+            j = 0;                         /* high dispersion for rate <= 7.5 kbit/s */
+        else if (nb_bits <= NBBITS_9k)
+            j = 1;                         /* low dispersion for rate <= 9.6 kbit/s */
+        else
+            j = 2;                         /* no dispersion for rate > 9.6 kbit/s */
+
+        Phase_dispersion_flt(gain_code, gain_pit, code_f, j, st->disp_mem);
+
+        /*------------------------------------------------------------*
+         * noise enhancer                                             *
+         * ~~~~~~~~~~~~~~                                             *
+         * - Enhance excitation on noise. (modify gain of code)       *
+         *   If signal is noisy and LPC filter is stable, move gain   *
+         *   of code 1.5 dB toward gain of code threshold.            *
+         *   This decrease by 3 dB noise energy variation.            *
+         *------------------------------------------------------------*/
+
+        fac = stab_fac * 0.5f * (1.0f - voice_fac);    /* 1=unvoiced, 0=voiced */
+
+        tmp = gain_code;
+        if (tmp < st->gc_thres)
+        {
+            tmp *= 1.19f;
+            if (tmp > st->gc_thres)
+            {
+                tmp = st->gc_thres;
+            }
+        } else
+        {
+            tmp *= 0.84f;
+            if (tmp < st->gc_thres)
+            {
+                tmp = st->gc_thres;
+            }
+        }
+        st->gc_thres = tmp;
+
+        gc_enh = gain_code * (1.0f - fac) + tmp * fac;
+
+        /*------------------------------------------------------------*
+         * pitch enhancer                                             *
+         * ~~~~~~~~~~~~~~                                             *
+         * - Enhance excitation on voice. (HP filtering of code)      *
+         *   On voiced signal, filtering of code by a smooth fir HP   *
+         *   filter to decrease energy of code in low frequency.      *
+         *------------------------------------------------------------*/
+
+        tmp = 0.125f * voice_fac + 0.125f; /* 0.25=voiced, 0=unvoiced */
+
+        code2[0] = code_f[0] - tmp * code_f[1];
+        for (i = 1; i < L_SUBFR - 1; i++)
+        {
+            code2[i] = code_f[i] - tmp * (code_f[i + 1] + code_f[i - 1]);
+        }
+        code2[L_SUBFR - 1] = code_f[L_SUBFR - 1] - tmp * code_f[L_SUBFR - 2];
+
+        /* build excitation */
+
+        for (i = 0; i < L_SUBFR; i++)
+        {
+            exc2[i] = gain_pit * exc2[i] + gc_enh * code2[i];
+        }
+
+        if (nb_bits <= NBBITS_9k)
+        {
+            if (gain_pit > 0.5f)
+            {
+                for (i = 0; i < L_SUBFR; i++)
+                {
+                    excp[i] += exc2[i];
+                }
+                agc2_flt(exc2, excp, L_SUBFR);
+                for (i = 0; i < L_SUBFR; i++)
+                    exc2[i] = excp[i];
+            }
+        }
+        if (nb_bits <= NBBITS_7k)
+        {
+            Int_HfIsf(isf_tmp, isf, interpol_frac[i_subfr >> 6], HfIsf);
+        } else
+        {
+            for (i = 0; i < M16k - M; i++)
+                st->mem_syn_hf[i] = 0.0f;
+        }
+
+        if (nb_bits >= NBBITS_24k)
+        {
+            corr_gain = Serial_parm(4, &prms);
+            synthesis_flt(p_Aq, exc2, &synth16k[i_subfr * 5 / 4], corr_gain, HfIsf, nb_bits, newDTXState, st, bfi);
+        } else
+            synthesis_flt(p_Aq, exc2, &synth16k[i_subfr * 5 / 4], 0, HfIsf, nb_bits, newDTXState, st, bfi);
+
+        p_Aq += (M + 1);                   /* interpolated LPC parameters for next subframe */
+    }
+
+    /*--------------------------------------------------*
+     * Update signal for next frame.                    *
+     * -> save past of exc[].                           *
+     * -> save pitch parameters.                        *
+     *--------------------------------------------------*/
+
+    for (i = 0; i < PIT_MAX + L_INTERPOL; i++)
+        st->old_exc[i] = old_exc[L_FRAME + i];
+
+    Flt_to_word16(exc, exc2_16, L_FRAME);
+    dtx_dec_activity_update(st->dtx_decSt, isf, exc2_16);
+
+    st->dtx_decSt->dtxGlobalState = newDTXState;
+
+    st->prev_bfi = bfi;
+
+    return;
+}
+
+/*-----------------------------------------------------*
+ * Function synthesis_flt()                            *
+ *                                                     *
+ * Synthesis of signal at 16kHz with HF extension.     *
+ *                                                     *
+ *-----------------------------------------------------*/
+
+static void synthesis_flt(
+     Float Aq[],                           /* A(z)  : quantized Az               */
+     Float exc[],                          /* (i)   : excitation at 12kHz        */
+     Word16 synth16k[],                    /* (o)   : 16kHz synthesis signal     */
+     Word16 prms,                          /* (i)   : parameter                  */
+     Word16 HfIsf[],
+     Word16 nb_bits,
+     Word16 newDTXState,
+     Decoder_State_flt * st,               /* (i/o) : State structure            */
+     Word16 bfi                            /* (i)   : bad frame indicator        */
+)
+{
+    Word16 i;
+    Float fac, tmp, ener, ener_hf, r0, r1;
+    Float synth[L_SUBFR];
+    Float synth16[L_SUBFR16k];
+    Float HF[L_SUBFR16k];                  /* High Frequency vector      */
+    Float Ap[M16k + 1];
+    Float HfA[M16k + 1];
+    Float HfIsp[M16k];
+
+    /*------------------------------------------------------------*
+     * speech synthesis                                           *
+     * ~~~~~~~~~~~~~~~~                                           *
+     * - Find synthesis speech corresponding to exc2[].           *
+     * - Perform fixed deemphasis and hp 50hz filtering.          *
+     * - Oversampling from 12.8kHz to 16kHz.                      *
+     *------------------------------------------------------------*/
+
+    Syn_filt_flt(Aq, M, exc, synth, L_SUBFR, st->mem_syn2, 1);
+    Deemph_flt(synth, PREEMPH_FAC_FLT, L_SUBFR, &(st->mem_deemph));
+    HP50_12k8_flt(synth, L_SUBFR, st->mem_sig_out);
+    Oversamp_16k_flt(synth, L_SUBFR, synth16, st->mem_oversamp);
+
+    if (st->hf_bypass != 0)
+    {
+        Flt_to_word16(synth16, synth16k, L_SUBFR16k);
+        return;
+    }
+
+    /*------------------------------------------------------*
+     * HF noise synthesis                                   *
+     * ~~~~~~~~~~~~~~~~~~                                   *
+     * - Generate HF noise between 5.5 and 7.5 kHz.         *
+     * - Set energy of noise according to synthesis tilt.   *
+     *     tilt > 0.8 ==> - 14 dB (voiced)                  *
+     *     tilt   0.5 ==> - 6 dB  (voiced or noise)         *
+     *     tilt < 0.0 ==>   0 dB  (noise)                   *
+     *------------------------------------------------------*/
+
+    /* generate white noise vector */
+    for (i = 0; i < L_SUBFR16k; i++)
+    {
+        HF[i] = (Float) Random(&(st->seed2)) * 0.125f;
+    }
+
+    /* set energy of white noise to energy of excitation */
+
+    ener = Dot_product_flt(exc, exc, L_SUBFR) + 0.01f;
+    ener_hf = Dot_product_flt(HF, HF, L_SUBFR16k) + 0.01f;
+    tmp = (Float) sqrt(ener / ener_hf);
+
+    for (i = 0; i < L_SUBFR16k; i++)
+    {
+        HF[i] *= tmp;
+    }
+
+    /* find tilt of synthesis speech (tilt: 1=voiced, -1=unvoiced) */
+
+    HP400_12k8_flt(synth, L_SUBFR, st->mem_hp400);
+
+    r0 = 1.0f + Dot_product_flt(synth, synth, L_SUBFR);
+    r1 = 1.0f;
+    for (i = 1; i < L_SUBFR; i++)
+        r1 += synth[i] * synth[i - 1];
+
+    if (r1 > 0.0f)
+    {
+        fac = r1 / r0;
+    } else
+    {
+        fac = 0.0f;
+    }
+
+    /* modify energy of white noise according to synthesis tilt */
+    if (st->vad_hist > 0)
+    {
+        tmp = 1.25f * (1.0f - fac);
+    } else
+    {
+        tmp = 1.0f - fac;
+    }
+    if (tmp < 0.1f)
+    {
+        tmp = 0.1f;
+    }
+
+    if ((nb_bits >= NBBITS_24k) && (bfi == 0))
+    {
+        /* HF correction gain */
+        tmp = (Float) HP_gain[prms] * (1.0f / 16384.0f);
+    }
+    for (i = 0; i < L_SUBFR16k; i++)
+    {
+        HF[i] *= tmp;
+    }
+
+    if ((nb_bits <= NBBITS_7k) && (newDTXState == SPEECH))
+    {
+        Isf_Extrapolation(HfIsf);          /* returns the 20 isp (Q15) */
+        for (i = 0; i < M16k; i++)
+            HfIsp[i] = (Float) HfIsf[i] * (1.0f / 32768.0f);
+        Isp_Az_flt(HfIsp, HfA, M16k);
+
+        Weight_a_flt(HfA, Ap, 0.9f, M16k);
+        Syn_filt_flt(Ap, M16k, HF, HF, L_SUBFR16k, st->mem_syn_hf, 1);
+    } else
+    {
+        /* synthesis of noise: 4.8kHz..5.6kHz --> 6kHz..7kHz */
+        Weight_a_flt(Aq, Ap, 0.6f, M);
+        Syn_filt_flt(Ap, M, HF, HF, L_SUBFR16k, st->mem_syn_hf + (M16k - M), 1);
+    }
+
+    /* noise High Pass filtering (1ms of delay) */
+    Filt_6k_7k_flt(HF, L_SUBFR16k, st->mem_hf);
+
+    if (nb_bits >= NBBITS_24k)
+    {
+        /* Low Pass filtering (7 kHz) */
+        Filt_7k_flt(HF, L_SUBFR16k, st->mem_hf3);
+    }
+    /* add filtered HF noise to speech synthesis */
+    for (i = 0; i < L_SUBFR16k; i++)
+    {
+        synth16[i] += HF[i];
+    }
+    Flt_to_word16(synth16, synth16k, L_SUBFR16k);
+
+    return;
+}
@@ -0,0 +1,43 @@
+/*--------------------------------------------------------------------------*
+ *                         DEC_FLT.H                                        *
+ *--------------------------------------------------------------------------*
+ *       Static memory in the floating-point decoder                        *
+ *--------------------------------------------------------------------------*/
+
+#include "cnst.h"                          /* coder constant parameters */
+#include "dtx.h"
+
+typedef struct
+{
+    Float old_exc[PIT_MAX + L_INTERPOL];   /* old excitation vector */
+    Float ispold[M];                       /* old isp (immittance spectral pairs) */
+    Word16 isfold[M];                      /* old isf (frequency domain) */
+    Word16 isf_buf[L_MEANBUF * M];         /* isf buffer(frequency domain) */
+    Word16 past_isfq[M];                   /* past isf quantizer */
+    Word16 tilt_code;                      /* tilt of code (Q15, fixed-point code path) */
+    Float gc_thres;                        /* threshold for noise enhancer */
+    Float mem_syn2[M];                     /* modified synthesis memory */
+    Float mem_deemph;                      /* speech deemph filter memory */
+    Float mem_sig_out[4];                  /* hp50 filter memory for synthesis */
+    Float mem_oversamp[2 * L_FILT];        /* synthesis oversampled filter memory */
+    Float mem_syn_hf[M16k];                /* HF synthesis memory */
+    Float mem_hf[2 * L_FILT16k];           /* HF band-pass filter memory */
+    Float mem_hf3[2 * L_FILT16k];          /* HF band-pass filter memory */
+    Word16 seed;                           /* random memory for frame erasure */
+    Word16 seed2;                          /* random memory for HF generation */
+    Word16 old_T0;                         /* old pitch lag */
+    Word16 old_T0_frac;                    /* old pitch fraction lag */
+    Word16 lag_hist[5];
+    Word16 dec_gain[23];                   /* gain decoder memory */
+    Word16 seed3;                          /* random memory for lag concealment */
+    Float disp_mem[8];                     /* phase dispersion memory */
+    Float mem_hp400[4];                    /* hp400 filter memory for synthesis */
+
+    Word16 prev_bfi;
+    Word16 state;
+    Word16 first_frame;
+    dtx_decState *dtx_decSt;
+    Word16 vad_hist;
+    Word16 hf_bypass;                      /* no HF generation (output band 0..6.4kHz) */
+
+} Decoder_State_flt;
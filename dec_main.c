@@ -25,11 +25,12 @@
 #include "count.h"
 #include "math_op.h"
 #include "main.h"
+#include "transrate.h"
+#include "cpu_disp.h"
+#include "rom_tab.h"
+#include "dec_parm.h"
 
 
-/* LPC interpolation coef {0.45, 0.8, 0.96, 1.0}; in Q15 */
-static Word16 interpol_frac[NB_SUBFR] = {14746, 26214, 31457, 32767};
-
 /* High Band encoding */
 static const Word16 HP_gain[16] =
 {
@@ -37,19 +38,13 @@ static const Word16 HP_gain[16] =
    11210, 12206, 13391, 14844, 16770, 19655, 24289, 32728
 };
 
-/* isp tables for initialization */
-
-static Word16 isp_init[M] =
-{
-   32138, 30274, 27246, 23170, 18205, 12540, 6393, 0,
-   -6393, -12540, -18205, -23170, -27246, -30274, -32138, 1475
-};
-
-static Word16 isf_init[M] =
-{
-   1024, 2048, 3072, 4096, 5120, 6144, 7168, 8192,
-   9216, 10240, 11264, 12288, 13312, 14336, 15360, 3840
-};
+static void synthesis_12k8(
+     Word16 Aq[],                          /* A(z)  : quantized Az               */
+     Word16 exc[],                         /* (i)   : excitation at 12kHz        */
+     Word16 Q_new,                         /* (i)   : scaling performed on exc   */
+     Word16 speech[],                      /* (o)   : synthesis before deemphasis*/
+     Decoder_State * st                    /* (i/o) : State structure            */
+);
 
 static void synthesis(
      Word16 Aq[],                          /* A(z)  : quantized Az               */
@@ -76,6 +71,7 @@ void Init_decoder(void **spd_state)
     Decoder_State *st;
 
     *spd_state = NULL;
+    Disp_init();                           /* kernels of the CPU */
 
     /*-------------------------------------------------------------------------*
      * Memory allocation for coder state.                                      *
@@ -87,8 +83,9 @@ void Init_decoder(void **spd_state)
         printf("Can not malloc Decoder_State structure!\n");
         return;
     }
-    st->dtx_decSt = NULL;
-    dtx_dec_init(&st->dtx_decSt, isf_init);
+    st->hf_bypass = 0;
+    st->trans = NULL;
+    st->cng_skip = 0;
 
     Reset_decoder((void *) st, 1);
 
@@ -158,16 +155,87 @@ void Reset_decoder(void *st, Word16 reset_all)
         Set_zero(dec_state->mem_syn_hi, M);
         Set_zero(dec_state->mem_syn_lo, M);
 
-        dtx_dec_reset(dec_state->dtx_decSt, isf_init);
+        dtx_dec_reset(&(dec_state->dtx_decSt), isf_init);
         dec_state->vad_hist = 0;           move16();
+        dec_state->cn_valid = 0;           move16();
 
     }
     return;
 }
 
+/*-----------------------------------------------------------------*
+ *   Funtion  Set_decoder_hf_bypass                                *
+ *            ~~~~~~~~~~~~~~~~~~~~~                                *
+ *   ->Low-power decoding: the 6.4-7kHz band (HF noise) is not     *
+ *     generated, the 0-6.4kHz synthesis is unchanged.             *
+ *     The setting is kept over decoder resets (homing frames).    *
+ *-----------------------------------------------------------------*/
+
+void Set_decoder_hf_bypass(void *spd_state, Word16 bypass)
+{
+    ((Decoder_State *) spd_state)->hf_bypass = bypass;
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Set_decoder_trans                                    *
+ *            ~~~~~~~~~~~~~~~~~                                    *
+ *   ->Decoding for transrating (see transrate.c): the decoded     *
+ *     ISFs, pitch lags and 12.8kHz synthesis before deemphasis    *
+ *     are written to *parm and no 16kHz synthesis is produced     *
+ *     (synth16k[] is not written). NULL for normal decoding.      *
+ *-----------------------------------------------------------------*/
+
+void Set_decoder_trans(void *spd_state, Trans_Parm * parm)
+{
+    ((Decoder_State *) spd_state)->trans = parm;
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Set_decoder_cng_skip                                 *
+ *            ~~~~~~~~~~~~~~~~~~~~                                 *
+ *   ->The comfort noise is not synthesized (synth16k[] is zero    *
+ *     in DTX frames), e.g. for a conference bridge which does not *
+ *     mix the silent participants. The DTX state is still         *
+ *     updated, but the memories of the synthesis (mem_syn_hi/lo, *
+ *     mem_deemph, mem_sig_out, mem_oversamp, seed2) keep their    *
+ *     values of the last speech frame: the first speech frame     *
+ *     after a DTX period differs from the output of a decoder     *
+ *     which synthesizes the comfort noise.                        *
+ *-----------------------------------------------------------------*/
+
+void Set_decoder_cng_skip(void *spd_state, Word16 skip)
+{
+    ((Decoder_State *) spd_state)->cng_skip = skip;
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Decoder_active                                       *
+ *            ~~~~~~~~~~~~~~                                       *
+ *   ->Returns 1 if the last decoded frame is active speech: a     *
+ *     speech frame with the VAD flag set (the flag of the last    *
+ *     good frame is kept over bad frames), 0 for comfort noise    *
+ *     and DTX hangover frames.                                    *
+ *-----------------------------------------------------------------*/
+
+Word16 Decoder_active(void *spd_state)
+{
+    Decoder_State *st;
+
+    st = (Decoder_State *) spd_state;
+
+    test();test();
+    if ((sub(st->dtx_decSt.dtxGlobalState, SPEECH) == 0) && (st->vad_hist == 0))
+    {
+        return 1;
+    }
+    return 0;
+}
+
 void Close_decoder(void *spd_state)
 {
-    dtx_dec_exit(&(((Decoder_State *) spd_state)->dtx_decSt));
     free(spd_state);
     return;
 }
@@ -211,11 +279,11 @@ void decoder(
 
     /* Scalars */
 
-    Word16 i, j, i_subfr, index, ind[8], max, tmp;
-    Word16 T0, T0_frac, pit_flag, T0_max, select, T0_min = 0;
+    Word16 i, j, i_subfr, ind[8], max, tmp;
+    Word16 T0, T0_frac, select, T0_min = 0;
     Word16 gain_pit, gain_code, gain_code_lo;
     Word16 newDTXState, bfi, unusable_frame, nb_bits;
-    Word16 vad_flag;
+    Word16 vad_flag = 1;
     Word16 pit_sharp;
     Word16 excp[L_SUBFR];
     Word16 isf_tmp[M];
@@ -232,113 +300,65 @@ void decoder(
     *frame_length = L_FRAME16k;            move16();
 
     /* find the new  DTX state  SPEECH OR DTX */
-    newDTXState = rx_dtx_handler(st->dtx_decSt, frame_type);
+    newDTXState = rx_dtx_handler(&(st->dtx_decSt), frame_type);
 
     test();
     if (sub(newDTXState, SPEECH) != 0)
     {
-        dtx_dec(st->dtx_decSt, exc2, newDTXState, isf, &prms);
-    }
-    /* SPEECH action state machine  */
-    test();test();
-    if ((sub(frame_type, RX_SPEECH_BAD) == 0) ||
-        (sub(frame_type, RX_SPEECH_PROBABLY_DEGRADED) == 0))
-    {
-        /* bfi only for lsf, gains and pitch period */
-        bfi = 1;                           move16();
-        unusable_frame = 0;                move16();
-    } else if ((sub(frame_type, RX_NO_DATA) == 0) ||
-    		   (sub(frame_type, RX_SPEECH_LOST) == 0))
-    {
-        /* bfi for all index, bits are not usable */
-        bfi = 1;                           move16();
-        unusable_frame = 1;                move16();
-    } else
-    {
-        bfi = 0;                           move16();
-        unusable_frame = 0;                move16();
-    }
-    test();
-    if (bfi != 0)
-    {
-        st->state = add(st->state, 1);     move16();
-        test();
-        if (sub(st->state, 6) > 0)
-        {
-            st->state = 6;                 move16();
-        }
-    } else
-    {
-        st->state = shr(st->state, 1);     move16();
+        dtx_dec(&(st->dtx_decSt), exc2, newDTXState, isf, &prms);
     }
+    bfi = D_frame_state(frame_type, newDTXState, &prms, &unusable_frame, &vad_flag,
+                        &(st->state), &(st->prev_bfi), &(st->vad_hist), &(st->dtx_decSt));
 
-    /* If this frame is the first speech frame after CNI period,     */
-    /* set the BFH state machine to an appropriate state depending   */
-    /* on whether there was DTX muting before start of speech or not */
-    /* If there was DTX muting, the first speech frame is muted.     */
-    /* If there was no DTX muting, the first speech frame is not     */
-    /* muted. The BFH state machine starts from state 5, however, to */
-    /* keep the audible noise resulting from a SID frame which is    */
-    /* erroneously interpreted as a good speech frame as small as    */
-    /* possible (the decoder output in this case is quickly muted)   */
-    test();test();
-    if (sub(st->dtx_decSt->dtxGlobalState, DTX) == 0)
-    {
-        st->state = 5;                     move16();
-        st->prev_bfi = 0;                  move16();
-    } else if (sub(st->dtx_decSt->dtxGlobalState, DTX_MUTE) == 0)
-    {
-        st->state = 5;                     move16();
-        st->prev_bfi = 1;                  move16();
-    }
-	test();
-	if (sub(newDTXState, SPEECH) == 0)
-	{
-		vad_flag = Serial_parm(1, &prms);
-		test();
-		if (bfi == 0)
-		{
-			test();
-			if (vad_flag == 0)
-			{
-				st->vad_hist = add(st->vad_hist, 1);    move16();
-				st->dtx_decSt->dtx_vad_hist = add(st->dtx_decSt->dtx_vad_hist, 1);    move16();
-			} else
-			{
-				st->vad_hist = 0;          move16();
-				st->dtx_decSt->dtx_vad_hist = 0;      move16();
-			}
-		}
-		else if (st->dtx_decSt->dtx_vad_hist > 0)
-		{
-			st->dtx_decSt->dtx_vad_hist = add(st->dtx_decSt->dtx_vad_hist, 1);    move16();
-		}
-	}
     /*----------------------------------------------------------------------*
      *                              DTX-CNG                                 *
      *----------------------------------------------------------------------*/
     test();
     if (sub(newDTXState, SPEECH) != 0)     /* CNG mode */
     {
-        /* increase slightly energy of noise below 200 Hz */
+        /* The CN isf[] only change with SID updates, during the      */
+        /* interpolation that follows them and with CN dithering:     */
+        /* A(z) is kept from the previous CN frame when isf[] is the  */
+        /* same.                                                      */
+
+        j = st->cn_valid;                  move16();
+        for (i = 0; i < M; i++)
+        {
+            test();
+            if (sub(isf[i], st->cn_isf[i]) != 0)
+            {
+                j = 0;                     move16();
+            }
+        }
+        test();test();
+        if ((j == 0) && (st->cng_skip == 0))
+        {
+            /* increase slightly energy of noise below 200 Hz */
 
-        /* Convert ISFs to the cosine domain */
-        Isf_isp(isf, ispnew, M);
+            /* Convert ISFs to the cosine domain */
+            Isf_isp(isf, ispnew, M);
 
-        Isp_Az(ispnew, Aq, M, 1);
+            Isp_Az(ispnew, st->cn_Aq, M, 1);
 
-        Copy(st->isfold, isf_tmp, M);
+            Copy(isf, st->cn_isf, M);
+            st->cn_valid = 1;              move16();
+        }
 
-        for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+        /* HfIsf[] is only used by synthesis() for speech frames */
+        test();test();
+        if (st->trans != NULL)
         {
-            j = shr(i_subfr, 6);
-            for (i = 0; i < M; i++)
+            /* no comfort noise: the frame is not transrated */
+            st->trans->dtx_state = newDTXState; move16();
+        } else if (st->cng_skip != 0)
+        {
+            Set_zero(synth16k, L_FRAME16k);
+        } else
+        {
+            for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
             {
-                L_tmp = L_mult(isf_tmp[i], sub(32767, interpol_frac[j]));
-                L_tmp = L_mac(L_tmp, isf[i], interpol_frac[j]);
-                HfIsf[i] = round(L_tmp);   move16();
+                synthesis(st->cn_Aq, &exc2[i_subfr], 0, &synth16k[i_subfr * 5 / 4], (short) 1, HfIsf, nb_bits, newDTXState, st, bfi);
             }
-            synthesis(Aq, &exc2[i_subfr], 0, &synth16k[i_subfr * 5 / 4], (short) 1, HfIsf, nb_bits, newDTXState, st, bfi);
         }
 
         /* reset speech coder memories */
@@ -347,7 +367,7 @@ void decoder(
         Copy(isf, st->isfold, M);
 
         st->prev_bfi = bfi;                move16();
-        st->dtx_decSt->dtxGlobalState = newDTXState;    move16();
+        st->dtx_decSt.dtxGlobalState = newDTXState;    move16();
 
         return;
     }
@@ -361,28 +381,7 @@ void decoder(
     exc = old_exc + PIT_MAX + L_INTERPOL;  move16();
 
     /* Decode the ISFs */
-    test();
-    if (sub(nb_bits, NBBITS_7k) <= 0)
-    {
-        ind[0] = Serial_parm(8, &prms);    move16();
-        ind[1] = Serial_parm(8, &prms);    move16();
-        ind[2] = Serial_parm(7, &prms);    move16();
-        ind[3] = Serial_parm(7, &prms);    move16();
-        ind[4] = Serial_parm(6, &prms);    move16();
-
-        Dpisf_2s_36b(ind, isf, st->past_isfq, st->isfold, st->isf_buf, bfi, 1);
-    } else
-    {
-        ind[0] = Serial_parm(8, &prms);    move16();
-        ind[1] = Serial_parm(8, &prms);    move16();
-        ind[2] = Serial_parm(6, &prms);    move16();
-        ind[3] = Serial_parm(7, &prms);    move16();
-        ind[4] = Serial_parm(7, &prms);    move16();
-        ind[5] = Serial_parm(5, &prms);    move16();
-        ind[6] = Serial_parm(5, &prms);    move16();
-
-        Dpisf_2s_46b(ind, isf, st->past_isfq, st->isfold, st->isf_buf, bfi, 1);
-    }
+    D_isf_parm(nb_bits, &prms, isf, st->past_isfq, st->isfold, st->isf_buf, bfi);
 
     /* Convert ISFs to the cosine domain */
 
@@ -420,6 +419,19 @@ void decoder(
     Copy(st->isfold, isf_tmp, M);
     Copy(isf, st->isfold, M);
 
+    test();
+    if (st->trans != NULL)
+    {
+        st->trans->dtx_state = newDTXState; move16();
+        st->trans->vad_flag = vad_flag;    move16();
+        test();
+        if (bfi != 0)
+        {
+            st->trans->vad_flag = 1;       move16();
+        }
+        Copy(isf, st->trans->isf, M);
+    }
+
     /*------------------------------------------------------------------------*
      *          Loop for every subframe in the analysis frame                 *
      *------------------------------------------------------------------------*
@@ -436,97 +448,16 @@ void decoder(
 
     for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
     {
-        pit_flag = i_subfr;                move16();
-
-        test();test();
-        if ((sub(i_subfr, 2 * L_SUBFR) == 0) && (sub(nb_bits, NBBITS_7k) > 0))
-        {
-            pit_flag = 0;                  move16();
-        }
         /*-------------------------------------------------*
          * - Decode pitch lag                              *
-         * Lag indeces received also in case of BFI,       *
-         * so that the parameter pointer stays in sync.    *
          *-------------------------------------------------*/
-        test();
-        if (pit_flag == 0)
-        {
-            test();
-            if (sub(nb_bits, NBBITS_9k) <= 0)
-            {
-                index = Serial_parm(8, &prms);
-                test();
-                if (sub(index, (PIT_FR1_8b - PIT_MIN) * 2) < 0)
-                {
-                    T0 = add(PIT_MIN, shr(index, 1));
-                    T0_frac = sub(index, shl(sub(T0, PIT_MIN), 1));
-                    T0_frac = shl(T0_frac, 1);
-                } else
-                {
-                    T0 = add(index, PIT_FR1_8b - ((PIT_FR1_8b - PIT_MIN) * 2));
-                    T0_frac = 0;           move16();
-                }
-            } else
-            {
-                index = Serial_parm(9, &prms);
-                test();test();
-                if (sub(index, (PIT_FR2 - PIT_MIN) * 4) < 0)
-                {
-                    T0 = add(PIT_MIN, shr(index, 2));
-                    T0_frac = sub(index, shl(sub(T0, PIT_MIN), 2));
-                } else if (sub(index, (((PIT_FR2 - PIT_MIN) * 4) + ((PIT_FR1_9b - PIT_FR2) * 2))) < 0)
-                {
-                    index = sub(index, (PIT_FR2 - PIT_MIN) * 4);
-                    T0 = add(PIT_FR2, shr(index, 1));
-                    T0_frac = sub(index, shl(sub(T0, PIT_FR2), 1));
-                    T0_frac = shl(T0_frac, 1);
-                } else
-                {
-                    T0 = add(index, (PIT_FR1_9b - ((PIT_FR2 - PIT_MIN) * 4) - ((PIT_FR1_9b - PIT_FR2) * 2)));
-                    T0_frac = 0;           move16();
-                }
-            }
-
-            /* find T0_min and T0_max for subframe 2 and 4 */
-
-            T0_min = sub(T0, 8);
-            test();
-            if (sub(T0_min, PIT_MIN) < 0)
-            {
-                T0_min = PIT_MIN;          move16();
-            }
-            T0_max = add(T0_min, 15);
-            test();
-            if (sub(T0_max, PIT_MAX) > 0)
-            {
-                T0_max = PIT_MAX;          move16();
-                T0_min = sub(T0_max, 15);
-            }
-        } else
-        {                                  /* if subframe 2 or 4 */
-            test();
-            if (sub(nb_bits, NBBITS_9k) <= 0)
-            {
-                index = Serial_parm(5, &prms);
-
-                T0 = add(T0_min, shr(index, 1));
-                T0_frac = sub(index, shl(sub(T0, T0_min), 1));
-                T0_frac = shl(T0_frac, 1);
-            } else
-            {
-                index = Serial_parm(6, &prms);
+        D_pitch_lag(nb_bits, i_subfr, &prms, bfi, unusable_frame, &T0, &T0_frac, &T0_min,
+                    &(st->dec_gain[17]), st->lag_hist, &(st->old_T0), &(st->seed3));
 
-                T0 = add(T0_min, shr(index, 2));
-                T0_frac = sub(index, shl(sub(T0, T0_min), 2));
-            }
-        }
-
-        /* check BFI after pitch lag decoding */
         test();
-        if (bfi != 0)                      /* if frame erasure */
+        if (st->trans != NULL)
         {
-            lagconc(&(st->dec_gain[17]), st->lag_hist, &T0, &(st->old_T0), &(st->seed3), unusable_frame);
-            T0_frac = 0;                   move16();
+            st->trans->T0[shr(i_subfr, 6)] = T0;        move16();
         }
         /*-------------------------------------------------*
          * - Find the pitch gain, the interpolation filter *
@@ -657,18 +588,8 @@ void decoder(
         /*-------------------------------------------------*
          * - Decode codebooks gains.                       *
          *-------------------------------------------------*/
-        test();
-        if (sub(nb_bits, NBBITS_9k) <= 0)
-        {
-            index = Serial_parm(6, &prms); /* codebook gain index */
-
-            D_gain2(index, 6, code, L_SUBFR, &gain_pit, &L_gain_code, bfi, st->prev_bfi, st->state, unusable_frame, st->vad_hist, st->dec_gain);
-        } else
-        {
-            index = Serial_parm(7, &prms); /* codebook gain index */
-
-            D_gain2(index, 7, code, L_SUBFR, &gain_pit, &L_gain_code, bfi, st->prev_bfi, st->state, unusable_frame, st->vad_hist, st->dec_gain);
-        }
+        D_gain_parm(nb_bits, &prms, code, T0, &gain_pit, &L_gain_code, bfi, st->prev_bfi, st->state,
+                    unusable_frame, st->vad_hist, st->dec_gain, st->lag_hist, &(st->old_T0));
 
         /* find best scaling to perform on excitation (Q_new) */
 
@@ -713,14 +634,6 @@ void decoder(
         test();
         if (bfi == 0)
         {
-            /* LTP-Lag history update */
-            for (i = 4; i > 0; i--)
-            {
-                st->lag_hist[i] = st->lag_hist[i - 1];  move16();
-            }
-            st->lag_hist[0] = T0;          move16();
-
-            st->old_T0 = T0;               move16();
             st->old_T0_frac = 0;           move16();  /* Remove fraction in case of BFI */
         }
         /* find voice factor in Q15 (1=voiced, -1=unvoiced) */
@@ -916,9 +829,17 @@ void decoder(
             Set_zero(st->mem_syn_hf, M16k - M);
         }
 
+        test();
         if (sub(nb_bits, NBBITS_24k) >= 0)
         {
             corr_gain = Serial_parm(4, &prms);
+        }
+        test();
+        if (st->trans != NULL)
+        {
+            synthesis_12k8(p_Aq, exc2, Q_new, &(st->trans->speech[i_subfr]), st);
+        } else if (sub(nb_bits, NBBITS_24k) >= 0)
+        {
             synthesis(p_Aq, exc2, Q_new, &synth16k[i_subfr * 5 / 4], corr_gain, HfIsf, nb_bits, newDTXState, st, bfi);
         } else
             synthesis(p_Aq, exc2, Q_new, &synth16k[i_subfr * 5 / 4], 0, HfIsf, nb_bits, newDTXState, st, bfi);
@@ -934,10 +855,21 @@ void decoder(
 
     Copy(&old_exc[L_FRAME], st->old_exc, PIT_MAX + L_INTERPOL);
 
+    test();
+    if (st->trans != NULL)
+    {
+        /* memories of the far-end decoder of a frame passed through */
+        Copy(st->old_exc, st->trans->old_exc, PIT_MAX + L_INTERPOL);
+        st->trans->Q_exc = st->Q_old;      move16();
+        Copy(st->past_isfq, st->trans->past_isfq, M);
+        Copy(st->dec_gain, st->trans->past_qua_en, 4);
+        st->trans->tilt_code = st->tilt_code;   move16();
+    }
+
     Scale_sig(exc, L_FRAME, sub(0, Q_new));
-    dtx_dec_activity_update(st->dtx_decSt, isf, exc);
+    dtx_dec_activity_update(&(st->dtx_decSt), isf, exc);
 
-    st->dtx_decSt->dtxGlobalState = newDTXState;        move16();
+    st->dtx_decSt.dtxGlobalState = newDTXState;        move16();
 
     st->prev_bfi = bfi;                    move16();
 
@@ -946,6 +878,46 @@ void decoder(
 
 
 
+/*-----------------------------------------------------*
+ * Function synthesis_12k8()                           *
+ *                                                     *
+ * Synthesis at 12.8kHz before deemphasis (transrating)*
+ * in the scale of the encoder speech[] (x 0.5).       *
+ *-----------------------------------------------------*/
+
+static void synthesis_12k8(
+     Word16 Aq[],                          /* A(z)  : quantized Az               */
+     Word16 exc[],                         /* (i)   : excitation at 12kHz        */
+     Word16 Q_new,                         /* (i)   : scaling performed on exc   */
+     Word16 speech[],                      /* (o)   : synthesis before deemphasis*/
+     Decoder_State * st                    /* (i/o) : State structure            */
+)
+{
+    Word16 i;
+    Word32 L_tmp;
+    Word16 synth_hi[M + L_SUBFR], synth_lo[M + L_SUBFR];
+
+    Copy(st->mem_syn_hi, synth_hi, M);
+    Copy(st->mem_syn_lo, synth_lo, M);
+
+    Syn_filt_32(Aq, M, exc, Q_new, synth_hi + M, synth_lo + M, L_SUBFR);
+
+    Copy(synth_hi + L_SUBFR, st->mem_syn_hi, M);
+    Copy(synth_lo + L_SUBFR, st->mem_syn_lo, M);
+
+    /* hi<<16 + lo<<4 = synthesis x 4096 (see Deemph_32) */
+    for (i = 0; i < L_SUBFR; i++)
+    {
+        L_tmp = L_deposit_h(synth_hi[i + M]);
+        L_tmp = L_mac(L_tmp, synth_lo[i + M], 8);
+        speech[i] = round(L_shl(L_tmp, 3));     /* saturation can occur here */
+        move16();
+    }
+
+    return;
+}
+
+
 /*-----------------------------------------------------*
  * Function synthesis()                                *
  *                                                     *
@@ -1002,6 +974,12 @@ static void synthesis(
 
     Oversamp_16k(synth, L_SUBFR, synth16k, st->mem_oversamp);
 
+    test();
+    if (st->hf_bypass != 0)
+    {
+        return;
+    }
+
     /*------------------------------------------------------*
     * HF noise synthesis                                   *
     * ~~~~~~~~~~~~~~~~~~                                   *
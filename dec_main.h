@@ -6,41 +6,63 @@
 
 #include "cnst.h"                          /* coder constant parameters */
 #include "dtx.h"
+#include "transrate.h"
+
+/*--------------------------------------------------------------------------*
+ * The fields are grouped by the part of decoder() that uses them, in the   *
+ * order of processing: frame control, ISF and excitation, the per-sample   *
+ * synthesis filters, then what only some frames use (23.85k HF filter,     *
+ * comfort noise, concealment). The DTX state is part of the structure:     *
+ * one memory block per channel.                                            *
+ *--------------------------------------------------------------------------*/
 
 typedef struct
 {
-    Word16 old_exc[PIT_MAX + L_INTERPOL];  /* old excitation vector */
+    /* frame control: every frame */
+    Word16 prev_bfi;
+    Word16 state;
+    Word16 first_frame;
+    Word16 vad_hist;
+    Word16 hf_bypass;                      /* no HF generation (output band 0..6.4kHz) */
+    Word16 cng_skip;                       /* no comfort noise synthesis (output zero) */
+    Trans_Parm *trans;                     /* transrating: decoded frame, no synthesis */
+
+    /* ISF, excitation, gains: speech frames */
     Word16 ispold[M];                      /* old isp (immittance spectral pairs) */
     Word16 isfold[M];                      /* old isf (frequency domain) */
-    Word16 isf_buf[L_MEANBUF * M];         /* isf buffer(frequency domain) */
     Word16 past_isfq[M];                   /* past isf quantizer */
+    Word16 isf_buf[L_MEANBUF * M];         /* isf buffer(frequency domain) */
+    Word16 old_exc[PIT_MAX + L_INTERPOL];  /* old excitation vector */
+    Word16 old_T0;                         /* old pitch lag */
+    Word16 old_T0_frac;                    /* old pitch fraction lag */
+    Word16 lag_hist[5];
     Word16 tilt_code;                      /* tilt of code */
+    Word16 dec_gain[23];                   /* gain decoder memory */
     Word16 Q_old;                          /* old scaling factor */
     Word16 Qsubfr[4];                      /* old maximum scaling factor */
+    Word16 disp_mem[8];                    /* phase dispersion memory */
     Word32 L_gc_thres;                     /* threshold for noise enhancer */
+
+    /* synthesis filters: every subframe */
     Word16 mem_syn_hi[M];                  /* modified synthesis memory (MSB) */
     Word16 mem_syn_lo[M];                  /* modified synthesis memory (LSB) */
     Word16 mem_deemph;                     /* speech deemph filter memory */
     Word16 mem_sig_out[6];                 /* hp50 filter memory for synthesis */
     Word16 mem_oversamp[2 * L_FILT];       /* synthesis oversampled filter memory */
+    Word16 seed2;                          /* random memory for HF generation */
+    Word16 mem_hp400[6];                   /* hp400 filter memory for synthesis */
     Word16 mem_syn_hf[M16k];               /* HF synthesis memory */
     Word16 mem_hf[2 * L_FILT16k];          /* HF band-pass filter memory */
-    Word16 mem_hf2[2 * L_FILT16k];         /* HF band-pass filter memory */
+
+    /* 23.85k only */
     Word16 mem_hf3[2 * L_FILT16k];         /* HF band-pass filter memory */
+
+    /* frame erasure, comfort noise */
     Word16 seed;                           /* random memory for frame erasure */
-    Word16 seed2;                          /* random memory for HF generation */
-    Word16 old_T0;                         /* old pitch lag */
-    Word16 old_T0_frac;                    /* old pitch fraction lag */
-    Word16 lag_hist[5];
-    Word16 dec_gain[23];                   /* gain decoder memory */
     Word16 seed3;                          /* random memory for lag concealment */
-    Word16 disp_mem[8];                    /* phase dispersion memory */
-    Word16 mem_hp400[6];                   /* hp400 filter memory for synthesis */
-
-    Word16 prev_bfi;
-    Word16 state;
-    Word16 first_frame;
-    dtx_decState *dtx_decSt;
-    Word16 vad_hist;
+    Word16 cn_valid;                       /* cn_Aq[] is valid */
+    Word16 cn_isf[M];                      /* isf of the cached comfort noise filter */
+    Word16 cn_Aq[M + 1];                   /* comfort noise filter A(z) of cn_isf[] */
+    dtx_decState dtx_decSt;                /* DTX state */
 
 } Decoder_State;
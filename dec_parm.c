@@ -0,0 +1,553 @@
+/*------------------------------------------------------------------------*
+ *                         DEC_PARM.C                                     *
+ *------------------------------------------------------------------------*
+ * Parameter extraction without synthesis                                 *
+ *------------------------------------------------------------------------*/
+
+/*___________________________________________________________________________
+ |                                                                           |
+ | Fixed-point C simulation of AMR WB ACELP coding algorithm with 20 ms      |
+ | speech frames for wideband speech signals.                                |
+ |___________________________________________________________________________|
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "cnst.h"
+#include "acelp.h"
+#include "dec_parm.h"
+#include "bits.h"
+#include "count.h"
+#include "rom_tab.h"
+
+/*-----------------------------------------------------------------*
+ * The parameter path of decoder() (dec_main.c) for analytics:     *
+ * ISFs, pitch lags, gains and VAD flag of each frame are decoded  *
+ * by the same functions (D_frame_state() to D_gain_parm() below,  *
+ * also called by decoder()), but no excitation and no synthesis   *
+ * is computed.                                                    *
+ *                                                                 *
+ * The ISFs, pitch lags and pitch gains are those of decoder().    *
+ * The algebraic code is not decoded: D_gain2() is given a code    *
+ * of unit energy, so that the code gain is the rms of the         *
+ * innovative excitation (gain x code of decoder(), before the     *
+ * noise enhancer). The gain predictor does not depend on code[].  *
+ *-----------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_dec_parm                                        *
+ *            ~~~~~~~~~~~~~                                        *
+ *   ->Initialization of the parameter decoder.                    *
+ *-----------------------------------------------------------------*/
+
+void Init_dec_parm(Parm_State ** state)
+{
+    Parm_State *st;
+
+    *state = NULL;
+
+    test();
+    if ((st = (Parm_State *) malloc(sizeof(Parm_State))) == NULL)
+    {
+        printf("Can not malloc Parm_State structure!\n");
+        return;
+    }
+    st->dtx_decSt = NULL;
+    dtx_dec_init(&st->dtx_decSt, isf_init);
+
+    Reset_dec_parm(st, 1);
+
+    *state = st;
+
+    return;
+}
+
+void Reset_dec_parm(Parm_State * st, Word16 reset_all)
+{
+    Word16 i;
+
+    Set_zero(st->past_isfq, M);
+
+    st->old_T0 = 64;                       move16();
+
+    if (reset_all != 0)
+    {
+        Init_D_gain2(st->dec_gain);
+        Init_Lagconc(st->lag_hist);
+
+        Copy(isf_init, st->isfold, M);
+        for (i = 0; i < L_MEANBUF; i++)
+            Copy(isf_init, &st->isf_buf[i * M], M);
+
+        st->seed3 = 21845;                 move16();
+
+        st->state = 0;                     move16();
+        st->prev_bfi = 0;                  move16();
+
+        dtx_dec_reset(st->dtx_decSt, isf_init);
+        st->vad_hist = 0;                  move16();
+    }
+    return;
+}
+
+void Close_dec_parm(Parm_State * st)
+{
+    dtx_dec_exit(&st->dtx_decSt);
+    free(st);
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ * Parameter decoding shared by decoder() and dec_parm(): each     *
+ * caller passes its own memories.                                 *
+ *-----------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------*
+ *   Funtion  D_frame_state                                        *
+ *            ~~~~~~~~~~~~~                                        *
+ *   ->Bad frame indicators of the received frame type, BFH state  *
+ *     machine and VAD flag of a speech frame. Returns the bfi.    *
+ *-----------------------------------------------------------------*/
+
+Word16 D_frame_state(                      /* Return the bad frame indicator         */
+     Word16 frame_type,                    /* (i)   : received frame type            */
+     Word16 newDTXState,                   /* (i)   : SPEECH, DTX or DTX_MUTE        */
+     Word16 ** prms,                       /* (i/o) : parameter vector               */
+     Word16 * unusable_frame,              /* (o)   : bits not usable                */
+     Word16 * vad_flag,                    /* (o)   : VAD flag (speech frames only)  */
+     Word16 * state,                       /* (i/o) : state of BFH                   */
+     Word16 * prev_bfi,                    /* (i/o) : previous BF indicator          */
+     Word16 * vad_hist,                    /* (i/o) : number of non-speech frames    */
+     dtx_decState * dtx_decSt              /* (i/o) : DTX state                      */
+)
+{
+    Word16 bfi;
+
+    /* SPEECH action state machine  */
+    test();test();
+    if ((sub(frame_type, RX_SPEECH_BAD) == 0) ||
+        (sub(frame_type, RX_SPEECH_PROBABLY_DEGRADED) == 0))
+    {
+        /* bfi only for lsf, gains and pitch period */
+        bfi = 1;                           move16();
+        *unusable_frame = 0;               move16();
+    } else if ((sub(frame_type, RX_NO_DATA) == 0) ||
+               (sub(frame_type, RX_SPEECH_LOST) == 0))
+    {
+        /* bfi for all index, bits are not usable */
+        bfi = 1;                           move16();
+        *unusable_frame = 1;               move16();
+    } else
+    {
+        bfi = 0;                           move16();
+        *unusable_frame = 0;               move16();
+    }
+    test();
+    if (bfi != 0)
+    {
+        *state = add(*state, 1);           move16();
+        test();
+        if (sub(*state, 6) > 0)
+        {
+            *state = 6;                    move16();
+        }
+    } else
+    {
+        *state = shr(*state, 1);           move16();
+    }
+
+    /* If this frame is the first speech frame after CNI period,     */
+    /* set the BFH state machine to an appropriate state depending   */
+    /* on whether there was DTX muting before start of speech or not */
+    /* If there was DTX muting, the first speech frame is muted.     */
+    /* If there was no DTX muting, the first speech frame is not     */
+    /* muted. The BFH state machine starts from state 5, however, to */
+    /* keep the audible noise resulting from a SID frame which is    */
+    /* erroneously interpreted as a good speech frame as small as    */
+    /* possible (the decoder output in this case is quickly muted)   */
+    test();test();
+    if (sub(dtx_decSt->dtxGlobalState, DTX) == 0)
+    {
+        *state = 5;                        move16();
+        *prev_bfi = 0;                     move16();
+    } else if (sub(dtx_decSt->dtxGlobalState, DTX_MUTE) == 0)
+    {
+        *state = 5;                        move16();
+        *prev_bfi = 1;                     move16();
+    }
+    test();
+    if (sub(newDTXState, SPEECH) == 0)
+    {
+        *vad_flag = Serial_parm(1, prms);
+        test();
+        if (bfi == 0)
+        {
+            test();
+            if (*vad_flag == 0)
+            {
+                *vad_hist = add(*vad_hist, 1);  move16();
+                dtx_decSt->dtx_vad_hist = add(dtx_decSt->dtx_vad_hist, 1);    move16();
+            } else
+            {
+                *vad_hist = 0;             move16();
+                dtx_decSt->dtx_vad_hist = 0;    move16();
+            }
+        }
+        else if (dtx_decSt->dtx_vad_hist > 0)
+        {
+            dtx_decSt->dtx_vad_hist = add(dtx_decSt->dtx_vad_hist, 1);    move16();
+        }
+    }
+    return bfi;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  D_isf_parm                                           *
+ *            ~~~~~~~~~~                                           *
+ *   ->Decodes the ISFs of a speech frame (36 or 46 bits).         *
+ *-----------------------------------------------------------------*/
+
+void D_isf_parm(
+     Word16 nb_bits,                       /* (i)   : number of bits of the mode     */
+     Word16 ** prms,                       /* (i/o) : parameter vector               */
+     Word16 isf[],                         /* (o)   : quantized ISFs at 4th subframe */
+     Word16 past_isfq[],                   /* (i/o) : past isf quantizer             */
+     Word16 isfold[],                      /* (i)   : past quantized ISFs            */
+     Word16 isf_buf[],                     /* (i/o) : isf buffer                     */
+     Word16 bfi                            /* (i)   : bad frame indicator            */
+)
+{
+    Word16 ind[7];
+
+    test();
+    if (sub(nb_bits, NBBITS_7k) <= 0)
+    {
+        ind[0] = Serial_parm(8, prms);     move16();
+        ind[1] = Serial_parm(8, prms);     move16();
+        ind[2] = Serial_parm(7, prms);     move16();
+        ind[3] = Serial_parm(7, prms);     move16();
+        ind[4] = Serial_parm(6, prms);     move16();
+
+        Dpisf_2s_36b(ind, isf, past_isfq, isfold, isf_buf, bfi, 1);
+    } else
+    {
+        ind[0] = Serial_parm(8, prms);     move16();
+        ind[1] = Serial_parm(8, prms);     move16();
+        ind[2] = Serial_parm(6, prms);     move16();
+        ind[3] = Serial_parm(7, prms);     move16();
+        ind[4] = Serial_parm(7, prms);     move16();
+        ind[5] = Serial_parm(5, prms);     move16();
+        ind[6] = Serial_parm(5, prms);     move16();
+
+        Dpisf_2s_46b(ind, isf, past_isfq, isfold, isf_buf, bfi, 1);
+    }
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  D_pitch_lag                                          *
+ *            ~~~~~~~~~~~                                          *
+ *   ->Decodes the pitch lag of a subframe. Lag indices are read   *
+ *     also in case of BFI, so that the parameter pointer stays in *
+ *     sync; the lag is then concealed.                            *
+ *-----------------------------------------------------------------*/
+
+void D_pitch_lag(
+     Word16 nb_bits,                       /* (i)   : number of bits of the mode     */
+     Word16 i_subfr,                       /* (i)   : subframe position              */
+     Word16 ** prms,                       /* (i/o) : parameter vector               */
+     Word16 bfi,                           /* (i)   : bad frame indicator            */
+     Word16 unusable_frame,                /* (i)   : UF indicator                   */
+     Word16 * lag,                         /* (o)   : integer pitch lag              */
+     Word16 * lag_frac,                    /* (o)   : fraction of pitch lag          */
+     Word16 * lag_min,                     /* (i/o) : T0_min of subframe 2 and 4     */
+     Word16 gain_hist[],                   /* (i)   : gain history (dec_gain[17])    */
+     Word16 lag_hist[],                    /* (i/o) : lag history                    */
+     Word16 * old_T0,                      /* (i/o) : old pitch lag                  */
+     Word16 * seed3                        /* (i/o) : random memory for concealment  */
+)
+{
+    Word16 index, pit_flag, T0, T0_frac, T0_min, T0_max;
+
+    T0_min = *lag_min;                     move16();
+    pit_flag = i_subfr;                    move16();
+
+    test();test();
+    if ((sub(i_subfr, 2 * L_SUBFR) == 0) && (sub(nb_bits, NBBITS_7k) > 0))
+    {
+        pit_flag = 0;                      move16();
+    }
+    test();
+    if (pit_flag == 0)
+    {
+        test();
+        if (sub(nb_bits, NBBITS_9k) <= 0)
+        {
+            index = Serial_parm(8, prms);
+            test();
+            if (sub(index, (PIT_FR1_8b - PIT_MIN) * 2) < 0)
+            {
+                T0 = add(PIT_MIN, shr(index, 1));
+                T0_frac = sub(index, shl(sub(T0, PIT_MIN), 1));
+                T0_frac = shl(T0_frac, 1);
+            } else
+            {
+                T0 = add(index, PIT_FR1_8b - ((PIT_FR1_8b - PIT_MIN) * 2));
+                T0_frac = 0;               move16();
+            }
+        } else
+        {
+            index = Serial_parm(9, prms);
+            test();test();
+            if (sub(index, (PIT_FR2 - PIT_MIN) * 4) < 0)
+            {
+                T0 = add(PIT_MIN, shr(index, 2));
+                T0_frac = sub(index, shl(sub(T0, PIT_MIN), 2));
+            } else if (sub(index, (((PIT_FR2 - PIT_MIN) * 4) + ((PIT_FR1_9b - PIT_FR2) * 2))) < 0)
+            {
+                index = sub(index, (PIT_FR2 - PIT_MIN) * 4);
+                T0 = add(PIT_FR2, shr(index, 1));
+                T0_frac = sub(index, shl(sub(T0, PIT_FR2), 1));
+                T0_frac = shl(T0_frac, 1);
+            } else
+            {
+                T0 = add(index, (PIT_FR1_9b - ((PIT_FR2 - PIT_MIN) * 4) - ((PIT_FR1_9b - PIT_FR2) * 2)));
+                T0_frac = 0;               move16();
+            }
+        }
+
+        /* find T0_min and T0_max for subframe 2 and 4 */
+
+        T0_min = sub(T0, 8);
+        test();
+        if (sub(T0_min, PIT_MIN) < 0)
+        {
+            T0_min = PIT_MIN;              move16();
+        }
+        T0_max = add(T0_min, 15);
+        test();
+        if (sub(T0_max, PIT_MAX) > 0)
+        {
+            T0_max = PIT_MAX;              move16();
+            T0_min = sub(T0_max, 15);
+        }
+    } else
+    {                                      /* if subframe 2 or 4 */
+        test();
+        if (sub(nb_bits, NBBITS_9k) <= 0)
+        {
+            index = Serial_parm(5, prms);
+
+            T0 = add(T0_min, shr(index, 1));
+            T0_frac = sub(index, shl(sub(T0, T0_min), 1));
+            T0_frac = shl(T0_frac, 1);
+        } else
+        {
+            index = Serial_parm(6, prms);
+
+            T0 = add(T0_min, shr(index, 2));
+            T0_frac = sub(index, shl(sub(T0, T0_min), 2));
+        }
+    }
+
+    /* check BFI after pitch lag decoding */
+    test();
+    if (bfi != 0)                          /* if frame erasure */
+    {
+        lagconc(gain_hist, lag_hist, &T0, old_T0, seed3, unusable_frame);
+        T0_frac = 0;                       move16();
+    }
+    *lag = T0;                             move16();
+    *lag_frac = T0_frac;                   move16();
+    *lag_min = T0_min;                     move16();
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  D_gain_parm                                          *
+ *            ~~~~~~~~~~~                                          *
+ *   ->Decodes the pitch and code gains of a subframe (6 or 7 bit  *
+ *     index) and, for a good frame, updates the lag history used  *
+ *     by the lag concealment.                                     *
+ *-----------------------------------------------------------------*/
+
+void D_gain_parm(
+     Word16 nb_bits,                       /* (i)   : number of bits of the mode     */
+     Word16 ** prms,                       /* (i/o) : parameter vector               */
+     Word16 code[],                        /* (i) Q9: innovative vector              */
+     Word16 T0,                            /* (i)   : integer pitch lag              */
+     Word16 * gain_pit,                    /* (o) Q14: pitch gain                    */
+     Word32 * L_gain_code,                 /* (o) Q16: code gain                     */
+     Word16 bfi,                           /* (i)   : bad frame indicator            */
+     Word16 prev_bfi,                      /* (i)   : previous BF indicator          */
+     Word16 state,                         /* (i)   : state of BFH                   */
+     Word16 unusable_frame,                /* (i)   : UF indicator                   */
+     Word16 vad_hist,                      /* (i)   : number of non-speech frames    */
+     Word16 dec_gain[],                    /* (i/o) : gain decoder memory            */
+     Word16 lag_hist[],                    /* (i/o) : lag history                    */
+     Word16 * old_T0                       /* (o)   : old pitch lag                  */
+)
+{
+    Word16 i, index;
+
+    test();
+    if (sub(nb_bits, NBBITS_9k) <= 0)
+    {
+        index = Serial_parm(6, prms);      /* codebook gain index */
+
+        D_gain2(index, 6, code, L_SUBFR, gain_pit, L_gain_code, bfi, prev_bfi, state, unusable_frame, vad_hist, dec_gain);
+    } else
+    {
+        index = Serial_parm(7, prms);      /* codebook gain index */
+
+        D_gain2(index, 7, code, L_SUBFR, gain_pit, L_gain_code, bfi, prev_bfi, state, unusable_frame, vad_hist, dec_gain);
+    }
+
+    test();
+    if (bfi == 0)
+    {
+        /* LTP-Lag history update */
+        for (i = 4; i > 0; i--)
+        {
+            lag_hist[i] = lag_hist[i - 1]; move16();
+        }
+        lag_hist[0] = T0;                  move16();
+
+        *old_T0 = T0;                      move16();
+    }
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion dec_parm                                              *
+ *           ~~~~~~~~                                              *
+ *   ->Decodes the parameters of one frame (see decoder()).        *
+ *-----------------------------------------------------------------*/
+
+void dec_parm(
+     Word16 mode,                          /* input : used mode                     */
+     Word16 prms[],                        /* input : parameter vector              */
+     Dec_Parm * parm,                      /* output: decoded parameters            */
+     Parm_State * st,                      /* i/o   : State structure               */
+     Word16 frame_type                     /* input : received frame type           */
+)
+{
+    Word16 isf[M];                         /* ISF (frequency domain) at 4nd sfr    */
+    Word16 code[L_SUBFR];                  /* unit energy code (1.0 in Q9)         */
+    Word16 exc2[L_FRAME];                  /* CN excitation / frame energy         */
+
+    Word16 i, i_subfr;
+    Word16 T0, T0_frac, T0_min = 0;
+    Word16 gain_pit;
+    Word32 L_gain_code;
+    Word16 newDTXState, bfi, unusable_frame, nb_bits;
+    Word16 vad_flag = 0;                   /* 0 in comfort noise */
+
+    nb_bits = nb_of_bits[mode];            move16();
+
+    parm->frame_type = frame_type;         move16();
+    parm->mode = mode;                     move16();
+
+    /* find the new  DTX state  SPEECH OR DTX */
+    newDTXState = rx_dtx_handler(st->dtx_decSt, frame_type);
+
+    test();
+    if (sub(newDTXState, SPEECH) != 0)
+    {
+        dtx_dec(st->dtx_decSt, exc2, newDTXState, isf, &prms);
+    }
+    bfi = D_frame_state(frame_type, newDTXState, &prms, &unusable_frame, &vad_flag,
+                        &(st->state), &(st->prev_bfi), &(st->vad_hist), st->dtx_decSt);
+
+    parm->dtx_state = newDTXState;         move16();
+    parm->bfi = bfi;                       move16();
+    parm->vad = vad_flag;                  move16();
+    for (i = 0; i < NB_SUBFR; i++)
+    {
+        parm->T0[i] = 0;                   move16();
+        parm->T0_frac[i] = 0;              move16();
+        parm->gain_pit[i] = 0;             move16();
+        parm->gain_code[i] = 0;            move32();
+        parm->hf_gain[i] = -1;             move16();
+    }
+
+    /*----------------------------------------------------------------------*
+     *                              DTX-CNG                                 *
+     *----------------------------------------------------------------------*/
+    test();
+    if (sub(newDTXState, SPEECH) != 0)     /* CNG mode */
+    {
+        Copy(isf, parm->isf, M);
+
+        /* reset speech coder memories */
+        Reset_dec_parm(st, 0);
+
+        Copy(isf, st->isfold, M);
+
+        st->prev_bfi = bfi;                move16();
+        st->dtx_decSt->dtxGlobalState = newDTXState;    move16();
+
+        return;
+    }
+    /*----------------------------------------------------------------------*
+     *                               ACELP                                  *
+     *----------------------------------------------------------------------*/
+
+    /* Decode the ISFs */
+    D_isf_parm(nb_bits, &prms, isf, st->past_isfq, st->isfold, st->isf_buf, bfi);
+
+    Copy(isf, st->isfold, M);
+    Copy(isf, parm->isf, M);
+
+    for (i = 0; i < L_SUBFR; i++)
+    {
+        code[i] = 512;                     move16();
+    }
+
+    for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+    {
+        D_pitch_lag(nb_bits, i_subfr, &prms, bfi, unusable_frame, &T0, &T0_frac, &T0_min,
+                    &(st->dec_gain[17]), st->lag_hist, &(st->old_T0), &(st->seed3));
+
+        /* LP filter selection bit (not used) */
+        test();test();
+        if ((unusable_frame == 0) && (sub(nb_bits, NBBITS_9k) > 0))
+        {
+            Serial_parm(1, &prms);
+        }
+        /* innovative codebook indices skipped (unit code[], see above) */
+        test();
+        if (unusable_frame == 0)
+        {
+            prms += nb_of_cb_bits[mode];   move16();
+        }
+        /* codebooks gains */
+        D_gain_parm(nb_bits, &prms, code, T0, &gain_pit, &L_gain_code, bfi, st->prev_bfi, st->state,
+                    unusable_frame, st->vad_hist, st->dec_gain, st->lag_hist, &(st->old_T0));
+
+        test();
+        if (sub(nb_bits, NBBITS_24k) >= 0)
+        {
+            parm->hf_gain[i_subfr / L_SUBFR] = Serial_parm(4, &prms);   move16();
+        }
+        parm->T0[i_subfr / L_SUBFR] = T0;  move16();
+        parm->T0_frac[i_subfr / L_SUBFR] = T0_frac;     move16();
+        parm->gain_pit[i_subfr / L_SUBFR] = gain_pit;   move16();
+        parm->gain_code[i_subfr / L_SUBFR] = L_gain_code;       move32();
+    }
+
+    /* no excitation: only the ISF history is kept for the comfort noise ISFs */
+    Set_zero(exc2, L_FRAME);
+    dtx_dec_activity_update(st->dtx_decSt, isf, exc2);
+
+    st->dtx_decSt->dtxGlobalState = newDTXState;        move16();
+
+    st->prev_bfi = bfi;                    move16();
+
+    return;
+}
@@ -0,0 +1,115 @@
+/*--------------------------------------------------------------------------*
+ *                         DEC_PARM.H                                       *
+ *--------------------------------------------------------------------------*
+ *       Parameter extraction without synthesis (analytics)                 *
+ *--------------------------------------------------------------------------*/
+
+#ifndef dec_parm_h
+#define dec_parm_h
+
+#include "typedef.h"
+#include "cnst.h"                          /* coder constant parameters */
+#include "dtx.h"
+
+/* decoded parameters of one frame */
+
+typedef struct
+{
+    Word16 frame_type;                     /* received frame type (RX_xxx)           */
+    Word16 mode;                           /* used mode                              */
+    Word16 dtx_state;                      /* SPEECH, DTX or DTX_MUTE                */
+    Word16 bfi;                            /* bad frame indicator                    */
+    Word16 vad;                            /* VAD flag (0 in comfort noise)          */
+    Word16 isf[M];                         /* ISF at 4th subframe (Q15 of 6400 Hz)   */
+    Word16 T0[NB_SUBFR];                   /* closed-loop pitch lag (integer part)   */
+    Word16 T0_frac[NB_SUBFR];              /* fraction of pitch lag (1/4 samples)    */
+    Word16 gain_pit[NB_SUBFR];             /* pitch gain (Q14)                       */
+    Word32 gain_code[NB_SUBFR];            /* rms of the innovative excitation (Q16) */
+    Word16 hf_gain[NB_SUBFR];              /* HF gain index (23.85 kbit/s, else -1)  */
+} Dec_Parm;
+
+/* decoder memories that carry parameters from frame to frame */
+
+typedef struct
+{
+    Word16 isfold[M];                      /* old isf (frequency domain) */
+    Word16 isf_buf[L_MEANBUF * M];         /* isf buffer(frequency domain) */
+    Word16 past_isfq[M];                   /* past isf quantizer */
+    Word16 old_T0;                         /* old pitch lag */
+    Word16 lag_hist[5];
+    Word16 dec_gain[23];                   /* gain decoder memory */
+    Word16 seed3;                          /* random memory for lag concealment */
+
+    Word16 prev_bfi;
+    Word16 state;
+    dtx_decState *dtx_decSt;
+    Word16 vad_hist;
+
+} Parm_State;
+
+/* parameter decoding shared with decoder() (dec_main.c) */
+
+Word16 D_frame_state(                      /* Return the bad frame indicator         */
+     Word16 frame_type,                    /* (i)   : received frame type            */
+     Word16 newDTXState,                   /* (i)   : SPEECH, DTX or DTX_MUTE        */
+     Word16 ** prms,                       /* (i/o) : parameter vector               */
+     Word16 * unusable_frame,              /* (o)   : bits not usable                */
+     Word16 * vad_flag,                    /* (o)   : VAD flag (speech frames only)  */
+     Word16 * state,                       /* (i/o) : state of BFH                   */
+     Word16 * prev_bfi,                    /* (i/o) : previous BF indicator          */
+     Word16 * vad_hist,                    /* (i/o) : number of non-speech frames    */
+     dtx_decState * dtx_decSt              /* (i/o) : DTX state                      */
+);
+void D_isf_parm(
+     Word16 nb_bits,                       /* (i)   : number of bits of the mode     */
+     Word16 ** prms,                       /* (i/o) : parameter vector               */
+     Word16 isf[],                         /* (o)   : quantized ISFs at 4th subframe */
+     Word16 past_isfq[],                   /* (i/o) : past isf quantizer             */
+     Word16 isfold[],                      /* (i)   : past quantized ISFs            */
+     Word16 isf_buf[],                     /* (i/o) : isf buffer                     */
+     Word16 bfi                            /* (i)   : bad frame indicator            */
+);
+void D_pitch_lag(
+     Word16 nb_bits,                       /* (i)   : number of bits of the mode     */
+     Word16 i_subfr,                       /* (i)   : subframe position              */
+     Word16 ** prms,                       /* (i/o) : parameter vector               */
+     Word16 bfi,                           /* (i)   : bad frame indicator            */
+     Word16 unusable_frame,                /* (i)   : UF indicator                   */
+     Word16 * lag,                         /* (o)   : integer pitch lag              */
+     Word16 * lag_frac,                    /* (o)   : fraction of pitch lag          */
+     Word16 * lag_min,                     /* (i/o) : T0_min of subframe 2 and 4     */
+     Word16 gain_hist[],                   /* (i)   : gain history (dec_gain[17])    */
+     Word16 lag_hist[],                    /* (i/o) : lag history                    */
+     Word16 * old_T0,                      /* (i/o) : old pitch lag                  */
+     Word16 * seed3                        /* (i/o) : random memory for concealment  */
+);
+void D_gain_parm(
+     Word16 nb_bits,                       /* (i)   : number of bits of the mode     */
+     Word16 ** prms,                       /* (i/o) : parameter vector               */
+     Word16 code[],                        /* (i) Q9: innovative vector              */
+     Word16 T0,                            /* (i)   : integer pitch lag              */
+     Word16 * gain_pit,                    /* (o) Q14: pitch gain                    */
+     Word32 * L_gain_code,                 /* (o) Q16: code gain                     */
+     Word16 bfi,                           /* (i)   : bad frame indicator            */
+     Word16 prev_bfi,                      /* (i)   : previous BF indicator          */
+     Word16 state,                         /* (i)   : state of BFH                   */
+     Word16 unusable_frame,                /* (i)   : UF indicator                   */
+     Word16 vad_hist,                      /* (i)   : number of non-speech frames    */
+     Word16 dec_gain[],                    /* (i/o) : gain decoder memory            */
+     Word16 lag_hist[],                    /* (i/o) : lag history                    */
+     Word16 * old_T0                       /* (o)   : old pitch lag                  */
+);
+
+void Init_dec_parm(Parm_State ** st);
+void Reset_dec_parm(Parm_State * st, Word16 reset_all);
+void Close_dec_parm(Parm_State * st);
+
+void dec_parm(
+     Word16 mode,                          /* input : used mode                     */
+     Word16 prms[],                        /* input : parameter vector              */
+     Dec_Parm * parm,                      /* output: decoded parameters            */
+     Parm_State * st,                      /* i/o   : State structure               */
+     Word16 frame_type                     /* input : received frame type           */
+);
+
+#endif
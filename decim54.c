@@ -10,6 +10,7 @@
 #include "acelp.h"
 #include "count.h"
 #include "cnst.h"
+#include "rom_tab.h"
 
 #define FAC4   4
 #define FAC5   5
@@ -33,80 +34,11 @@ static void Up_samp(
 );
 static Word16 Interpol(                    /* return result of interpolation */
      Word16 * x,                           /* input vector                   */
-     Word16 * fir,                         /* filter coefficient             */
-     Word16 frac,                          /* fraction (0..resol)            */
-     Word16 resol,                         /* resolution                     */
+     const Word16 fir[],                   /* filter of the fraction         */
      Word16 nb_coef                        /* number of coefficients         */
 );
 
 
-/* 1/5 resolution interpolation filter  (in Q14)  */
-/* -1.5dB @ 6kHz, -6dB @ 6.4kHz, -10dB @ 6.6kHz, -20dB @ 6.9kHz, -25dB @ 7kHz, -55dB @ 8kHz */
-
-static Word16 fir_up[120] =
-{
-    -1, -4, -7, -6, 0,
-    12, 24, 30, 23, 0,
-    -33, -62, -73, -52, 0,
-    68, 124, 139, 96, 0,
-    -119, -213, -235, -160, 0,
-    191, 338, 368, 247, 0,
-    -291, -510, -552, -369, 0,
-    430, 752, 812, 542, 0,
-    -634, -1111, -1204, -809, 0,
-    963, 1708, 1881, 1288, 0,
-    -1616, -2974, -3432, -2496, 0,
-    3792, 8219, 12368, 15317, 16384,
-    15317, 12368, 8219, 3792, 0,
-    -2496, -3432, -2974, -1616, 0,
-    1288, 1881, 1708, 963, 0,
-    -809, -1204, -1111, -634, 0,
-    542, 812, 752, 430, 0,
-    -369, -552, -510, -291, 0,
-    247, 368, 338, 191, 0,
-    -160, -235, -213, -119, 0,
-    96, 139, 124, 68, 0,
-    -52, -73, -62, -33, 0,
-    23, 30, 24, 12, 0,
-    -6, -7, -4, -1, 0
-};
-
-static Word16 fir_down[120] =
-{            /* table x4/5 */
-    -1, -3, -6, -5,
-    0, 9, 19, 24,
-    18, 0, -26, -50,
-    -58, -41, 0, 54,
-    99, 111, 77, 0,
-    -95, -170, -188, -128,
-    0, 153, 270, 294,
-    198, 0, -233, -408,
-    -441, -295, 0, 344,
-    601, 649, 434, 0,
-    -507, -888, -964, -647,
-    0, 770, 1366, 1505,
-    1030, 0, -1293, -2379,
-    -2746, -1997, 0, 3034,
-    6575, 9894, 12254, 13107,
-    12254, 9894, 6575, 3034,
-    0, -1997, -2746, -2379,
-    -1293, 0, 1030, 1505,
-    1366, 770, 0, -647,
-    -964, -888, -507, 0,
-    434, 649, 601, 344,
-    0, -295, -441, -408,
-    -233, 0, 198, 294,
-    270, 153, 0, -128,
-    -188, -170, -95, 0,
-    77, 111, 99, 54,
-    0, -41, -58, -50,
-    -26, 0, 18, 24,
-    19, 9, 0, -5,
-    -6, -3, -1, 0
-};
-
-
-
 void Init_Decim_12k8(
      Word16 mem[]                          /* output: memory (2*NB_COEF_DOWN) set to zeros */
 )
@@ -185,7 +117,7 @@ static void Down_samp(
         i = shr(pos, 2);                   /* integer part     */
         frac = (Word16) (pos & 3);         logic16();  /* fractional part */
 
-        sig_d[j] = Interpol(&sig[i], fir_down, frac, FAC4, NB_COEF_DOWN);       move16();
+        sig_d[j] = Interpol(&sig[i], fir_down_ph[frac], NB_COEF_DOWN);       move16();
 
         pos = add(pos, FAC5);              /* pos + 5/4 */
     }
@@ -209,7 +141,7 @@ static void Up_samp(
         i = mult(pos, INV_FAC5);           /* integer part = pos * 1/5 */
         frac = sub(pos, add(shl(i, 2), i));/* frac = pos - (pos/5)*5   */
 
-        sig_u[j] = Interpol(&sig_d[i], fir_up, frac, FAC5, NB_COEF_UP); move16();
+        sig_u[j] = Interpol(&sig_d[i], fir_up_ph[frac], NB_COEF_UP); move16();
 
         pos = add(pos, FAC4);              /* position + 4/5 */
     }
@@ -217,25 +149,24 @@ static void Up_samp(
     return;
 }
 
-/* Fractional interpolation of signal at position (frac/resol) */
+/* Fractional interpolation of signal: fir[] is the phase of the     */
+/* fraction in the polyphase filters of rom_tab.c (fir_down_ph[frac]) */
 
 static Word16 Interpol(                    /* return result of interpolation */
      Word16 * x,                           /* input vector                   */
-     Word16 * fir,                         /* filter coefficient             */
-     Word16 frac,                          /* fraction (0..resol)            */
-     Word16 resol,                         /* resolution                     */
+     const Word16 fir[],                   /* filter of the fraction         */
      Word16 nb_coef                        /* number of coefficients         */
 )
 {
-    Word16 i, k;
+    Word16 i;
     Word32 L_sum;
 
     x = x - nb_coef + 1;                   move16();
 
     L_sum = 0L;                            move32();
-    for (i = 0, k = sub(sub(resol, 1), frac); i < 2 * nb_coef; i++, k = (Word16) (k + resol))
+    for (i = 0; i < 2 * nb_coef; i++)
     {
-        L_sum = L_mac(L_sum, x[i], fir[k]);
+        L_sum = L_mac(L_sum, x[i], fir[i]);
     }
     L_sum = L_shl(L_sum, 1);               /* saturation can occur here */
 
@@ -17,13 +17,172 @@
 #include "bits.h"
 #include "dtx.h"
 #include "count.h"
+#include "pcm_io.h"
+#include "rtp_pl.h"
+#include "dec_parm.h"
+#include "jitbuf.h"
+#include "cpu_disp.h"
+#include "runstat.h"
+
+/*-------------------------------------------------------------------*
+ * Write_parm: one text line per frame (decoder -parm)               *
+ *   frame frame_type mode dtx_state bfi vad                         *
+ *   16 ISFs in Hz                                                   *
+ *   per subframe: pitch lag, pitch gain, code gain, HF gain index   *
+ *-------------------------------------------------------------------*/
+
+static void Write_parm(FILE * fp, long frame, Dec_Parm * parm)
+{
+    Word16 i;
+
+    fprintf(fp, "%ld %d %d %d %d %d ", frame, parm->frame_type, parm->mode,
+        parm->dtx_state, parm->bfi, parm->vad);
+    for (i = 0; i < M; i++)
+    {
+        fprintf(fp, " %.0f", (double) parm->isf[i] * (6400.0 / 16384.0));
+    }
+    for (i = 0; i < NB_SUBFR; i++)
+    {
+        fprintf(fp, "  %.2f %.3f %.2f %d", (double) parm->T0[i] + (double) parm->T0_frac[i] / 4.0,
+            (double) parm->gain_pit[i] / 16384.0, (double) parm->gain_code[i] / 65536.0,
+            parm->hf_gain[i]);
+    }
+    fprintf(fp, "\n");
+    return;
+}
+
+/*-------------------------------------------------------------------*
+ * Decode_jitter: decoding through the jitter buffer (decoder -jitter)*
+ *   Frame n is sent at n x 20 ms. The trace file gives the arrival  *
+ *   time in ms of each frame (text, one value per frame, negative:  *
+ *   lost); frames after the end of the trace arrive when sent.      *
+ *   RX_NO_DATA frames are not sent (DTX). The playout takes         *
+ *   L_FRAME16k samples from the jitter buffer every 20 ms.          *
+ *-------------------------------------------------------------------*/
+
+typedef struct
+{
+    Word32 ts;
+    Word32 arrival;
+    Word16 type;
+    Word16 mode;
+    Word16 prms[NB_BITS_MAX];
+} Packet;
+
+static long Decode_jitter(FILE * f_serial, FILE * f_trace, FILE * f_synth, void *st,
+    RX_State * rx_state, Word16 bitstreamformat, PCM_State * pcm_state, Run_State * run_st)
+{
+    Word16 synth[L_FRAME16k];
+    Word16 i, k, eof, nb_pend;
+    Word32 now, ts;
+    long arrival, frame;
+    Packet *pend;
+    JB_State *jb;
+
+    if (((pend = (Packet *) malloc(JB_MAX_FRAMES * sizeof(Packet))) == NULL) || (Init_jitbuf(&jb, st) != 0))
+    {
+        fprintf(stderr, "Decode_jitter: can not malloc jitter buffer\n");
+        exit(0);
+    }
+    eof = 0;
+    nb_pend = 0;
+    ts = 0;
+    frame = 0;
+
+    for (now = 0;; now += JB_FRAME_MS)
+    {
+        Reset_WMOPS_counter();
+
+        /* frames sent up to now */
+
+        while ((eof == 0) && (ts * JB_FRAME_MS <= now))
+        {
+            if (Read_serial(f_serial, pend[nb_pend].prms, &pend[nb_pend].type, &pend[nb_pend].mode,
+                    rx_state, bitstreamformat) == 0)
+            {
+                eof = 1;
+                break;
+            }
+            Run_frame_rx(run_st, pend[nb_pend].type, pend[nb_pend].mode, pend[nb_pend].prms);
+            if (fscanf(f_trace, "%ld", &arrival) != 1)
+                arrival = ts * JB_FRAME_MS;
+            if ((arrival >= 0) && (pend[nb_pend].type != RX_NO_DATA))
+            {
+                if (arrival < ts * JB_FRAME_MS)
+                    arrival = ts * JB_FRAME_MS;
+
+                /* later than the jitter buffer can hold: lost */
+                if (arrival < (ts + JB_MAX_FRAMES - 1) * JB_FRAME_MS)
+                {
+                    pend[nb_pend].ts = ts;
+                    pend[nb_pend].arrival = arrival;
+                    nb_pend++;
+                }
+            }
+            ts++;
+        }
+
+        /* frames arrived up to now, in order of arrival */
+
+        for (;;)
+        {
+            k = -1;
+            for (i = 0; i < nb_pend; i++)
+            {
+                if ((pend[i].arrival <= now) && ((k < 0) || (pend[i].arrival < pend[k].arrival)))
+                    k = i;
+            }
+            if (k < 0)
+                break;
+            Jb_put(jb, pend[k].ts, pend[k].arrival, pend[k].prms, pend[k].type, pend[k].mode);
+            nb_pend--;
+            if (k != nb_pend)
+                pend[k] = pend[nb_pend];
+        }
+
+        if ((eof != 0) && (nb_pend == 0) && Jb_empty(jb))
+            break;
+
+        Run_start(run_st);
+        Jb_get(jb, now, synth);
+        Run_stop(run_st);
+
+        frame++;
+        Run_progress(stderr, run_st, "Frames played", frame, 0);
+
+        for (i = 0; i < L_FRAME16k; i++)   /* Delete the 2 LSBs (14-bit output) */
+        {
+            synth[i] = (Word16) (synth[i] & 0xfffC);      logic16(); move16();
+        }
+        Write_pcm(f_synth, synth, L_FRAME16k, pcm_state);
+
+        WMOPS_output(0);
+    }
+
+    Run_progress(stderr, run_st, "Frames played", frame, 1);
+    fprintf(stderr, "Jitter buffer: %ld frames received, %ld late, %ld dropped, %ld concealed\n",
+        (long) jb->stats.received, (long) jb->stats.late, (long) jb->stats.dropped, (long) jb->stats.concealed);
+    fprintf(stderr, "Time-scaling:  %ld frames accelerated (%.1f ms), %ld expanded (%.1f ms)\n",
+        (long) jb->stats.accelerated, (double) jb->stats.samples_removed / JB_SAMPLES_MS,
+        (long) jb->stats.expanded, (double) jb->stats.samples_added / JB_SAMPLES_MS);
+    fprintf(stderr, "Playout delay: %.1f ms mean, %d ms target at the end\n",
+        jb->stats.frames ? jb->stats.delay_sum / (double) jb->stats.frames : 0.0, jb->target);
+
+    Close_jitbuf(jb);
+    free(pend);
+
+    return frame;
+}
 
 /*-------------------------------------------------------------------*
  * DECODER.C                                                         *
  * ~~~~~~~~~                                                         *
  * Main program of the AMR WB ACELP wideband decoder.                *
  *                                                                   *
- *    Usage : decoder (-itu | -mime) bitstream_file synth_file bit_rate      *
+ *    Usage : decoder (-float) (-nohf | -parm) (-cpu level)          *
+ *                    (-stats file) (-itu | -mime | -rtp | -rtpoa)   *
+ *                    (-ill L) (-alaw | -ulaw) (-wav)                *
+ *                    (-jitter trace_file) bitstream_file synth_file *
  *                                                                   *
  *    Format for bitstream_file (default):                           *
  *																     *
@@ -45,15 +204,35 @@
  *    if option -mime defined:                         		         *
  *        AMR-WB MIME/storage format, see RFC 3267 (sections 5.1 and 5.3) for details *
  *                                                                 *
+ *    if option -rtp or -rtpoa defined:                              *
+ *        AMR-WB RTP payloads, see RFC 4867 (bandwidth-efficient     *
+ *        or octet-aligned mode), each one preceded by 1 word        *
+ *        (2-byte, big endian) for the payload size                  *
+ *        -ill L: interleaved payloads (ILL/ILP octet, -rtpoa)       *
+ *                                                                   *
  *    Format for synth_file:                                         *
  *      Synthesis is written to a binary file of 16 bits data.       *
+ *      -alaw / -ulaw: 8 bits G.711 A-law / mu-law data.             *
+ *      -wav: RIFF/WAVE file (16 bits, A-law or mu-law, 16 kHz).     *
  *                                                                   *
+ *    -float: use the floating-point decoder (dec_flt.c)             *
+ *    -nohf:  low-power decoding, no 6.4-7 kHz band generation       *
+ *    -parm:  parameters of each frame written as text to synth_file *
+ *            instead of the synthesis (dec_parm.c, no synthesis)    *
+ *    -jitter: frames decoded through the adaptive jitter buffer     *
+ *            (jitbuf.c) with the packet arrivals of trace_file      *
+ *    -cpu level: kernels of level ref, c, sse4.1, avx2, avx512bw    *
+ *            or auto (cpu_disp.c), listed on stderr                 *
+ *    -stats file: frame times, real-time factor, frame types and    *
+ *            VAD activity written to file as JSON (runstat.c)       *
  *-------------------------------------------------------------------*/
 
 int main(int argc, char *argv[])
 {
     FILE *f_serial;                        /* File of serial bits for transmission  */
     FILE *f_synth;                         /* File of speech data                   */
+    FILE *f_trace;                         /* File of packet arrival times          */
+    FILE *f_stats = NULL;                  /* File of the run statistics (JSON)     */
 
     Word16 synth[L_FRAME16k];              /* Buffer for speech @ 16kHz             */
     Word16 prms[NB_BITS_MAX];
@@ -63,13 +242,20 @@ int main(int argc, char *argv[])
     Word16 reset_flag_old = 1;
     Word16 mode_old = 0;
     Word16 i;
+    Word16 flt_engine, hf_bypass, parm_only, cpu_report;
     long frame;
 
 	Word16 bitstreamformat;
+	Word16 pcm_format, pcm_wav;
+	Word16 rtp_ill;
 	RX_State *rx_state;
+	PCM_State *pcm_state;
 
 	char magic[10];
     void *st;
+    Parm_State *parm_st;
+    Dec_Parm parm;
+    Run_State *run_st;
 
       fprintf(stderr, "\n");
       fprintf(stderr, " ==================================================================================================\n");
@@ -81,9 +267,9 @@ int main(int argc, char *argv[])
      *           Read passed arguments and open in/out files           *
      *-----------------------------------------------------------------*/
 
-    if (argc != 3 && argc != 4)
+    if ((argc < 3) || (argc > 17))
     {
-        fprintf(stderr, "Usage : decoder  (-itu | -mime) bitstream_file  synth_file\n");
+        fprintf(stderr, "Usage : decoder  (-float) (-nohf | -parm) (-cpu level) (-stats file) (-itu | -mime | -rtp | -rtpoa) (-ill L) (-alaw | -ulaw) (-wav) (-jitter trace_file) bitstream_file  synth_file\n");
         fprintf(stderr, "\n");
         fprintf(stderr, "Format for bitstream_file: (default)\n");
         fprintf(stderr, "  One word (2-byte) to indicate type of frame type.\n");
@@ -99,12 +285,73 @@ int main(int argc, char *argv[])
         fprintf(stderr, "  if option -mime defined:\n");
 		fprintf(stderr, "  AMR-WB MIME/storage format, see RFC 3267 (sections 5.1 and 5.3) for details.\n");
         fprintf(stderr, "\n");
+        fprintf(stderr, "  if option -rtp or -rtpoa defined:\n");
+		fprintf(stderr, "  AMR-WB RTP payloads, see RFC 4867 (bandwidth-efficient or octet-aligned mode).\n");
+		fprintf(stderr, "  One word (2-byte, big endian) for payload size, then the payload, per packet.\n");
+		fprintf(stderr, "  -ill L: interleaved payloads (octet-aligned only)\n");
+        fprintf(stderr, "\n");
         fprintf(stderr, "Format for synth_file:\n");
         fprintf(stderr, "  Synthesis is written to a binary file of 16 bits data.\n");
+        fprintf(stderr, "  if option -alaw or -ulaw defined: 8 bits G.711 A-law or mu-law data.\n");
+        fprintf(stderr, "  if option -wav defined: RIFF/WAVE file, mono 16 kHz (16 bits PCM, or A-law/mu-law with -alaw/-ulaw).\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "-float: floating-point decoder (not bit-exact)\n");
+        fprintf(stderr, "-nohf: low-power decoding without the 6.4-7 kHz band\n");
+        fprintf(stderr, "-parm: write the decoded parameters (text, one line per frame) instead of the synthesis\n");
+        fprintf(stderr, "-cpu level: kernels of level ref, c, sse4.1, avx2, avx512bw or auto (same synthesis)\n");
+        fprintf(stderr, "-stats file: frame times (p50/p99/max), real-time factor, frame types and VAD activity, as JSON\n");
+        fprintf(stderr, "-jitter: decode through the adaptive jitter buffer, frame n sent at n x 20 ms,\n");
+        fprintf(stderr, "         trace_file: arrival time in ms of each frame (text, negative: lost)\n");
         fprintf(stderr, "\n");
         exit(0);
     }
 
+    flt_engine = 0;
+    if (strcmp(argv[1], "-float") == 0)
+    {
+        flt_engine = 1;
+        argv++;
+        fprintf(stderr, "Floating-point decoder\n");
+    }
+
+    hf_bypass = 0;
+    if (strcmp(argv[1], "-nohf") == 0)
+    {
+        hf_bypass = 1;
+        argv++;
+        fprintf(stderr, "High band (6.4-7 kHz) not generated\n");
+    }
+
+    parm_only = 0;
+    if (strcmp(argv[1], "-parm") == 0)
+    {
+        parm_only = 1;
+        argv++;
+        fprintf(stderr, "Parameter extraction (no synthesis)\n");
+    }
+
+    cpu_report = 0;
+    if (strcmp(argv[1], "-cpu") == 0)
+    {
+        if (Disp_force(argv[2]) != 0)
+        {
+            fprintf(stderr, "Kernels %s: unknown level or not supported by the CPU\n", argv[2]);
+            exit(0);
+        }
+        cpu_report = 1;
+        argv += 2;
+    }
+
+    if (strcmp(argv[1], "-stats") == 0)
+    {
+        if ((f_stats = fopen(argv[2], "w")) == NULL)
+        {
+            fprintf(stderr, "Cannot open file '%s' !!\n", argv[2]);
+            exit(0);
+        }
+        fprintf(stderr, "Run statistics file:    %s\n", argv[2]);
+        argv += 2;
+    }
 
 	bitstreamformat = 0;
     if (strcmp(argv[1], "-itu") == 0)
@@ -119,12 +366,67 @@ int main(int argc, char *argv[])
 			bitstreamformat = 2;
 			argv++;
 			fprintf(stderr, "Input bitstream format: MIME\n");
+		} else if (strcmp(argv[1], "-rtp") == 0)
+		{
+			bitstreamformat = 3;
+			argv++;
+			fprintf(stderr, "Input bitstream format: RTP payload (bandwidth-efficient)\n");
+		} else if (strcmp(argv[1], "-rtpoa") == 0)
+		{
+			bitstreamformat = 4;
+			argv++;
+			fprintf(stderr, "Input bitstream format: RTP payload (octet-aligned)\n");
 		} else
 		{
 			fprintf(stderr, "Input bitstream format: Default\n");
 		}
 	}
 
+    rtp_ill = 0;
+    if (strcmp(argv[1], "-ill") == 0)
+    {
+        rtp_ill = (Word16)atoi(argv[2]);
+        argv += 2;
+    }
+
+    pcm_format = PCM_LINEAR;
+    if (strcmp(argv[1], "-alaw") == 0)
+    {
+        pcm_format = PCM_ALAW;
+        argv++;
+        fprintf(stderr, "Output speech format: G.711 A-law\n");
+    } else if (strcmp(argv[1], "-ulaw") == 0)
+    {
+        pcm_format = PCM_ULAW;
+        argv++;
+        fprintf(stderr, "Output speech format: G.711 mu-law\n");
+    }
+
+    pcm_wav = 0;
+    if (strcmp(argv[1], "-wav") == 0)
+    {
+        pcm_wav = 1;
+        argv++;
+        fprintf(stderr, "Output speech file container: WAV\n");
+    }
+
+    f_trace = NULL;
+    if (strcmp(argv[1], "-jitter") == 0)
+    {
+        if (flt_engine || parm_only)
+        {
+            fprintf(stderr, "Option -jitter is not available with -float and -parm\n");
+            exit(0);
+        }
+        if ((f_trace = fopen(argv[2], "r")) == NULL)
+        {
+            fprintf(stderr, "Trace file '%s' does not exist !!\n", argv[2]);
+            exit(0);
+        }
+        fprintf(stderr, "Jitter buffer, packet arrivals: %s\n", argv[2]);
+        argv += 2;
+    }
+
     /* Open file for synthesis and packed serial stream */
 
     if ((f_serial = fopen(argv[1], "rb")) == NULL)
@@ -133,19 +435,52 @@ int main(int argc, char *argv[])
         exit(0);
     } else
         fprintf(stderr, "Input bitstream file:   %s\n", argv[1]);
+    Blk_buffer(f_serial);
 
     if ((f_synth = fopen(argv[2], "wb")) == NULL)
     {
         fprintf(stderr, "Cannot open file '%s' !!\n", argv[2]);
         exit(0);
-    } else
+    } else if (parm_only)
+        fprintf(stderr, "Parameter file:         %s\n", argv[2]);
+    else
         fprintf(stderr, "Synthesis speech file:  %s\n", argv[2]);
+    Blk_buffer(f_synth);
     /*-----------------------------------------------------------------*
      *           Initialization of decoder                             *
      *-----------------------------------------------------------------*/
 
-    Init_decoder(&st);
+    st = NULL;
+    parm_st = NULL;
+    if (parm_only)
+    {
+        Init_dec_parm(&parm_st);
+    } else if (flt_engine)
+    {
+        Init_decoder_flt(&st);
+        Set_decoder_hf_bypass_flt(st, hf_bypass);
+    } else
+    {
+        Init_decoder(&st);
+        Set_decoder_hf_bypass(st, hf_bypass);
+    }
+    if (cpu_report)
+    {
+        Disp_report(stderr);
+    }
 	Init_read_serial(&rx_state);
+	if (bitstreamformat >= 3)
+	{
+		if (Init_rtp(&rx_state->rtp, (Word16) (bitstreamformat == 4), 1, rtp_ill) != 0)
+		{
+			exit(0);
+		}
+	}
+	Init_write_pcm(&pcm_state, f_synth, pcm_format, (Word16) (pcm_wav && !parm_only));
+    if (Init_runstat(&run_st, "decoder", (Word16) (f_stats != NULL)) != 0)
+    {
+        exit(0);
+    }
     Init_WMOPS_counter();
 
     /*-----------------------------------------------------------------*
@@ -168,71 +503,120 @@ int main(int argc, char *argv[])
 		}
 	}
 
-    frame = 0;
-    while ((nb_bits = Read_serial(f_serial, prms, &frame_type, &mode, rx_state, bitstreamformat)) != 0)
+    /* the frames are parsed out of a mapping of the file */
+    if (bitstreamformat < 3)
     {
-        Reset_WMOPS_counter();
+        Map_read_serial(rx_state, f_serial);
+    }
 
-        frame++;
+    frame = 0;
+    if (f_trace != NULL)
+    {
+        frame = Decode_jitter(f_serial, f_trace, f_synth, st, rx_state, bitstreamformat, pcm_state, run_st);
+    } else
+    {
+        while ((nb_bits = Read_serial(f_serial, prms, &frame_type, &mode, rx_state, bitstreamformat)) != 0)
+        {
+            Reset_WMOPS_counter();
 
-        fprintf(stderr, " Frames processed: %ld\r", frame);
+            frame++;
+            Run_frame_rx(run_st, frame_type, mode, prms);
+            Run_progress(stderr, run_st, "Frames processed", frame, 0);
 
-        if ((frame_type == RX_NO_DATA) | (frame_type == RX_SPEECH_LOST))
-        {
-           mode = mode_old;
-           reset_flag = 0;
-        }
-        else
-        {
-           mode_old = mode;
+            if ((frame_type == RX_NO_DATA) | (frame_type == RX_SPEECH_LOST))
+            {
+               mode = mode_old;
+               reset_flag = 0;
+            }
+            else
+            {
+               mode_old = mode;
 
-        /* if homed: check if this frame is another homing frame */
-        if (reset_flag_old == 1)
-        {
-            /* only check until end of first subframe */
-            reset_flag = decoder_homing_frame_test_first(prms, mode);
-        }
-        }
+            /* if homed: check if this frame is another homing frame */
+            if (reset_flag_old == 1)
+            {
+                /* only check until end of first subframe */
+                reset_flag = decoder_homing_frame_test_first(prms, mode);
+            }
+            }
 
-        /* produce encoder homing frame if homed & input=decoder homing frame */
-        if ((reset_flag != 0) && (reset_flag_old != 0))
-        {
-            for (i = 0; i < L_FRAME16k; i++)
+            /* produce encoder homing frame if homed & input=decoder homing frame */
+            if ((reset_flag != 0) && (reset_flag_old != 0))
+            {
+                for (i = 0; i < L_FRAME16k; i++)
+                {
+                    synth[i] = EHF_MASK;
+                }
+                if (parm_only)
+                    fprintf(f_synth, "%ld homing\n", frame);
+            } else if (parm_only)
+            {
+                Run_start(run_st);
+                dec_parm(mode, prms, &parm, parm_st, frame_type);
+                Run_stop(run_st);
+                Write_parm(f_synth, frame, &parm);
+            } else
             {
-                synth[i] = EHF_MASK;
+                Run_start(run_st);
+                if (flt_engine)
+                    decoder_flt(mode, prms, synth, &frame_length, st, frame_type);
+                else
+                    decoder(mode, prms, synth, &frame_length, st, frame_type);
+                Run_stop(run_st);
             }
-        } else
-        {
-            decoder(mode, prms, synth, &frame_length, st, frame_type);
-        }
 
-        for (i = 0; i < L_FRAME16k; i++)   /* Delete the 2 LSBs (14-bit output) */
-        {
-            synth[i] = (Word16) (synth[i] & 0xfffC);      logic16(); move16();
-        }
+            if (!parm_only)
+            {
+                for (i = 0; i < L_FRAME16k; i++)   /* Delete the 2 LSBs (14-bit output) */
+                {
+                    synth[i] = (Word16) (synth[i] & 0xfffC);      logic16(); move16();
+                }
 
-        fwrite(synth, sizeof(Word16), L_FRAME16k, f_synth);
+                Write_pcm(f_synth, synth, L_FRAME16k, pcm_state);
+            }
 
-        WMOPS_output((Word16) (mode == MRDTX));
+            WMOPS_output((Word16) (mode == MRDTX));
 
-        /* if not homed: check whether current frame is a homing frame */
-        if (reset_flag_old == 0)
-        {
-            /* check whole frame */
-            reset_flag = decoder_homing_frame_test(prms, mode);
-        }
-        /* reset decoder if current frame is a homing frame */
-        if (reset_flag != 0)
-        {
-            Reset_decoder(st, 1);
-        }
-        reset_flag_old = reset_flag;
+            /* if not homed: check whether current frame is a homing frame */
+            if (reset_flag_old == 0)
+            {
+                /* check whole frame */
+                reset_flag = decoder_homing_frame_test(prms, mode);
+            }
+            /* reset decoder if current frame is a homing frame */
+            if (reset_flag != 0)
+            {
+                if (parm_only)
+                    Reset_dec_parm(parm_st, 1);
+                else if (flt_engine)
+                    Reset_decoder_flt(st, 1);
+                else
+                    Reset_decoder(st, 1);
+            }
+            reset_flag_old = reset_flag;
 
+        }
+        Run_progress(stderr, run_st, "Frames processed", frame, 1);
     }
 
-    Close_decoder(st);
+    if (f_stats != NULL)
+    {
+        Run_report(f_stats, run_st);
+        fclose(f_stats);
+    }
+    Close_runstat(run_st);
+
+    if (parm_only)
+        Close_dec_parm(parm_st);
+    else if (flt_engine)
+        Close_decoder_flt(st);
+    else
+        Close_decoder(st);
     Close_read_serial(rx_state);
+    Close_write_pcm(pcm_state, f_synth);
     fclose(f_serial);
     fclose(f_synth);
+    if (f_trace != NULL)
+        fclose(f_trace);
     exit(0);
 }
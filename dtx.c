@@ -38,7 +38,7 @@ static void CN_dithering(
 );
 
 /* excitation energy adjustment depending on speech coder mode used, Q7 */
-static Word16 en_adjust[9] =
+static const Word16 en_adjust[9] =
 {
     230,                                   /* mode0 = 7k  :  -5.4dB  */
     179,                                   /* mode1 = 9k  :  -4.2dB  */
@@ -58,7 +58,7 @@ static Word16 en_adjust[9] =
  *
  *
  **************************************************************************/
-Word16 dtx_enc_init(dtx_encState ** st, Word16 isf_init[])
+Word16 dtx_enc_init(dtx_encState ** st, const Word16 isf_init[])
 {
     dtx_encState *s;
 
@@ -90,7 +90,7 @@ Word16 dtx_enc_init(dtx_encState ** st, Word16 isf_init[])
  *
  *
  **************************************************************************/
-Word16 dtx_enc_reset(dtx_encState * st, Word16 isf_init[])
+Word16 dtx_enc_reset(dtx_encState * st, const Word16 isf_init[])
 {
     Word16 i;
 
@@ -293,6 +293,31 @@ Word16 dtx_enc(
     return 0;
 }
 
+/**************************************************************************
+ *
+ *
+ * Function    : dtx_enc_skip
+ * Purpose     : state update of dtx_enc() for a DTX frame whose SID
+ *               parameters are not needed (frame not transmitted):
+ *               ISF distance history and CN random generator only
+ *
+ **************************************************************************/
+void dtx_enc_skip(
+     dtx_encState * st                     /* i/o : State struct                                         */
+)
+{
+    Word16 i;
+    Word16 isf_order[3];
+
+    find_frame_indices(st->isf_hist, isf_order, st);
+
+    for (i = 0; i < L_FRAME; i++)
+    {
+        Random(&(st->cng_seed));
+    }
+    return;
+}
+
 /**************************************************************************
  *
  *
@@ -399,7 +424,7 @@ void tx_dtx_handler(dtx_encState * st,     /* i/o : State struct           */
  *
  *
  **************************************************************************/
-Word16 dtx_dec_init(dtx_decState ** st, Word16 isf_init[])
+Word16 dtx_dec_init(dtx_decState ** st, const Word16 isf_init[])
 {
     dtx_decState *s;
 
@@ -431,7 +456,7 @@ Word16 dtx_dec_init(dtx_decState ** st, Word16 isf_init[])
  *
  *
  **************************************************************************/
-Word16 dtx_dec_reset(dtx_decState * st, Word16 isf_init[])
+Word16 dtx_dec_reset(dtx_decState * st, const Word16 isf_init[])
 {
     Word16 i;
 
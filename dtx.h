@@ -96,8 +96,8 @@ typedef struct
 
 } dtx_decState;
 
-Word16 dtx_enc_init(dtx_encState ** st, Word16 isf_init[]);
-Word16 dtx_enc_reset(dtx_encState * st, Word16 isf_init[]);
+Word16 dtx_enc_init(dtx_encState ** st, const Word16 isf_init[]);
+Word16 dtx_enc_reset(dtx_encState * st, const Word16 isf_init[]);
 void dtx_enc_exit(dtx_encState ** st);
 
 Word16 dtx_enc(
@@ -107,6 +107,10 @@ Word16 dtx_enc(
      Word16 ** prms
 );
 
+void dtx_enc_skip(
+     dtx_encState * st                     /* i/o : State struct                                         */
+);
+
 Word16 dtx_buffer(
      dtx_encState * st,                    /* i/o : State struct                    */
      Word16 isf_new[],                     /* i   : isf vector                      */
@@ -126,8 +130,8 @@ void Qisf_ns(
 );
 
 
-Word16 dtx_dec_init(dtx_decState ** st, Word16 isf_init[]);
-Word16 dtx_dec_reset(dtx_decState * st, Word16 isf_init[]);
+Word16 dtx_dec_init(dtx_decState ** st, const Word16 isf_init[]);
+Word16 dtx_dec_reset(dtx_decState * st, const Word16 isf_init[]);
 void dtx_dec_exit(dtx_decState ** st);
 
 Word16 dtx_dec(
@@ -0,0 +1,703 @@
+/*------------------------------------------------------------------------*
+ *                         FLT_ACELP.C                                    *
+ *------------------------------------------------------------------------*
+ * Floating-point algebraic codebook search and gain quantization.        *
+ *                                                                        *
+ * The search strategy (sign preselection, pulse position preselection,   *
+ * depth-first search with the same track orders and iteration counts)    *
+ * and the index coding are those of c2t64fx.c, c4t64fx.c and q_gain2.c,  *
+ * so that the produced indices are decoded by the fixed-point decoder.   *
+ *------------------------------------------------------------------------*/
+
+#include <math.h>
+
+#include "typedef.h"
+#include "cnst.h"
+#include "flt_lib.h"
+#include "q_pulse.h"
+#include "rom_tab.h"
+
+#define NB_PULSE_MAX  24
+#define NB_TRACK      4
+#define STEP          4
+#define NB_POS        16
+#define NB_MAX        8
+#define NPMAXPT       ((NB_PULSE_MAX + NB_TRACK - 1) / NB_TRACK)
+
+#define MEAN_ENER     30.0f
+#define RANGE         64
+#define PRED_ORDER    4
+
+/* MA prediction coeff ={0.5, 0.4, 0.3, 0.2} */
+static const Float pred_flt[PRED_ORDER] = {0.5f, 0.4f, 0.3f, 0.2f};
+
+
+/*-------------------------------------------------------------------*
+ * Find the sign of each pulse position from dn2[] = cn[] + alp*dn[] *
+ * (both normalized) and fold it into dn[].                          *
+ *-------------------------------------------------------------------*/
+
+static void Set_sign_flt(
+     Float dn[],                           /* (i/o) : correlation, sign removed on output */
+     Float cn[],                           /* (i)   : residual after long term prediction */
+     Float alp,                            /* (i)   : weight of dn[] in the mix           */
+     Float dn2[],                          /* (o)   : mix of dn[] and cn[] (|.|)         */
+     Float sign[]                          /* (o)   : sign of each position              */
+)
+{
+    Word16 i;
+    Float k_cn, k_dn, s;
+
+    k_cn = 1.0f / (Float) sqrt(Dot_product_flt(cn, cn, L_SUBFR) + 0.01f);
+    k_dn = alp / (Float) sqrt(Dot_product_flt(dn, dn, L_SUBFR) + 0.01f);
+
+    for (i = 0; i < L_SUBFR; i++)
+    {
+        s = k_cn * cn[i] + k_dn * dn[i];
+        if (s >= 0.0f)
+        {
+            sign[i] = 1.0f;
+            dn2[i] = s;
+        } else
+        {
+            sign[i] = -1.0f;
+            dn[i] = -dn[i];
+            dn2[i] = -s;
+        }
+    }
+    return;
+}
+
+/*-------------------------------------------------------------------*
+ * Correlation of the impulse responses at 2 positions, with the     *
+ * pulse signs included:  rr[i][j] = sign[i]*sign[j]*<h(.-i),h(.-j)> *
+ *-------------------------------------------------------------------*/
+
+static void Cor_h_sign_flt(
+     Float h[],                            /* (i) : impulse response        */
+     Float sign[],                         /* (i) : sign of each position   */
+     Float rr[][L_SUBFR]                   /* (o) : correlation matrix      */
+)
+{
+    Word16 i, j, d;
+    Float s;
+
+    for (d = 0; d < L_SUBFR; d++)
+    {
+        s = 0.0f;
+        for (i = (Word16) (L_SUBFR - 1 - d), j = (Word16) (L_SUBFR - 1); i >= 0; i--, j--)
+        {
+            s += h[L_SUBFR - 1 - i] * h[L_SUBFR - 1 - j];
+            rr[i][j] = s * sign[i] * sign[j];
+            rr[j][i] = rr[i][j];
+        }
+    }
+    return;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Function  ACELP_2t64_flt()                                        *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~                                        *
+ * 12 bits algebraic codebook: 2 tracks x 32 positions.              *
+ * All combinations (32 x 32) are tested.                            *
+ *-------------------------------------------------------------------*/
+
+void ACELP_2t64_flt(
+     Float dn[],                           /* (i) : correlation between target x[] and H[]  */
+     Float cn[],                           /* (i) : residual after long term prediction     */
+     Float H[],                            /* (i) : impulse response of weighted synthesis  */
+     Float code[],                         /* (o) : algebraic (fixed) codebook excitation   */
+     Float y[],                            /* (o) : filtered fixed codebook excitation      */
+     Word16 * index                        /* (o) : index (12 bits)                         */
+)
+{
+    Word16 i, i0, i1, ix, iy, pos;
+    Float ps, sq, alp, psk, alpk;
+    Float dn2[L_SUBFR], sign[L_SUBFR];
+    Float rr[L_SUBFR][L_SUBFR];
+
+    Set_sign_flt(dn, cn, 2.0f, dn2, sign);
+    Cor_h_sign_flt(H, sign, rr);
+
+    psk = -1.0f;
+    alpk = 1.0f;
+    ix = 0;
+    iy = 1;
+
+    for (i0 = 0; i0 < L_SUBFR; i0 += 2)
+    {
+        pos = -1;
+        for (i1 = 1; i1 < L_SUBFR; i1 += 2)
+        {
+            ps = dn[i0] + dn[i1];
+            alp = rr[i0][i0] + rr[i1][i1] + 2.0f * rr[i0][i1];
+            sq = ps * ps;
+
+            if ((alpk * sq - psk * alp) > 0.0f)
+            {
+                psk = sq;
+                alpk = alp;
+                pos = i1;
+            }
+        }
+        if (pos >= 0)
+        {
+            ix = i0;
+            iy = pos;
+        }
+    }
+
+    /* build the codeword, the filtered codeword and index of codevector */
+
+    for (i = 0; i < L_SUBFR; i++)
+        code[i] = 0.0f;
+
+    i0 = (Word16) (ix >> 1);               /* pos of pulse 1 (0..31) */
+    i1 = (Word16) (iy >> 1);               /* pos of pulse 2 (0..31) */
+
+    code[ix] = sign[ix];
+    if (sign[ix] < 0.0f)
+        i0 += 32;
+
+    code[iy] = sign[iy];
+    if (sign[iy] < 0.0f)
+        i1 += 32;
+
+    *index = (Word16) ((i0 << 6) + i1);
+
+    for (i = 0; i < L_SUBFR; i++)
+    {
+        y[i] = 0.0f;
+        if (i >= ix)
+            y[i] += sign[ix] * H[i - ix];
+        if (i >= iy)
+            y[i] += sign[iy] * H[i - iy];
+    }
+
+    return;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Find the best positions of 2 pulses in 2 tracks (c4t64fx.c).      *
+ *-------------------------------------------------------------------*/
+
+static void search_ixiy_flt(
+     Word16 nb_pos_ix,                     /* (i) nb of pos for pulse 1 (1..8)       */
+     Word16 track_x,                       /* (i) track of pulse 1                   */
+     Word16 track_y,                       /* (i) track of pulse 2                   */
+     Float * ps,                           /* (i/o) correlation of all fixed pulses  */
+     Float * alp,                          /* (i/o) energy of all fixed pulses       */
+     Word16 * ix,                          /* (o) position of pulse 1                */
+     Word16 * iy,                          /* (o) position of pulse 2                */
+     Float dn[],                           /* (i) corr. between target and h[]       */
+     Float dn2[],                          /* (i) vector of selected positions       */
+     Float cor[],                          /* (i) corr. of pulses with fixed pulses  */
+     Float rr[][L_SUBFR]                   /* (i) corr. of 2 pulses                  */
+)
+{
+    Word16 x, y, pos;
+    Float thres_ix, ps1, ps2, sq, sqk, alp1, alp2, alpk;
+
+    thres_ix = (Float) (nb_pos_ix - NB_MAX);
+
+    sqk = -1.0f;
+    alpk = 1.0f;
+
+    *ix = track_x;
+    *iy = track_y;
+
+    for (x = track_x; x < L_SUBFR; x += STEP)
+    {
+        if (dn2[x] < thres_ix)
+        {
+            ps1 = *ps + dn[x];
+            alp1 = *alp + rr[x][x] + 2.0f * cor[x];
+
+            pos = -1;
+            for (y = track_y; y < L_SUBFR; y += STEP)
+            {
+                ps2 = ps1 + dn[y];
+                alp2 = alp1 + rr[y][y] + 2.0f * (cor[y] + rr[x][y]);
+                sq = ps2 * ps2;
+
+                if ((alpk * sq - sqk * alp2) > 0.0f)
+                {
+                    sqk = sq;
+                    alpk = alp2;
+                    pos = y;
+                }
+            }
+            if (pos >= 0)
+            {
+                *ix = x;
+                *iy = pos;
+            }
+        }
+    }
+
+    *ps = *ps + dn[*ix] + dn[*iy];
+    *alp = alpk;
+
+    return;
+}
+
+/*-------------------------------------------------------------------*
+ * Function  ACELP_4t64_flt()                                        *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~                                        *
+ * 20, 36, 44, 52, 64, 72, 88 bits algebraic codebook.               *
+ * 4 tracks x 16 positions per track = 64 samples.                   *
+ *-------------------------------------------------------------------*/
+
+void ACELP_4t64_flt(
+     Float dn[],                           /* (i) : correlation between target x[] and H[]  */
+     Float cn[],                           /* (i) : residual after long term prediction     */
+     Float H[],                            /* (i) : impulse response of weighted synthesis  */
+     Float code[],                         /* (o) : algebraic (fixed) codebook excitation   */
+     Float y[],                            /* (o) : filtered fixed codebook excitation      */
+     Word16 nbbits,                        /* (i) : 20, 36, 44, 52, 64, 72 or 88 bits       */
+     Word16 ser_size,                      /* (i) : bit rate                                */
+     Word16 _index[]                       /* (o) : same indices as ACELP_4t64_fx()         */
+)
+{
+    Word16 i, j, k, st, ix, iy, pos, index, track, nb_pulse, nbiter;
+    Word32 L_index;
+    Float psk, ps, alpk, alp, s, alp_mix;
+    Float dn2[L_SUBFR], sign[L_SUBFR], vec[L_SUBFR], cor[L_SUBFR];
+    Word16 ind[NPMAXPT * NB_TRACK];
+    Word16 codvec[NB_PULSE_MAX], nbpos[10];
+    Word16 pos_max[NB_TRACK];
+    Word16 ipos[NB_PULSE_MAX];
+    Float rr[L_SUBFR][L_SUBFR];
+
+    switch (nbbits)
+    {
+    case 20:                               /* 20 bits, 4 pulses, 4 tracks */
+        nbiter = 4;
+        alp_mix = 2.0f;
+        nb_pulse = 4;
+        nbpos[0] = 4;
+        nbpos[1] = 8;
+        break;
+    case 36:                               /* 36 bits, 8 pulses, 4 tracks */
+        nbiter = 4;
+        alp_mix = 1.0f;
+        nb_pulse = 8;
+        nbpos[0] = 4;
+        nbpos[1] = 8;
+        nbpos[2] = 8;
+        break;
+    case 44:                               /* 44 bits, 10 pulses, 4 tracks */
+        nbiter = 4;
+        alp_mix = 1.0f;
+        nb_pulse = 10;
+        nbpos[0] = 4;
+        nbpos[1] = 6;
+        nbpos[2] = 8;
+        nbpos[3] = 8;
+        break;
+    case 52:                               /* 52 bits, 12 pulses, 4 tracks */
+        nbiter = 4;
+        alp_mix = 1.0f;
+        nb_pulse = 12;
+        nbpos[0] = 4;
+        nbpos[1] = 6;
+        nbpos[2] = 8;
+        nbpos[3] = 8;
+        break;
+    case 64:                               /* 64 bits, 16 pulses, 4 tracks */
+        nbiter = 3;
+        alp_mix = 0.8f;
+        nb_pulse = 16;
+        nbpos[0] = 4;
+        nbpos[1] = 4;
+        nbpos[2] = 6;
+        nbpos[3] = 6;
+        nbpos[4] = 8;
+        nbpos[5] = 8;
+        break;
+    case 72:                               /* 72 bits, 18 pulses, 4 tracks */
+        nbiter = 3;
+        alp_mix = 0.75f;
+        nb_pulse = 18;
+        nbpos[0] = 2;
+        nbpos[1] = 3;
+        nbpos[2] = 4;
+        nbpos[3] = 5;
+        nbpos[4] = 6;
+        nbpos[5] = 7;
+        nbpos[6] = 8;
+        break;
+    case 88:                               /* 88 bits, 24 pulses, 4 tracks */
+        if (ser_size > 462)
+            nbiter = 1;
+        else
+            nbiter = 2;
+
+        alp_mix = 0.5f;
+        nb_pulse = 24;
+        nbpos[0] = 2;
+        nbpos[1] = 2;
+        nbpos[2] = 3;
+        nbpos[3] = 4;
+        nbpos[4] = 5;
+        nbpos[5] = 6;
+        nbpos[6] = 7;
+        nbpos[7] = 8;
+        nbpos[8] = 8;
+        nbpos[9] = 8;
+        break;
+    default:
+        nbiter = 0;
+        alp_mix = 0.0f;
+        nb_pulse = 0;
+    }
+
+    for (i = 0; i < nb_pulse; i++)
+        codvec[i] = i;
+
+    /* sign of each pulse position, folded into dn[] */
+    Set_sign_flt(dn, cn, alp_mix, dn2, sign);
+
+    /* select NB_MAX position per track according to max of dn2[] */
+    pos = 0;
+    for (i = 0; i < NB_TRACK; i++)
+    {
+        for (k = 0; k < NB_MAX; k++)
+        {
+            ps = -1.0f;
+            for (j = i; j < L_SUBFR; j += STEP)
+            {
+                if (dn2[j] > ps)
+                {
+                    ps = dn2[j];
+                    pos = j;
+                }
+            }
+            dn2[pos] = (Float) (k - NB_MAX);   /* dn2 < 0 when position is selected */
+            if (k == 0)
+                pos_max[i] = pos;
+        }
+    }
+
+    Cor_h_sign_flt(H, sign, rr);
+
+    /* deep first search */
+
+    psk = -1.0f;
+    alpk = 1.0f;
+
+    for (k = 0; k < nbiter; k++)
+    {
+        for (i = 0; i < nb_pulse; i++)
+            ipos[i] = tipos[(k * 4) + i];
+
+        if (nbbits == 20)
+        {
+            pos = 0;
+            ps = 0.0f;
+            alp = 0.0f;
+        } else if ((nbbits == 36) || (nbbits == 44))
+        {
+            /* first stage: fix 2 pulses */
+            pos = 2;
+
+            ix = ind[0] = pos_max[ipos[0]];
+            iy = ind[1] = pos_max[ipos[1]];
+            ps = dn[ix] + dn[iy];
+            alp = rr[ix][ix] + rr[iy][iy] + 2.0f * rr[ix][iy];
+
+            if (nbbits == 44)
+            {
+                ipos[8] = 0;
+                ipos[9] = 1;
+            }
+        } else
+        {
+            /* first stage: fix 4 pulses */
+            pos = 4;
+
+            ps = 0.0f;
+            for (i = 0; i < 4; i++)
+            {
+                ind[i] = pos_max[ipos[i]];
+                ps += dn[ind[i]];
+            }
+            alp = 0.0f;
+            for (i = 0; i < 4; i++)
+                for (j = 0; j < 4; j++)
+                    alp += rr[ind[i]][ind[j]];
+
+            if (nbbits == 72)
+            {
+                ipos[16] = 0;
+                ipos[17] = 1;
+            }
+        }
+
+        /* correlation of every position with the fixed pulses */
+        for (i = 0; i < L_SUBFR; i++)
+        {
+            s = 0.0f;
+            for (j = 0; j < pos; j++)
+                s += rr[i][ind[j]];
+            cor[i] = s;
+        }
+
+        /* other stages of 2 pulses */
+
+        for (j = pos, st = 0; j < nb_pulse; j += 2, st++)
+        {
+            search_ixiy_flt(nbpos[st], ipos[j], ipos[j + 1], &ps, &alp,
+                &ix, &iy, dn, dn2, cor, rr);
+
+            ind[j] = ix;
+            ind[j + 1] = iy;
+
+            for (i = 0; i < L_SUBFR; i++)
+                cor[i] += rr[i][ix] + rr[i][iy];
+        }
+
+        /* memorise the best codevector */
+
+        ps = ps * ps;
+        if ((alpk * ps - psk * alp) > 0.0f)
+        {
+            psk = ps;
+            alpk = alp;
+            for (i = 0; i < nb_pulse; i++)
+                codvec[i] = ind[i];
+        }
+    }
+
+    /* build the codeword, the filtered codeword and index of codevector */
+
+    for (i = 0; i < NPMAXPT * NB_TRACK; i++)
+        ind[i] = -1;
+    for (i = 0; i < L_SUBFR; i++)
+    {
+        code[i] = 0.0f;
+        vec[i] = 0.0f;
+    }
+
+    for (k = 0; k < nb_pulse; k++)
+    {
+        i = codvec[k];                     /* read pulse position */
+
+        index = (Word16) (i >> 2);         /* index = pos of pulse (0..15) */
+        track = (Word16) (i & 0x03);       /* track = i % NB_TRACK (0..3)  */
+
+        code[i] += sign[i];
+        for (j = i; j < L_SUBFR; j++)
+            vec[j] += sign[i] * H[j - i];
+
+        if (sign[i] < 0.0f)
+            index = (Word16) (index + NB_POS);
+
+        i = (Word16) (track * NPMAXPT);
+        while (ind[i] >= 0)
+            i++;
+        ind[i] = index;
+    }
+    for (i = 0; i < L_SUBFR; i++)
+        y[i] = vec[i];
+
+    k = 0;
+    /* Build index of codevector */
+    if (nbbits == 20)
+    {
+        for (track = 0; track < NB_TRACK; track++)
+        {
+            _index[track] = (Word16) quant_1p_N1(ind[k], 4);
+            k += NPMAXPT;
+        }
+    } else if (nbbits == 36)
+    {
+        for (track = 0; track < NB_TRACK; track++)
+        {
+            _index[track] = (Word16) quant_2p_2N1(ind[k], ind[k + 1], 4);
+            k += NPMAXPT;
+        }
+    } else if (nbbits == 44)
+    {
+        for (track = 0; track < NB_TRACK - 2; track++)
+        {
+            _index[track] = (Word16) quant_3p_3N1(ind[k], ind[k + 1], ind[k + 2], 4);
+            k += NPMAXPT;
+        }
+        for (track = 2; track < NB_TRACK; track++)
+        {
+            _index[track] = (Word16) quant_2p_2N1(ind[k], ind[k + 1], 4);
+            k += NPMAXPT;
+        }
+    } else if (nbbits == 52)
+    {
+        for (track = 0; track < NB_TRACK; track++)
+        {
+            _index[track] = (Word16) quant_3p_3N1(ind[k], ind[k + 1], ind[k + 2], 4);
+            k += NPMAXPT;
+        }
+    } else if (nbbits == 64)
+    {
+        for (track = 0; track < NB_TRACK; track++)
+        {
+            L_index = quant_4p_4N(&ind[k], 4);
+            _index[track] = (Word16) ((L_index >> 14) & 3);
+            _index[track + NB_TRACK] = (Word16) (L_index & 0x3FFF);
+            k += NPMAXPT;
+        }
+    } else if (nbbits == 72)
+    {
+        for (track = 0; track < NB_TRACK - 2; track++)
+        {
+            L_index = quant_5p_5N(&ind[k], 4);
+            _index[track] = (Word16) ((L_index >> 10) & 0x03FF);
+            _index[track + NB_TRACK] = (Word16) (L_index & 0x03FF);
+            k += NPMAXPT;
+        }
+        for (track = 2; track < NB_TRACK; track++)
+        {
+            L_index = quant_4p_4N(&ind[k], 4);
+            _index[track] = (Word16) ((L_index >> 14) & 3);
+            _index[track + NB_TRACK] = (Word16) (L_index & 0x3FFF);
+            k += NPMAXPT;
+        }
+    } else if (nbbits == 88)
+    {
+        for (track = 0; track < NB_TRACK; track++)
+        {
+            L_index = quant_6p_6N_2(&ind[k], 4);
+            _index[track] = (Word16) ((L_index >> 11) & 0x07FF);
+            _index[track + NB_TRACK] = (Word16) (L_index & 0x07FF);
+            k += NPMAXPT;
+        }
+    }
+    return;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Function  Q_gain2_flt()                                           *
+ * ~~~~~~~~~~~~~~~~~~~~~~~                                           *
+ * Quantization of pitch and codebook gains (q_gain2.c).             *
+ * MA prediction is performed on the innovation energy (in dB with   *
+ * mean removed).                                                    *
+ *-------------------------------------------------------------------*/
+
+void Init_Q_gain2_flt(
+     Float * mem                           /* output  : past quantized energies (4) */
+)
+{
+    Word16 i;
+
+    for (i = 0; i < PRED_ORDER; i++)
+        mem[i] = -14.0f;
+
+    return;
+}
+
+Word16 Q_gain2_flt(                        /* Return index of quantization                  */
+     Float xn[],                           /* (i) : target vector                           */
+     Float y1[],                           /* (i) : filtered adaptive codebook              */
+     Float y2[],                           /* (i) : filtered innovative vector              */
+     Float code[],                         /* (i) : innovative vector                       */
+     Float g_coeff[],                      /* (i) : <y1 y1> and <xn y1> from G_pitch_flt()  */
+     Word16 L_subfr,                       /* (i) : subframe length                         */
+     Word16 nbits,                         /* (i) : number of bits (6 or 7)                 */
+     Float * gain_pit,                     /* (i/o): pitch gain                             */
+     Float * gain_cod,                     /* (o) : code gain                               */
+     Word16 gp_clip,                       /* (i) : Gp Clipping flag                        */
+     Float * mem                           /* (i/o): past quantized energies (4)            */
+)
+{
+    Word16 i, j, index, min_ind, size;
+    const Word16 *t_qua_gain, *p;
+    Float coeff[5], g_pitch, g_code, gcode0, ener_code, pred_en, dist, dist_min;
+    Float *past_qua_en;
+
+    past_qua_en = mem;
+
+    /* find the initial quantization pitch index and set gains search range */
+
+    if (nbits == 6)
+    {
+        t_qua_gain = t_qua_gain6b;
+        min_ind = 0;
+        size = RANGE;
+        if (gp_clip == 1)
+            size -= 16;                    /* limit gain pitch to 1.0 */
+    } else
+    {
+        t_qua_gain = t_qua_gain7b;
+        p = t_qua_gain7b + RANGE;          /* pt at 1/4th of table */
+        j = nb_qua_gain7b - RANGE;
+        if (gp_clip == 1)
+            j -= 27;                       /* limit gain pitch to 1.0 */
+
+        min_ind = 0;
+        g_pitch = *gain_pit * 16384.0f;
+        for (i = 0; i < j; i++, p += 2)
+        {
+            if (g_pitch > (Float) (*p))
+                min_ind++;
+        }
+        size = RANGE;
+    }
+
+    /* coefficients of the quadratic error */
+
+    coeff[0] = g_coeff[0];                              /*    y1 y1 */
+    coeff[1] = -2.0f * g_coeff[1];                      /* -2 xn y1 */
+    coeff[2] = Dot_product_flt(y2, y2, L_subfr);        /*    y2 y2 */
+    coeff[3] = -2.0f * Dot_product_flt(xn, y2, L_subfr);/* -2 xn y2 */
+    coeff[4] = 2.0f * Dot_product_flt(y1, y2, L_subfr); /*  2 y1 y2 */
+
+    /* predicted code gain: MEAN_ENER - 10log10(energy of code / L_subfr) + prediction */
+
+    ener_code = Dot_product_flt(code, code, L_subfr) / (Float) L_subfr + 0.01f;
+    pred_en = MEAN_ENER - 10.0f * (Float) log10(ener_code);
+    for (i = 0; i < PRED_ORDER; i++)
+        pred_en += pred_flt[i] * past_qua_en[i];
+
+    gcode0 = (Float) pow(10.0, pred_en / 20.0f);
+
+    /* codebook search */
+
+    dist_min = 1.0e38f;
+    p = &t_qua_gain[min_ind * 2];
+    index = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        g_pitch = (Float) (*p++) * (1.0f / 16384.0f);
+        g_code = (Float) (*p++) * (1.0f / 2048.0f) * gcode0;
+
+        dist = coeff[0] * g_pitch * g_pitch + coeff[1] * g_pitch
+            + coeff[2] * g_code * g_code + coeff[3] * g_code
+            + coeff[4] * g_pitch * g_code;
+
+        if (dist < dist_min)
+        {
+            dist_min = dist;
+            index = i;
+        }
+    }
+
+    /* read the quantized gains */
+
+    index = (Word16) (index + min_ind);
+    p = &t_qua_gain[index * 2];
+    *gain_pit = (Float) (*p++) * (1.0f / 16384.0f);
+    g_code = (Float) (*p++) * (1.0f / 2048.0f);
+    *gain_cod = g_code * gcode0;
+
+    /* update table of past quantized energies */
+
+    past_qua_en[3] = past_qua_en[2];
+    past_qua_en[2] = past_qua_en[1];
+    past_qua_en[1] = past_qua_en[0];
+    past_qua_en[0] = 20.0f * (Float) log10(g_code);
+
+    return (index);
+}
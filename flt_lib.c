@@ -0,0 +1,1259 @@
+/*------------------------------------------------------------------------*
+ *                         FLT_LIB.C                                      *
+ *------------------------------------------------------------------------*
+ * Floating-point versions of the signal processing routines.             *
+ *                                                                        *
+ * Each function follows the algorithm of its fixed-point counterpart     *
+ * (same filters, same search strategy, same tables) but works on the     *
+ * natural scale of the signals: no saturation, no Q format and no        *
+ * dynamic scaling of the buffers.                                        *
+ *------------------------------------------------------------------------*/
+
+#include <math.h>
+
+#include "typedef.h"
+#include "cnst.h"
+#include "flt_lib.h"
+#include "flt_lib.tab"
+
+#define GRID_POINTS   100
+#define PI_FLT        3.14159265358979f
+
+/* shared tables of the fixed-point library */
+extern const Word16 window[L_WINDOW];            /* ham_wind.tab (Q15) */
+extern const Word16 lag_h[M];                    /* lag_wind.tab (DPF) */
+extern const Word16 lag_l[M];
+extern const Word16 grid[GRID_POINTS + 1];       /* grid100.tab  (Q15) */
+
+
+/*-----------------------------------------------------------------*
+ *                      conversion utilities                       *
+ *-----------------------------------------------------------------*/
+
+void Word16_to_flt(Word16 x[], Float y[], Word16 lg)
+{
+    Word16 i;
+
+    for (i = 0; i < lg; i++)
+        y[i] = (Float) x[i];
+    return;
+}
+
+void Flt_to_word16(Float x[], Word16 y[], Word16 lg)
+{
+    Word16 i;
+    Float tmp;
+
+    for (i = 0; i < lg; i++)
+    {
+        tmp = x[i];
+        if (tmp >= 0.0f)
+            tmp += 0.5f;
+        else
+            tmp -= 0.5f;
+
+        if (tmp > 32767.0f)
+            y[i] = 32767;
+        else if (tmp < -32768.0f)
+            y[i] = -32768;
+        else
+            y[i] = (Word16) tmp;
+    }
+    return;
+}
+
+Float Dot_product_flt(Float x[], Float y[], Word16 lg)
+{
+    Word16 i;
+    Float sum;
+
+    sum = 0.0f;
+    for (i = 0; i < lg; i++)
+        sum += x[i] * y[i];
+    return (sum);
+}
+
+/*-----------------------------------------------------------------*
+ *                 sampling rate conversion (decim54.c)            *
+ *-----------------------------------------------------------------*/
+
+#define NB_COEF_DOWN  15
+#define NB_COEF_UP    12
+
+static Float Interpol_flt(                 /* return result of interpolation */
+     Float * x,                            /* input vector                   */
+     const Float * fir,                    /* filter coefficient (Q14)       */
+     Word16 frac,                          /* fraction (0..resol)            */
+     Word16 resol,                         /* resolution                     */
+     Word16 nb_coef                        /* number of coefficients         */
+)
+{
+    Word16 i, k;
+    Float sum;
+
+    x = x - nb_coef + 1;
+    sum = 0.0f;
+    for (i = 0, k = (Word16) (resol - 1 - frac); i < 2 * nb_coef; i++, k = (Word16) (k + resol))
+        sum += x[i] * fir[k];
+
+    return (sum * (1.0f / 16384.0f));
+}
+
+void Decim_12k8_flt(
+     Float sig16k[],                       /* input:  signal to downsampling  */
+     Word16 lg,                            /* input:  length of input         */
+     Float sig12k8[],                      /* output: decimated signal        */
+     Float mem[]                           /* in/out: memory (2*NB_COEF_DOWN) */
+)
+{
+    Word16 i, j, frac, pos, lg_down;
+    Float signal[L_FRAME16k + (2 * NB_COEF_DOWN)];
+
+    for (i = 0; i < 2 * NB_COEF_DOWN; i++)
+        signal[i] = mem[i];
+    for (i = 0; i < lg; i++)
+        signal[i + (2 * NB_COEF_DOWN)] = sig16k[i];
+
+    lg_down = (Word16) ((lg * 4) / 5);
+
+    pos = 0;                               /* position is in Q2 -> 1/4 resolution */
+    for (j = 0; j < lg_down; j++)
+    {
+        i = (Word16) (pos >> 2);
+        frac = (Word16) (pos & 3);
+        sig12k8[j] = Interpol_flt(&signal[NB_COEF_DOWN + i], fir_down_flt, frac, 4, NB_COEF_DOWN);
+        pos = (Word16) (pos + 5);
+    }
+
+    for (i = 0; i < 2 * NB_COEF_DOWN; i++)
+        mem[i] = signal[lg + i];
+
+    return;
+}
+
+void Oversamp_16k_flt(
+     Float sig12k8[],                      /* input:  signal to oversampling  */
+     Word16 lg,                            /* input:  length of input         */
+     Float sig16k[],                       /* output: oversampled signal      */
+     Float mem[]                           /* in/out: memory (2*NB_COEF_UP)   */
+)
+{
+    Word16 i, j, frac, pos, lg_up;
+    Float signal[L_SUBFR + (2 * NB_COEF_UP)];
+
+    for (i = 0; i < 2 * NB_COEF_UP; i++)
+        signal[i] = mem[i];
+    for (i = 0; i < lg; i++)
+        signal[i + (2 * NB_COEF_UP)] = sig12k8[i];
+
+    lg_up = (Word16) ((lg * 5) / 4);
+
+    pos = 0;                               /* position with 1/5 resolution */
+    for (j = 0; j < lg_up; j++)
+    {
+        i = (Word16) (pos / 5);
+        frac = (Word16) (pos - (i * 5));
+        sig16k[j] = Interpol_flt(&signal[NB_COEF_UP + i], fir_up_flt, frac, 5, NB_COEF_UP);
+        pos = (Word16) (pos + 4);
+    }
+
+    for (i = 0; i < 2 * NB_COEF_UP; i++)
+        mem[i] = signal[lg + i];
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *                         IIR filters                             *
+ *-----------------------------------------------------------------*/
+
+/* 2nd order high pass filter with cut off frequency at 50 Hz (hp50.c) */
+
+void HP50_12k8_flt(
+     Float signal[],                       /* input/output signal */
+     Word16 lg,                            /* lenght of signal    */
+     Float mem[]                           /* filter memory [4]   */
+)
+{
+    Word16 i;
+    Float x0, x1, x2, y0, y1, y2;
+
+    y1 = mem[0];
+    y2 = mem[1];
+    x0 = mem[2];
+    x1 = mem[3];
+
+    for (i = 0; i < lg; i++)
+    {
+        x2 = x1;
+        x1 = x0;
+        x0 = signal[i];
+
+        y0 = 0.989501953f * x0 - 1.979003906f * x1 + 0.989501953f * x2
+            + 1.978881836f * y1 - 0.979125977f * y2;
+
+        y2 = y1;
+        y1 = y0;
+        signal[i] = y0;
+    }
+
+    mem[0] = y1;
+    mem[1] = y2;
+    mem[2] = x0;
+    mem[3] = x1;
+
+    return;
+}
+
+/* 2nd order high pass filter with cut off frequency at 400 Hz (hp400.c) */
+
+void HP400_12k8_flt(
+     Float signal[],                       /* input/output signal */
+     Word16 lg,                            /* lenght of signal    */
+     Float mem[]                           /* filter memory [4]   */
+)
+{
+    Word16 i;
+    Float x0, x1, x2, y0, y1, y2;
+
+    y1 = mem[0];
+    y2 = mem[1];
+    x0 = mem[2];
+    x1 = mem[3];
+
+    for (i = 0; i < lg; i++)
+    {
+        x2 = x1;
+        x1 = x0;
+        x0 = signal[i];
+
+        y0 = 0.893554687f * x0 - 1.787109375f * x1 + 0.893554687f * x2
+            + 1.787109375f * y1 - 0.864257812f * y2;
+
+        y2 = y1;
+        y1 = y0;
+        signal[i] = y0;
+    }
+
+    mem[0] = y1;
+    mem[1] = y2;
+    mem[2] = x0;
+    mem[3] = x1;
+
+    return;
+}
+
+/* 3nd order high pass filter for the normalized correlation of wsp[] (hp_wsp.c) */
+
+void Hp_wsp_flt(
+     Float wsp[],                          /* i   : wsp[]  signal       */
+     Float hp_wsp[],                       /* o   : hypass wsp[]        */
+     Word16 lg,                            /* i   : lenght of signal    */
+     Float mem[]                           /* i/o : filter memory [6]   */
+)
+{
+    Word16 i;
+    Float x0, x1, x2, x3, y0, y1, y2, y3;
+
+    y3 = mem[0];
+    y2 = mem[1];
+    y1 = mem[2];
+    x0 = mem[3];
+    x1 = mem[4];
+    x2 = mem[5];
+
+    for (i = 0; i < lg; i++)
+    {
+        x3 = x2;
+        x2 = x1;
+        x1 = x0;
+        x0 = wsp[i];
+
+        y0 = -0.83787057505665f * x0 + 2.50975570071058f * x1
+            - 2.50975570071058f * x2 + 0.83787057505665f * x3
+            + 2.64436711600664f * y1 - 2.35087386625360f * y2
+            + 0.70001156927424f * y3;
+
+        y3 = y2;
+        y2 = y1;
+        y1 = y0;
+        hp_wsp[i] = y0;
+    }
+
+    mem[0] = y3;
+    mem[1] = y2;
+    mem[2] = y1;
+    mem[3] = x0;
+    mem[4] = x1;
+    mem[5] = x2;
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *                         FIR filters                             *
+ *-----------------------------------------------------------------*/
+
+/* 15th order band pass 6kHz to 7kHz FIR filter (hp6k.c) */
+
+void Filt_6k_7k_flt(
+     Float signal[],                       /* input:  signal                  */
+     Word16 lg,                            /* input:  length of input         */
+     Float mem[]                           /* in/out: memory (size=30)        */
+)
+{
+    Word16 i, j;
+    Float x[L_SUBFR16k + (L_FIR_HF - 1)], sum;
+
+    for (i = 0; i < L_FIR_HF - 1; i++)
+        x[i] = mem[i];
+    for (i = 0; i < lg; i++)
+        x[i + L_FIR_HF - 1] = signal[i];
+
+    for (i = 0; i < lg; i++)
+    {
+        sum = 0.0f;
+        for (j = 0; j < L_FIR_HF; j++)
+            sum += x[i + j] * fir_6k_7k_flt[j];
+        signal[i] = sum * (1.0f / 131072.0f);   /* Q15 and gain of filter = 4 */
+    }
+
+    for (i = 0; i < L_FIR_HF - 1; i++)
+        mem[i] = x[i + lg];
+
+    return;
+}
+
+/* 15th order low pass 7kHz FIR filter (hp7k.c) */
+
+void Filt_7k_flt(
+     Float signal[],                       /* input:  signal                  */
+     Word16 lg,                            /* input:  length of input         */
+     Float mem[]                           /* in/out: memory (size=30)        */
+)
+{
+    Word16 i, j;
+    Float x[L_SUBFR16k + (L_FIR_HF - 1)], sum;
+
+    for (i = 0; i < L_FIR_HF - 1; i++)
+        x[i] = mem[i];
+    for (i = 0; i < lg; i++)
+        x[i + L_FIR_HF - 1] = signal[i];
+
+    for (i = 0; i < lg; i++)
+    {
+        sum = 0.0f;
+        for (j = 0; j < L_FIR_HF; j++)
+            sum += x[i + j] * fir_7k_flt[j];
+        signal[i] = sum * (1.0f / 32768.0f);
+    }
+
+    for (i = 0; i < L_FIR_HF - 1; i++)
+        mem[i] = x[i + lg];
+
+    return;
+}
+
+/* Decimate a vector by 2 with 2nd order fir filter (lp_dec2.c) */
+
+#define L_FIR_DEC2  5
+#define L_MEM_DEC2  (L_FIR_DEC2 - 2)
+
+void LP_Decim2_flt(
+     Float x[],                            /* in/out: signal to process         */
+     Word16 l,                             /* input : size of filtering         */
+     Float mem[]                           /* in/out: memory (size=3)           */
+)
+{
+    Word16 i, j, k;
+    Float x_buf[L_FRAME + L_MEM_DEC2], sum;
+
+    for (i = 0; i < L_MEM_DEC2; i++)
+        x_buf[i] = mem[i];
+    for (i = 0; i < l; i++)
+        x_buf[i + L_MEM_DEC2] = x[i];
+    for (i = 0; i < L_MEM_DEC2; i++)
+        mem[i] = x[l - L_MEM_DEC2 + i];
+
+    for (i = 0, j = 0; i < l; i += 2, j++)
+    {
+        sum = 0.0f;
+        for (k = 0; k < L_FIR_DEC2; k++)
+            sum += x_buf[i + k] * h_fir_flt[k];
+        x[j] = sum * (1.0f / 32768.0f);
+    }
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *          preemphasis, deemphasis and pitch sharpening           *
+ *-----------------------------------------------------------------*/
+
+void Preemph_flt(
+     Float x[],                            /* (i/o)   : input signal overwritten by the output */
+     Float mu,                             /* (i)     : preemphasis coefficient                */
+     Word16 lg,                            /* (i)     : lenght of filtering                    */
+     Float * mem                           /* (i/o)   : memory (x[-1])                         */
+)
+{
+    Word16 i;
+    Float temp;
+
+    temp = x[lg - 1];
+
+    for (i = (Word16) (lg - 1); i > 0; i--)
+        x[i] -= mu * x[i - 1];
+
+    x[0] -= mu * (*mem);
+
+    *mem = temp;
+
+    return;
+}
+
+void Deemph_flt(
+     Float x[],                            /* (i/o)   : input signal overwritten by the output */
+     Float mu,                             /* (i)     : deemphasis factor                      */
+     Word16 L,                             /* (i)     : vector size                            */
+     Float * mem                           /* (i/o)   : memory (y[-1])                         */
+)
+{
+    Word16 i;
+
+    x[0] += mu * (*mem);
+
+    for (i = 1; i < L; i++)
+        x[i] += mu * x[i - 1];
+
+    *mem = x[L - 1];
+
+    return;
+}
+
+void Pit_shrp_flt(
+     Float x[],                            /* in/out: impulse response (or algebraic code) */
+     Word16 pit_lag,                       /* input : pitch lag                            */
+     Float sharp,                          /* input : pitch sharpening factor              */
+     Word16 L_subfr                        /* input : subframe size                        */
+)
+{
+    Word16 i;
+
+    for (i = pit_lag; i < L_subfr; i++)
+        x[i] += x[i - pit_lag] * sharp;
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *                 LP filtering and convolution                    *
+ *-----------------------------------------------------------------*/
+
+void Residu_flt(
+     Float a[],                            /* (i)     : prediction coefficients                     */
+     Word16 m,                             /* (i)     : order of LP filter                          */
+     Float x[],                            /* (i)     : speech (values x[-m..-1] are needed         */
+     Float y[],                            /* (o)     : residual signal                             */
+     Word16 lg                             /* (i)     : size of filtering                           */
+)
+{
+    Word16 i, j;
+    Float s;
+
+    for (i = 0; i < lg; i++)
+    {
+        s = x[i];
+        for (j = 1; j <= m; j++)
+            s += a[j] * x[i - j];
+        y[i] = s;
+    }
+
+    return;
+}
+
+void Syn_filt_flt(
+     Float a[],                            /* (i)     : a[m+1] prediction coefficients (a[0]=1) */
+     Word16 m,                             /* (i)     : order of LP filter                       */
+     Float x[],                            /* (i)     : input signal                             */
+     Float y[],                            /* (o)     : output signal                            */
+     Word16 lg,                            /* (i)     : size of filtering                        */
+     Float mem[],                          /* (i/o)   : memory associated with this filtering.   */
+     Word16 update                         /* (i)     : 0=no update, 1=update of memory.         */
+)
+{
+    Word16 i, j;
+    Float y_buf[L_SUBFR16k + M16k], s;
+    Float *yy;
+
+    yy = &y_buf[m];
+
+    for (i = 0; i < m; i++)
+        y_buf[i] = mem[i];
+
+    for (i = 0; i < lg; i++)
+    {
+        s = x[i];
+        for (j = 1; j <= m; j++)
+            s -= a[j] * yy[i - j];
+        yy[i] = s;
+        y[i] = s;
+    }
+
+    if (update)
+        for (i = 0; i < m; i++)
+            mem[i] = yy[lg - m + i];
+
+    return;
+}
+
+void Weight_a_flt(
+     Float a[],                            /* (i) : LPC coefficients                */
+     Float ap[],                           /* (o) : Spectral expanded LPC coeffs    */
+     Float gamma,                          /* (i) : Spectral expansion factor       */
+     Word16 m                              /* (i) : LPC order                       */
+)
+{
+    Word16 i;
+    Float fac;
+
+    ap[0] = a[0];
+    fac = gamma;
+    for (i = 1; i <= m; i++)
+    {
+        ap[i] = a[i] * fac;
+        fac *= gamma;
+    }
+
+    return;
+}
+
+void Convolve_flt(
+     Float x[],                            /* (i) : input vector                    */
+     Float h[],                            /* (i) : impulse response                */
+     Float y[],                            /* (o) : output vector                   */
+     Word16 L                              /* (i) : vector size                     */
+)
+{
+    Word16 i, n;
+    Float s;
+
+    for (n = 0; n < L; n++)
+    {
+        s = 0.0f;
+        for (i = 0; i <= n; i++)
+            s += x[i] * h[n - i];
+        y[n] = s;
+    }
+
+    return;
+}
+
+void Cor_h_x_flt(
+     Float h[],                            /* (i) : impulse response of weighted synthesis filter */
+     Float x[],                            /* (i) : target vector                                 */
+     Float dn[]                            /* (o) : correlation between target and h[]            */
+)
+{
+    Word16 i, j;
+    Float s;
+
+    for (i = 0; i < L_SUBFR; i++)
+    {
+        s = 0.0f;
+        for (j = i; j < L_SUBFR; j++)
+            s += x[j] * h[j - i];
+        dn[i] = s;
+    }
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *                           LPC analysis                          *
+ *-----------------------------------------------------------------*/
+
+void Autocorr_flt(
+     Float x[],                            /* (i) : Input signal (L_WINDOW)   */
+     Word16 m,                             /* (i) : LPC order                 */
+     Float r[]                             /* (o) : Autocorrelations          */
+)
+{
+    Word16 i, j;
+    Float y[L_WINDOW], sum;
+
+    for (i = 0; i < L_WINDOW; i++)
+        y[i] = x[i] * (Float) window[i] * (1.0f / 32768.0f);
+
+    for (i = 0; i <= m; i++)
+    {
+        sum = 0.0f;
+        for (j = 0; j < L_WINDOW - i; j++)
+            sum += y[j] * y[j + i];
+        r[i] = sum;
+    }
+
+    /* noise floor: keeps Levinson_flt() well conditioned on digital silence */
+    r[0] = r[0] * 1.0001f + 1.0f;
+
+    return;
+}
+
+void Lag_window_flt(
+     Float r[]                             /* (i/o) : Autocorrelations        */
+)
+{
+    Word16 i;
+
+    for (i = 1; i <= M; i++)
+        r[i] *= (Float) lag_h[i - 1] * (1.0f / 32768.0f) + (Float) lag_l[i - 1] * (1.0f / 1073741824.0f);
+
+    return;
+}
+
+void Levinson_flt(
+     Float r[],                            /* (i) : Autocorrelations                   */
+     Float A[],                            /* (o) : LPC coefficients (A[0] = 1.0)      */
+     Float mem[]                           /* (i/o): last stable filter (M+1)          */
+)
+{
+    Word16 i, j;
+    Float err, k, s, tmp[M + 1];
+
+    A[0] = 1.0f;
+    k = -r[1] / r[0];
+    A[1] = k;
+    err = r[0] * (1.0f - k * k);
+
+    for (i = 2; i <= M; i++)
+    {
+        s = r[i];
+        for (j = 1; j < i; j++)
+            s += A[j] * r[i - j];
+        k = -s / err;
+
+        /* unstable filter: keep the filter of the previous frame */
+        if ((k > 0.9995f) || (k < -0.9995f) || (err <= 0.0f))
+        {
+            for (j = 0; j <= M; j++)
+                A[j] = mem[j];
+            return;
+        }
+        for (j = 1; j < i; j++)
+            tmp[j] = A[j] + k * A[i - j];
+        for (j = 1; j < i; j++)
+            A[j] = tmp[j];
+        A[i] = k;
+        err *= (1.0f - k * k);
+    }
+
+    for (j = 0; j <= M; j++)
+        mem[j] = A[j];
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *                    ISP / LPC conversions                        *
+ *-----------------------------------------------------------------*/
+
+/* Chebyshev polynomial series C(x) = f(0)T_n(x) + ... + f(n-1)T_1(x) + f(n)/2 */
+
+static Float Chebps2_flt(Float x, Float f[], Word16 n)
+{
+    Word16 i;
+    Float b0, b1, b2, x2;
+
+    x2 = 2.0f * x;
+    b2 = f[0];
+    b1 = x2 * b2 + f[1];
+
+    for (i = 2; i < n; i++)
+    {
+        b0 = x2 * b1 - b2 + f[i];
+        b2 = b1;
+        b1 = b0;
+    }
+
+    return (x * b1 - b2 + 0.5f * f[n]);
+}
+
+void Az_isp_flt(
+     Float a[],                            /* (i) : predictor coefficients                 */
+     Float isp[],                          /* (o) : Immittance spectral pairs              */
+     Float old_isp[]                       /* (i) : old isp[] (in case not found M roots)  */
+)
+{
+    Word16 i, j, nf, ip, order;
+    Float xlow, ylow, xhigh, yhigh, xmid, ymid, xint;
+    Float *coef;
+    Float f1[M / 2 + 1], f2[M / 2];
+
+    /* F1(z) = A(z) + z^-M A(z^-1), F2(z) = [A(z) - z^-M A(z^-1)]/(1-z^-2) */
+    for (i = 0; i < M / 2; i++)
+    {
+        f1[i] = a[i] + a[M - i];
+        f2[i] = a[i] - a[M - i];
+    }
+    f1[M / 2] = 2.0f * a[M / 2];
+
+    for (i = 2; i < M / 2; i++)
+        f2[i] += f2[i - 2];
+
+    /* roots of F1(z) and F2(z) are alternatively searched on the grid */
+    nf = 0;
+    ip = 0;
+    coef = f1;
+    order = M / 2;
+
+    xlow = (Float) grid[0] * (1.0f / 32768.0f);
+    ylow = Chebps2_flt(xlow, coef, order);
+
+    j = 0;
+    while ((nf < M - 1) && (j < GRID_POINTS))
+    {
+        j++;
+        xhigh = xlow;
+        yhigh = ylow;
+        xlow = (Float) grid[j] * (1.0f / 32768.0f);
+        ylow = Chebps2_flt(xlow, coef, order);
+
+        if ((ylow * yhigh) <= 0.0f)
+        {
+            /* divide 2 times the interval */
+            for (i = 0; i < 2; i++)
+            {
+                xmid = 0.5f * (xlow + xhigh);
+                ymid = Chebps2_flt(xmid, coef, order);
+
+                if ((ylow * ymid) <= 0.0f)
+                {
+                    yhigh = ymid;
+                    xhigh = xmid;
+                } else
+                {
+                    ylow = ymid;
+                    xlow = xmid;
+                }
+            }
+
+            /* linear interpolation */
+            if (yhigh == ylow)
+                xint = xlow;
+            else
+                xint = xlow - ylow * (xhigh - xlow) / (yhigh - ylow);
+
+            isp[nf] = xint;
+            xlow = xint;
+            nf++;
+
+            if (ip == 0)
+            {
+                ip = 1;
+                coef = f2;
+                order = M / 2 - 1;
+            } else
+            {
+                ip = 0;
+                coef = f1;
+                order = M / 2;
+            }
+            ylow = Chebps2_flt(xlow, coef, order);
+        }
+    }
+
+    /* check if M-1 roots found */
+    if (nf < M - 1)
+    {
+        for (i = 0; i < M; i++)
+            isp[i] = old_isp[i];
+    } else
+    {
+        isp[M - 1] = a[M];
+    }
+
+    return;
+}
+
+static void Get_isp_pol_flt(Float * isp, Float * f, Word16 n)
+{
+    Word16 i, j;
+    Float b;
+
+    f[0] = 1.0f;
+    f[1] = -2.0f * isp[0];
+
+    for (i = 2; i <= n; i++)
+    {
+        b = -2.0f * isp[2 * i - 2];
+        f[i] = b * f[i - 1] + 2.0f * f[i - 2];
+        for (j = (Word16) (i - 1); j > 1; j--)
+            f[j] += b * f[j - 1] + f[j - 2];
+        f[1] += b;
+    }
+
+    return;
+}
+
+void Isp_Az_flt(
+     Float isp[],                          /* (i) : Immittance spectral pairs            */
+     Float a[],                            /* (o) : predictor coefficients (order = m)   */
+     Word16 m                              /* (i) : LPC order (M or M16k)                */
+)
+{
+    Word16 i, j, nc;
+    Float f1[M16k / 2 + 1], f2[M16k / 2];
+
+    nc = (Word16) (m >> 1);
+
+    Get_isp_pol_flt(&isp[0], f1, nc);
+    Get_isp_pol_flt(&isp[1], f2, (Word16) (nc - 1));
+
+    /* multiply F2(z) by (1 - z^-2) */
+    for (i = (Word16) (nc - 1); i > 1; i--)
+        f2[i] -= f2[i - 2];
+
+    /* scale F1(z) by (1+isp[m-1]) and F2(z) by (1-isp[m-1]) */
+    for (i = 0; i < nc; i++)
+    {
+        f1[i] *= (1.0f + isp[m - 1]);
+        f2[i] *= (1.0f - isp[m - 1]);
+    }
+
+    /* A(z) = (F1(z)+F2(z))/2, F1(z) is symmetric and F2(z) is antisymmetric */
+    a[0] = 1.0f;
+    for (i = 1, j = (Word16) (m - 1); i < nc; i++, j--)
+    {
+        a[i] = 0.5f * (f1[i] + f2[i]);
+        a[j] = 0.5f * (f1[i] - f2[i]);
+    }
+    a[nc] = 0.5f * f1[nc] * (1.0f + isp[m - 1]);
+    a[m] = isp[m - 1];
+
+    return;
+}
+
+void Int_isp_flt(
+     Float isp_old[],                      /* input : isps from past frame              */
+     Float isp_new[],                      /* input : isps from present frame           */
+     const Float frac[],                   /* input : fraction for 3 first subfr        */
+     Float Az[]                            /* output: LP coefficients in 4 subframes    */
+)
+{
+    Word16 i, k;
+    Float isp[M];
+
+    for (k = 0; k < 3; k++)
+    {
+        for (i = 0; i < M; i++)
+            isp[i] = isp_old[i] * (1.0f - frac[k]) + isp_new[i] * frac[k];
+
+        Isp_Az_flt(isp, Az, M);
+        Az += M + 1;
+    }
+
+    /* 4th subframe: isp_new (frac=1.0) */
+    Isp_Az_flt(isp_new, Az, M);
+
+    return;
+}
+
+void Isp_isf_flt(
+     Float isp[],                          /* (i)     : isp[m] (range: -1<=val<1)                */
+     Word16 isf[],                         /* (o) Q15 : isf[m] normalized (range: 0.0<=val<=0.5) */
+     Word16 m                              /* (i)     : LPC order                                */
+)
+{
+    Word16 i;
+    Float tmp;
+
+    for (i = 0; i < m; i++)
+    {
+        tmp = isp[i];
+        if (tmp > 1.0f)
+            tmp = 1.0f;
+        if (tmp < -1.0f)
+            tmp = -1.0f;
+        isf[i] = (Word16) (acos(tmp) * (16384.0 / PI_FLT) + 0.5);
+    }
+    isf[m - 1] = (Word16) (isf[m - 1] >> 1);
+
+    return;
+}
+
+void Isf_isp_flt(
+     Word16 isf[],                         /* (i) Q15 : isf[m] normalized (range: 0.0<=val<=0.5) */
+     Float isp[],                          /* (o)     : isp[m] (range: -1<=val<1)                */
+     Word16 m                              /* (i)     : LPC order                                */
+)
+{
+    Word16 i;
+
+    for (i = 0; i < m - 1; i++)
+        isp[i] = (Float) cos((Float) isf[i] * (PI_FLT / 16384.0f));
+    isp[m - 1] = (Float) cos((Float) isf[m - 1] * (PI_FLT / 8192.0f));
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *                          pitch analysis                         *
+ *-----------------------------------------------------------------*/
+
+Word16 Pitch_med_ol_flt(                   /* output: open loop pitch lag                   */
+     Float wsp[],                          /* input : signal (wsp[-L_max..-1] must be known) */
+     Word16 L_min,                         /* input : minimum pitch lag                     */
+     Word16 L_max,                         /* input : maximum pitch lag                     */
+     Word16 L_frame,                       /* input : length of frame to compute pitch      */
+     Word16 L_0,                           /* input : old open-loop pitch                   */
+     Float * gain,                         /* output: normalized correlation of hp_wsp      */
+     Float * hp_wsp_mem,                   /* i/o   : memory of Hp_wsp_flt() (6)            */
+     Float * old_hp_wsp,                   /* i/o   : past high-passed wsp[]                */
+     Word16 wght_flg                       /* input : is weighting function used            */
+)
+{
+    Word16 i, j, Tm;
+    const Float *ww, *we;
+    Float *hp_wsp;
+    Float max, R0, R1, R2;
+
+    ww = &corrweight_flt[198];
+    we = &corrweight_flt[98 + L_max - L_0];
+
+    max = -1.0e30f;
+    Tm = 0;
+    for (i = L_max; i > L_min; i--)
+    {
+        R0 = 0.0f;
+        for (j = 0; j < L_frame; j++)
+            R0 += wsp[j] * wsp[j - i];
+
+        /* weighting of the correlation function */
+        R0 *= *ww--;
+
+        /* weight the neighbourhood of the old lag */
+        if ((L_0 > 0) && (wght_flg > 0))
+            R0 *= *we--;
+
+        if (R0 >= max)
+        {
+            max = R0;
+            Tm = i;
+        }
+    }
+
+    /* hypass the wsp[] vector */
+    hp_wsp = old_hp_wsp + L_max;
+    Hp_wsp_flt(wsp, hp_wsp, L_frame, hp_wsp_mem);
+
+    /* normalized correlation at delay Tm */
+    R0 = 0.0f;
+    R1 = 1.0f;
+    R2 = 1.0f;
+    for (j = 0; j < L_frame; j++)
+    {
+        R0 += hp_wsp[j] * hp_wsp[j - Tm];
+        R1 += hp_wsp[j - Tm] * hp_wsp[j - Tm];
+        R2 += hp_wsp[j] * hp_wsp[j];
+    }
+    *gain = R0 / (Float) sqrt(R1 * R2);
+
+    /* shift hp_wsp[] for next frame */
+    for (i = 0; i < L_max; i++)
+        old_hp_wsp[i] = old_hp_wsp[i + L_frame];
+
+    return (Tm);
+}
+
+/* interpolation of the normalized correlation with 1/4 resolution */
+
+static Float Interpol_4_flt(Float * x, Word16 frac)
+{
+    Word16 i, k;
+    Float sum;
+
+    if (frac < 0)
+    {
+        frac = (Word16) (frac + 4);
+        x--;
+    }
+    x = x - L_INTERPOL1_FLT + 1;
+
+    sum = 0.0f;
+    for (i = 0, k = (Word16) (3 - frac); i < 2 * L_INTERPOL1_FLT; i++, k += 4)
+        sum += x[i] * inter4_1_flt[k];
+
+    return (sum * (1.0f / 16384.0f));
+}
+
+Word16 Pitch_fr4_flt(                      /* output: pitch period                          */
+     Float exc[],                          /* input : excitation buffer                     */
+     Float xn[],                           /* input : target vector                         */
+     Float h[],                            /* input : impulse response of filters           */
+     Word16 t0_min,                        /* input : minimum value in the searched range   */
+     Word16 t0_max,                        /* input : maximum value in the searched range   */
+     Word16 * pit_frac,                    /* output: chosen fraction (0, 1, 2 or 3)        */
+     Word16 i_subfr,                       /* input : indicator for first subframe          */
+     Word16 t0_fr2,                        /* input : minimum value for resolution 1/2      */
+     Word16 t0_fr1                         /* input : minimum value for resolution 1        */
+)
+{
+    Word16 i, k, t, t_min, t_max, t0, fraction, step;
+    Float corr_v[40], *corr;
+    Float excf[L_SUBFR], max, temp, cor, ener;
+
+    /* interval to compute normalized correlation */
+    t_min = (Word16) (t0_min - L_INTERPOL1_FLT);
+    t_max = (Word16) (t0_max + L_INTERPOL1_FLT);
+    corr = &corr_v[-t_min];
+
+    /* normalized correlation between target and filtered excitation */
+    k = (Word16) (-t_min);
+    Convolve_flt(&exc[k], h, excf, L_SUBFR);
+
+    for (t = t_min; t <= t_max; t++)
+    {
+        cor = Dot_product_flt(xn, excf, L_SUBFR);
+        ener = Dot_product_flt(excf, excf, L_SUBFR) + 0.01f;
+        corr[t] = cor / (Float) sqrt(ener);
+
+        /* update the filtered excitation excf[] for the next delay */
+        if (t != t_max)
+        {
+            k--;
+            for (i = (Word16) (L_SUBFR - 1); i > 0; i--)
+                excf[i] = excf[i - 1] + exc[k] * h[i];
+            excf[0] = exc[k] * h[0];
+        }
+    }
+
+    /* find integer pitch */
+    max = corr[t0_min];
+    t0 = t0_min;
+    for (i = (Word16) (t0_min + 1); i <= t0_max; i++)
+    {
+        if (corr[i] >= max)
+        {
+            max = corr[i];
+            t0 = i;
+        }
+    }
+
+    /* if first subframe and t0 >= t0_fr1, do not search fractionnal pitch */
+    if ((i_subfr == 0) && (t0 >= t0_fr1))
+    {
+        *pit_frac = 0;
+        return (t0);
+    }
+
+    /* search fractionnal pitch with 1/4 subsample resolution */
+    step = 1;
+    fraction = -3;
+    if (((i_subfr == 0) && (t0 >= t0_fr2)) || (t0_fr2 == PIT_MIN))
+    {
+        step = 2;
+        fraction = -2;
+    }
+    if (t0 == t0_min)
+        fraction = 0;
+
+    max = Interpol_4_flt(&corr[t0], fraction);
+    for (i = (Word16) (fraction + step); i <= 3; i = (Word16) (i + step))
+    {
+        temp = Interpol_4_flt(&corr[t0], i);
+        if (temp > max)
+        {
+            max = temp;
+            fraction = i;
+        }
+    }
+
+    /* limit the fraction value in the interval [0,1,2,3] */
+    if (fraction < 0)
+    {
+        fraction = (Word16) (fraction + 4);
+        t0--;
+    }
+    *pit_frac = fraction;
+
+    return (t0);
+}
+
+void Pred_lt4_flt(
+     Float exc[],                          /* in/out: excitation buffer */
+     Word16 T0,                            /* input : integer pitch lag */
+     Word16 frac,                          /* input : fraction of lag   */
+     Word16 L_subfr                        /* input : subframe size     */
+)
+{
+    Word16 i, j, k;
+    Float *x, sum;
+
+    x = &exc[-T0];
+    frac = (Word16) (-frac);
+    if (frac < 0)
+    {
+        frac = (Word16) (frac + 4);
+        x--;
+    }
+    x = x - L_INTERPOL2_FLT + 1;
+
+    for (j = 0; j < L_subfr; j++)
+    {
+        sum = 0.0f;
+        for (i = 0, k = (Word16) (3 - frac); i < 2 * L_INTERPOL2_FLT; i++, k += 4)
+            sum += x[i] * inter4_2_flt[k];
+
+        exc[j] = sum * (1.0f / 16384.0f);
+        x++;
+    }
+
+    return;
+}
+
+Float G_pitch_flt(                         /* (o)   : Gain of pitch lag saturated to 1.2   */
+     Float xn[],                           /* (i)   : Pitch target.                        */
+     Float y1[],                           /* (i)   : filtered adaptive codebook.          */
+     Float g_coeff[],                      /* (o)   : <y1 y1> and <xn y1>                  */
+     Word16 L_subfr                        /* (i)   : Length of subframe.                  */
+)
+{
+    Float xy, yy, gain;
+
+    yy = Dot_product_flt(y1, y1, L_subfr) + 0.01f;
+    xy = Dot_product_flt(xn, y1, L_subfr);
+
+    g_coeff[0] = yy;
+    g_coeff[1] = xy;
+
+    if (xy < 0.0f)
+        return (0.0f);
+
+    gain = xy / yy;
+    if (gain > 1.2f)
+        gain = 1.2f;
+
+    return (gain);
+}
+
+/*-----------------------------------------------------------------*
+ *                    excitation post-processing                   *
+ *-----------------------------------------------------------------*/
+
+Float voice_factor_flt(                    /* output: -1 (unvoiced) to 1 (voiced)           */
+     Float exc[],                          /* input : pitch excitation                      */
+     Float gain_pit,                       /* input : gain of pitch                         */
+     Float code[],                         /* input : fixed codebook excitation             */
+     Float gain_code,                      /* input : gain of code                          */
+     Word16 L_subfr                        /* input : subframe length                       */
+)
+{
+    Float ener1, ener2;
+
+    ener1 = gain_pit * gain_pit * Dot_product_flt(exc, exc, L_subfr);
+    ener2 = gain_code * gain_code * Dot_product_flt(code, code, L_subfr);
+
+    return ((ener1 - ener2) / (ener1 + ener2 + 0.01f));
+}
+
+void Phase_dispersion_flt(
+     Float gain_code,                      /* (i)     : gain of code             */
+     Float gain_pit,                       /* (i)     : gain of pitch            */
+     Float code[],                         /* (i/o)   : code vector              */
+     Word16 mode,                          /* (i)     : level, 0=hi, 1=lo, 2=off */
+     Float disp_mem[]                      /* (i/o)   : static memory (size = 8) */
+)
+{
+    Word16 i, j, state;
+    Float *prev_gain_pit, *prev_gain_code, *prev_state;
+    Float code2[2 * L_SUBFR];
+    const Float *ph_imp;
+
+    prev_state = disp_mem;
+    prev_gain_code = disp_mem + 1;
+    prev_gain_pit = disp_mem + 2;
+
+    if (gain_pit < 0.6f)
+        state = 0;
+    else if (gain_pit < 0.9f)
+        state = 1;
+    else
+        state = 2;
+
+    for (i = 5; i > 0; i--)
+        prev_gain_pit[i] = prev_gain_pit[i - 1];
+    prev_gain_pit[0] = gain_pit;
+
+    if ((gain_code - *prev_gain_code) > (2.0f * *prev_gain_code))
+    {
+        /* onset */
+        if (state < 2)
+            state++;
+    } else
+    {
+        j = 0;
+        for (i = 0; i < 6; i++)
+        {
+            if (prev_gain_pit[i] < 0.6f)
+                j++;
+        }
+        if (j > 2)
+            state = 0;
+
+        if ((state - (Word16) (*prev_state)) > 1)
+            state--;
+    }
+
+    *prev_gain_code = gain_code;
+    *prev_state = (Float) state;
+
+    /* circular convolution */
+    state = (Word16) (state + mode);       /* level of dispersion */
+
+    if (state >= 2)
+        return;
+
+    ph_imp = (state == 0) ? ph_imp_low_flt : ph_imp_mid_flt;
+
+    for (i = 0; i < 2 * L_SUBFR; i++)
+        code2[i] = 0.0f;
+
+    for (i = 0; i < L_SUBFR; i++)
+    {
+        if (code[i] != 0.0f)
+        {
+            for (j = 0; j < L_SUBFR; j++)
+                code2[i + j] += code[i] * ph_imp[j] * (1.0f / 32768.0f);
+        }
+    }
+
+    for (i = 0; i < L_SUBFR; i++)
+        code[i] = code2[i] + code2[i + L_SUBFR];
+
+    return;
+}
+
+void agc2_flt(
+     Float sig_in[],                       /* (i)     : postfilter input signal  */
+     Float sig_out[],                      /* (i/o)   : postfilter output signal */
+     Word16 l_trm                          /* (i)     : subframe size            */
+)
+{
+    Word16 i;
+    Float gain_in, gain_out, g0;
+
+    gain_out = Dot_product_flt(sig_out, sig_out, l_trm);
+    if (gain_out == 0.0f)
+        return;
+
+    gain_in = Dot_product_flt(sig_in, sig_in, l_trm);
+    if (gain_in == 0.0f)
+        g0 = 0.0f;
+    else
+        g0 = (Float) sqrt(gain_in / gain_out);
+
+    for (i = 0; i < l_trm; i++)
+        sig_out[i] *= g0;
+
+    return;
+}
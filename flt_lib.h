@@ -0,0 +1,162 @@
+/*--------------------------------------------------------------------------*
+ *                         FLT_LIB.H                                        *
+ *--------------------------------------------------------------------------*
+ *       Floating-point signal processing used by cod_flt.c and dec_flt.c   *
+ *                                                                          *
+ * All the signals are kept in their natural scale (no Q format, no        *
+ * dynamic scaling): speech and excitation are in the 16-bit PCM range     *
+ * and the LP coefficients have a[0] = 1.0.                                 *
+ *--------------------------------------------------------------------------*/
+
+#ifndef flt_lib_h
+#define flt_lib_h
+
+#include "typedef.h"
+#include "cnst.h"
+
+#define L_INTERPOL1_FLT   4                /* Pitch_fr4_flt() interpolation length  */
+#define L_INTERPOL2_FLT   16               /* Pred_lt4_flt() interpolation length   */
+#define L_FIR_HF          31               /* Filt_6k_7k_flt(), Filt_7k_flt() length */
+
+/*-----------------------------------------------------------------*
+ *                      conversion utilities                       *
+ *-----------------------------------------------------------------*/
+
+void Word16_to_flt(Word16 x[], Float y[], Word16 lg);
+void Flt_to_word16(Float x[], Word16 y[], Word16 lg);   /* rounding with saturation */
+Float Dot_product_flt(Float x[], Float y[], Word16 lg);
+
+/*-----------------------------------------------------------------*
+ *                 sampling rate conversion and filters            *
+ *-----------------------------------------------------------------*/
+
+void Decim_12k8_flt(
+     Float sig16k[],                       /* input:  signal to downsampling  */
+     Word16 lg,                            /* input:  length of input         */
+     Float sig12k8[],                      /* output: decimated signal        */
+     Float mem[]                           /* in/out: memory (2*15)           */
+);
+void Oversamp_16k_flt(
+     Float sig12k8[],                      /* input:  signal to oversampling  */
+     Word16 lg,                            /* input:  length of input         */
+     Float sig16k[],                       /* output: oversampled signal      */
+     Float mem[]                           /* in/out: memory (2*12)           */
+);
+void HP50_12k8_flt(Float signal[], Word16 lg, Float mem[]);      /* mem[4] */
+void HP400_12k8_flt(Float signal[], Word16 lg, Float mem[]);     /* mem[4] */
+void Filt_6k_7k_flt(Float signal[], Word16 lg, Float mem[]);     /* mem[30] */
+void Filt_7k_flt(Float signal[], Word16 lg, Float mem[]);        /* mem[30] */
+void LP_Decim2_flt(Float x[], Word16 l, Float mem[]);            /* mem[3] */
+void Hp_wsp_flt(Float wsp[], Float hp_wsp[], Word16 lg, Float mem[]);   /* mem[6] */
+
+void Preemph_flt(Float x[], Float mu, Word16 lg, Float * mem);
+void Deemph_flt(Float x[], Float mu, Word16 L, Float * mem);
+void Pit_shrp_flt(Float x[], Word16 pit_lag, Float sharp, Word16 L_subfr);
+
+void Residu_flt(Float a[], Word16 m, Float x[], Float y[], Word16 lg);
+void Syn_filt_flt(Float a[], Word16 m, Float x[], Float y[], Word16 lg, Float mem[], Word16 update);
+void Weight_a_flt(Float a[], Float ap[], Float gamma, Word16 m);
+void Convolve_flt(Float x[], Float h[], Float y[], Word16 L);
+void Cor_h_x_flt(Float h[], Float x[], Float dn[]);
+
+/*-----------------------------------------------------------------*
+ *                           LPC analysis                          *
+ *-----------------------------------------------------------------*/
+
+void Autocorr_flt(Float x[], Word16 m, Float r[]);
+void Lag_window_flt(Float r[]);
+void Levinson_flt(Float r[], Float A[], Float mem[]);            /* mem[M+1] */
+void Az_isp_flt(Float a[], Float isp[], Float old_isp[]);
+void Isp_Az_flt(Float isp[], Float a[], Word16 m);
+void Int_isp_flt(Float isp_old[], Float isp_new[], const Float frac[], Float Az[]);
+void Isp_isf_flt(Float isp[], Word16 isf[], Word16 m);           /* isf[] in Q15 (quantizer domain) */
+void Isf_isp_flt(Word16 isf[], Float isp[], Word16 m);
+
+/*-----------------------------------------------------------------*
+ *                          pitch analysis                         *
+ *-----------------------------------------------------------------*/
+
+Word16 Pitch_med_ol_flt(                   /* output: open loop pitch lag                   */
+     Float wsp[],                          /* input : signal (wsp[-L_max..-1] must be known) */
+     Word16 L_min,                         /* input : minimum pitch lag                     */
+     Word16 L_max,                         /* input : maximum pitch lag                     */
+     Word16 L_frame,                       /* input : length of frame to compute pitch      */
+     Word16 L_0,                           /* input : old open-loop pitch                   */
+     Float * gain,                         /* output: normalized correlation of hp_wsp      */
+     Float * hp_wsp_mem,                   /* i/o   : memory of Hp_wsp_flt() (6)            */
+     Float * old_hp_wsp,                   /* i/o   : past high-passed wsp[]                */
+     Word16 wght_flg                       /* input : is weighting function used            */
+);
+Word16 Pitch_fr4_flt(                      /* output: pitch period                          */
+     Float exc[],                          /* input : excitation buffer                     */
+     Float xn[],                           /* input : target vector                         */
+     Float h[],                            /* input : impulse response of filters           */
+     Word16 t0_min,                        /* input : minimum value in the searched range   */
+     Word16 t0_max,                        /* input : maximum value in the searched range   */
+     Word16 * pit_frac,                    /* output: chosen fraction (0, 1, 2 or 3)        */
+     Word16 i_subfr,                       /* input : indicator for first subframe          */
+     Word16 t0_fr2,                        /* input : minimum value for resolution 1/2      */
+     Word16 t0_fr1                         /* input : minimum value for resolution 1        */
+);
+void Pred_lt4_flt(Float exc[], Word16 T0, Word16 frac, Word16 L_subfr);
+Float G_pitch_flt(Float xn[], Float y1[], Float g_coeff[], Word16 L_subfr);
+
+/*-----------------------------------------------------------------*
+ *                    excitation post-processing                   *
+ *-----------------------------------------------------------------*/
+
+Float voice_factor_flt(                    /* output: -1 (unvoiced) to 1 (voiced)           */
+     Float exc[],                          /* input : pitch excitation                      */
+     Float gain_pit,                       /* input : gain of pitch                         */
+     Float code[],                         /* input : fixed codebook excitation             */
+     Float gain_code,                      /* input : gain of code                          */
+     Word16 L_subfr                        /* input : subframe length                       */
+);
+void Phase_dispersion_flt(
+     Float gain_code,                      /* (i)     : gain of code             */
+     Float gain_pit,                       /* (i)     : gain of pitch            */
+     Float code[],                         /* (i/o)   : code vector              */
+     Word16 mode,                          /* (i)     : level, 0=hi, 1=lo, 2=off */
+     Float disp_mem[]                      /* (i/o)   : static memory (size = 8) */
+);
+void agc2_flt(Float sig_in[], Float sig_out[], Word16 l_trm);
+
+/*-----------------------------------------------------------------*
+ *                   codebook search and gain quantizer            *
+ *-----------------------------------------------------------------*/
+
+void ACELP_2t64_flt(
+     Float dn[],                           /* (i) : correlation between target x[] and H[]  */
+     Float cn[],                           /* (i) : residual after long term prediction     */
+     Float H[],                            /* (i) : impulse response of weighted synthesis  */
+     Float code[],                         /* (o) : algebraic (fixed) codebook excitation   */
+     Float y[],                            /* (o) : filtered fixed codebook excitation      */
+     Word16 * index                        /* (o) : index (12 bits)                         */
+);
+void ACELP_4t64_flt(
+     Float dn[],                           /* (i) : correlation between target x[] and H[]  */
+     Float cn[],                           /* (i) : residual after long term prediction     */
+     Float H[],                            /* (i) : impulse response of weighted synthesis  */
+     Float code[],                         /* (o) : algebraic (fixed) codebook excitation   */
+     Float y[],                            /* (o) : filtered fixed codebook excitation      */
+     Word16 nbbits,                        /* (i) : 20, 36, 44, 52, 64, 72 or 88 bits       */
+     Word16 ser_size,                      /* (i) : bit rate                                */
+     Word16 _index[]                       /* (o) : same indices as ACELP_4t64_fx()         */
+);
+
+void Init_Q_gain2_flt(Float * mem);        /* mem[4] */
+Word16 Q_gain2_flt(                        /* Return index of quantization                  */
+     Float xn[],                           /* (i) : target vector                           */
+     Float y1[],                           /* (i) : filtered adaptive codebook              */
+     Float y2[],                           /* (i) : filtered innovative vector              */
+     Float code[],                         /* (i) : innovative vector                       */
+     Float g_coeff[],                      /* (i) : <y1 y1> and <xn y1> from G_pitch_flt()  */
+     Word16 L_subfr,                       /* (i) : subframe length                         */
+     Word16 nbits,                         /* (i) : number of bits (6 or 7)                 */
+     Float * gain_pit,                     /* (i/o): pitch gain                             */
+     Float * gain_cod,                     /* (o) : code gain                               */
+     Word16 gp_clip,                       /* (i) : Gp Clipping flag                        */
+     Float * mem                           /* (i/o): past quantized energies (4)            */
+);
+
+#endif
@@ -0,0 +1,374 @@
+/*------------------------------------------------------------------------*
+ *                         GSCALE.C                                       *
+ *------------------------------------------------------------------------*
+ * Gain scaling in the coded domain                                       *
+ *------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "oper_32b.h"
+#include "log2.h"
+#include "cnst.h"
+#include "bits.h"
+#include "dtx.h"
+#include "main.h"
+#include "count.h"
+#include "rom_tab.h"
+#include "gscale.h"
+
+/*-----------------------------------------------------------------*
+ * The level of a bitstream is changed by rewriting the indices    *
+ * of the gain quantizer (and the energy index of the SID frames), *
+ * without decoding the signal.                                    *
+ *                                                                 *
+ * The code gain of a subframe is g_code x gcode0, where gcode0 is *
+ * predicted from the past g_code (MA predictor of D_gain2()).     *
+ * The predictor of the received stream and the predictor of the   *
+ * rewritten stream are both tracked: the new index is the entry   *
+ * of the gain table with the closest pitch gain and the closest   *
+ * code gain to (received code gain + scale), in the predictor     *
+ * of the rewritten stream.                                        *
+ *                                                                 *
+ * The pitch gain is kept: the past excitation of the decoder is   *
+ * already scaled. The 23.85 kbit/s HF gain is relative to the     *
+ * synthesis and is not modified.                                  *
+ *-----------------------------------------------------------------*/
+
+#define PRED_ORDER   4
+
+/* MA prediction coeff ={0.5, 0.4, 0.3, 0.2} in Q13: pred_gain[] of rom_tab.c */
+
+/* position (bit) of the energy index in SID frames */
+#define SID_LOG_EN_POS  28
+#define SID_LOG_EN_BITS 6
+
+static Word16 qua_ener(Word16 g_code);
+static Word32 pred_ener(Word16 past_qua_en[]);
+static void update_qua_en(Word16 past_qua_en[], Word16 qua, Word16 bfi);
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_gain_scale                                      *
+ *            ~~~~~~~~~~~~~~~                                      *
+ *   ->Initialization of the gain scaler (scale = 0 dB).           *
+ *-----------------------------------------------------------------*/
+
+Word16 Init_gain_scale(GScale_State ** state)
+{
+    GScale_State *st;
+    Word16 i;
+
+    *state = NULL;
+
+    test();
+    if ((st = (GScale_State *) malloc(sizeof(GScale_State))) == NULL)
+    {
+        fprintf(stderr, "Init_gain_scale: can not malloc state structure\n");
+        return -1;
+    }
+    for (i = 0; i < nb_qua_gain6b; i++)
+    {
+        st->qua_ener6b[i] = qua_ener(t_qua_gain6b[2 * i + 1]);  move16();
+    }
+    for (i = 0; i < nb_qua_gain7b; i++)
+    {
+        st->qua_ener7b[i] = qua_ener(t_qua_gain7b[2 * i + 1]);  move16();
+    }
+    Set_gain_scale(st, 0);
+    Reset_gain_scale(st);
+
+    *state = st;
+
+    return 0;
+}
+
+void Reset_gain_scale(GScale_State * st)
+{
+    Word16 i;
+
+    /* 4nd order quantizer energy predictor (init to -14.0 in Q10) */
+    for (i = 0; i < PRED_ORDER; i++)
+    {
+        st->past_qua_en[i] = -14336;       move16();
+        st->past_qua_en_out[i] = -14336;   move16();
+    }
+    st->dtx = 0;                           move16();
+
+    return;
+}
+
+void Close_gain_scale(GScale_State * st)
+{
+    free(st);
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Set_gain_scale                                       *
+ *            ~~~~~~~~~~~~~~                                       *
+ *   ->Gain in dB (Q10) applied from the next frame.               *
+ *     SID energy index: log2(E) x 2.625, i.e. 0.872 step per dB.  *
+ *-----------------------------------------------------------------*/
+
+void Set_gain_scale(GScale_State * st, Word16 scale)
+{
+    st->scale = scale;                     move16();
+    st->sid_step = shr_r(mult(scale, 28574), 10);       move16();
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Gain_scale                                           *
+ *            ~~~~~~~~~~                                           *
+ *   ->Rewrites the gain indices of one frame in prms[].           *
+ *     Bad frames and decoder homing frames are not modified.      *
+ *-----------------------------------------------------------------*/
+
+void Gain_scale(
+     Word16 mode,                          /* i   : used mode                   */
+     Word16 prms[],                        /* i/o : parameter vector (serial)   */
+     Word16 frame_type,                    /* i   : received frame type         */
+     GScale_State * st                     /* i/o : State structure             */
+)
+{
+    Word16 j, i_subfr, nb_bits, nbits_gain, pos, index, best;
+    Word16 gain_pit, dp, dq, bfi;
+    Word16 *p, *qua, size;
+    const Word16 *table;
+    Word32 L_target, L_tmp, L_err, L_err_min;
+
+    /* SPEECH / DTX decision of rx_dtx_handler() */
+    test();test();test();test();test();test();test();test();
+    if ((sub(frame_type, RX_SID_FIRST) == 0) ||
+        (sub(frame_type, RX_SID_UPDATE) == 0) ||
+        (sub(frame_type, RX_SID_BAD) == 0) ||
+        ((st->dtx != 0) &&
+            ((sub(frame_type, RX_NO_DATA) == 0) ||
+                (sub(frame_type, RX_SPEECH_BAD) == 0) ||
+                (sub(frame_type, RX_SPEECH_LOST) == 0))))
+    {
+        st->dtx = 1;                       move16();
+
+        test();
+        if (sub(frame_type, RX_SID_UPDATE) == 0)
+        {
+            p = &prms[SID_LOG_EN_POS];
+            index = Serial_parm(SID_LOG_EN_BITS, &p);
+            index = add(index, st->sid_step);
+            test();
+            if (index < 0)
+            {
+                index = 0;                 move16();
+            }
+            test();
+            if (sub(index, (1 << SID_LOG_EN_BITS) - 1) > 0)
+            {
+                index = (1 << SID_LOG_EN_BITS) - 1;     move16();
+            }
+            p = &prms[SID_LOG_EN_POS];
+            Parm_serial(index, SID_LOG_EN_BITS, &p);
+        }
+        return;
+    }
+    st->dtx = 0;                           move16();
+
+    /* decoder homing frame: the decoder is reset after it */
+    test();
+    if (sub(frame_type, RX_SPEECH_GOOD) == 0)
+    {
+        test();
+        if (decoder_homing_frame_test(prms, mode) != 0)
+        {
+            Reset_gain_scale(st);
+            return;
+        }
+    }
+    test();
+    if (sub(frame_type, RX_SPEECH_GOOD) == 0)
+    {
+        bfi = 0;                           move16();
+    } else
+    {
+        bfi = 1;                           move16();
+    }
+    /* the gains of a bad frame are concealed by the decoder */
+    test();
+    if (bfi != 0)
+    {
+        for (i_subfr = 0; i_subfr < NB_SUBFR; i_subfr++)
+        {
+            update_qua_en(st->past_qua_en, 0, 1);
+            update_qua_en(st->past_qua_en_out, 0, 1);
+        }
+        return;
+    }
+    nb_bits = nb_of_bits[mode];            move16();
+
+    test();
+    if (sub(nb_bits, NBBITS_9k) <= 0)
+    {
+        nbits_gain = 6;                    move16();
+        table = t_qua_gain6b;              move16();
+        qua = st->qua_ener6b;              move16();
+        size = nb_qua_gain6b;              move16();
+    } else
+    {
+        nbits_gain = 7;                    move16();
+        table = t_qua_gain7b;              move16();
+        qua = st->qua_ener7b;              move16();
+        size = nb_qua_gain7b;              move16();
+    }
+
+    /* bit position of the first gain index (see decoder()) */
+    test();
+    if (sub(nb_bits, NBBITS_7k) <= 0)
+    {
+        pos = 1 + 36;                      move16();
+    } else
+    {
+        pos = 1 + 46;                      move16();
+    }
+
+    for (i_subfr = 0; i_subfr < NB_SUBFR; i_subfr++)
+    {
+        /* pitch lag */
+        test();test();test();
+        if ((i_subfr == 0) || ((sub(i_subfr, 2) == 0) && (sub(nb_bits, NBBITS_7k) > 0)))
+        {
+            test();
+            if (sub(nb_bits, NBBITS_9k) <= 0)
+                pos = add(pos, 8);
+            else
+                pos = add(pos, 9);
+        } else
+        {
+            test();
+            if (sub(nb_bits, NBBITS_9k) <= 0)
+                pos = add(pos, 5);
+            else
+                pos = add(pos, 6);
+        }
+        /* LP filter selection and algebraic codebook */
+        test();
+        if (sub(nb_bits, NBBITS_9k) > 0)
+        {
+            pos = add(pos, 1);
+        }
+        pos = add(pos, nb_of_cb_bits[mode]);
+
+        /* received gains */
+        p = &prms[pos];
+        index = Serial_parm(nbits_gain, &p);
+        gain_pit = table[2 * index];       move16();
+
+        /* code gain to reach in the rewritten stream, relative to its prediction (Q10) */
+        L_target = L_add(L_deposit_l(qua[index]), pred_ener(st->past_qua_en));
+        L_target = L_add(L_target, L_deposit_l(st->scale));
+        L_target = L_sub(L_target, pred_ener(st->past_qua_en_out));
+
+        update_qua_en(st->past_qua_en, qua[index], 0);
+
+        /* closest entry: 1 dB of code gain (Q10) weighs as 1/16 of pitch gain (Q14) */
+        best = index;                      move16();
+        L_err_min = MAX_32;                move32();
+        for (j = 0; j < size; j++)
+        {
+            dp = sub(table[2 * j], gain_pit);
+            L_tmp = L_sub(L_deposit_l(qua[j]), L_target);
+            test();test();
+            if (L_sub(L_tmp, 16383) > 0)
+            {
+                L_tmp = 16383;             move32();
+            } else if (L_add(L_tmp, 16383) < 0)
+            {
+                L_tmp = -16383;            move32();
+            }
+            dq = extract_l(L_tmp);
+            L_err = L_mult(dp, dp);
+            L_err = L_mac(L_err, dq, dq);
+            test();
+            if (L_sub(L_err, L_err_min) < 0)
+            {
+                L_err_min = L_err;         move32();
+                best = j;                  move16();
+            }
+        }
+        update_qua_en(st->past_qua_en_out, qua[best], 0);
+
+        p = &prms[pos];
+        Parm_serial(best, nbits_gain, &p);
+
+        pos = add(pos, nbits_gain);
+
+        /* HF gain (23.85 kbit/s) */
+        test();
+        if (sub(nb_bits, NBBITS_24k) >= 0)
+        {
+            pos = add(pos, 4);
+        }
+    }
+
+    return;
+}
+
+/* 20*log10(g_code), g_code in Q11 -> Q10 (as in D_gain2()) */
+
+static Word16 qua_ener(Word16 g_code)
+{
+    Word16 exp, frac;
+    Word32 L_tmp;
+
+    L_tmp = L_deposit_l(g_code);
+    Log2(L_tmp, &exp, &frac);
+    exp = sub(exp, 11);
+    L_tmp = Mpy_32_16(exp, frac, 24660);   /* x 6.0206 in Q12 */
+
+    return extract_l(L_shr(L_tmp, 3));     /* result in Q10 */
+}
+
+/* predicted energy Sum(i=0,3) pred[i]*past_qua_en[i] in Q10 (32 bits) */
+
+static Word32 pred_ener(Word16 past_qua_en[])
+{
+    Word16 i;
+    Word32 L_tmp;
+
+    L_tmp = 0;                             move32();
+    for (i = 0; i < PRED_ORDER; i++)
+    {
+        L_tmp = L_mac(L_tmp, pred_gain[i], past_qua_en[i]);  /* Q13*Q10 -> Q24 */
+    }
+    return L_shr(L_tmp, 14);
+}
+
+/* update of the past quantized energies (bad frame: as in D_gain2()) */
+
+static void update_qua_en(Word16 past_qua_en[], Word16 qua, Word16 bfi)
+{
+    Word32 L_tmp;
+
+    test();
+    if (bfi != 0)
+    {
+        L_tmp = L_mult(past_qua_en[0], 8192);   /* x 0.25 */
+        L_tmp = L_mac(L_tmp, past_qua_en[1], 8192);
+        L_tmp = L_mac(L_tmp, past_qua_en[2], 8192);
+        L_tmp = L_mac(L_tmp, past_qua_en[3], 8192);
+        qua = extract_h(L_tmp);
+
+        qua = sub(qua, 3072);              /* -3 in Q10 */
+        test();
+        if (sub(qua, -14336) < 0)
+        {
+            qua = -14336;                  move16();  /* -14 in Q10 */
+        }
+    }
+    past_qua_en[3] = past_qua_en[2];       move16();
+    past_qua_en[2] = past_qua_en[1];       move16();
+    past_qua_en[1] = past_qua_en[0];       move16();
+    past_qua_en[0] = qua;                  move16();
+
+    return;
+}
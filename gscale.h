@@ -0,0 +1,40 @@
+/*--------------------------------------------------------------------------*
+ *                         GSCALE.H                                         *
+ *--------------------------------------------------------------------------*
+ *       Gain scaling in the coded domain (volume control of a bitstream)   *
+ *--------------------------------------------------------------------------*/
+
+#ifndef gscale_h
+#define gscale_h
+
+#include "typedef.h"
+#include "cnst.h"
+
+typedef struct
+{
+    Word16 scale;                          /* gain applied to the stream (dB, Q10)        */
+    Word16 sid_step;                       /* same gain in SID energy index steps         */
+    Word16 past_qua_en[4];                 /* gain predictor of the received stream (Q10) */
+    Word16 past_qua_en_out[4];             /* gain predictor of the rewritten stream      */
+    Word16 dtx;                            /* decoder in DTX (no gain decoding)           */
+    Word16 qua_ener6b[64];                 /* 20*log10(g_code) of t_qua_gain6b[] (Q10)    */
+    Word16 qua_ener7b[128];                /* 20*log10(g_code) of t_qua_gain7b[] (Q10)    */
+} GScale_State;
+
+Word16 Init_gain_scale(GScale_State ** st);
+void Reset_gain_scale(GScale_State * st);
+void Close_gain_scale(GScale_State * st);
+
+void Set_gain_scale(
+     GScale_State * st,                    /* i/o : State structure             */
+     Word16 scale                          /* i   : gain in dB (Q10)            */
+);
+
+void Gain_scale(
+     Word16 mode,                          /* i   : used mode                   */
+     Word16 prms[],                        /* i/o : parameter vector (serial)   */
+     Word16 frame_type,                    /* i   : received frame type         */
+     GScale_State * st                     /* i/o : State structure             */
+);
+
+#endif
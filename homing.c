@@ -119,3 +119,22 @@ Word16 decoder_homing_frame_test_first(Word16 input_frame[], Word16 mode)
     /* perform test for FIRST SUBFRAME of parameter frame ONLY */
     return dhf_test(input_frame, mode, prmnofsf[mode]);
 }
+
+
+/* serial bits of the decoder homing frame of a speech mode (transrating) */
+void decoder_homing_frame(Word16 prms[], Word16 mode)
+{
+    Word16 i, n, nbits;
+
+    nbits = nb_of_bits[mode];
+    for (i = 0; nbits > 0; i++)
+    {
+        n = PRML;
+        if (sub(nbits, PRML) < 0)
+        {
+            n = nbits;
+        }
+        Parm_serial(shr(dhf[mode][i], sub(PRML, n)), n, &prms);
+        nbits = sub(nbits, n);
+    }
+}
@@ -25,11 +25,9 @@
 #include "oper_32b.h"
 #include "acelp.h"
 #include "count.h"
+#include "rom_tab.h"
 
-/* filter coefficients  */
-
-static Word16 b[3] = {915, -1830, 915};         /* Q12 (/4) */
-static Word16 a[3] = {16384, 29280, -14160};    /* Q12 (x4) */
+/* filter coefficients: hp400_b[] (Q12 /4), hp400_a[] (Q12 x4) of rom_tab.c */
 
 
 /* Initialization of static values */
@@ -68,14 +66,14 @@ void HP400_12k8(
 
         move32();
         L_tmp = 16384L;                    /* rounding to maximise precision */
-        L_tmp = L_mac(L_tmp, y1_lo, a[1]);
-        L_tmp = L_mac(L_tmp, y2_lo, a[2]);
+        L_tmp = L_mac(L_tmp, y1_lo, hp400_a[1]);
+        L_tmp = L_mac(L_tmp, y2_lo, hp400_a[2]);
         L_tmp = L_shr(L_tmp, 15);
-        L_tmp = L_mac(L_tmp, y1_hi, a[1]);
-        L_tmp = L_mac(L_tmp, y2_hi, a[2]);
-        L_tmp = L_mac(L_tmp, x0, b[0]);
-        L_tmp = L_mac(L_tmp, x1, b[1]);
-        L_tmp = L_mac(L_tmp, x2, b[2]);
+        L_tmp = L_mac(L_tmp, y1_hi, hp400_a[1]);
+        L_tmp = L_mac(L_tmp, y2_hi, hp400_a[2]);
+        L_tmp = L_mac(L_tmp, x0, hp400_b[0]);
+        L_tmp = L_mac(L_tmp, x1, hp400_b[1]);
+        L_tmp = L_mac(L_tmp, x2, hp400_b[2]);
 
         L_tmp = L_shl(L_tmp, 1);           /* coeff Q12 --> Q13 */
 
@@ -26,10 +26,9 @@
 #include "cnst.h"
 #include "acelp.h"
 #include "count.h"
+#include "rom_tab.h"
 
-/* filter coefficients  */
-static Word16 b[3] = {4053, -8106, 4053};  /* Q12 */
-static Word16 a[3] = {8192, 16211, -8021}; /* Q12 (x2) */
+/* filter coefficients: hp50_b[] (Q12), hp50_a[] (Q12 x2) of rom_tab.c */
 
 /* Initialization of static values */
 
@@ -67,14 +66,14 @@ void HP50_12k8(
 
         move32();
         L_tmp = 16384L;                    /* rounding to maximise precision */
-        L_tmp = L_mac(L_tmp, y1_lo, a[1]);
-        L_tmp = L_mac(L_tmp, y2_lo, a[2]);
+        L_tmp = L_mac(L_tmp, y1_lo, hp50_a[1]);
+        L_tmp = L_mac(L_tmp, y2_lo, hp50_a[2]);
         L_tmp = L_shr(L_tmp, 15);
-        L_tmp = L_mac(L_tmp, y1_hi, a[1]);
-        L_tmp = L_mac(L_tmp, y2_hi, a[2]);
-        L_tmp = L_mac(L_tmp, x0, b[0]);
-        L_tmp = L_mac(L_tmp, x1, b[1]);
-        L_tmp = L_mac(L_tmp, x2, b[2]);
+        L_tmp = L_mac(L_tmp, y1_hi, hp50_a[1]);
+        L_tmp = L_mac(L_tmp, y2_hi, hp50_a[2]);
+        L_tmp = L_mac(L_tmp, x0, hp50_b[0]);
+        L_tmp = L_mac(L_tmp, x1, hp50_b[1]);
+        L_tmp = L_mac(L_tmp, x2, hp50_b[2]);
 
         L_tmp = L_shl(L_tmp, 2);           /* coeff Q12 --> Q14 */
 
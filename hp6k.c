@@ -12,21 +12,11 @@
 #include "acelp.h"
 #include "count.h"
 #include "cnst.h"
+#include "rom_tab.h"
 
 #define L_FIR 31
 
-/* filter coefficients (gain=4.0) */
-
-static Word16 fir_6k_7k[L_FIR] =
-{
-    -32, 47, 32, -27, -369,
-    1122, -1421, 0, 3798, -8880,
-    12349, -10984, 3548, 7766, -18001,
-    22118, -18001, 7766, 3548, -10984,
-    12349, -8880, 3798, 0, -1421,
-    1122, -369, -27, 32, 47,
-    -32
-};
+/* filter coefficients (gain=4.0): fir_6k_7k[] of rom_tab.c */
 
 
 void Init_Filt_6k_7k(Word16 mem[])         /* mem[30] */
@@ -42,8 +32,7 @@ void Filt_6k_7k(
      Word16 mem[]                          /* in/out: memory (size=30)        */
 )
 {
-    Word16 i, j, x[L_SUBFR16k + (L_FIR - 1)];
-    Word32 L_tmp;
+    Word16 i, x[L_SUBFR16k + (L_FIR - 1)];
 
     Copy(mem, x, L_FIR - 1);
 
@@ -52,13 +41,7 @@ void Filt_6k_7k(
         x[i + L_FIR - 1] = shr(signal[i], 2);   move16();  /* gain of filter = 4 */
     }
 
-    for (i = 0; i < lg; i++)
-    {
-        L_tmp = 0;                         move32();
-        for (j = 0; j < L_FIR; j++)
-            L_tmp = L_mac(L_tmp, x[i + j], fir_6k_7k[j]);
-        signal[i] = round(L_tmp);          move16();
-    }
+    Fir_sym31(x, fir_6k_7k, signal, lg);        /* symmetric filter */
 
     Copy(x + lg, mem, L_FIR - 1);
 
@@ -1,5 +1,5 @@
 /*-------------------------------------------------------------------*
- *                         HP6K.C									 *
+ *                         HP7K.C									 *
  *-------------------------------------------------------------------*
  * 15th order high pass 7kHz FIR filter.                             *
  *                                                                   *
@@ -10,20 +10,12 @@
 #include "cnst.h"
 #include "acelp.h"
 #include "count.h"
+#include "rom_tab.h"
 
 
 #define L_FIR 31
 
-static Word16 fir_7k[L_FIR] =
-{
-    -21, 47, -89, 146, -203,
-    229, -177, 0, 335, -839,
-    1485, -2211, 2931, -3542, 3953,
-    28682, 3953, -3542, 2931, -2211,
-    1485, -839, 335, 0, -177,
-    229, -203, 146, -89, 47,
-    -21
-};
+/* filter coefficients: fir_7k[] of rom_tab.c */
 
 void Init_Filt_7k(Word16 mem[])            /* mem[30] */
 {
@@ -39,8 +31,7 @@ void Filt_7k(
      Word16 mem[]                          /* in/out: memory (size=30)        */
 )
 {
-    Word16 i, j, x[L_SUBFR16k + (L_FIR - 1)];
-    Word32 L_tmp;
+    Word16 i, x[L_SUBFR16k + (L_FIR - 1)];
 
     Copy(mem, x, L_FIR - 1);
 
@@ -49,13 +40,7 @@ void Filt_7k(
         x[i + L_FIR - 1] = signal[i];      move16();
     }
 
-    for (i = 0; i < lg; i++)
-    {
-        L_tmp = 0;                         move32();
-        for (j = 0; j < L_FIR; j++)
-            L_tmp = L_mac(L_tmp, x[i + j], fir_7k[j]);
-        signal[i] = round(L_tmp);          move16();
-    }
+    Fir_sym31(x, fir_7k, signal, lg);        /* symmetric filter */
 
     Copy(x + lg, mem, L_FIR - 1);
 
@@ -27,12 +27,10 @@
 #include "oper_32b.h"
 #include "acelp.h"
 #include "count.h"
+#include "rom_tab.h"
 
 
-/* filter coefficients in Q12 */
-
-static Word16 a[4] = {8192, 21663, -19258, 5734};
-static Word16 b[4] = {-3432, +10280, -10280, +3432};
+/* filter coefficients in Q12: hp_wsp_a[], hp_wsp_b[] of rom_tab.c */
 
 
 /* Initialization of static values */
@@ -101,17 +99,17 @@ void Hp_wsp(
 
         move32();
         L_tmp = 16384L;                    /* rounding to maximise precision */
-        L_tmp = L_mac(L_tmp, y1_lo, a[1]);
-        L_tmp = L_mac(L_tmp, y2_lo, a[2]);
-        L_tmp = L_mac(L_tmp, y3_lo, a[3]);
+        L_tmp = L_mac(L_tmp, y1_lo, hp_wsp_a[1]);
+        L_tmp = L_mac(L_tmp, y2_lo, hp_wsp_a[2]);
+        L_tmp = L_mac(L_tmp, y3_lo, hp_wsp_a[3]);
         L_tmp = L_shr(L_tmp, 15);
-        L_tmp = L_mac(L_tmp, y1_hi, a[1]);
-        L_tmp = L_mac(L_tmp, y2_hi, a[2]);
-        L_tmp = L_mac(L_tmp, y3_hi, a[3]);
-        L_tmp = L_mac(L_tmp, x0, b[0]);
-        L_tmp = L_mac(L_tmp, x1, b[1]);
-        L_tmp = L_mac(L_tmp, x2, b[2]);
-        L_tmp = L_mac(L_tmp, x3, b[3]);
+        L_tmp = L_mac(L_tmp, y1_hi, hp_wsp_a[1]);
+        L_tmp = L_mac(L_tmp, y2_hi, hp_wsp_a[2]);
+        L_tmp = L_mac(L_tmp, y3_hi, hp_wsp_a[3]);
+        L_tmp = L_mac(L_tmp, x0, hp_wsp_b[0]);
+        L_tmp = L_mac(L_tmp, x1, hp_wsp_b[1]);
+        L_tmp = L_mac(L_tmp, x2, hp_wsp_b[2]);
+        L_tmp = L_mac(L_tmp, x3, hp_wsp_b[3]);
 
         L_tmp = L_shl(L_tmp, 2);           /* coeff Q12 --> Q15 */
 
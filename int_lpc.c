@@ -16,7 +16,7 @@
 void Int_isp(
      Word16 isp_old[],                     /* input : isps from past frame              */
      Word16 isp_new[],                     /* input : isps from present frame           */
-     Word16 frac[],                        /* input : fraction for 3 first subfr (Q15)  */
+     const Word16 frac[],                  /* input : fraction for 3 first subfr (Q15)  */
      Word16 Az[]                           /* output: LP coefficients in 4 subframes    */
 )
 {
@@ -0,0 +1,74 @@
+/*___________________________________________________________________________
+ |                                                                           |
+ | Synthetic packet arrival trace for the jitter buffer (decoder -jitter).   |
+ |___________________________________________________________________________|
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/*-----------------------------------------------------------------*
+ * JBTRACE.C                                                       *
+ * ~~~~~~~~~                                                       *
+ * Writes the arrival time in ms of each frame (one line per       *
+ * frame, -1 for a lost packet). Frame n is sent at n x 20 ms and  *
+ * arrives after a network delay of delay_ms plus an exponential   *
+ * jitter of mean jitter_ms (packets can arrive out of order).     *
+ * A delay spike of spike_ms, decreasing to 0 over one second,     *
+ * starts every 10 seconds.                                        *
+ *                                                                 *
+ *    Usage : jbtrace nb_frames delay_ms jitter_ms loss_pct        *
+ *                    (spike_ms) (seed) > trace_file               *
+ *                                                                 *
+ * The random generator is portable, so a seed gives the same      *
+ * trace on all platforms.                                         *
+ *-----------------------------------------------------------------*/
+
+#define FRAME_MS     20
+#define SPIKE_PERIOD 500                   /* frames between delay spikes (10 s) */
+#define SPIKE_LEN    50                    /* frames to recover from a spike     */
+
+static unsigned long seed = 12345;
+
+static double Random(void)                 /* uniform in ]0, 1[ */
+{
+    seed = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    return ((double) seed + 0.5) / 2147483648.0;
+}
+
+int main(int argc, char *argv[])
+{
+    long n, nb_frames;
+    double delay, jitter, loss, spike, d;
+
+    if ((argc < 5) || (argc > 7))
+    {
+        fprintf(stderr, "Usage : jbtrace nb_frames delay_ms jitter_ms loss_pct (spike_ms) (seed) > trace_file\n");
+        exit(0);
+    }
+    nb_frames = atol(argv[1]);
+    delay = atof(argv[2]);
+    jitter = atof(argv[3]);
+    loss = atof(argv[4]) / 100.0;
+    spike = (argc > 5) ? atof(argv[5]) : 0.0;
+    if (argc > 6)
+        seed = (unsigned long) atol(argv[6]);
+
+    for (n = 0; n < nb_frames; n++)
+    {
+        if (Random() < loss)
+        {
+            printf("-1\n");
+            continue;
+        }
+        d = delay - jitter * log(Random());
+        if ((n % SPIKE_PERIOD) >= SPIKE_PERIOD - SPIKE_LEN)
+        {
+            d += spike * (double) (SPIKE_PERIOD - n % SPIKE_PERIOD) / (double) SPIKE_LEN;
+        }
+        printf("%ld\n", n * FRAME_MS + (long) (d + 0.5));
+    }
+
+    return 0;
+}
@@ -0,0 +1,495 @@
+/*------------------------------------------------------------------------*
+ *                         JITBUF.C                                       *
+ *------------------------------------------------------------------------*
+ * Adaptive jitter buffer with time-scaling in front of decoder()         *
+ *                                                                        *
+ * Frames are given to Jb_put() with their timestamp (in frames) and     *
+ * arrival time, in any order. Jb_get() is called every 20 ms by the     *
+ * playout and returns L_FRAME16k samples:                                *
+ *                                                                        *
+ *  - the frame of the next timestamp is decoded; a missing frame is      *
+ *    decoded as RX_SPEECH_LOST (concealment), or as RX_NO_DATA during    *
+ *    comfort noise, where frames are not transmitted. A frame arriving   *
+ *    after its playout is late and is discarded.                         *
+ *  - the target playout delay follows the transit delays of the last     *
+ *    JB_WIN packets: JB_LATE_PCT % of them may arrive too late.          *
+ *  - the playout delay is moved to the target by time-scaling the        *
+ *    decoded frames: one pitch period is removed (accelerate) or         *
+ *    repeated (expand) with an overlap-add, in frames where the signal   *
+ *    is periodic, silent or comfort noise, so no gap is heard.           *
+ *                                                                        *
+ * The playout delay of a frame is the time from its earliest expected    *
+ * arrival (lowest transit delay of the history) to its playout.          *
+ *------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "math_op.h"
+#include "cnst.h"
+#include "bits.h"
+#include "dtx.h"
+#include "main.h"
+#include "count.h"
+#include "jitbuf.h"
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Time_scale                                           *
+ *            ~~~~~~~~~~                                           *
+ *   ->Removes or repeats one period of a decoded frame.           *
+ *                                                                 *
+ *   The period (JB_TS_MIN..JB_TS_MAX) maximizes the normalized    *
+ *   correlation between x[0..P-1] and x[P..2P-1]. The two periods *
+ *   are overlap-added with a linear cross-fade:                   *
+ *     accelerate: x[0..P-1] fades into x[P..2P-1], the rest of    *
+ *                 the frame follows x[2P..]                       *
+ *     expand:     x[P..2P-1] fades into x[0..P-1], the rest of    *
+ *                 the frame follows x[P..]                        *
+ *   Returns the number of samples removed or added, 0 if the      *
+ *   correlation is below min_corr (silent frames always scaled).  *
+ *-----------------------------------------------------------------*/
+
+static Word16 Time_scale(
+     Word16 x[],                           /* (i/o)   : frame, L_FRAME16k (+JB_TS_MAX) samples */
+     Word16 expand,                        /* (i)     : 1: repeat a period, 0: remove one      */
+     Word16 min_corr                       /* (i) Q15 : normalized correlation needed          */
+)
+{
+    Word16 i, t, period, max, corr, exp_corr, exp_norm, exp, w, step;
+    Word16 xs[L_FRAME16k];
+    Word32 L_tmp, L_en;
+
+    /* 12-bit signal for the correlations */
+
+    L_en = 0L;                             move32();
+    for (i = 0; i < L_FRAME16k; i++)
+    {
+        xs[i] = shr(x[i], 4);              move16();
+        L_en = L_mac(L_en, xs[i], xs[i]);
+    }
+
+    period = JB_TS_MAX;                    move16();
+
+    test();
+    if (L_sub(L_en, JB_SIL_THRES) >= 0)
+    {
+        max = MIN_16;                      move16();
+
+        for (t = JB_TS_MIN; t <= JB_TS_MAX; t++)
+        {
+            L_tmp = Dot_product12(xs, &xs[t], t, &exp_corr);
+            corr = extract_h(L_tmp);
+
+            /* 1/sqrt(energy of both periods) */
+
+            L_tmp = Dot_product12(xs, xs, t, &exp_norm);
+            w = extract_h(L_tmp);
+            L_tmp = Dot_product12(&xs[t], &xs[t], t, &exp);
+            L_tmp = L_mult(w, extract_h(L_tmp));
+            exp_norm = add(exp_norm, exp);
+
+            exp = norm_l(L_tmp);
+            L_tmp = L_shl(L_tmp, exp);
+            exp_norm = sub(exp_norm, exp);
+            Isqrt_n(&L_tmp, &exp_norm);
+
+            L_tmp = L_mult(corr, extract_h(L_tmp));
+            corr = round(L_shl(L_tmp, add(exp_corr, exp_norm)));
+
+            test();
+            if (sub(corr, max) >= 0)
+            {
+                max = corr;                move16();
+                period = t;                move16();
+            }
+        }
+
+        test();
+        if (sub(max, min_corr) < 0)
+        {
+            return 0;
+        }
+    }
+    step = div_s(1, period);
+    w = 0;                                 move16();
+
+    test();
+    if (expand != 0)
+    {
+        for (i = L_FRAME16k - 1; i >= period; i--)
+        {
+            x[i + period] = x[i];          move16();
+        }
+        for (i = 0; i < period; i++)
+        {
+            x[i + period] = add(mult(x[i + 2 * period], sub(MAX_16, w)), mult(x[i], w));   move16();
+            w = add(w, step);
+        }
+    } else
+    {
+        for (i = 0; i < period; i++)
+        {
+            x[i] = add(mult(x[i], sub(MAX_16, w)), mult(x[i + period], w));   move16();
+            w = add(w, step);
+        }
+        for (i = period; i < L_FRAME16k - period; i++)
+        {
+            x[i] = x[i + period];          move16();
+        }
+    }
+
+    return period;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Update_target                                        *
+ *            ~~~~~~~~~~~~~                                        *
+ *   ->Lowest transit delay (base) and target playout delay from   *
+ *     the histogram of the transit delays above base.             *
+ *-----------------------------------------------------------------*/
+
+static void Update_target(JB_State * st)
+{
+    Word16 i, b, hist[JB_NB_BINS];
+    Word32 base, cum, needed;
+
+    if (st->nb_hist == 0)
+    {
+        st->target = JB_INIT_DELAY;
+        return;
+    }
+    base = st->transit[0];
+    for (i = 1; i < st->nb_hist; i++)
+    {
+        if (st->transit[i] < base)
+            base = st->transit[i];
+    }
+    for (b = 0; b < JB_NB_BINS; b++)
+    {
+        hist[b] = 0;
+    }
+    for (i = 0; i < st->nb_hist; i++)
+    {
+        cum = (st->transit[i] - base) / JB_BIN_MS;
+        if (cum >= JB_NB_BINS)
+            cum = JB_NB_BINS - 1;
+        hist[cum]++;
+    }
+
+    /* delay reached by all but JB_LATE_PCT % of the packets */
+
+    needed = st->nb_hist - (st->nb_hist * JB_LATE_PCT) / 100;
+    cum = 0;
+    for (b = 0; b < JB_NB_BINS - 1; b++)
+    {
+        cum += hist[b];
+        if (cum >= needed)
+            break;
+    }
+    st->base = base;
+    st->target = (Word16) ((b + 1) * JB_BIN_MS + JB_FRAME_MS);
+
+    /* first second: not enough packets for the statistics */
+    if ((st->nb_hist < JB_WIN / 5) && (st->target < JB_INIT_DELAY))
+        st->target = JB_INIT_DELAY;
+    if (st->target > JB_MAX_DELAY)
+        st->target = JB_MAX_DELAY;
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Decode_next                                          *
+ *            ~~~~~~~~~~~                                          *
+ *   ->Decodes the frame of the next timestamp (or conceals it)    *
+ *     with the homing of the decoder program.                     *
+ *-----------------------------------------------------------------*/
+
+static void Decode_next(JB_State * st, Word16 synth[])
+{
+    Word16 i, k, type, mode, frame_length, reset_flag;
+    Word16 lost[NB_BITS_MAX];
+    Word16 *prms;
+
+    k = (Word16) (st->play_ts % JB_MAX_FRAMES);
+
+    if ((st->used[k] != 0) && (st->ts[k] == st->play_ts))
+    {
+        prms = st->prms[k];
+        type = st->type[k];
+        mode = st->mode[k];
+        st->used[k] = 0;
+        st->nb_frames--;
+    } else
+    {
+        for (i = 0; i < NB_BITS_MAX; i++)
+        {
+            lost[i] = 0;
+        }
+        prms = lost;
+        type = (Word16) (st->dtx ? RX_NO_DATA : RX_SPEECH_LOST);
+        mode = st->mode_old;
+        if (st->dtx == 0)
+            st->stats.concealed++;
+    }
+    st->play_ts++;
+
+    reset_flag = 0;
+    if ((type != RX_NO_DATA) && (type != RX_SPEECH_LOST))
+    {
+        st->mode_old = mode;
+        st->dtx = (Word16) ((type == RX_SID_FIRST) || (type == RX_SID_UPDATE) || (type == RX_SID_BAD));
+
+        if (st->reset_flag_old != 0)
+            reset_flag = decoder_homing_frame_test_first(prms, mode);
+    } else
+    {
+        mode = st->mode_old;
+    }
+
+    if ((reset_flag != 0) && (st->reset_flag_old != 0))
+    {
+        for (i = 0; i < L_FRAME16k; i++)
+        {
+            synth[i] = EHF_MASK;
+        }
+    } else
+    {
+        decoder(mode, prms, synth, &frame_length, st->dec_state, type);
+    }
+
+    if (st->reset_flag_old == 0)
+        reset_flag = decoder_homing_frame_test(prms, mode);
+    if (reset_flag != 0)
+        Reset_decoder(st->dec_state, 1);
+    st->reset_flag_old = reset_flag;
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_jitbuf                                          *
+ *            ~~~~~~~~~~~                                          *
+ *   ->Initialization of the jitter buffer of a decoder.           *
+ *-----------------------------------------------------------------*/
+
+Word16 Init_jitbuf(JB_State ** state, void *dec_state)
+{
+    JB_State *st;
+
+    *state = NULL;
+
+    if ((st = (JB_State *) malloc(sizeof(JB_State))) == NULL)
+    {
+        fprintf(stderr, "Init_jitbuf: can not malloc state structure\n");
+        return -1;
+    }
+    st->dec_state = dec_state;
+    Reset_jitbuf(st);
+
+    *state = st;
+
+    return 0;
+}
+
+void Reset_jitbuf(JB_State * st)
+{
+    Word16 i;
+
+    for (i = 0; i < JB_MAX_FRAMES; i++)
+    {
+        st->used[i] = 0;
+    }
+    st->nb_frames = 0;
+    st->started = 0;
+    st->play_ts = 0;
+    st->mode_old = 0;
+    st->dtx = 0;
+    st->reset_flag_old = 1;
+    st->nb_hist = 0;
+    st->i_hist = 0;
+    st->base = 0;
+    st->target = JB_INIT_DELAY;
+    st->nb_out = 0;
+
+    st->stats.received = 0;
+    st->stats.late = 0;
+    st->stats.dropped = 0;
+    st->stats.concealed = 0;
+    st->stats.accelerated = 0;
+    st->stats.expanded = 0;
+    st->stats.samples_removed = 0;
+    st->stats.samples_added = 0;
+    st->stats.frames = 0;
+    st->stats.delay_sum = 0.0;
+
+    return;
+}
+
+void Close_jitbuf(JB_State * st)
+{
+    free(st);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Jb_put                                               *
+ *            ~~~~~~                                               *
+ *   ->Stores a received frame. Its transit delay is added to the  *
+ *     history also if it arrives too late for its playout.        *
+ *-----------------------------------------------------------------*/
+
+Word16 Jb_put(
+     JB_State * st,                        /* i/o : jitter buffer state                */
+     Word32 ts,                            /* i   : timestamp (frames)                 */
+     Word32 arrival,                       /* i   : arrival time (ms)                  */
+     Word16 prms[],                        /* i   : decoder() parameters               */
+     Word16 frame_type,                    /* i   : RX frame type                      */
+     Word16 mode                           /* i   : mode                               */
+)
+{
+    Word16 i, k;
+
+    st->stats.received++;
+
+    st->transit[st->i_hist] = arrival - ts * JB_FRAME_MS;
+    st->i_hist = (Word16) ((st->i_hist + 1) % JB_WIN);
+    if (st->nb_hist < JB_WIN)
+        st->nb_hist++;
+
+    if ((st->started != 0) && (ts < st->play_ts))
+    {
+        st->stats.late++;
+        return 1;
+    }
+    k = (Word16) (ts % JB_MAX_FRAMES);
+
+    /* duplicate, or more than JB_MAX_FRAMES ahead */
+    if ((st->used[k] != 0) || ((st->started != 0) && (ts >= st->play_ts + JB_MAX_FRAMES)))
+    {
+        st->stats.dropped++;
+        return -1;
+    }
+    st->used[k] = 1;
+    st->ts[k] = ts;
+    st->type[k] = frame_type;
+    st->mode[k] = mode;
+    for (i = 0; i < NB_BITS_MAX; i++)
+    {
+        st->prms[k][i] = prms[i];
+    }
+    st->nb_frames++;
+
+    return 0;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Jb_get                                               *
+ *            ~~~~~~                                               *
+ *   ->Returns the next L_FRAME16k samples to play, decoding and   *
+ *     time-scaling frames as needed.                              *
+ *-----------------------------------------------------------------*/
+
+void Jb_get(
+     JB_State * st,                        /* i/o : jitter buffer state                */
+     Word32 now,                           /* i   : playout time (ms)                  */
+     Word16 synth[]                        /* o   : L_FRAME16k samples to play         */
+)
+{
+    Word16 i, k, n, min_corr;
+    Word32 delay;
+
+    Update_target(st);
+
+    if (st->started == 0)
+    {
+        if (st->nb_frames == 0)
+        {
+            for (i = 0; i < L_FRAME16k; i++)
+            {
+                synth[i] = 0;
+            }
+            return;
+        }
+
+        /* start with the oldest frame, silence up to the target delay */
+
+        st->play_ts = -1;
+        for (k = 0; k < JB_MAX_FRAMES; k++)
+        {
+            if ((st->used[k] != 0) && ((st->play_ts < 0) || (st->ts[k] < st->play_ts)))
+                st->play_ts = st->ts[k];
+        }
+        delay = st->target - (now - st->play_ts * JB_FRAME_MS - st->base);
+        if (delay < 0)
+            delay = 0;
+        if (delay > JB_MAX_DELAY)
+            delay = JB_MAX_DELAY;
+
+        st->nb_out = (Word16) (delay * JB_SAMPLES_MS);
+        for (i = 0; i < st->nb_out; i++)
+        {
+            st->out[i] = 0;
+        }
+        st->started = 1;
+    }
+
+    while (st->nb_out < L_FRAME16k)
+    {
+        /* playout delay of the next frame */
+
+        delay = now + st->nb_out / JB_SAMPLES_MS - st->play_ts * JB_FRAME_MS - st->base;
+
+        Decode_next(st, &st->out[st->nb_out]);
+
+        st->stats.frames++;
+        st->stats.delay_sum += (double) delay;
+
+        /* far from the target or comfort noise: any correlation */
+
+        n = 0;
+        if (delay > st->target + JB_HYST)
+        {
+            min_corr = (Word16) (((st->dtx != 0) || (delay > st->target + 4 * JB_HYST)) ? MIN_16 : JB_TS_CORR);
+            n = Time_scale(&st->out[st->nb_out], 0, min_corr);
+            if (n > 0)
+            {
+                st->stats.accelerated++;
+                st->stats.samples_removed += n;
+            }
+            n = (Word16) (-n);
+        } else if ((delay < st->target) && (st->nb_out + L_FRAME16k + JB_TS_MAX <= JB_OUT_MAX))
+        {
+            min_corr = (Word16) (((st->dtx != 0) || (delay < st->target - JB_HYST)) ? MIN_16 : JB_TS_CORR);
+            n = Time_scale(&st->out[st->nb_out], 1, min_corr);
+            if (n > 0)
+            {
+                st->stats.expanded++;
+                st->stats.samples_added += n;
+            }
+        }
+        st->nb_out = (Word16) (st->nb_out + L_FRAME16k + n);
+    }
+
+    for (i = 0; i < L_FRAME16k; i++)
+    {
+        synth[i] = st->out[i];
+    }
+    st->nb_out = (Word16) (st->nb_out - L_FRAME16k);
+    for (i = 0; i < st->nb_out; i++)
+    {
+        st->out[i] = st->out[i + L_FRAME16k];
+    }
+
+    return;
+}
+
+Word16 Jb_empty(
+     JB_State * st                         /* i   : jitter buffer state                */
+)
+{
+    return (Word16) (st->nb_frames == 0);
+}
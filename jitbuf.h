@@ -0,0 +1,101 @@
+/*--------------------------------------------------------------------------*
+ *                         JITBUF.H                                         *
+ *--------------------------------------------------------------------------*
+ *       Adaptive jitter buffer with time-scaling in front of decoder()     *
+ *--------------------------------------------------------------------------*/
+
+#ifndef jitbuf_h
+#define jitbuf_h
+
+#include "typedef.h"
+#include "cnst.h"
+#include "bits.h"
+
+#define JB_FRAME_MS       20               /* frame duration (ms)                          */
+#define JB_SAMPLES_MS     16               /* samples per ms at 16 kHz                     */
+#define JB_MAX_FRAMES     64               /* frames held ahead of playout (1.28 s)        */
+
+#define JB_WIN            250              /* delay history (packets, 5 s)                 */
+#define JB_BIN_MS         5                /* resolution of the delay histogram (ms)       */
+#define JB_NB_BINS        100              /* delays above 500 ms in the last bin          */
+#define JB_LATE_PCT       3                /* packets allowed to arrive too late (%)       */
+
+#define JB_INIT_DELAY     60               /* target delay before any statistics (ms)      */
+#define JB_MAX_DELAY      500              /* highest target delay (ms)                    */
+#define JB_HYST           10               /* window above the target delay (ms)           */
+
+#define JB_TS_MIN         40               /* time-scaling period search (16 kHz samples)  */
+#define JB_TS_MAX         (L_FRAME16k / 2)
+#define JB_TS_CORR        26214            /* 0.8 in Q15: normalized correlation needed    */
+#define JB_SIL_THRES      (L_FRAME16k * 32L) /* frame energy of silence (mean amplitude 64)*/
+
+#define JB_OUT_MAX        (JB_MAX_DELAY * JB_SAMPLES_MS + 3 * L_FRAME16k)
+
+typedef struct
+{
+    Word32 received;                       /* frames given to Jb_put()                     */
+    Word32 late;                           /* frames arrived after their playout           */
+    Word32 dropped;                        /* duplicate frames, frames too far ahead       */
+    Word32 concealed;                      /* speech frames missing at playout             */
+    Word32 accelerated;                    /* frames shortened by time-scaling             */
+    Word32 expanded;                       /* frames lengthened by time-scaling            */
+    Word32 samples_removed;
+    Word32 samples_added;
+    Word32 frames;                         /* frames decoded                               */
+    double delay_sum;                      /* sum of the playout delays (ms)               */
+} JB_Stats;
+
+typedef struct
+{
+    void *dec_state;                       /* decoder() state (owned by the caller)        */
+
+    /* received frames, indexed by timestamp modulo JB_MAX_FRAMES */
+    Word16 used[JB_MAX_FRAMES];
+    Word32 ts[JB_MAX_FRAMES];
+    Word16 type[JB_MAX_FRAMES];
+    Word16 mode[JB_MAX_FRAMES];
+    Word16 prms[JB_MAX_FRAMES][NB_BITS_MAX];
+    Word16 nb_frames;                      /* frames stored                                */
+
+    Word16 started;                        /* playout started                              */
+    Word32 play_ts;                        /* timestamp of the next frame to decode        */
+    Word16 mode_old;                       /* mode of the last frame                       */
+    Word16 dtx;                            /* 1: comfort noise, missing frames are NO_DATA */
+    Word16 reset_flag_old;                 /* decoder homed                                */
+
+    /* transit delay (arrival - timestamp) of the last JB_WIN packets */
+    Word32 transit[JB_WIN];
+    Word16 nb_hist;
+    Word16 i_hist;
+    Word32 base;                           /* lowest transit delay of the history (ms)     */
+    Word16 target;                         /* target playout delay above base (ms)         */
+
+    /* decoded samples not played yet */
+    Word16 nb_out;
+    Word16 out[JB_OUT_MAX];
+
+    JB_Stats stats;
+} JB_State;
+
+Word16 Init_jitbuf(JB_State ** st, void *dec_state);
+void Reset_jitbuf(JB_State * st);
+void Close_jitbuf(JB_State * st);
+
+Word16 Jb_put(                             /* Return 0 if stored, 1 late, -1 dropped   */
+     JB_State * st,                        /* i/o : jitter buffer state                */
+     Word32 ts,                            /* i   : timestamp (frames)                 */
+     Word32 arrival,                       /* i   : arrival time (ms)                  */
+     Word16 prms[],                        /* i   : decoder() parameters               */
+     Word16 frame_type,                    /* i   : RX frame type                      */
+     Word16 mode                           /* i   : mode                               */
+);
+void Jb_get(
+     JB_State * st,                        /* i/o : jitter buffer state                */
+     Word32 now,                           /* i   : playout time (ms)                  */
+     Word16 synth[]                        /* o   : L_FRAME16k samples to play         */
+);
+Word16 Jb_empty(                           /* Return 1 if no frame is left to decode   */
+     JB_State * st                         /* i   : jitter buffer state                */
+);
+
+#endif
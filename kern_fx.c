@@ -0,0 +1,55 @@
+/*------------------------------------------------------------------------*
+ *                         KERN_FX.C                                      *
+ *------------------------------------------------------------------------*
+ * Variants of the kernels for each instruction set (see CPU_DISP.C):     *
+ * the body (KERN_FX.INC) is compiled once for the portable C level and,  *
+ * on x86 with GCC or Clang, once per extension with the target of the    *
+ * functions set to it, so that the vectorized loops use the extension.   *
+ * A variant is only called when cpu_disp.c found the extension.          *
+ *                                                                        *
+ * With the complexity counters (WMOPS), only the reference is used.      *
+ *------------------------------------------------------------------------*/
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "oper_32b.h"
+#include "cpu_disp.h"
+
+#if (WMOPS == 0)
+
+#define KERN_SUBFR     64                  /* cor_h_x(): subframe, tracks */
+#define KERN_TRACK     4
+#define KERN_WINDOW    384                 /* Autocorr(): L_WINDOW        */
+#define KERN_SURV_MAX  4                   /* VQ_stage1(): survivors,     */
+#define KERN_DICO_MAX  256                 /*   codebook size             */
+
+extern const Word16 window[];                    /* ham_wind.tab (autocorr.c)   */
+
+/* name of a generated function: name ## KERN_SFX */
+#define KERN_PASTE(a, b)   a ## b
+#define KERN_CAT(a, b)     KERN_PASTE(a, b)
+#define KERN_NAME(name)    KERN_CAT(name, KERN_SFX)
+
+#define KERN_LEVEL  "c"
+#define KERN_SFX    c
+#define KERN_ATTR
+#include "kern_fx.inc"
+
+#ifdef DISP_X86
+#define KERN_LEVEL  "sse4.1"
+#define KERN_SFX    sse41
+#define KERN_ATTR   __attribute__((target("sse4.1")))
+#include "kern_fx.inc"
+
+#define KERN_LEVEL  "avx2"
+#define KERN_SFX    avx2
+#define KERN_ATTR   __attribute__((target("avx2")))
+#include "kern_fx.inc"
+
+#define KERN_LEVEL  "avx512bw"
+#define KERN_SFX    avx512bw
+#define KERN_ATTR   __attribute__((target("avx512f,avx512bw")))
+#include "kern_fx.inc"
+#endif
+
+#endif
@@ -0,0 +1,627 @@
+/*___________________________________________________________________________
+ |                                                                           |
+ | Differential test of the optimized kernels against the reference.         |
+ |___________________________________________________________________________|
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "oper_32b.h"
+#include "math_op.h"
+#include "acelp.h"
+#include "cnst.h"
+#include "cpu_disp.h"
+#include "taskgrp.h"
+
+/*-----------------------------------------------------------------*
+ * KERNTEST.C                                                      *
+ * ~~~~~~~~~~                                                      *
+ * Each optimized kernel is run next to its reference on the same  *
+ * inputs, and the outputs and the Overflow flag are compared:     *
+ *                                                                 *
+ *   - the kernels of cpu_disp.c, at every level of the CPU,       *
+ *     against the reference (basic operators);                    *
+ *   - L_Extract(), L_Comp(), Mpy_32(), Mpy_32_16() (native with   *
+ *     a 64-bit type, oper_32b.c), Div_32() (built on them) and    *
+ *     Fir_sym31() (util.c) against their basic operator code;     *
+ *   - the codebook searches of each mode with the iterations on   *
+ *     a task group against the iterations in turn.                *
+ *                                                                 *
+ * The inputs are random, of random amplitude, and saturating      *
+ * (all -32768, all 32767, alternated, spikes in small values).    *
+ *                                                                 *
+ *    Usage : kerntest (-n cases) (-seed s)                        *
+ *                                                                 *
+ * The exit status is 1 if a result differs. The full codec is     *
+ * checked with the conformance vectors (testv/check.sh).          *
+ *-----------------------------------------------------------------*/
+
+#define NB_KIND     7                      /* kinds of input (Fill()) */
+#define L_MAX       384                    /* longest input           */
+#define NB_IND_MAX  8                      /* indices of a codevector */
+#define ACELP_DIV   50                     /* fewer searches: cases / ACELP_DIV */
+
+static unsigned long seed = 12345;
+
+static Word16 Random16(void)
+{
+    seed = (seed * 1103515245UL + 12345UL) & 0xffffffffUL;
+    return (Word16) ((Word32) ((seed >> 16) & 0xffff) - 32768);
+}
+
+static Word16 Random_n(Word16 n)           /* 0..n-1 */
+{
+    return (Word16) (((UWord32) Random16() & 0xffff) % (UWord32) n);
+}
+
+/* input of a kind: 0 full scale, 1 random amplitude, 2 all -32768,          */
+/* 3 all 32767, 4 alternated -32768/32767, 5 small with spikes, 6 zeros      */
+static void Fill(Word16 x[], Word16 n, Word16 kind)
+{
+    Word16 i, sft;
+
+    sft = Random_n(16);
+    for (i = 0; i < n; i++)
+    {
+        switch (kind)
+        {
+        case 0:
+            x[i] = Random16();
+            break;
+        case 1:
+            x[i] = (Word16) (Random16() >> sft);
+            break;
+        case 2:
+            x[i] = MIN_16;
+            break;
+        case 3:
+            x[i] = MAX_16;
+            break;
+        case 4:
+            x[i] = (i & 1) ? MAX_16 : MIN_16;
+            break;
+        case 5:
+            x[i] = (Random_n(8) == 0) ? ((Random16() < 0) ? MIN_16 : MAX_16) : (Word16) (Random16() >> 10);
+            break;
+        default:
+            x[i] = 0;
+            break;
+        }
+    }
+
+    return;
+}
+
+static Word16 Diff16(Word16 a[], Word16 b[], Word16 n)
+{
+    Word16 i;
+
+    for (i = 0; i < n; i++)
+    {
+        if (a[i] != b[i])
+            return 1;
+    }
+    return 0;
+}
+
+static long nb_fail = 0;
+
+static void Report(const char *kernel, const char *level, long cases, long fail, long first)
+{
+    if (fail == 0)
+    {
+        printf("  %-14s %-9s %7ld  ok\n", kernel, level, cases);
+    } else
+    {
+        printf("  %-14s %-9s %7ld  FAILED %ld (first: case %ld)\n", kernel, level, cases, fail, first);
+    }
+    nb_fail += fail;
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ * Kernels of cpu_disp.c: one function per kernel, for a table.    *
+ * Return the number of cases which differ, *first the first one.  *
+ *-----------------------------------------------------------------*/
+
+static long Test_convolve(const Disp_Kernels * k, long n, long *first)
+{
+    Word16 x[L_SUBFR], h[L_SUBFR], y0[L_SUBFR], y1[L_SUBFR], L;
+    Flag o0;
+    long c, fail = 0;
+
+    for (c = 0; c < n; c++)
+    {
+        Fill(x, L_SUBFR, (Word16) (c % NB_KIND));
+        Fill(h, L_SUBFR, (Word16) ((c / NB_KIND) % NB_KIND));
+        L = (Word16) ((c & 1) ? L_SUBFR : 1 + Random_n(L_SUBFR));
+
+        Overflow = 0;
+        Convolve_ref(x, h, y0, L);
+        o0 = Overflow;
+        Overflow = 0;
+        k->convolve(x, h, y1, L);
+
+        if (Diff16(y0, y1, L) || (o0 != Overflow))
+        {
+            if (fail++ == 0)
+                *first = c;
+        }
+    }
+    return fail;
+}
+
+static long Test_residu(const Disp_Kernels * k, long n, long *first)
+{
+    Word16 a[M + 1], x[M + L_FRAME], y0[L_FRAME], y1[L_FRAME], lg;
+    Flag o0;
+    long c, fail = 0;
+
+    for (c = 0; c < n; c++)
+    {
+        Fill(a, M + 1, (Word16) (c % NB_KIND));
+        Fill(x, M + L_FRAME, (Word16) ((c / NB_KIND) % NB_KIND));
+        lg = (Word16) ((c & 1) ? L_SUBFR : 1 + Random_n(L_FRAME));
+
+        Overflow = 0;
+        Residu_ref(a, M, &x[M], y0, lg);
+        o0 = Overflow;
+        Overflow = 0;
+        k->residu(a, M, &x[M], y1, lg);
+
+        if (Diff16(y0, y1, lg) || (o0 != Overflow))
+        {
+            if (fail++ == 0)
+                *first = c;
+        }
+    }
+    return fail;
+}
+
+static long Test_cor_h_x(const Disp_Kernels * k, long n, long *first)
+{
+    Word16 h[L_SUBFR], x[L_SUBFR], dn0[L_SUBFR], dn1[L_SUBFR];
+    Flag o0;
+    long c, fail = 0;
+
+    for (c = 0; c < n; c++)
+    {
+        Fill(h, L_SUBFR, (Word16) (c % NB_KIND));
+        Fill(x, L_SUBFR, (Word16) ((c / NB_KIND) % NB_KIND));
+
+        Overflow = 0;
+        cor_h_x_ref(h, x, dn0);
+        o0 = Overflow;
+        Overflow = 0;
+        k->cor_h_x(h, x, dn1);
+
+        if (Diff16(dn0, dn1, L_SUBFR) || (o0 != Overflow))
+        {
+            if (fail++ == 0)
+                *first = c;
+        }
+    }
+    return fail;
+}
+
+static long Test_autocorr(const Disp_Kernels * k, long n, long *first)
+{
+    Word16 x[L_MAX], r_h0[M + 1], r_l0[M + 1], r_h1[M + 1], r_l1[M + 1];
+    Flag o0;
+    long c, fail = 0;
+
+    for (c = 0; c < n; c++)
+    {
+        Fill(x, L_MAX, (Word16) (c % NB_KIND));
+
+        Overflow = 0;
+        Autocorr_ref(x, M, r_h0, r_l0);
+        o0 = Overflow;
+        Overflow = 0;
+        k->autocorr(x, M, r_h1, r_l1);
+
+        if (Diff16(r_h0, r_h1, M + 1) || Diff16(r_l0, r_l1, M + 1) || (o0 != Overflow))
+        {
+            if (fail++ == 0)
+                *first = c;
+        }
+    }
+    return fail;
+}
+
+static long Test_dot_product12(const Disp_Kernels * k, long n, long *first)
+{
+    Word16 x[L_FRAME], y[L_FRAME], *py, lg, exp0, exp1;
+    Word32 L0, L1;
+    Flag o0;
+    long c, fail = 0;
+
+    for (c = 0; c < n; c++)
+    {
+        Fill(x, L_FRAME, (Word16) (c % NB_KIND));
+        Fill(y, L_FRAME, (Word16) ((c / NB_KIND) % NB_KIND));
+        py = ((c % 3) == 0) ? x : y;       /* energies: x[] = y[] */
+        lg = (Word16) ((c & 1) ? L_SUBFR : 1 + Random_n(L_FRAME));
+
+        Overflow = 0;
+        L0 = Dot_product12_ref(x, py, lg, &exp0);
+        o0 = Overflow;
+        Overflow = 0;
+        L1 = k->dot_product12(x, py, lg, &exp1);
+
+        if ((L0 != L1) || (exp0 != exp1) || (o0 != Overflow))
+        {
+            if (fail++ == 0)
+                *first = c;
+        }
+    }
+    return fail;
+}
+
+static long Test_vq_stage1(const Disp_Kernels * k, long n, long *first)
+{
+    Word16 x[9], dico[9 * 256], ind0[4], ind1[4], dim, size, surv;
+    Flag o0;
+    long c, fail = 0;
+
+    for (c = 0; c < n; c++)
+    {
+        dim = (Word16) ((c & 1) ? 9 : 7);
+        size = (Word16) ((c & 2) ? 256 : 64);
+        surv = (Word16) (1 + Random_n(4));
+        Fill(x, dim, (Word16) (c % NB_KIND));
+        Fill(dico, (Word16) (dim * size), (Word16) ((c / NB_KIND) % NB_KIND));
+
+        Overflow = 0;
+        VQ_stage1_ref(x, dico, dim, size, ind0, surv);
+        o0 = Overflow;
+        Overflow = 0;
+        k->vq_stage1(x, dico, dim, size, ind1, surv);
+
+        if (Diff16(ind0, ind1, surv) || (o0 != Overflow))
+        {
+            if (fail++ == 0)
+                *first = c;
+        }
+    }
+    return fail;
+}
+
+typedef struct
+{
+    const char *name;
+    long (*test) (const Disp_Kernels * k, long n, long *first);
+} Disp_Test;
+
+static const Disp_Test disp_test[] =
+{
+    {"Convolve", Test_convolve},
+    {"Residu", Test_residu},
+    {"cor_h_x", Test_cor_h_x},
+    {"Autocorr", Test_autocorr},
+    {"Dot_product12", Test_dot_product12},
+    {"VQ_stage1", Test_vq_stage1}
+};
+
+/*-----------------------------------------------------------------*
+ * Native code of oper_32b.c and util.c: the basic operator code   *
+ * they replace.                                                   *
+ *-----------------------------------------------------------------*/
+
+/* Div_32() of oper_32b.c with the basic operator L_Extract(), Mpy_32() and Mpy_32_16() */
+static Word32 Div_32_ref(Word32 L_num, Word16 denom_hi, Word16 denom_lo)
+{
+    Word16 approx, hi, lo, n_hi, n_lo;
+    Word32 L_32;
+
+    approx = div_s((Word16) 0x3fff, denom_hi);
+
+    L_32 = L_mult(denom_hi, approx);
+    L_32 = L_mac(L_32, mult(denom_lo, approx), 1);
+    L_32 = L_sub((Word32) 0x7fffffffL, L_32);
+
+    hi = extract_h(L_32);
+    lo = extract_l(L_msu(L_shr(L_32, 1), hi, 16384));
+    L_32 = L_mult(hi, approx);
+    L_32 = L_mac(L_32, mult(lo, approx), 1);
+
+    hi = extract_h(L_32);
+    lo = extract_l(L_msu(L_shr(L_32, 1), hi, 16384));
+    n_hi = extract_h(L_num);
+    n_lo = extract_l(L_msu(L_shr(L_num, 1), n_hi, 16384));
+    L_32 = L_mult(n_hi, hi);
+    L_32 = L_mac(L_32, mult(n_hi, lo), 1);
+    L_32 = L_mac(L_32, mult(n_lo, hi), 1);
+    L_32 = L_shl(L_32, 2);
+
+    return (L_32);
+}
+
+static void Test_oper_32b(long n)
+{
+    Word16 hi0, lo0, hi1, lo1, hi2, lo2, v, w;
+    Word32 L, L0, L1;
+    Flag o0;
+    long c, fail[5], first[5];
+
+    memset(fail, 0, sizeof(fail));
+    memset(first, 0, sizeof(first));
+    for (c = 0; c < n; c++)
+    {
+        Fill(&hi1, 1, (Word16) (c % NB_KIND));
+        Fill(&lo1, 1, (Word16) ((c / NB_KIND) % NB_KIND));
+        Fill(&hi2, 1, (Word16) ((c / (NB_KIND * NB_KIND)) % NB_KIND));
+        Fill(&lo2, 1, (Word16) (c % 5));
+        L = L_deposit_h(hi1) + (Word32) (UWord16) lo1;
+
+        /* L_Extract() */
+        Overflow = 0;
+        hi0 = extract_h(L);
+        lo0 = extract_l(L_msu(L_shr(L, 1), hi0, 16384));
+        o0 = Overflow;
+        Overflow = 0;
+        L_Extract(L, &v, &w);
+        if ((hi0 != v) || (lo0 != w) || (o0 != Overflow))
+        {
+            if (fail[0]++ == 0)
+                first[0] = c;
+        }
+
+        /* L_Comp() */
+        Overflow = 0;
+        L0 = L_mac(L_deposit_h(hi1), lo1, 1);
+        o0 = Overflow;
+        Overflow = 0;
+        L1 = L_Comp(hi1, lo1);
+        if ((L0 != L1) || (o0 != Overflow))
+        {
+            if (fail[1]++ == 0)
+                first[1] = c;
+        }
+
+        /* Mpy_32() */
+        Overflow = 0;
+        L0 = L_mult(hi1, hi2);
+        L0 = L_mac(L0, mult(hi1, lo2), 1);
+        L0 = L_mac(L0, mult(lo1, hi2), 1);
+        o0 = Overflow;
+        Overflow = 0;
+        L1 = Mpy_32(hi1, lo1, hi2, lo2);
+        if ((L0 != L1) || (o0 != Overflow))
+        {
+            if (fail[2]++ == 0)
+                first[2] = c;
+        }
+
+        /* Mpy_32_16() */
+        Overflow = 0;
+        L0 = L_mult(hi1, hi2);
+        L0 = L_mac(L0, mult(lo1, hi2), 1);
+        o0 = Overflow;
+        Overflow = 0;
+        L1 = Mpy_32_16(hi1, lo1, hi2);
+        if ((L0 != L1) || (o0 != Overflow))
+        {
+            if (fail[3]++ == 0)
+                first[3] = c;
+        }
+
+        /* Div_32(): normalized denominator (0x40000000..0x7fffffff, lo of
+         * L_Extract()) and 0 <= L_num < L_denom, with the extreme values */
+        switch (c % 4)
+        {
+        case 0:
+            hi2 = 0x4000;
+            lo2 = 0;
+            break;
+        case 1:
+            hi2 = 0x7fff;
+            lo2 = 0x7fff;
+            break;
+        default:
+            hi2 = (Word16) (0x4000 + Random_n(0x4000));
+            lo2 = Random_n(0x7fff);
+            break;
+        }
+        L1 = L_Comp(hi2, lo2);             /* L_denom */
+        switch ((c / 4) % 3)
+        {
+        case 0:
+            L = 0;
+            break;
+        case 1:
+            L = L1 - 1;
+            break;
+        default:
+            L = (Word32) ((((UWord32) (UWord16) Random16() << 15) ^ (UWord16) Random16()) % (UWord32) L1);
+            break;
+        }
+        Overflow = 0;
+        L0 = Div_32_ref(L, hi2, lo2);
+        o0 = Overflow;
+        Overflow = 0;
+        L1 = Div_32(L, hi2, lo2);
+        if ((L0 != L1) || (o0 != Overflow))
+        {
+            if (fail[4]++ == 0)
+                first[4] = c;
+        }
+    }
+    Report("L_Extract", "native", n, fail[0], first[0]);
+    Report("L_Comp", "native", n, fail[1], first[1]);
+    Report("Mpy_32", "native", n, fail[2], first[2]);
+    Report("Mpy_32_16", "native", n, fail[3], first[3]);
+    Report("Div_32", "native", n, fail[4], first[4]);
+
+    return;
+}
+
+#define L_FIR31  31
+
+static void Test_fir_sym31(long n)
+{
+    Word16 x[L_FRAME16k + L_FIR31 - 1], fir[L_FIR31], y0[L_FRAME16k], y1[L_FRAME16k], i, j, lg;
+    Word32 L_tmp;
+    Flag o0;
+    long c, fail = 0, first = 0;
+
+    for (c = 0; c < n; c++)
+    {
+        Fill(fir, L_FIR31 / 2 + 1, (Word16) (c % NB_KIND));
+        for (j = 0; j < L_FIR31 / 2; j++)
+            fir[L_FIR31 - 1 - j] = fir[j];
+        Fill(x, L_FRAME16k + L_FIR31 - 1, (Word16) ((c / NB_KIND) % NB_KIND));
+        lg = (Word16) ((c & 1) ? L_SUBFR16k : 1 + Random_n(L_FRAME16k));
+
+        Overflow = 0;
+        for (i = 0; i < lg; i++)
+        {
+            L_tmp = 0;
+            for (j = 0; j < L_FIR31; j++)
+                L_tmp = L_mac(L_tmp, x[i + j], fir[j]);
+            y0[i] = round(L_tmp);
+        }
+        o0 = Overflow;
+        Overflow = 0;
+        Fir_sym31(x, fir, y1, lg);
+
+        if (Diff16(y0, y1, lg) || (o0 != Overflow))
+        {
+            if (fail++ == 0)
+                first = c;
+        }
+    }
+    Report("Fir_sym31", "native", n, fail, first);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ * Codebook searches: iterations on a task group / in turn.        *
+ *-----------------------------------------------------------------*/
+
+typedef void (*Acelp_Func) (Word16 dn[], Word16 cn[], Word16 H[], Word16 code[], Word16 y[], Word16 _index[],
+                            struct Task_Group * grp);
+
+static const struct
+{
+    const char *name;
+    Acelp_Func search;
+} acelp_test[] =
+{
+    {"ACELP 20b", ACELP_4t64_9k_fx},
+    {"ACELP 36b", ACELP_4t64_12k_fx},
+    {"ACELP 44b", ACELP_4t64_14k_fx},
+    {"ACELP 52b", ACELP_4t64_16k_fx},
+    {"ACELP 64b", ACELP_4t64_18k_fx},
+    {"ACELP 72b", ACELP_4t64_20k_fx},
+    {"ACELP 88b", ACELP_4t64_23k_fx}
+};
+
+static void Test_acelp(long n, Task_Group * grp)
+{
+    Word16 dn[L_SUBFR], cn[L_SUBFR], H[L_SUBFR], dn1[L_SUBFR], cn1[L_SUBFR], H1[L_SUBFR];
+    Word16 code0[L_SUBFR], y0[L_SUBFR], ind0[NB_IND_MAX], code1[L_SUBFR], y1[L_SUBFR], ind1[NB_IND_MAX];
+    Word16 i, m;
+    long c, fail, first;
+
+    for (m = 0; m < (Word16) (sizeof(acelp_test) / sizeof(acelp_test[0])); m++)
+    {
+        fail = 0;
+        first = 0;
+        for (c = 0; c < n; c++)
+        {
+            /* the search expects dn[] and cn[] on 12 bits, h[0] = 1.0 in Q12 */
+            Fill(dn, L_SUBFR, (Word16) (c % NB_KIND));
+            Fill(cn, L_SUBFR, (Word16) ((c / NB_KIND) % NB_KIND));
+            Fill(H, L_SUBFR, (Word16) (c % 2));
+            for (i = 0; i < L_SUBFR; i++)
+            {
+                dn[i] = shr(dn[i], 4);
+                cn[i] = shr(cn[i], 4);
+                H[i] = shr(H[i], (Word16) (3 + i / 8));
+            }
+            H[0] = 4096;
+            memset(ind0, 0, sizeof(ind0));
+            memset(ind1, 0, sizeof(ind1));
+            Copy(dn, dn1, L_SUBFR);
+            Copy(cn, cn1, L_SUBFR);
+            Copy(H, H1, L_SUBFR);
+
+            acelp_test[m].search(dn, cn, H, code0, y0, ind0, NULL);
+            acelp_test[m].search(dn1, cn1, H1, code1, y1, ind1, grp);
+
+            if (Diff16(code0, code1, L_SUBFR) || Diff16(y0, y1, L_SUBFR) || Diff16(ind0, ind1, NB_IND_MAX))
+            {
+                if (fail++ == 0)
+                    first = c;
+            }
+        }
+        Report(acelp_test[m].name, "taskgrp", n, fail, first);
+    }
+
+    return;
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *const level[] = {"c", "sse4.1", "avx2", "avx512bw"};
+    Word16 i, l;
+    long n, fail, first;
+    Task_Group *grp;
+
+    n = 10000;
+    while ((argc > 2) && (argv[1][0] == '-'))
+    {
+        if (strcmp(argv[1], "-n") == 0)
+            n = atol(argv[2]);
+        else if (strcmp(argv[1], "-seed") == 0)
+            seed = (unsigned long) atol(argv[2]);
+        else
+            break;
+        argc -= 2;
+        argv += 2;
+    }
+    if ((argc > 1) || (n <= 0))
+    {
+        fprintf(stderr, "Usage : kerntest (-n cases) (-seed s)\n");
+        exit(0);
+    }
+
+    printf("Kernels against the reference, %ld cases, seed %lu\n", n, seed);
+
+    for (l = 0; l < (Word16) (sizeof(level) / sizeof(level[0])); l++)
+    {
+        if (Disp_force(level[l]) != 0)
+        {
+            printf("  %-14s %-9s           not supported\n", "(all)", level[l]);
+            continue;
+        }
+        for (i = 0; i < (Word16) (sizeof(disp_test) / sizeof(disp_test[0])); i++)
+        {
+            first = 0;
+            fail = disp_test[i].test(disp_kern, n, &first);
+            Report(disp_test[i].name, level[l], n, fail, first);
+        }
+    }
+    Disp_force("ref");
+
+    Test_oper_32b(n);
+    Test_fir_sym31(n);
+
+    if (Init_taskgrp(&grp, 4) != 0)
+    {
+        exit(1);
+    }
+    Test_acelp(n / ACELP_DIV, grp);
+    Close_taskgrp(grp);
+
+    printf("%s\n", (nb_fail == 0) ? "All kernels bit-exact" : "KERNELS DIFFER");
+
+    return (nb_fail == 0) ? 0 : 1;
+}
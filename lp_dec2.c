@@ -7,6 +7,7 @@
 #include "typedef.h"
 #include "basic_op.h"
 #include "count.h"
+#include "rom_tab.h"
 #include "cnst.h"
 
 #define L_FIR  5
@@ -14,7 +15,7 @@
 
 /* static float h_fir[L_FIR] = {0.13, 0.23, 0.28, 0.23, 0.13}; */
 /* fixed-point: sum of coef = 32767 to avoid overflow on DC */
-static Word16 h_fir[L_FIR] = {4260, 7536, 9175, 7536, 4260};
+/* fir_dec2[] of rom_tab.c = {4260, 7536, 9175, 7536, 4260}            */
 
 
 void LP_Decim2(
@@ -49,7 +50,7 @@ void LP_Decim2(
 
         L_tmp = 0L;                        move32();
         for (k = 0; k < L_FIR; k++)
-            L_tmp = L_mac(L_tmp, *p_x++, h_fir[k]);
+            L_tmp = L_mac(L_tmp, *p_x++, fir_dec2[k]);
 
         x[j] = round(L_tmp);               move16();
     }
@@ -30,10 +30,85 @@ void decoder(
 
 void Reset_encoder(void *st, Word16 reset_all);
 
+/* pipelined encoder (cod_pipe.c): the output of coder_pipe() is one frame late */
+
+void Init_coder_pipe(void **spe_state);
+void Close_coder_pipe(void *spe_state);
+
+Word16 coder_pipe(                         /* Return 1 if a frame is output, else 0      */
+     Word16 * mode,                        /* i/o   :  mode of the new frame / used mode of the output */
+     Word16 speech16k[],                   /* input :  320 new speech samples, NULL: flush             */
+     Word16 prms[],                        /* output:  output parameters                               */
+     Word16 * ser_size,                    /* output:  bit rate of the used mode                       */
+     void *spe_state,                      /* i/o   :  State structure                                 */
+     Word16 allow_dtx,                     /* input :  DTX ON/OFF                                      */
+     Word16 reset                          /* input :  homing frame: reset after it                    */
+);
+
+void Set_coder_pipe_search(void *spe_state, void *grp);
+void Set_coder_pipe_rate(void *spe_state, void *rate);
+
+/* DTX frames not transmitted (TX_NO_DATA), see Set_encoder_dtx_skip() */
+#define DTX_SKIP_NONE  0                   /* full comfort noise processing            */
+#define DTX_SKIP_SYN   1                   /* no synthesis (HF gain estimator memory)  */
+#define DTX_SKIP_SID   2                   /* no synthesis and no SID parameters       */
+
+void Set_encoder_dtx_skip(void *spe_state, Word16 skip);
+
+/* task group (taskgrp.h) running the codebook search iterations together, NULL: in turn */
+void Set_encoder_search(void *spe_state, void *grp);
+
+/* rate controller (ratectl.h) choosing the mode of each frame, NULL: the mode given */
+void Set_encoder_rate(void *spe_state, void *rate);
+
+void Copy_coder(void *dst_state, void *src_state);
+
 void Reset_decoder(void *st, Word16 reset_all);
 
+void Set_decoder_hf_bypass(void *spd_state, Word16 bypass);
+
+void Set_decoder_cng_skip(void *spd_state, Word16 skip);
+
+Word16 Decoder_active(void *spd_state);
+
 Word16 encoder_homing_frame_test(Word16 input_frame[]);
 
 Word16 decoder_homing_frame_test(Word16 input_frame[], Word16 mode);
 
 Word16 decoder_homing_frame_test_first(Word16 input_frame[], Word16 mode);
+
+void decoder_homing_frame(Word16 prms[], Word16 mode);
+
+/* floating-point engine (cod_flt.c, dec_flt.c): same interface and bitstream */
+
+void Init_coder_flt(void **spe_state);
+void Close_coder_flt(void *spe_state);
+
+void coder_flt(
+     Word16 * mode,                        /* input :  used mode                             */
+     Word16 speech16k[],                   /* input :  320 new speech samples (at 16 kHz)    */
+     Word16 prms[],                        /* output:  output parameters           */
+     Word16 * ser_size,                    /* output:  bit rate of the used mode   */
+     void *spe_state,                      /* i/o   :  State structure                       */
+     Word16 allow_dtx                      /* input :  DTX ON/OFF                            */
+);
+
+void Init_decoder_flt(void **spd_state);
+void Close_decoder_flt(void *spd_state);
+
+void decoder_flt(
+     Word16 mode,                          /* input : used mode                     */
+     Word16 prms[],                        /* input : parameter vector                     */
+     Word16 synth16k[],                    /* output: synthesis speech              */
+     Word16 * frame_length,                /* output:  lenght of the frame         */
+     void *spd_state,                      /* i/o   : State structure                      */
+     Word16 frame_type                     /* input : received frame type           */
+);
+
+void Reset_encoder_flt(void *st, Word16 reset_all);
+
+void Set_encoder_dtx_skip_flt(void *spe_state, Word16 skip);
+
+void Reset_decoder_flt(void *st, Word16 reset_all);
+
+void Set_decoder_hf_bypass_flt(void *spd_state, Word16 bypass);
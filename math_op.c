@@ -25,6 +25,7 @@
 #include "basic_op.h"
 #include "math_op.h"
 #include "count.h"
+#include "cpu_disp.h"
 
 /*___________________________________________________________________________
  |                                                                           |
@@ -78,7 +79,7 @@ Word32 Isqrt(                              /* (o) Q31 : output value (range: 0<=
  |   6- fraction = table[i]<<16 - (table[i] - table[i+1]) * a * 2            |
  |___________________________________________________________________________|
 */
-static Word16 table_isqrt[49] =
+static const Word16 table_isqrt[49] =
 {
     32767, 31790, 30894, 30070, 29309, 28602, 27945, 27330, 26755, 26214,
     25705, 25225, 24770, 24339, 23930, 23541, 23170, 22817, 22479, 22155,
@@ -141,7 +142,7 @@ void Isqrt_n(
  |   4- L_x = L_x >> (30-exponant)     (with rounding)                       |
  |___________________________________________________________________________|
 */
-static Word16 table_pow2[33] =
+static const Word16 table_pow2[33] =
 {
     16384, 16743, 17109, 17484, 17867, 18258, 18658, 19066, 19484, 19911,
     20347, 20792, 21247, 21713, 22188, 22674, 23170, 23678, 24196, 24726,
@@ -187,7 +188,7 @@ Word32 Pow2(                               /* (o) Q0  : result       (range: 0<=
  |___________________________________________________________________________|
 */
 
-Word32 Dot_product12(                      /* (o) Q31: normalized result (1 < val <= -1) */
+Word32 Dot_product12_ref(                      /* (o) Q31: normalized result (1 < val <= -1) */
      Word16 x[],                           /* (i) 12bits: x vector                       */
      Word16 y[],                           /* (i) 12bits: y vector                       */
      Word16 lg,                            /* (i)    : vector length                     */
@@ -210,3 +211,17 @@ Word32 Dot_product12(                      /* (o) Q31: normalized result (1 < va
 
     return (L_sum);
 }
+
+Word32 Dot_product12(                      /* (o) Q31: normalized result (1 < val <= -1) */
+     Word16 x[],                           /* (i) 12bits: x vector                       */
+     Word16 y[],                           /* (i) 12bits: y vector                       */
+     Word16 lg,                            /* (i)    : vector length                     */
+     Word16 * exp                          /* (o)    : exponent of result (0..+30)       */
+)
+{
+#if (WMOPS == 0)
+    return disp_kern->dot_product12(x, y, lg, exp);
+#else
+    return Dot_product12_ref(x, y, lg, exp);
+#endif
+}
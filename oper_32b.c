@@ -27,6 +27,45 @@
 #include "oper_32b.h"
 #include "count.h"
 
+/*****************************************************************************
+ *  Without complexity counting (WMOPS == 0) and with a 64-bit integer type, *
+ *  the functions below use native arithmetic instead of the basic           *
+ *  operators. The saturations of the basic operators are done at the same  *
+ *  places (L_sat64(), MULT_SAT()), so the results are bit-exact, including  *
+ *  the Overflow flag.                                                       *
+ *****************************************************************************
+*/
+
+#if (WMOPS == 0) && defined(maxWord64)
+#define NATIVE_32B
+
+static Word32 L_sat64 (Word64 L_64)
+{
+    if (L_64 > (Word64) MAX_32)
+    {
+        Overflow = 1;
+        return MAX_32;
+    }
+    if (L_64 < (Word64) MIN_32)
+    {
+        Overflow = 1;
+        return MIN_32;
+    }
+    return (Word32) L_64;
+}
+
+/* mult(var1, var2): saturates only for var1 = var2 = -32768 */
+#define MULT_SAT(var1, var2, var_out)                            \
+{                                                                \
+    var_out = ((Word32) (var1) * (Word32) (var2)) >> 15;         \
+    if (var_out > (Word32) MAX_16)                               \
+    {                                                            \
+        Overflow = 1;                                            \
+        var_out = MAX_16;                                        \
+    }                                                            \
+}
+#endif
+
 /*****************************************************************************
  *                                                                           *
  *  Function L_Extract()                                                     *
@@ -44,8 +83,14 @@
 
 void L_Extract (Word32 L_32, Word16 *hi, Word16 *lo)
 {
+#ifdef NATIVE_32B
+    /* (L_32>>1) - hi<<15 never saturates: it is b1 to b15 of L_32 */
+    *hi = (Word16) (L_32 >> 16);
+    *lo = (Word16) ((L_32 >> 1) & 0x7fff);
+#else
     *hi = extract_h (L_32);
     *lo = extract_l (L_msu (L_shr (L_32, 1), *hi, 16384));
+#endif
     return;
 }
 
@@ -72,10 +117,14 @@ void L_Extract (Word32 L_32, Word16 *hi, Word16 *lo)
 
 Word32 L_Comp (Word16 hi, Word16 lo)
 {
+#ifdef NATIVE_32B
+    return (L_sat64 ((Word64) hi * 65536 + (Word64) lo * 2));
+#else
     Word32 L_32;
 
     L_32 = L_deposit_h (hi);
     return (L_mac (L_32, lo, 1));       /* = hi<<16 + lo<<1 */
+#endif
 }
 
 /*****************************************************************************
@@ -101,10 +150,21 @@ Word32 L_Comp (Word16 hi, Word16 lo)
 Word32 Mpy_32 (Word16 hi1, Word16 lo1, Word16 hi2, Word16 lo2)
 {
     Word32 L_32;
+#ifdef NATIVE_32B
+    Word32 m1, m2;
+
+    MULT_SAT (hi1, lo2, m1);
+    MULT_SAT (lo1, hi2, m2);
+
+    L_32 = L_sat64 ((Word64) hi1 * hi2 * 2);
+    L_32 = L_sat64 ((Word64) L_32 + m1 * 2);
+    L_32 = L_sat64 ((Word64) L_32 + m2 * 2);
+#else
 
     L_32 = L_mult (hi1, hi2);
     L_32 = L_mac (L_32, mult (hi1, lo2), 1);
     L_32 = L_mac (L_32, mult (lo1, hi2), 1);
+#endif
 
     return (L_32);
 }
@@ -130,9 +190,18 @@ Word32 Mpy_32 (Word16 hi1, Word16 lo1, Word16 hi2, Word16 lo2)
 Word32 Mpy_32_16 (Word16 hi, Word16 lo, Word16 n)
 {
     Word32 L_32;
+#ifdef NATIVE_32B
+    Word32 m;
+
+    MULT_SAT (lo, n, m);
+
+    L_32 = L_sat64 ((Word64) hi * n * 2);
+    L_32 = L_sat64 ((Word64) L_32 + m * 2);
+#else
 
     L_32 = L_mult (hi, n);
     L_32 = L_mac (L_32, mult (lo, n), 1);
+#endif
 
     return (L_32);
 }
@@ -29,7 +29,8 @@ Word16 Pitch_med_ol(                       /* output: open loop pitch lag
 {
     Word16 i, j, Tm;
     Word16 hi, lo;
-    Word16 *ww, *we, *hp_wsp;
+    const Word16 *ww, *we;
+    Word16 *hp_wsp;
     Word16 exp_R0, exp_R1, exp_R2;
     Word32 max, R0, R1, R2;
 
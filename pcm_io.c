@@ -0,0 +1,422 @@
+/*------------------------------------------------------------------------*
+ *                         PCM_IO.C                                       *
+ *------------------------------------------------------------------------*
+ * Speech file input/output:                                              *
+ *   - raw 16-bit linear samples (host byte order, as testv .inp files)   *
+ *   - raw 8-bit G.711 A-law or mu-law samples                            *
+ *   - RIFF/WAVE container holding any of the above (little endian)       *
+ *                                                                        *
+ * G.711 expansion is done while the frame is read: the companded bytes   *
+ * are loaded into the upper half of the caller's Word16 frame buffer     *
+ * and expanded forward in place, so no intermediate buffer or file is    *
+ * needed.  Compression on output works the same way in reverse.         *
+ *------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "typedef.h"
+#include "pcm_io.h"
+
+#include "g711.tab"
+
+#define WAV_HEADER_SIZE 58                 /* RIFF + fmt(18) + fact + data headers */
+
+/*-----------------------------------------------------*
+ * Little endian helpers for the RIFF/WAVE header      *
+ *-----------------------------------------------------*/
+
+static Word32 get_le16(UWord8 *p)
+{
+    return (Word32) p[0] | ((Word32) p[1] << 8);
+}
+
+static Word32 get_le32(UWord8 *p)
+{
+    return (Word32) p[0] | ((Word32) p[1] << 8) | ((Word32) p[2] << 16) | ((Word32) p[3] << 24);
+}
+
+static void put_le16(UWord8 *p, Word32 v)
+{
+    p[0] = (UWord8) (v & 0xFF);
+    p[1] = (UWord8) ((v >> 8) & 0xFF);
+}
+
+static void put_le32(UWord8 *p, Word32 v)
+{
+    put_le16(p, v & 0xFFFF);
+    put_le16(p + 2, (v >> 16) & 0xFFFF);
+}
+
+#ifndef LSBFIRST
+static void swap_bytes(Word16 x[], Word16 lg)
+{
+    Word16 i;
+
+    for (i = 0; i < lg; i++)
+    {
+        x[i] = (Word16) (((x[i] >> 8) & 0x00FF) | (x[i] << 8));
+    }
+}
+#endif
+
+/*-----------------------------------------------------*
+ * G.711 compression (ITU-T G.711, segment search)     *
+ *-----------------------------------------------------*/
+
+static const Word16 seg_aend[8] = {0x1F, 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF};
+static const Word16 seg_uend[8] = {0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF, 0x1FFF};
+
+static Word16 search_seg(Word16 val, const Word16 *table)
+{
+    Word16 i;
+
+    for (i = 0; i < 8; i++)
+    {
+        if (val <= table[i])
+            return i;
+    }
+    return 8;
+}
+
+UWord8 linear_to_alaw(Word16 pcm)
+{
+    Word16 mask, seg;
+    UWord8 aval;
+
+    pcm = (Word16) (pcm >> 3);
+
+    if (pcm >= 0)
+    {
+        mask = 0xD5;                       /* sign (7th) bit = 1 */
+    } else
+    {
+        mask = 0x55;                       /* sign bit = 0 */
+        pcm = (Word16) (-pcm - 1);
+    }
+
+    seg = search_seg(pcm, seg_aend);
+
+    if (seg >= 8)                          /* out of range, return maximum value */
+        return (UWord8) (0x7F ^ mask);
+
+    aval = (UWord8) (seg << 4);
+    if (seg < 2)
+        aval |= (pcm >> 1) & 0x0F;
+    else
+        aval |= (pcm >> seg) & 0x0F;
+
+    return (UWord8) (aval ^ mask);
+}
+
+UWord8 linear_to_ulaw(Word16 pcm)
+{
+    Word16 mask, seg;
+    UWord8 uval;
+
+    pcm = (Word16) (pcm >> 2);
+
+    if (pcm < 0)
+    {
+        pcm = (Word16) (-pcm);
+        mask = 0x7F;
+    } else
+    {
+        mask = 0xFF;
+    }
+    if (pcm > 8159)                        /* clip the magnitude */
+        pcm = 8159;
+    pcm = (Word16) (pcm + (0x84 >> 2));    /* add bias */
+
+    seg = search_seg(pcm, seg_uend);
+
+    if (seg >= 8)
+        return (UWord8) (0x7F ^ mask);
+
+    uval = (UWord8) ((seg << 4) | ((pcm >> (seg + 1)) & 0x0F));
+
+    return (UWord8) (uval ^ mask);
+}
+
+/*-----------------------------------------------------*
+ * Read_pcm -> read speech samples from a file         *
+ *-----------------------------------------------------*/
+
+static Word16 Read_wav_header(PCM_State *st, FILE *fp)
+{
+    UWord8 hdr[16];
+    Word32 size, tag = -1, channels = 0, rate = 0, bits = 0;
+
+    if ((fread(hdr, 1, 12, fp) != 12) || (strncmp((char *) hdr, "RIFF", 4) != 0) ||
+        (strncmp((char *) hdr + 8, "WAVE", 4) != 0))
+    {
+        fprintf(stderr, "read_pcm_init: not a RIFF/WAVE file\n");
+        return -1;
+    }
+
+    /* walk the chunk list up to the data chunk */
+    while (fread(hdr, 1, 8, fp) == 8)
+    {
+        size = get_le32(hdr + 4);
+
+        if (strncmp((char *) hdr, "fmt ", 4) == 0)
+        {
+            if ((size < 16) || (fread(hdr, 1, 16, fp) != 16))
+                break;
+            tag = get_le16(hdr);
+            channels = get_le16(hdr + 2);
+            rate = get_le32(hdr + 4);
+            bits = get_le16(hdr + 14);
+            size -= 16;
+        } else if (strncmp((char *) hdr, "data", 4) == 0)
+        {
+            if (tag == WAVE_FORMAT_PCM && bits == 16)
+            {
+                st->format = PCM_LINEAR;
+            } else if (tag == WAVE_FORMAT_ALAW && bits == 8)
+            {
+                st->format = PCM_ALAW;
+            } else if (tag == WAVE_FORMAT_MULAW && bits == 8)
+            {
+                st->format = PCM_ULAW;
+            } else
+            {
+                fprintf(stderr, "read_pcm_init: unsupported WAV format tag %ld (%ld bits)\n", (long) tag, (long) bits);
+                return -1;
+            }
+            if ((channels != 1) || (rate != PCM_SAMPLE_RATE))
+            {
+                fprintf(stderr, "read_pcm_init: WAV file must be mono at %d Hz (found %ld ch, %ld Hz)\n",
+                    PCM_SAMPLE_RATE, (long) channels, (long) rate);
+                return -1;
+            }
+            st->data_size = (long) size;
+            return 0;
+        }
+
+        /* skip the rest of the chunk, chunks are word aligned */
+        if (fseek(fp, (long) (size + (size & 1)), SEEK_CUR) != 0)
+            break;
+    }
+
+    fprintf(stderr, "read_pcm_init: no fmt/data chunk found in WAV file\n");
+    return -1;
+}
+
+Word16 Init_read_pcm(PCM_State ** st, FILE * fp, Word16 format, Word16 wav)
+{
+    PCM_State *s;
+
+    if ((s = (PCM_State *) malloc(sizeof(PCM_State))) == NULL)
+    {
+        fprintf(stderr, "read_pcm_init: can not malloc state structure\n");
+        return -1;
+    }
+    s->format = format;
+    s->wav = wav;
+    s->data_size = 0;
+    Blk_init(&(s->map));
+
+    if ((wav != 0) && (Read_wav_header(s, fp) != 0))
+    {
+        free(s);
+        return -1;
+    }
+
+    /* the samples are read out of a mapping of the file when possible */
+    Blk_map(&(s->map), fp);
+    *st = s;
+
+    return 0;
+}
+
+Word16 Close_read_pcm(PCM_State * st)
+{
+    if (st != NULL)
+    {
+        Blk_unmap(&(st->map));
+        free(st);
+        return 0;
+    }
+    return 1;
+}
+
+Word16 Read_pcm(FILE * fp, Word16 signal[], Word16 lg, PCM_State * st)
+{
+    Word16 i, n, size;
+    UWord8 *bytes;
+    const Word16 *table;
+
+    size = (Word16) ((st->format == PCM_LINEAR) ? sizeof(Word16) : sizeof(UWord8));
+
+    /* do not read past the end of the WAV data chunk */
+    if ((st->wav != 0) && (st->data_size < (long) lg * size))
+    {
+        lg = (Word16) (st->data_size / size);
+    }
+
+    if (st->format == PCM_LINEAR)
+    {
+        if (st->map.data != NULL)
+            n = (Word16) Blk_read(signal, sizeof(Word16), lg, &(st->map));
+        else
+            n = (Word16) fread(signal, sizeof(Word16), lg, fp);
+#ifndef LSBFIRST
+        if (st->wav != 0)
+            swap_bytes(signal, n);
+#endif
+    } else
+    {
+        if (st->map.data != NULL)
+        {
+            /* expand the 8-bit codes straight from the mapped file */
+            n = (Word16) ((st->map.size - st->map.pos < lg) ? (st->map.size - st->map.pos) : lg);
+            bytes = Blk_get(&(st->map), n);
+        } else
+        {
+            /* load the 8-bit codes into the upper half of signal[] and  */
+            /* expand forward: code i is always read before it is hit   */
+            bytes = (UWord8 *) signal + lg;
+            n = (Word16) fread(bytes, sizeof(UWord8), lg, fp);
+        }
+
+        table = (st->format == PCM_ALAW) ? alaw_to_pcm : ulaw_to_pcm;
+
+        for (i = 0; i < n; i++)
+        {
+            signal[i] = table[bytes[i]];
+        }
+    }
+
+    if (st->wav != 0)
+        st->data_size -= (long) n * size;
+
+    return n;
+}
+
+/*-----------------------------------------------------*
+ * Write_pcm -> write speech samples into a file       *
+ *-----------------------------------------------------*/
+
+static void Write_wav_header(PCM_State *st, FILE *fp)
+{
+    UWord8 hdr[WAV_HEADER_SIZE];
+    Word32 tag, bits, data_size;
+
+    data_size = (Word32) st->data_size;
+    if (st->format == PCM_LINEAR)
+    {
+        tag = WAVE_FORMAT_PCM;
+        bits = 16;
+    } else
+    {
+        tag = (st->format == PCM_ALAW) ? WAVE_FORMAT_ALAW : WAVE_FORMAT_MULAW;
+        bits = 8;
+    }
+
+    memcpy(hdr, "RIFF", 4);
+    put_le32(hdr + 4, WAV_HEADER_SIZE - 8 + data_size + (data_size & 1));
+    memcpy(hdr + 8, "WAVE", 4);
+
+    memcpy(hdr + 12, "fmt ", 4);
+    put_le32(hdr + 16, 18);
+    put_le16(hdr + 20, tag);
+    put_le16(hdr + 22, 1);                 /* mono */
+    put_le32(hdr + 24, PCM_SAMPLE_RATE);
+    put_le32(hdr + 28, PCM_SAMPLE_RATE * (bits / 8));
+    put_le16(hdr + 32, bits / 8);          /* block align */
+    put_le16(hdr + 34, bits);
+    put_le16(hdr + 36, 0);                 /* no extension */
+
+    memcpy(hdr + 38, "fact", 4);
+    put_le32(hdr + 42, 4);
+    put_le32(hdr + 46, data_size / (bits / 8));
+
+    memcpy(hdr + 50, "data", 4);
+    put_le32(hdr + 54, data_size);
+
+    fwrite(hdr, sizeof(UWord8), WAV_HEADER_SIZE, fp);
+}
+
+Word16 Init_write_pcm(PCM_State ** st, FILE * fp, Word16 format, Word16 wav)
+{
+    PCM_State *s;
+
+    if ((s = (PCM_State *) malloc(sizeof(PCM_State))) == NULL)
+    {
+        fprintf(stderr, "write_pcm_init: can not malloc state structure\n");
+        return -1;
+    }
+    s->format = format;
+    s->wav = wav;
+    s->data_size = 0;
+    Blk_init(&(s->map));
+
+    /* sizes are patched in Close_write_pcm() */
+    if (wav != 0)
+        Write_wav_header(s, fp);
+    *st = s;
+
+    return 0;
+}
+
+Word16 Close_write_pcm(PCM_State * st, FILE * fp)
+{
+    UWord8 pad = 0;
+
+    if (st == NULL)
+        return 1;
+
+    if (st->wav != 0)
+    {
+        if (st->data_size & 1)
+            fwrite(&pad, sizeof(UWord8), 1, fp);
+
+        if (fseek(fp, 0L, SEEK_SET) == 0)
+            Write_wav_header(st, fp);
+        else
+            fprintf(stderr, "write_pcm_close: output not seekable, WAV sizes not updated\n");
+    }
+    free(st);
+
+    return 0;
+}
+
+void Write_pcm(FILE * fp, Word16 signal[], Word16 lg, PCM_State * st)
+{
+    Word16 i;
+    UWord8 *bytes;
+
+    if (st->format == PCM_LINEAR)
+    {
+#ifndef LSBFIRST
+        if (st->wav != 0)
+            swap_bytes(signal, lg);
+#endif
+        fwrite(signal, sizeof(Word16), lg, fp);
+#ifndef LSBFIRST
+        if (st->wav != 0)
+            swap_bytes(signal, lg);
+#endif
+        st->data_size += (long) lg * sizeof(Word16);
+    } else
+    {
+        /* compress forward in place: byte i lands in sample i/2, */
+        /* which has already been converted                      */
+        bytes = (UWord8 *) signal;
+
+        if (st->format == PCM_ALAW)
+        {
+            for (i = 0; i < lg; i++)
+                bytes[i] = linear_to_alaw(signal[i]);
+        } else
+        {
+            for (i = 0; i < lg; i++)
+                bytes[i] = linear_to_ulaw(signal[i]);
+        }
+        fwrite(bytes, sizeof(UWord8), lg, fp);
+        st->data_size += (long) lg;
+    }
+
+    return;
+}
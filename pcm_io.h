@@ -0,0 +1,55 @@
+/*--------------------------------------------------------------------------*
+ *                         PCM_IO.H                                         *
+ *--------------------------------------------------------------------------*
+ *       Speech file formats: raw 16-bit, G.711 A-law/mu-law, RIFF/WAVE     *
+ *--------------------------------------------------------------------------*/
+
+#ifndef pcm_io_h
+#define pcm_io_h
+
+#include <stdio.h>
+#include "typedef.h"
+#include "blk_io.h"
+
+#define PCM_LINEAR        0                /* 16-bit linear samples              */
+#define PCM_ALAW          1                /* 8-bit G.711 A-law                  */
+#define PCM_ULAW          2                /* 8-bit G.711 mu-law                 */
+
+#define WAVE_FORMAT_PCM   1                /* RIFF/WAVE format tags              */
+#define WAVE_FORMAT_ALAW  6
+#define WAVE_FORMAT_MULAW 7
+
+#define PCM_SAMPLE_RATE   16000            /* only 16 kHz files are accepted     */
+
+typedef struct
+{
+    Word16 format;                         /* PCM_LINEAR, PCM_ALAW or PCM_ULAW   */
+    Word16 wav;                            /* 1 if a RIFF/WAVE container is used */
+    long data_size;                        /* WAV read: bytes left in data chunk */
+                                           /* WAV write: bytes written so far    */
+    Blk_Map map;                           /* read: mapped file (see blk_io.c)   */
+} PCM_State;
+
+Word16 Init_read_pcm(PCM_State ** st, FILE * fp, Word16 format, Word16 wav);
+Word16 Init_write_pcm(PCM_State ** st, FILE * fp, Word16 format, Word16 wav);
+Word16 Close_read_pcm(PCM_State * st);
+Word16 Close_write_pcm(PCM_State * st, FILE * fp);
+
+Word16 Read_pcm(                           /* Return number of samples read   */
+     FILE * fp,                            /* input : speech file             */
+     Word16 signal[],                      /* output: 16-bit linear samples   */
+     Word16 lg,                            /* input : number of samples       */
+     PCM_State * st                        /* i/o   : file format state       */
+);
+void Write_pcm(
+     FILE * fp,                            /* input : speech file             */
+     Word16 signal[],                      /* input : 16-bit linear samples   */
+                                           /*         (overwritten if G.711)  */
+     Word16 lg,                            /* input : number of samples       */
+     PCM_State * st                        /* i/o   : file format state       */
+);
+
+UWord8 linear_to_alaw(Word16 pcm);
+UWord8 linear_to_ulaw(Word16 pcm);
+
+#endif
@@ -19,7 +19,7 @@
 /* impulse response with phase dispersion */
 
 /* 2.0 - 6.4 kHz phase dispersion */
-static Word16 ph_imp_low[L_SUBFR] =
+static const Word16 ph_imp_low[L_SUBFR] =
 {
     20182, 9693, 3270, -3437, 2864, -5240, 1589, -1357,
     600, 3893, -1497, -698, 1203, -5249, 1199, 5371,
@@ -32,7 +32,7 @@ static Word16 ph_imp_low[L_SUBFR] =
 };
 
 /* 3.2 - 6.4 kHz phase dispersion */
-static Word16 ph_imp_mid[L_SUBFR] =
+static const Word16 ph_imp_mid[L_SUBFR] =
 {
     24098, 10460, -5263, -763, 2048, -927, 1753, -3323,
     2212, 652, -2146, 2487, -3539, 4109, -2107, -374,
@@ -10,6 +10,7 @@
 #include "acelp.h"
 #include "cnst.h"
 #include "count.h"
+#include "rom_tab.h"
 
 #define UP_SAMP      4
 #define L_INTERPOL1  4
@@ -242,19 +243,8 @@ static void Norm_Corr(
  * For interpolating the normalized correlation with 1/4 resolution.        *
  *--------------------------------------------------------------------------*/
 
-/* 1/4 resolution interpolation filter (-3 dB at 0.791*fs/2) in Q14 */
-
-static Word16 inter4_1[UP_SAMP * 2 * L_INTERPOL1] =
-{
-    -12, -26, 32, 206,
-    420, 455, 73, -766,
-    -1732, -2142, -1242, 1376,
-    5429, 9910, 13418, 14746,
-    13418, 9910, 5429, 1376,
-    -1242, -2142, -1732, -766,
-    73, 455, 420, 206,
-    32, -26, -12, 0
-};
+/* 1/4 resolution interpolation filter (-3 dB at 0.791*fs/2) in Q14:  */
+/* inter4_1_ph[frac][] of rom_tab.c, one row of 8 taps per fraction   */
 
 /*** Coefficients in floating point
 static float inter4_1[UP_SAMP*L_INTERPOL1+1] = {
@@ -270,7 +260,8 @@ static Word16 Interpol_4(                  /* (o)  : interpolated value  */
      Word16 frac                           /* (i)  : fraction (-4..+3)   */
 )
 {
-    Word16 i, k, sum;
+    Word16 i, sum;
+    const Word16 *fir;
     Word32 L_sum;
 
     test();
@@ -282,11 +273,12 @@ static Word16 Interpol_4(                  /* (o)  : interpolated value  */
     }
     x = x - L_INTERPOL1 + 1;
     move16();
+    fir = inter4_1_ph[frac];               move16();
 
     L_sum = 0L;                            move32();
-    for (i = 0, k = sub(sub(UP_SAMP, 1), frac); i < 2 * L_INTERPOL1; i++, k += UP_SAMP)
+    for (i = 0; i < 2 * L_INTERPOL1; i++)
     {
-        L_sum = L_mac(L_sum, x[i], inter4_1[k]);
+        L_sum = L_mac(L_sum, x[i], fir[i]);
     }
 
     sum = round(L_shl(L_sum, 1));
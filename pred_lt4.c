@@ -11,47 +11,13 @@
 #include "typedef.h"
 #include "basic_op.h"
 #include "count.h"
+#include "rom_tab.h"
 
 #define UP_SAMP      4
 #define L_INTERPOL2  16
 
-/* 1/4 resolution interpolation filter (-3 dB at 0.856*fs/2) in Q14 */
-
-static Word16 inter4_2[UP_SAMP * 2 * L_INTERPOL2] =
-{
-    0, 1, 2, 1,
-    -2, -7, -10, -7,
-    4, 19, 28, 22,
-    -2, -33, -55, -49,
-    -10, 47, 91, 92,
-    38, -52, -133, -153,
-    -88, 43, 175, 231,
-    165, -9, -209, -325,
-    -275, -60, 226, 431,
-    424, 175, -213, -544,
-    -619, -355, 153, 656,
-    871, 626, -16, -762,
-    -1207, -1044, -249, 853,
-    1699, 1749, 780, -923,
-    -2598, -3267, -2147, 968,
-    5531, 10359, 14031, 15401,
-    14031, 10359, 5531, 968,
-    -2147, -3267, -2598, -923,
-    780, 1749, 1699, 853,
-    -249, -1044, -1207, -762,
-    -16, 626, 871, 656,
-    153, -355, -619, -544,
-    -213, 175, 424, 431,
-    226, -60, -275, -325,
-    -209, -9, 165, 231,
-    175, 43, -88, -153,
-    -133, -52, 38, 92,
-    91, 47, -10, -49,
-    -55, -33, -2, 22,
-    28, 19, 4, -7,
-    -10, -7, -2, 1,
-    2, 1, 0, 0
-};
+/* 1/4 resolution interpolation filter (-3 dB at 0.856*fs/2) in Q14:  */
+/* inter4_2_ph[frac][] of rom_tab.c, one row of 32 taps per fraction  */
 
 /*** Coefficients in floating point
 static float inter4_2[UP_SAMP*L_INTERPOL2+1] = {
@@ -81,7 +47,8 @@ void Pred_lt4(
      Word16 L_subfr                        /* input : subframe size     */
 )
 {
-    Word16 i, j, k, *x;
+    Word16 i, j, *x;
+    const Word16 *fir;
     Word32 L_sum;
 
     x = &exc[-T0];
@@ -97,13 +64,14 @@ void Pred_lt4(
     }
     x = x - L_INTERPOL2 + 1;
     move16();
+    fir = inter4_2_ph[frac];               move16();
 
     for (j = 0; j < L_subfr; j++)
     {
         L_sum = 0L;                        move32();
-        for (i = 0, k = sub(sub(UP_SAMP, 1), frac); i < 2 * L_INTERPOL2; i++, k += UP_SAMP)
+        for (i = 0; i < 2 * L_INTERPOL2; i++)
         {
-            L_sum = L_mac(L_sum, x[i], inter4_2[k]);
+            L_sum = L_mac(L_sum, x[i], fir[i]);
         }
         L_sum = L_shl(L_sum, 1);
 
@@ -15,6 +15,7 @@
 #include "oper_32b.h"
 #include "math_op.h"
 #include "count.h"
+#include "rom_tab.h"
 #include "log2.h"
 
 #include "acelp.h"
@@ -26,8 +27,7 @@
 #define PRED_ORDER   4
 
 
-/* MA prediction coeff ={0.5, 0.4, 0.3, 0.2} in Q13 */
-static Word16 pred[PRED_ORDER] = {4096, 3277, 2458, 1638};
+/* MA prediction coeff ={0.5, 0.4, 0.3, 0.2} in Q13: pred_gain[] of rom_tab.c */
 
 
 void Init_Q_gain2(
@@ -62,13 +62,14 @@ Word16 Q_gain2(                            /* Return index of quantization.
      Word16 * mem                          /* (i/o)   : static memory (2 words)      */
 )
 {
-    Word16 i, j, index, *p, min_ind, size;
+    Word16 i, j, index, min_ind, size;
     Word16 exp, frac, gcode0, exp_gcode0, e_max, exp_code, qua_ener;
     Word16 g_pitch, g2_pitch, g_code, g_pit_cod, g2_code, g2_code_lo;
     Word16 coeff[5], coeff_lo[5], exp_coeff[5];
     Word16 exp_max[5];
     Word32 L_tmp, dist_min;
-    Word16 *past_qua_en, *t_qua_gain;
+    Word16 *past_qua_en;
+    const Word16 *t_qua_gain, *p;
 
     past_qua_en = mem;                     move16();
 
@@ -170,10 +171,10 @@ Word16 Q_gain2(                            /* Return index of quantization.
      *-----------------------------------------------------------------*/
 
     L_tmp = L_shl(L_tmp, 10);              /* From Q14 to Q24 */
-    L_tmp = L_mac(L_tmp, pred[0], past_qua_en[0]);      /* Q13*Q10 -> Q24 */
-    L_tmp = L_mac(L_tmp, pred[1], past_qua_en[1]);      /* Q13*Q10 -> Q24 */
-    L_tmp = L_mac(L_tmp, pred[2], past_qua_en[2]);      /* Q13*Q10 -> Q24 */
-    L_tmp = L_mac(L_tmp, pred[3], past_qua_en[3]);      /* Q13*Q10 -> Q24 */
+    L_tmp = L_mac(L_tmp, pred_gain[0], past_qua_en[0]);      /* Q13*Q10 -> Q24 */
+    L_tmp = L_mac(L_tmp, pred_gain[1], past_qua_en[1]);      /* Q13*Q10 -> Q24 */
+    L_tmp = L_mac(L_tmp, pred_gain[2], past_qua_en[2]);      /* Q13*Q10 -> Q24 */
+    L_tmp = L_mac(L_tmp, pred_gain[3], past_qua_en[3]);      /* Q13*Q10 -> Q24 */
 
     gcode0 = extract_h(L_tmp);             /* From Q24 to Q8  */
 
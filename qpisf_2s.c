@@ -13,6 +13,7 @@
 #include "cnst.h"
 #include "acelp.h"
 #include "count.h"
+#include "cpu_disp.h"
 
 #include "qpisf_2s.tab"                    /* Codebooks of isfs */
 
@@ -25,7 +26,7 @@
 
 static void VQ_stage1(
      Word16 * x,                           /* input : ISF residual vector           */
-     Word16 * dico,                        /* input : quantization codebook         */
+     const Word16 * dico,                  /* input : quantization codebook         */
      Word16 dim,                           /* input : dimention of vector           */
      Word16 dico_size,                     /* input : size of quantization codebook */
      Word16 * index,                       /* output: indices of survivors          */
@@ -461,13 +462,14 @@ void Reorder_isf(
 
 Word16 Sub_VQ(                             /* output: return quantization index     */
      Word16 * x,                           /* input : ISF residual vector           */
-     Word16 * dico,                        /* input : quantization codebook         */
+     const Word16 * dico,                  /* input : quantization codebook         */
      Word16 dim,                           /* input : dimention of vector           */
      Word16 dico_size,                     /* input : size of quantization codebook */
      Word32 * distance                     /* output: error of quantization         */
 )
 {
-    Word16 i, j, index, temp, *p_dico;
+    Word16 i, j, index, temp;
+    const Word16 *p_dico;
     Word32 dist_min, dist;
 
     dist_min = MAX_32;                     move32();
@@ -505,16 +507,36 @@ Word16 Sub_VQ(                             /* output: return quantization index
 }
 
 
+/* the variant of the CPU (cpu_disp.c), the reference with the counters */
 static void VQ_stage1(
      Word16 * x,                           /* input : ISF residual vector           */
-     Word16 * dico,                        /* input : quantization codebook         */
+     const Word16 * dico,                  /* input : quantization codebook         */
      Word16 dim,                           /* input : dimention of vector           */
      Word16 dico_size,                     /* input : size of quantization codebook */
      Word16 * index,                       /* output: indices of survivors          */
      Word16 surv                           /* input : number of survivor            */
 )
 {
-    Word16 i, j, k, l, temp, *p_dico;
+#if (WMOPS == 0)
+    disp_kern->vq_stage1(x, dico, dim, dico_size, index, surv);
+#else
+    VQ_stage1_ref(x, dico, dim, dico_size, index, surv);
+#endif
+
+    return;
+}
+
+void VQ_stage1_ref(
+     Word16 * x,                           /* input : ISF residual vector           */
+     const Word16 * dico,                  /* input : quantization codebook         */
+     Word16 dim,                           /* input : dimention of vector           */
+     Word16 dico_size,                     /* input : size of quantization codebook */
+     Word16 * index,                       /* output: indices of survivors          */
+     Word16 surv                           /* input : number of survivor            */
+)
+{
+    Word16 i, j, k, l, temp;
+    const Word16 *p_dico;
     Word32 dist_min[N_SURV_MAX], dist;
 
     for (i = 0; i < surv; i++)
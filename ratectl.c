@@ -0,0 +1,349 @@
+/*------------------------------------------------------------------------*
+ *                         RATECTL.C                                      *
+ *------------------------------------------------------------------------*
+ * Source-controlled rate: mode of each frame for a target bit rate       *
+ *------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "math_op.h"
+#include "acelp.h"
+#include "log2.h"
+#include "cnst.h"
+#include "bits.h"
+#include "count.h"
+#include "ratectl.h"
+
+/*-----------------------------------------------------------------*
+ * The mode of a frame is chosen by coder_front() after the LP     *
+ * analysis, before the open-loop pitch (the 6.60k search is not   *
+ * the one of the other modes), from the classification of the     *
+ * frame:                                                          *
+ *                                                                 *
+ * - onset: the VAD flag rises, the energy rises by more than      *
+ *   6 dB or the spectrum changes (isf distance of the stability   *
+ *   factor of coder_acelp()). The frame and the next one get the  *
+ *   budget of an active frame plus the bits the window has below  *
+ *   the target, up to 4 x the budget: a boost never takes the     *
+ *   window above the target.                                      *
+ * - stationary: stable spectrum and energy, voiced (open-loop     *
+ *   pitch gain of the previous frame) or noise-like (negative     *
+ *   tilt): 3/4 of the budget of an active frame.                  *
+ * - inactive (VAD flag 0): 1/2 of the budget.                     *
+ * - active: the budget.                                           *
+ *                                                                 *
+ * The mode is the highest one within the bits of the class.       *
+ *                                                                 *
+ * The budget is a closed loop on the bits of the last win frames: *
+ * the deficit of the window (win x target - bits) is spread on    *
+ * the next win/4 frames, and integrated in the long-term budget   *
+ * of an active frame, which settles at the value for which the    *
+ * mix of the classes gives the target. The window starts full of  *
+ * frames at the target.                                           *
+ *                                                                 *
+ * DTX frames are counted at RATE_DTX_BITS, a SID frame (35 bits)  *
+ * every 8 frames: the frame type is only known when written.      *
+ *-----------------------------------------------------------------*/
+
+#define RATE_DTX_BITS      5
+
+#define RATE_ONSET_ENER    2048            /* 6 dB: log2 energy +2.0 (Q10)  */
+#define RATE_ONSET_STAB    13107           /* stability factor 0.4 (Q15)    */
+#define RATE_ONSET_FRAMES  2
+#define RATE_ONSET_SHIFT   2               /* 4 x the budget                */
+
+#define RATE_STAT_ENER     1024            /* 3 dB (Q10)                    */
+#define RATE_STAT_STAB     26214           /* 0.8 (Q15)                     */
+#define RATE_STAT_GAIN     19661           /* open-loop pitch gain 0.6      */
+
+#define RATE_FAC_STAT      24576           /* 3/4 (Q15)                     */
+#define RATE_FAC_INACTIVE  16384           /* 1/2 (Q15)                     */
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_ratectl                                         *
+ *            ~~~~~~~~~~~~                                         *
+ *   ->Initialization of the rate controller: target in bits per   *
+ *     frame (kbit/s x 20), window in frames.                      *
+ *-----------------------------------------------------------------*/
+
+Word16 Init_ratectl(Rate_State ** state, Word16 target, Word16 win)
+{
+    Rate_State *st;
+
+    *state = NULL;
+
+    test();test();
+    if ((sub(win, RATE_WIN_MIN) < 0) || (sub(win, RATE_WIN_MAX) > 0))
+    {
+        fprintf(stderr, "Init_ratectl: window of %d frames, use %d to %d\n", win, RATE_WIN_MIN, RATE_WIN_MAX);
+        return -1;
+    }
+    test();
+    if ((st = (Rate_State *) malloc(sizeof(Rate_State))) == NULL)
+    {
+        fprintf(stderr, "Init_ratectl: can not malloc state structure\n");
+        return -1;
+    }
+    st->target = target;                   move16();
+    st->win = win;                         move16();
+    st->inv_spread = div_s(4, win);        move16();
+    Reset_ratectl(st);
+
+    *state = st;
+
+    return 0;
+}
+
+void Reset_ratectl(Rate_State * st)
+{
+    Word16 i;
+
+    for (i = 0; i < st->win; i++)
+    {
+        st->bits[i] = st->target;          move16();
+    }
+    st->pos = 0;                           move16();
+    st->L_sum = L_shr(L_mult(st->target, st->win), 1);  move32();
+    st->base = shl(st->target, 4);         move16();
+    st->budget = st->target;               move16();
+
+    for (i = 0; i < M; i++)
+    {
+        st->isf_old[i] = 0;                move16();
+    }
+    st->ener_old = 0;                      move16();
+    st->vad_old = 0;                       move16();
+    st->onset = 0;                         move16();
+
+    /* highest mode within the target */
+    for (st->mode = MODE_24k; st->mode > 0; st->mode--)
+    {
+        test();
+        if (sub(nb_of_bits[st->mode], st->target) <= 0)
+        {
+            break;
+        }
+    }
+
+    for (i = 0; i < NUM_OF_MODES; i++)
+    {
+        st->count[i] = 0;                  move32();
+    }
+    st->L_frames = 0;                      move32();
+    st->L_bits = 0;                        move32();
+    st->L_sum_min = MAX_32;                move32();
+    st->L_sum_max = 0;                     move32();
+
+    return;
+}
+
+void Close_ratectl(Rate_State * st)
+{
+    free(st);
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Rate_mode                                            *
+ *            ~~~~~~~~~                                            *
+ *   ->Mode of the frame and update of the bits of the window.     *
+ *     A DTX frame (MRDTX) is only counted.                        *
+ *-----------------------------------------------------------------*/
+
+Word16 Rate_mode(
+     Rate_State * st,                      /* i/o : State structure                     */
+     Word16 mode,                          /* i   : MRDTX if a DTX frame, else any mode */
+     Word16 vad_flag,                      /* i   : VAD flag of the frame               */
+     Word16 sig[],                         /* i   : speech of the VAD (L_FRAME)         */
+     Word16 isf[],                         /* i   : isf at 4th subframe                 */
+     Word16 rc0,                           /* i   : 1st reflection coefficient (Q15)    */
+     Word16 ol_gain                        /* i   : open-loop pitch gain (Q15)          */
+)
+{
+    Word16 i, exp, frac, ener, d_ener, stab, tmp, bits, deficit, corr;
+    Word32 L_tmp;
+
+    /* log2 of the energy (Q10) */
+    L_tmp = Dot_product12(sig, sig, L_FRAME, &exp);
+    Log2_norm(L_tmp, 0, &tmp, &frac);
+    ener = add(shl(exp, 10), shr(frac, 5));
+    d_ener = sub(ener, st->ener_old);
+
+    /* stability factor (see coder_acelp()) */
+    L_tmp = 0;                             move32();
+    for (i = 0; i < M - 1; i++)
+    {
+        tmp = sub(isf[i], st->isf_old[i]);
+        L_tmp = L_mac(L_tmp, tmp, tmp);
+    }
+    tmp = extract_h(L_shl(L_tmp, 8));
+    tmp = mult(tmp, 26214);                /* tmp = L_tmp*0.8/256 */
+    tmp = sub(20480, tmp);                 /* 1.25 - tmp (in Q14) */
+    stab = shl(tmp, 1);
+    test();
+    if (stab < 0)
+    {
+        stab = 0;                          move16();
+    }
+
+    test();
+    if (sub(mode, MRDTX) == 0)
+    {
+        bits = RATE_DTX_BITS;              move16();
+        st->onset = 0;                     move16();
+    } else
+    {
+        /* onset: the frame and the next ones at 23.85k */
+        test();test();test();test();
+        if ((vad_flag != 0) && ((st->vad_old == 0) || (sub(d_ener, RATE_ONSET_ENER) > 0) ||
+                (sub(stab, RATE_ONSET_STAB) < 0)))
+        {
+            st->onset = RATE_ONSET_FRAMES; move16();
+        }
+        tmp = st->budget;                  move16();
+        test();
+        if (st->onset > 0)
+        {
+            st->onset = sub(st->onset, 1); move16();
+
+            /* boost by the bits the window has below the target, */
+            /* up to 4 x the budget                                */
+            L_tmp = L_sub(L_shr(L_mult(st->target, st->win), 1), st->L_sum);
+            deficit = extract_h(L_shl(L_tmp, 16));
+            test();
+            if (deficit > 0)
+            {
+                tmp = add(st->budget, deficit);
+                test();
+                if (sub(tmp, shl(st->budget, RATE_ONSET_SHIFT)) > 0)
+                {
+                    tmp = shl(st->budget, RATE_ONSET_SHIFT);
+                }
+            }
+        } else
+        {
+            test();test();test();test();
+            if (vad_flag == 0)
+            {
+                tmp = mult(st->budget, RATE_FAC_INACTIVE);
+            } else if ((sub(stab, RATE_STAT_STAB) >= 0) && (sub(abs_s(d_ener), RATE_STAT_ENER) < 0) &&
+                ((sub(ol_gain, RATE_STAT_GAIN) > 0) || (rc0 > 0)))
+            {
+                tmp = mult(st->budget, RATE_FAC_STAT);
+            }
+        }
+
+        /* highest mode within the bits */
+        for (mode = MODE_24k; mode > 0; mode--)
+        {
+            test();
+            if (sub(nb_of_bits[mode], tmp) <= 0)
+            {
+                break;
+            }
+        }
+        bits = nb_of_bits[mode];           move16();
+        st->mode = mode;                   move16();
+    }
+
+    Copy(isf, st->isf_old, M);
+    st->ener_old = ener;                   move16();
+    st->vad_old = vad_flag;                move16();
+
+    /* bits of the window */
+    st->L_sum = L_sub(st->L_sum, L_deposit_l(st->bits[st->pos]));
+    st->L_sum = L_add(st->L_sum, L_deposit_l(bits));
+    st->bits[st->pos] = bits;              move16();
+    st->pos = add(st->pos, 1);
+    test();
+    if (sub(st->pos, st->win) == 0)
+    {
+        st->pos = 0;                       move16();
+    }
+
+    /* closed loop: deficit spread on win/4 frames, integrated in base */
+    L_tmp = L_sub(L_shr(L_mult(st->target, st->win), 1), st->L_sum);
+    deficit = extract_h(L_shl(L_tmp, 16));
+    corr = mult(deficit, st->inv_spread);
+
+    st->base = add(st->base, corr);
+    tmp = shl(nb_of_bits[0], 4);
+    test();
+    if (sub(st->base, tmp) < 0)
+    {
+        st->base = tmp;                    move16();
+    }
+    tmp = shl(nb_of_bits[MODE_24k], 5);    /* 2 x 23.85k: the classes below keep a margin */
+    test();
+    if (sub(st->base, tmp) > 0)
+    {
+        st->base = tmp;                    move16();
+    }
+    st->budget = add(shr(st->base, 4), corr);
+    test();
+    if (st->budget < 0)
+    {
+        st->budget = 0;                    move16();
+    }
+
+    /* statistics */
+    st->count[mode] = L_add(st->count[mode], 1);        move32();
+    st->L_frames = L_add(st->L_frames, 1);
+    st->L_bits = L_add(st->L_bits, L_deposit_l(bits));
+    test();
+    if (L_sub(st->L_frames, L_deposit_l(st->win)) >= 0)
+    {
+        test();
+        if (L_sub(st->L_sum, st->L_sum_min) < 0)
+        {
+            st->L_sum_min = st->L_sum;     move32();
+        }
+        test();
+        if (L_sub(st->L_sum, st->L_sum_max) > 0)
+        {
+            st->L_sum_max = st->L_sum;     move32();
+        }
+    }
+
+    return mode;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Rate_report                                          *
+ *            ~~~~~~~~~~~                                          *
+ *   ->Average bit rate, range of the window and frames per mode.  *
+ *-----------------------------------------------------------------*/
+
+void Rate_report(FILE * fp, Rate_State * st)
+{
+    static const char *const rate_name[NUM_OF_MODES] =
+    {
+        "6.60k", "8.85k", "12.65k", "14.25k", "15.85k", "18.25k", "19.85k", "23.05k", "23.85k", "DTX"
+    };
+    Word16 i;
+
+    fprintf(fp, "Rate control: target %.2f kbit/s, window of %d frames\n", st->target / 20.0, st->win);
+    if (st->L_frames == 0)
+    {
+        return;
+    }
+    fprintf(fp, "  average %.2f kbit/s over %ld frames\n", (double) st->L_bits / st->L_frames / 20.0,
+        (long) st->L_frames);
+    if (st->L_frames >= st->win)
+    {
+        fprintf(fp, "  window  %.2f to %.2f kbit/s\n", (double) st->L_sum_min / st->win / 20.0,
+            (double) st->L_sum_max / st->win / 20.0);
+    }
+    for (i = 0; i < NUM_OF_MODES; i++)
+    {
+        if (st->count[i] != 0)
+        {
+            fprintf(fp, "  %-6s  %ld frames\n", rate_name[i], (long) st->count[i]);
+        }
+    }
+
+    return;
+}
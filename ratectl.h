@@ -0,0 +1,61 @@
+/*--------------------------------------------------------------------------*
+ *                         RATECTL.H                                        *
+ *--------------------------------------------------------------------------*
+ *       Source-controlled rate: mode of each frame for a target bit rate   *
+ *--------------------------------------------------------------------------*/
+
+#ifndef ratectl_h
+#define ratectl_h
+
+#include <stdio.h>
+#include "typedef.h"
+#include "cnst.h"
+
+#define RATE_WIN_MIN   8                   /* window of the target (frames) */
+#define RATE_WIN_MAX   500
+#define RATE_WIN_DEF   50                  /* 1 s                           */
+
+typedef struct Rate_State
+{
+    Word16 target;                         /* bits per frame of the target bit rate     */
+    Word16 win;                            /* length of the window (frames)             */
+    Word16 inv_spread;                     /* 4 / win (Q15): deficit spread on win/4    */
+    Word16 bits[RATE_WIN_MAX];             /* bits of the last win frames (circular)    */
+    Word16 pos;                            /* oldest frame of bits[]                    */
+    Word32 L_sum;                          /* bits of the window                        */
+    Word16 base;                           /* bits of an active frame, long term (Q4)   */
+    Word16 budget;                         /* bits of an active frame, next frame       */
+    Word16 isf_old[M];                     /* isf of the previous frame                 */
+    Word16 ener_old;                       /* log2 energy of the previous frame (Q10)   */
+    Word16 vad_old;                        /* VAD flag of the previous frame            */
+    Word16 onset;                          /* frames left at 23.85k after an onset      */
+    Word16 mode;                           /* mode of the last speech frame             */
+
+    /* statistics (Rate_report()) */
+    Word32 count[NUM_OF_MODES];            /* frames of each mode                       */
+    Word32 L_frames;
+    Word32 L_bits;
+    Word32 L_sum_min, L_sum_max;           /* bits of the full windows                  */
+} Rate_State;
+
+Word16 Init_ratectl(                       /* Return 0 if ok, -1 on error               */
+     Rate_State ** st,                     /* o   : State structure                     */
+     Word16 target,                        /* i   : target bits per frame (kbit/s x 20) */
+     Word16 win                            /* i   : window of the target (frames)       */
+);
+void Reset_ratectl(Rate_State * st);
+void Close_ratectl(Rate_State * st);
+
+Word16 Rate_mode(                          /* Return the mode of the frame              */
+     Rate_State * st,                      /* i/o : State structure                     */
+     Word16 mode,                          /* i   : MRDTX if a DTX frame, else any mode */
+     Word16 vad_flag,                      /* i   : VAD flag of the frame               */
+     Word16 sig[],                         /* i   : speech of the VAD (L_FRAME)         */
+     Word16 isf[],                         /* i   : isf at 4th subframe                 */
+     Word16 rc0,                           /* i   : 1st reflection coefficient (Q15)    */
+     Word16 ol_gain                        /* i   : open-loop pitch gain (Q15)          */
+);
+
+void Rate_report(FILE * fp, Rate_State * st);
+
+#endif
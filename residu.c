@@ -7,9 +7,10 @@
 #include "typedef.h"
 #include "basic_op.h"
 #include "count.h"
+#include "cpu_disp.h"
 
 
-void Residu(
+void Residu_ref(
      Word16 a[],                           /* (i) Q12 : prediction coefficients                     */
      Word16 m,                             /* (i)     : order of LP filter                          */
      Word16 x[],                           /* (i)     : speech (values x[-m..-1] are needed         */
@@ -33,3 +34,20 @@ void Residu(
 
     return;
 }
+
+void Residu(
+     Word16 a[],                           /* (i) Q12 : prediction coefficients                     */
+     Word16 m,                             /* (i)     : order of LP filter                          */
+     Word16 x[],                           /* (i)     : speech (values x[-m..-1] are needed         */
+     Word16 y[],                           /* (o) x2  : residual signal                             */
+     Word16 lg                             /* (i)     : size of filtering                           */
+)
+{
+#if (WMOPS == 0)
+    disp_kern->residu(a, m, x, y, lg);
+#else
+    Residu_ref(a, m, x, y, lg);
+#endif
+
+    return;
+}
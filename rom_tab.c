@@ -0,0 +1,242 @@
+/*------------------------------------------------------------------------*
+ *                         ROM_TAB.C                                      *
+ *------------------------------------------------------------------------*
+ * Constant tables of the fixed-point and floating-point codecs           *
+ *                                                                        *
+ * The tables are const (one read-only copy, shared by all the encoders,  *
+ * decoders and threads of a process and, in the read-only segment, by    *
+ * all the processes running the programs) and aligned on a cache line.   *
+ *                                                                        *
+ * The polyphase filters are stored phase-major: the coefficients of one  *
+ * phase are contiguous, in the order of the reference loops, instead of  *
+ * a stride of the resolution in the prototype filter. The products and   *
+ * their order are unchanged (bit-exact).                                 *
+ *------------------------------------------------------------------------*/
+
+#include "typedef.h"
+#include "cnst.h"
+#include "rom_tab.h"
+
+/*-----------------------------------------------------------------*
+ * LP analysis and ISF                                             *
+ *-----------------------------------------------------------------*/
+
+/* LPC interpolation coef {0.45, 0.8, 0.96, 1.0}; in Q15 */
+const Word16 interpol_frac[NB_SUBFR] ROM_ALIGN =
+{
+    14746, 26214, 31457, 32767
+};
+
+/* isp and isf tables for initialization */
+const Word16 isp_init[M] ROM_ALIGN =
+{
+    32138, 30274, 27246, 23170, 18205, 12540, 6393, 0,
+    -6393, -12540, -18205, -23170, -27246, -30274, -32138, 1475
+};
+
+const Word16 isf_init[M] ROM_ALIGN =
+{
+    1024, 2048, 3072, 4096, 5120, 6144, 7168, 8192,
+    9216, 10240, 11264, 12288, 13312, 14336, 15360, 3840
+};
+
+/*-----------------------------------------------------------------*
+ * Resampling 16 kHz <-> 12.8 kHz (decim54.c)                      *
+ *-----------------------------------------------------------------*/
+
+/* 1/4 resolution filter x4/5 (in Q14), phase-major:                  */
+/* fir_down_ph[f][i] = fir_down[3 - f + 4 * i] of the 120-tap table   */
+const Word16 fir_down_ph[4][30] ROM_ALIGN =
+{
+    {
+        -5, 24, -50, 54, 0, -128, 294, -408, 344, 0,
+        -647, 1505, -2379, 3034, 13107, 3034, -2379, 1505, -647, 0,
+        344, -408, 294, -128, 0, 54, -50, 24, -5, 0
+    },
+    {
+        -6, 19, -26, 0, 77, -188, 270, -233, 0, 434,
+        -964, 1366, -1293, 0, 12254, 6575, -2746, 1030, 0, -507,
+        601, -441, 198, 0, -95, 99, -58, 18, 0, -1
+    },
+    {
+        -3, 9, 0, -41, 111, -170, 153, 0, -295, 649,
+        -888, 770, 0, -1997, 9894, 9894, -1997, 0, 770, -888,
+        649, -295, 0, 153, -170, 111, -41, 0, 9, -3
+    },
+    {
+        -1, 0, 18, -58, 99, -95, 0, 198, -441, 601,
+        -507, 0, 1030, -2746, 6575, 12254, 0, -1293, 1366, -964,
+        434, 0, -233, 270, -188, 77, 0, -26, 19, -6
+    }
+};
+
+/* 1/5 resolution interpolation filter (in Q14), phase-major:         */
+/* -1.5dB @ 6kHz, -6dB @ 6.4kHz, -10dB @ 6.6kHz, -20dB @ 6.9kHz,        */
+/* -25dB @ 7kHz, -55dB @ 8kHz                                           */
+/* fir_up_ph[f][i] = fir_up[4 - f + 5 * i] of the 120-tap table       */
+const Word16 fir_up_ph[5][24] ROM_ALIGN =
+{
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16384,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    },
+    {
+        -6, 23, -52, 96, -160, 247, -369, 542, -809, 1288, -2496, 15317,
+        3792, -1616, 963, -634, 430, -291, 191, -119, 68, -33, 12, -1
+    },
+    {
+        -7, 30, -73, 139, -235, 368, -552, 812, -1204, 1881, -3432, 12368,
+        8219, -2974, 1708, -1111, 752, -510, 338, -213, 124, -62, 24, -4
+    },
+    {
+        -4, 24, -62, 124, -213, 338, -510, 752, -1111, 1708, -2974, 8219,
+        12368, -3432, 1881, -1204, 812, -552, 368, -235, 139, -73, 30, -7
+    },
+    {
+        -1, 12, -33, 68, -119, 191, -291, 430, -634, 963, -1616, 3792,
+        15317, -2496, 1288, -809, 542, -369, 247, -160, 96, -52, 23, -6
+    }
+};
+
+/*-----------------------------------------------------------------*
+ * Fractional pitch (pitch_f4.c, pred_lt4.c)                       *
+ *-----------------------------------------------------------------*/
+
+/* 1/4 resolution interpolation filter (-3 dB at 0.791*fs/2) in Q14,  */
+/* phase-major: inter4_1_ph[f][i] = inter4_1[3 - f + 4 * i]          */
+const Word16 inter4_1_ph[4][8] ROM_ALIGN =
+{
+    {
+        206, -766, 1376, 14746, 1376, -766, 206, 0
+    },
+    {
+        32, 73, -1242, 13418, 5429, -1732, 420, -12
+    },
+    {
+        -26, 455, -2142, 9910, 9910, -2142, 455, -26
+    },
+    {
+        -12, 420, -1732, 5429, 13418, -1242, 73, 32
+    }
+};
+
+/* 1/4 resolution interpolation filter (-3 dB at 0.856*fs/2) in Q14,  */
+/* phase-major: inter4_2_ph[f][i] = inter4_2[3 - f + 4 * i]          */
+const Word16 inter4_2_ph[4][32] ROM_ALIGN =
+{
+    {
+        1, -7, 22, -49, 92, -153, 231, -325,
+        431, -544, 656, -762, 853, -923, 968, 15401,
+        968, -923, 853, -762, 656, -544, 431, -325,
+        231, -153, 92, -49, 22, -7, 1, 0
+    },
+    {
+        2, -10, 28, -55, 91, -133, 175, -209,
+        226, -213, 153, -16, -249, 780, -2147, 14031,
+        5531, -2598, 1699, -1207, 871, -619, 424, -275,
+        165, -88, 38, -10, -2, 4, -2, 0
+    },
+    {
+        1, -7, 19, -33, 47, -52, 43, -9,
+        -60, 175, -355, 626, -1044, 1749, -3267, 10359,
+        10359, -3267, 1749, -1044, 626, -355, 175, -60,
+        -9, 43, -52, 47, -33, 19, -7, 1
+    },
+    {
+        0, -2, 4, -2, -10, 38, -88, 165,
+        -275, 424, -619, 871, -1207, 1699, -2598, 5531,
+        14031, -2147, 780, -249, -16, 153, -213, 226,
+        -209, 175, -133, 91, -55, 28, -10, 2
+    }
+};
+
+/*-----------------------------------------------------------------*
+ * Algebraic codebook and gains                                    *
+ *-----------------------------------------------------------------*/
+
+/* starting points of the iterations of the 4-track searches (ipos[]) */
+const Word16 tipos[36] ROM_ALIGN =
+{
+    0, 1, 2, 3,
+    1, 2, 3, 0,
+    2, 3, 0, 1,
+    3, 0, 1, 2,
+    0, 1, 2, 3,
+    1, 2, 3, 0,
+    2, 3, 0, 1,
+    3, 0, 1, 2,
+    0, 1, 2, 3
+};
+
+/* MA prediction coeff of the code gain {0.5, 0.4, 0.3, 0.2} in Q13 */
+const Word16 pred_gain[4] ROM_ALIGN =
+{
+    4096, 3277, 2458, 1638
+};
+
+/*-----------------------------------------------------------------*
+ * Filters                                                         *
+ *-----------------------------------------------------------------*/
+
+/* 2nd order high pass 50 Hz at 12.8 kHz (hp50.c): b in Q12, a in Q12 (x2) */
+const Word16 hp50_b[3] ROM_ALIGN =
+{
+    4053, -8106, 4053
+};
+
+const Word16 hp50_a[3] ROM_ALIGN =
+{
+    8192, 16211, -8021
+};
+
+/* 2nd order high pass 400 Hz at 12.8 kHz (hp400.c): b in Q12 (/4), a in Q12 (x4) */
+const Word16 hp400_b[3] ROM_ALIGN =
+{
+    915, -1830, 915
+};
+
+const Word16 hp400_a[3] ROM_ALIGN =
+{
+    16384, 29280, -14160
+};
+
+/* 3rd order high pass of the weighted speech (hp_wsp.c), in Q12 */
+const Word16 hp_wsp_a[4] ROM_ALIGN =
+{
+    8192, 21663, -19258, 5734
+};
+
+const Word16 hp_wsp_b[4] ROM_ALIGN =
+{
+    -3432, 10280, -10280, 3432
+};
+
+/* 6-7 kHz band pass at 16 kHz (hp6k.c), gain=4.0 */
+const Word16 fir_6k_7k[31] ROM_ALIGN =
+{
+    -32, 47, 32, -27, -369,
+    1122, -1421, 0, 3798, -8880,
+    12349, -10984, 3548, 7766, -18001,
+    22118, -18001, 7766, 3548, -10984,
+    12349, -8880, 3798, 0, -1421,
+    1122, -369, -27, 32, 47,
+    -32
+};
+
+/* 7 kHz low pass at 16 kHz (hp7k.c) */
+const Word16 fir_7k[31] ROM_ALIGN =
+{
+    -21, 47, -89, 146, -203,
+    229, -177, 0, 335, -839,
+    1485, -2211, 2931, -3542, 3953,
+    28682, 3953, -3542, 2931, -2211,
+    1485, -839, 335, 0, -177,
+    229, -203, 146, -89, 47,
+    -21
+};
+
+/* decimation by 2 (lp_dec2.c): {0.13, 0.23, 0.28, 0.23, 0.13} in Q15 */
+const Word16 fir_dec2[5] ROM_ALIGN =
+{
+    4260, 7536, 9175, 7536, 4260
+};
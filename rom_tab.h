@@ -0,0 +1,48 @@
+/*--------------------------------------------------------------------------*
+ *                         ROM_TAB.H                                        *
+ *--------------------------------------------------------------------------*
+ *       Constant tables shared by the codecs (rom_tab.c)                   *
+ *--------------------------------------------------------------------------*/
+
+#ifndef rom_tab_h
+#define rom_tab_h
+
+#include "typedef.h"
+#include "cnst.h"
+
+#if defined(__GNUC__)
+#define ROM_ALIGN  __attribute__((aligned(64)))        /* cache line */
+#else
+#define ROM_ALIGN
+#endif
+
+/* LP analysis and ISF */
+extern const Word16 interpol_frac[NB_SUBFR];           /* LPC interpolation (Q15)         */
+extern const Word16 isp_init[M];                       /* initial isp and isf             */
+extern const Word16 isf_init[M];
+
+/* polyphase filters, phase-major: [fraction][tap] */
+extern const Word16 fir_down_ph[4][30];                /* 16 kHz -> 12.8 kHz, 1/4 res.    */
+extern const Word16 fir_up_ph[5][24];                  /* 12.8 kHz -> 16 kHz, 1/5 res.    */
+extern const Word16 inter4_1_ph[4][8];                 /* normalized correlation, 1/4     */
+extern const Word16 inter4_2_ph[4][32];                /* adaptive codebook, 1/4          */
+
+/* algebraic codebook and gains */
+extern const Word16 tipos[36];                         /* starting points of the searches */
+extern const Word16 pred_gain[4];                      /* MA predictor of the code gain   */
+
+/* gain quantizer (q_gain2.tab, defined in q_gain2.c); g_pitch Q14, g_code Q11 */
+#define nb_qua_gain6b  64                              /* Number of quantization level    */
+#define nb_qua_gain7b  128                             /* Number of quantization level    */
+extern const Word16 t_qua_gain6b[nb_qua_gain6b * 2];
+extern const Word16 t_qua_gain7b[nb_qua_gain7b * 2];
+
+/* filters */
+extern const Word16 hp50_b[3], hp50_a[3];              /* hp50.c                          */
+extern const Word16 hp400_b[3], hp400_a[3];            /* hp400.c                         */
+extern const Word16 hp_wsp_a[4], hp_wsp_b[4];          /* hp_wsp.c                        */
+extern const Word16 fir_6k_7k[31];                     /* hp6k.c                          */
+extern const Word16 fir_7k[31];                        /* hp7k.c                          */
+extern const Word16 fir_dec2[5];                       /* lp_dec2.c                       */
+
+#endif
@@ -0,0 +1,394 @@
+/*___________________________________________________________________________
+ |                                                                           |
+ | Fixed-point C simulation of AMR WB ACELP coding algorithm with 20 ms      |
+ | speech frames for wideband speech signals.                                |
+ |___________________________________________________________________________|
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "cnst.h"
+#include "main.h"
+#include "bits.h"
+#include "dtx.h"
+#include "count.h"
+#include "pcm_io.h"
+#include "rtsched.h"
+
+/*-------------------------------------------------------------------*
+ * RTLOAD.C                                                          *
+ * ~~~~~~~~                                                          *
+ * Load generator of the real-time scheduler (rtsched.c).            *
+ *                                                                   *
+ *    Usage : rtload (-j workers) (-s seconds) (-dec percent) (-pin) *
+ *                   (-max) mode speech_file bitstream_file          *
+ *                   nb_channels                                     *
+ *                                                                   *
+ *    Runs nb_channels live channels in real time for the given     *
+ *    time (default 10 s): the encoder channels code speech_file in *
+ *    mode (0..8) and the decoder channels (default 50 %) decode    *
+ *    bitstream_file (default bitstream format), both in a loop and *
+ *    each one from another frame. The outputs are discarded.       *
+ *                                                                   *
+ *    Prints the frames done after their deadline, the lateness,    *
+ *    the queue depths and the frames stolen by the workers.        *
+ *    -max: from nb_channels, doubles then bisects the number of    *
+ *    channels to find the most which can run with at most 0.1 %   *
+ *    of the frames late.                                           *
+ *-------------------------------------------------------------------*/
+
+#define LOAD_MISS_MAX     0.001            /* frames late at the sustainable load    */
+#define LOAD_MAX_CHAN     1000000
+
+typedef struct
+{
+    Word16 *speech;                        /* frames of speech_file (2 LSBs deleted) */
+    long nb_speech;
+    Word16 (*prms)[NB_BITS_MAX];           /* frames of bitstream_file               */
+    Word16 *mode;
+    Word16 *frame_type;
+    long nb_bits;
+} Load_Vectors;
+
+typedef struct
+{
+    void *state;                           /* coder() or decoder() state             */
+    Word16 mode;                           /* encoder: mode                          */
+    long frame;                            /* next frame of the vector               */
+    Load_Vectors *vec;
+    Word16 prms[NB_BITS_MAX];
+    Word16 synth[L_FRAME16k];
+} Load_Channel;
+
+static void Encode_frame(void *arg)
+{
+    Load_Channel *ch = (Load_Channel *) arg;
+    Word16 signal[L_FRAME16k];
+    Word16 coding_mode, nb_bits;
+
+    memcpy(signal, &(ch->vec->speech[ch->frame * L_FRAME16k]), L_FRAME16k * sizeof(Word16));
+    coding_mode = ch->mode;
+    coder(&coding_mode, signal, ch->prms, &nb_bits, ch->state, 0);
+
+    if (++ch->frame == ch->vec->nb_speech)
+    {
+        ch->frame = 0;
+    }
+    return;
+}
+
+static void Decode_frame(void *arg)
+{
+    Load_Channel *ch = (Load_Channel *) arg;
+    Load_Vectors *vec = ch->vec;
+    Word16 frame_length;
+
+    memcpy(ch->prms, vec->prms[ch->frame], NB_BITS_MAX * sizeof(Word16));
+    decoder(vec->mode[ch->frame], ch->prms, ch->synth, &frame_length, ch->state, vec->frame_type[ch->frame]);
+
+    if (++ch->frame == vec->nb_bits)
+    {
+        ch->frame = 0;
+    }
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Read_vectors: speech_file and bitstream_file in memory        *
+ *-----------------------------------------------------------------*/
+
+static Word16 Read_vectors(Load_Vectors * vec, char *speech_file, char *bits_file)
+{
+    FILE *f;
+    PCM_State *pcm_state;
+    RX_State *rx_state;
+    Word16 prms[NB_BITS_MAX], frame_type, mode;
+    long size, i;
+
+    if ((f = fopen(speech_file, "rb")) == NULL)
+    {
+        fprintf(stderr, "Input file '%s' does not exist !!\n", speech_file);
+        return -1;
+    }
+    Init_read_pcm(&pcm_state, f, PCM_LINEAR, 0);
+    vec->nb_speech = 0;
+    size = 500;
+    vec->speech = (Word16 *) malloc(size * L_FRAME16k * sizeof(Word16));
+    while ((vec->speech != NULL) &&
+        (Read_pcm(f, &(vec->speech[vec->nb_speech * L_FRAME16k]), L_FRAME16k, pcm_state) == L_FRAME16k))
+    {
+        for (i = 0; i < L_FRAME16k; i++)   /* Delete the 2 LSBs (14-bit input) */
+        {
+            vec->speech[vec->nb_speech * L_FRAME16k + i] &= (Word16) 0xfffC;
+        }
+        if (++vec->nb_speech == size)
+        {
+            size *= 2;
+            vec->speech = (Word16 *) realloc(vec->speech, size * L_FRAME16k * sizeof(Word16));
+        }
+    }
+    Close_read_pcm(pcm_state);
+    fclose(f);
+
+    if ((f = fopen(bits_file, "rb")) == NULL)
+    {
+        fprintf(stderr, "Input file '%s' does not exist !!\n", bits_file);
+        return -1;
+    }
+    Init_read_serial(&rx_state);
+    vec->nb_bits = 0;
+    size = 500;
+    vec->prms = malloc(size * sizeof(vec->prms[0]));
+    vec->mode = (Word16 *) malloc(size * sizeof(Word16));
+    vec->frame_type = (Word16 *) malloc(size * sizeof(Word16));
+    while ((vec->prms != NULL) && (vec->mode != NULL) && (vec->frame_type != NULL) &&
+        (Read_serial(f, prms, &frame_type, &mode, rx_state, 0) != 0))
+    {
+        memcpy(vec->prms[vec->nb_bits], prms, NB_BITS_MAX * sizeof(Word16));
+        vec->mode[vec->nb_bits] = mode;
+        vec->frame_type[vec->nb_bits] = frame_type;
+        if (++vec->nb_bits == size)
+        {
+            size *= 2;
+            vec->prms = realloc(vec->prms, size * sizeof(vec->prms[0]));
+            vec->mode = (Word16 *) realloc(vec->mode, size * sizeof(Word16));
+            vec->frame_type = (Word16 *) realloc(vec->frame_type, size * sizeof(Word16));
+        }
+    }
+    Close_read_serial(rx_state);
+    fclose(f);
+
+    if ((vec->speech == NULL) || (vec->prms == NULL) || (vec->mode == NULL) || (vec->frame_type == NULL))
+    {
+        fprintf(stderr, "Can not malloc the test vectors\n");
+        return -1;
+    }
+    if ((vec->nb_speech == 0) || (vec->nb_bits == 0))
+    {
+        fprintf(stderr, "Empty test vector\n");
+        return -1;
+    }
+    return 0;
+}
+
+/*-----------------------------------------------------------------*
+ *   Run_load: nb_chan channels during nb_frames frames            *
+ *-----------------------------------------------------------------*/
+
+static Word16 Run_load(Load_Vectors * vec, long nb_chan, long nb_dec, Word16 mode,
+    Word16 nb_workers, Word16 pin, long nb_frames, Sch_Stats * stats)
+{
+    Sch_State *sched;
+    Load_Channel *chan;
+    Word16 error;
+    long c;
+
+    if ((chan = (Load_Channel *) malloc(nb_chan * sizeof(Load_Channel))) == NULL)
+    {
+        fprintf(stderr, "Can not malloc %ld channels\n", nb_chan);
+        return -1;
+    }
+    if (Init_sched(&sched, nb_workers, pin, nb_chan) != 0)
+    {
+        free(chan);
+        return -1;
+    }
+
+    /* the decoders are spread among the encoders */
+    error = 0;
+    for (c = 0; c < nb_chan; c++)
+    {
+        chan[c].vec = vec;
+        chan[c].mode = mode;
+        if ((c + 1) * nb_dec / nb_chan > c * nb_dec / nb_chan)
+        {
+            Init_decoder(&(chan[c].state));
+            chan[c].frame = c % vec->nb_bits;
+            Sched_add(sched, &chan[c], Decode_frame);
+        } else
+        {
+            Init_coder(&(chan[c].state));
+            chan[c].frame = c % vec->nb_speech;
+            Sched_add(sched, &chan[c], Encode_frame);
+        }
+        if (chan[c].state == NULL)
+        {
+            fprintf(stderr, "Can not init channel %ld\n", c);
+            nb_chan = c;
+            error = -1;
+            break;
+        }
+    }
+
+    if (error == 0)
+    {
+        error = Sched_run(sched, nb_frames);
+        Sched_stats(sched, stats);
+    }
+
+    for (c = 0; c < nb_chan; c++)
+    {
+        if ((c + 1) * nb_dec / nb_chan > c * nb_dec / nb_chan)
+        {
+            Close_decoder(chan[c].state);
+        } else
+        {
+            Close_coder(chan[c].state);
+        }
+    }
+    Close_sched(sched);
+    free(chan);
+
+    return error;
+}
+
+static Word16 Print_load(long nb_chan, long nb_dec, Sch_Stats * s)
+{
+    double frames = (s->frames > 0) ? (double) s->frames : 1.0;
+    double ticks = (s->ticks > 0) ? (double) s->ticks : 1.0;
+    Word16 ok;
+
+    ok = (Word16) ((double) s->misses <= LOAD_MISS_MAX * frames);
+
+    fprintf(stderr, "%7ld channels (%ld enc, %ld dec): %6.3f %% late, lateness %6.2f ms (max %7.2f), "
+        "queue %6.1f (max %ld), %5.1f %% stolen  %s\n",
+        nb_chan, nb_chan - nb_dec, nb_dec, 100.0 * (double) s->misses / frames,
+        s->late_sum / frames * 1e-3, (double) s->late_max * 1e-3,
+        s->queue_sum / ticks, (long) s->queue_max, 100.0 * (double) s->stolen / frames,
+        ok ? "ok" : "overloaded");
+
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    Load_Vectors vec;
+    Sch_Stats stats;
+    Word16 mode, nb_workers, pin, search, ok;
+    long nb_chan, dec_percent, seconds, lo, hi;
+
+    fprintf(stderr, "\n");
+    fprintf(stderr, " ==================================================================================================\n");
+    fprintf(stderr, " AMR Wideband Codec 3GPP TS26.190 / ITU-T G.722.2, Aug 25, 2003. Version %s.\n", CODEC_VERSION);
+    fprintf(stderr, " ==================================================================================================\n");
+    fprintf(stderr, "\n");
+
+    nb_workers = (Word16) sysconf(_SC_NPROCESSORS_ONLN);
+    seconds = 10;
+    dec_percent = 50;
+    pin = 0;
+    search = 0;
+
+    while ((argc > 1) && (argv[1][0] == '-'))
+    {
+        if ((strcmp(argv[1], "-j") == 0) && (argc > 2))
+        {
+            nb_workers = (Word16) atoi(argv[2]);
+            argv++;
+            argc--;
+        } else if ((strcmp(argv[1], "-s") == 0) && (argc > 2))
+        {
+            seconds = atol(argv[2]);
+            argv++;
+            argc--;
+        } else if ((strcmp(argv[1], "-dec") == 0) && (argc > 2))
+        {
+            dec_percent = atol(argv[2]);
+            argv++;
+            argc--;
+        } else if (strcmp(argv[1], "-pin") == 0)
+        {
+            pin = 1;
+        } else if (strcmp(argv[1], "-max") == 0)
+        {
+            search = 1;
+        } else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[1]);
+            exit(0);
+        }
+        argv++;
+        argc--;
+    }
+
+    if (argc != 5)
+    {
+        fprintf(stderr, "Usage : rtload  (-j workers) (-s seconds) (-dec percent) (-pin) (-max)\n");
+        fprintf(stderr, "                mode speech_file bitstream_file nb_channels\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "Runs nb_channels real-time channels (one frame every 20 ms) on the scheduler:\n");
+        fprintf(stderr, "encoders of speech_file in mode (0 to 8) and decoders of bitstream_file.\n");
+        fprintf(stderr, "-j: worker threads (default: one per processor), -pin: one processor per worker\n");
+        fprintf(stderr, "-s: duration (default 10 s), -dec: decoder channels (default 50 %%)\n");
+        fprintf(stderr, "-max: search the most channels with at most %.1f %% of the frames late\n", 100.0 * LOAD_MISS_MAX);
+        fprintf(stderr, "\n");
+        exit(0);
+    }
+    mode = (Word16) atoi(argv[1]);
+    nb_chan = atol(argv[4]);
+    if ((mode < 0) || (mode > 8))
+    {
+        fprintf(stderr, " error in bit rate mode %d: use 0 to 8\n", mode);
+        exit(0);
+    }
+    if ((nb_chan < 1) || (nb_chan > LOAD_MAX_CHAN) || (seconds < 1) || (dec_percent < 0) || (dec_percent > 100) ||
+        (nb_workers < 1) || (nb_workers > SCH_MAX_WORKERS))
+    {
+        fprintf(stderr, " error in the number of channels, workers, seconds or decoders\n");
+        exit(0);
+    }
+    if (Read_vectors(&vec, argv[2], argv[3]) != 0)
+    {
+        exit(0);
+    }
+    fprintf(stderr, "Workers: %d%s, %ld s per run, mode %d, %ld speech frames, %ld bitstream frames\n",
+        nb_workers, pin ? " (pinned)" : "", seconds, mode, vec.nb_speech, vec.nb_bits);
+
+    lo = 0;
+    hi = 0;
+    for (;;)
+    {
+        if (Run_load(&vec, nb_chan, nb_chan * dec_percent / 100, mode, nb_workers, pin,
+                seconds * 1000 / SCH_FRAME_MS, &stats) != 0)
+        {
+            exit(1);
+        }
+        ok = Print_load(nb_chan, nb_chan * dec_percent / 100, &stats);
+        if (search == 0)
+        {
+            return ok ? 0 : 2;
+        }
+
+        /* doubles up to the first overload, then bisects to 2 % */
+        if (ok)
+        {
+            lo = nb_chan;
+        } else
+        {
+            hi = nb_chan;
+        }
+        if (hi == 0)
+        {
+            if (2 * nb_chan > LOAD_MAX_CHAN)
+            {
+                break;
+            }
+            nb_chan = 2 * nb_chan;
+        } else
+        {
+            if (hi - lo <= ((lo / 50 > 1) ? lo / 50 : 1))
+            {
+                break;
+            }
+            nb_chan = (lo + hi) / 2;
+        }
+    }
+    fprintf(stderr, "Sustainable load: %ld channels\n", lo);
+
+    return 0;
+}
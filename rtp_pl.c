@@ -0,0 +1,502 @@
+/*------------------------------------------------------------------------*
+ *                         RTP_PL.C                                       *
+ *------------------------------------------------------------------------*
+ * AMR-WB RTP payload format (RFC 4867): packetizer and depacketizer      *
+ *                                                                        *
+ *  - bandwidth-efficient and octet-aligned modes                         *
+ *  - codec mode request (CMR, set by Set_rtp_cmr) and table of contents  *
+ *    (ToC) chain                                                         *
+ *  - several frames per packet and frame interleaving (octet-aligned)    *
+ *                                                                        *
+ * The speech bits are sorted with the tables of the MIME/storage format  *
+ * (mime_io.tab, in bits.c). coder() output is packed directly at its     *
+ * final place in the packet, and the payload is unpacked directly into   *
+ * the decoder() input arrays. The frame CRCs of the octet-aligned mode   *
+ * are not used.                                                          *
+ *------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "typedef.h"
+#include "basic_op.h"
+#include "cnst.h"
+#include "bits.h"
+#include "count.h"
+#include "dtx.h"
+#include "rtp_pl.h"
+
+
+#define MRSID     9                        /* frame type index of SID frames   */
+#define FT_LOST   14                       /* frame type index of lost speech  */
+#define FT_NODATA 15                       /* frame type index of empty frames */
+
+/*-----------------------------------------------------*
+ * bit access, MSB first (network order)               *
+ *-----------------------------------------------------*/
+
+static void Put_bits(UWord8 buf[], Word16 * pos, Word16 value, Word16 no_of_bits)
+{
+    Word16 i;
+
+    for (i = no_of_bits - 1; i >= 0; i--)
+    {
+        if ((value >> i) & 1)
+            buf[*pos >> 3] |= (UWord8) (0x80 >> (*pos & 7));
+        else
+            buf[*pos >> 3] &= (UWord8) ~(0x80 >> (*pos & 7));
+        (*pos)++;
+    }
+}
+
+static Word16 Get_bits(UWord8 buf[], Word16 * pos, Word16 no_of_bits)
+{
+    Word16 i, value;
+
+    value = 0;
+    for (i = 0; i < no_of_bits; i++)
+    {
+        value = (Word16) ((value << 1) | ((buf[*pos >> 3] >> (7 - (*pos & 7))) & 1));
+        (*pos)++;
+    }
+    return value;
+}
+
+/* size of the frame data in bits (octet-aligned mode: padded to a byte) */
+static Word16 Frame_bits(RTP_State * st, Word16 ft)
+{
+    if (st->octet_aligned)
+        return (Word16) (packed_size[ft] << 3);
+    if (ft == MRSID)
+        return (Word16) (unpacked_size[ft] + 5);   /* STI + mode indication */
+    return unpacked_size[ft];
+}
+
+static Word16 Header_bits(RTP_State * st)
+{
+    if (st->octet_aligned)
+        return (Word16) (st->interleaved ? 16 : 8);
+    return 4;
+}
+
+static Word16 Toc_bits(RTP_State * st)
+{
+    return (Word16) (st->octet_aligned ? 8 : 6);
+}
+
+/*-----------------------------------------------------*
+ * Init_rtp, Close_rtp, Reset_rtp                      *
+ *-----------------------------------------------------*/
+
+Word16 Init_rtp(RTP_State ** st, Word16 octet_aligned, Word16 frames_per_packet, Word16 ill)
+{
+    RTP_State *s;
+
+    if ((frames_per_packet < 1) || (frames_per_packet > RTP_MAX_FRAMES) ||
+        (ill < 0) || (ill >= RTP_MAX_ILL) || ((ill > 0) && !octet_aligned))
+    {
+        fprintf(stderr, "rtp_init: invalid payload parameters\n");
+        return -1;
+    }
+
+    /* allocate memory */
+    test();
+    if ((s = (RTP_State *) malloc(sizeof(RTP_State))) == NULL)
+    {
+        fprintf(stderr, "rtp_init: can not malloc state structure\n");
+        return -1;
+    }
+    s->octet_aligned = octet_aligned;
+    s->interleaved = (Word16) (ill > 0);
+    s->frames_per_packet = frames_per_packet;
+    s->ill = ill;
+    s->cmr = RTP_NO_CMR;
+    Reset_rtp(s);
+    *st = s;
+
+    return 0;
+}
+
+Word16 Close_rtp(RTP_State * st)
+{
+    test();
+    if (st != NULL)
+    {
+        free(st);
+        st = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+/*-----------------------------------------------------*
+ * Set_rtp_cmr: codec mode request sent in each packet *
+ *   (0..8, or RTP_NO_CMR for no mode request)         *
+ *-----------------------------------------------------*/
+
+Word16 Set_rtp_cmr(RTP_State * st, Word16 cmr)
+{
+    if ((cmr < 0) || ((cmr > MODE_24k) && (cmr != RTP_NO_CMR)))
+    {
+        fprintf(stderr, "rtp_cmr: invalid codec mode request\n");
+        return -1;
+    }
+    st->cmr = cmr;
+
+    return 0;
+}
+
+void Reset_rtp(RTP_State * st)
+{
+    st->nb_frames = 0;
+    st->cmr_rx = RTP_NO_CMR;
+    st->ill_rx = 0;
+    st->ilp_rx = 0;
+    st->prev_mode = 0;
+    st->nb_queued = 0;
+    st->next = 0;
+}
+
+/*-----------------------------------------------------*
+ * RTP_pack_frame -> add one coder() frame             *
+ *                                                     *
+ * Frame j of an interleaving group of L*N frames goes *
+ * to packet j % L (ILP) as its (j / L)-th frame. The  *
+ * L packets are completed with the last frame of the  *
+ * group and stay in st->packet[] until the next call. *
+ *-----------------------------------------------------*/
+
+Word16 RTP_pack_frame(RTP_State * st, Word16 prms[], Word16 coding_mode, Word16 mode, Word16 frame_type)
+{
+    Word16 i, p, k, L, ft, pos, toc;
+    UWord8 *packet;
+
+    L = (Word16) (st->ill + 1);
+
+    /* start of interleaving group: write the payload headers */
+    if (st->nb_frames == 0)
+    {
+        for (p = 0; p < L; p++)
+        {
+            pos = 0;
+            Put_bits(st->packet[p], &pos, st->cmr, 4);
+            if (st->octet_aligned)
+            {
+                Put_bits(st->packet[p], &pos, 0, 4);
+                if (st->interleaved)
+                {
+                    Put_bits(st->packet[p], &pos, st->ill, 4);
+                    Put_bits(st->packet[p], &pos, p, 4);
+                }
+            }
+            st->pos[p] = (Word16) (pos + st->frames_per_packet * Toc_bits(st));
+        }
+    }
+    p = (Word16) (st->nb_frames % L);
+    k = (Word16) (st->nb_frames / L);
+    packet = st->packet[p];
+
+    /* frame type index as in the MIME/storage format */
+    ft = coding_mode;
+    if (coding_mode == MRDTX)
+    {
+        ft = (frame_type == TX_NO_DATA) ? FT_NODATA : MRSID;
+    }
+    if ((ft < 0) || (ft > FT_NODATA) || ((ft > MRSID) && (ft < FT_LOST)))
+    {
+        ft = FT_NODATA;
+    }
+
+    /* ToC entry: F (set until packet completion), FT, Q */
+    pos = (Word16) (Header_bits(st) + k * Toc_bits(st));
+    toc = (Word16) ((1 << 5) | (ft << 1) | 1);
+    if (st->octet_aligned)
+        toc = (Word16) (toc << 2);
+    Put_bits(packet, &pos, toc, Toc_bits(st));
+
+    /* sorted speech or SID bits, straight from the coder() parameters */
+    pos = st->pos[p];
+    if ((ft == MRSID) && (frame_type == TX_SID_FIRST))
+    {
+        for (i = 0; i < unpacked_size[ft]; i++)
+            Put_bits(packet, &pos, 0, 1);
+    } else
+    {
+        for (i = 0; i < unpacked_size[ft]; i++)
+            Put_bits(packet, &pos, (Word16) (prms[sort_ptr[ft][i]] == BIT_1), 1);
+    }
+    if (ft == MRSID)
+    {
+        Put_bits(packet, &pos, (Word16) (frame_type == TX_SID_UPDATE), 1);
+        Put_bits(packet, &pos, (Word16) (mode & 0x000F), 4);
+    }
+    st->pos[p] = (Word16) (st->pos[p] + Frame_bits(st, ft));
+    while (pos < st->pos[p])
+        Put_bits(packet, &pos, 0, 1);
+
+    st->nb_frames++;
+    if (st->nb_frames < L * st->frames_per_packet)
+    {
+        return 0;
+    }
+    return RTP_flush(st);
+}
+
+/*-----------------------------------------------------*
+ * RTP_flush -> complete the packets of the current    *
+ *              (possibly partial) interleaving group  *
+ *-----------------------------------------------------*/
+
+Word16 RTP_flush(RTP_State * st)
+{
+    Word16 i, p, n, L, nb_packets, src, dst, end, pos, bit;
+
+    L = (Word16) (st->ill + 1);
+    nb_packets = (Word16) ((st->nb_frames < L) ? st->nb_frames : L);
+
+    for (p = 0; p < nb_packets; p++)
+    {
+        n = (Word16) ((st->nb_frames - p + L - 1) / L);
+
+        /* partial packet: move the frame data up to the end of the shorter ToC */
+        if (n < st->frames_per_packet)
+        {
+            src = (Word16) (Header_bits(st) + st->frames_per_packet * Toc_bits(st));
+            dst = (Word16) (Header_bits(st) + n * Toc_bits(st));
+            end = st->pos[p];
+            for (i = src; i < end; i++)
+            {
+                pos = i;
+                bit = Get_bits(st->packet[p], &pos, 1);
+                pos = (Word16) (dst + i - src);
+                Put_bits(st->packet[p], &pos, bit, 1);
+            }
+            st->pos[p] = (Word16) (end - src + dst);
+        }
+
+        /* clear F bit of the last ToC entry */
+        pos = (Word16) (Header_bits(st) + (n - 1) * Toc_bits(st));
+        Put_bits(st->packet[p], &pos, 0, 1);
+
+        /* zero padding up to the end of the last byte */
+        pos = st->pos[p];
+        while (pos & 7)
+            Put_bits(st->packet[p], &pos, 0, 1);
+        st->packet_len[p] = (Word16) (pos >> 3);
+    }
+    st->nb_frames = 0;
+
+    return nb_packets;
+}
+
+/*-----------------------------------------------------*
+ * RTP_unpack -> parse one payload into decoder()      *
+ *               parameters, frame types and modes     *
+ *-----------------------------------------------------*/
+
+Word16 RTP_unpack(RTP_State * st, UWord8 packet[], Word16 len, Word16 prms[][NB_BITS_MAX],
+                  Word16 frame_type[], Word16 mode[], Word16 slot[])
+{
+    Word16 i, k, n, f, ft, q, pos, data, size;
+    Word16 ft_list[RTP_MAX_FRAMES], q_list[RTP_MAX_FRAMES];
+
+    size = (Word16) (len << 3);
+    if (size < Header_bits(st))
+    {
+        return -1;
+    }
+
+    /* payload header */
+    pos = 0;
+    st->cmr_rx = Get_bits(packet, &pos, 4);
+    st->ill_rx = 0;
+    st->ilp_rx = 0;
+    if (st->octet_aligned)
+    {
+        pos = (Word16) (pos + 4);
+        if (st->interleaved)
+        {
+            st->ill_rx = Get_bits(packet, &pos, 4);
+            st->ilp_rx = Get_bits(packet, &pos, 4);
+            if (st->ilp_rx > st->ill_rx)
+            {
+                return -1;
+            }
+        }
+    }
+
+    /* table of contents */
+    n = 0;
+    do
+    {
+        if ((n == RTP_MAX_FRAMES) || (pos + Toc_bits(st) > size))
+        {
+            return -1;
+        }
+        f = Get_bits(packet, &pos, 1);
+        ft_list[n] = Get_bits(packet, &pos, 4);
+        q_list[n] = Get_bits(packet, &pos, 1);
+        pos = (Word16) (pos + Toc_bits(st) - 6);
+        n++;
+    } while (f);
+
+    /* frame data */
+    for (k = 0; k < n; k++)
+    {
+        ft = ft_list[k];
+        q = q_list[k];
+        data = pos;
+        if (pos + Frame_bits(st, ft) > size)
+        {
+            return -1;
+        }
+        for (i = 0; i < unpacked_size[ft]; i++)
+        {
+            prms[k][sort_ptr[ft][i]] = Get_bits(packet, &pos, 1) ? BIT_1 : BIT_0;
+        }
+
+        switch (ft)
+        {
+        case MODE_7k:
+        case MODE_9k:
+        case MODE_12k:
+        case MODE_14k:
+        case MODE_16k:
+        case MODE_18k:
+        case MODE_20k:
+        case MODE_23k:
+        case MODE_24k:
+            frame_type[k] = q ? RX_SPEECH_GOOD : RX_SPEECH_BAD;
+            st->prev_mode = ft;
+            break;
+        case MRSID:
+            if (q)
+                frame_type[k] = Get_bits(packet, &pos, 1) ? RX_SID_UPDATE : RX_SID_FIRST;
+            else
+                frame_type[k] = RX_SID_BAD;
+            break;
+        case FT_LOST:
+            frame_type[k] = RX_SPEECH_LOST;
+            break;
+        default:                           /* NO_DATA and unused frame types */
+            frame_type[k] = RX_NO_DATA;
+            break;
+        }
+        mode[k] = st->prev_mode;
+        slot[k] = (Word16) (st->ilp_rx + k * (st->ill_rx + 1));
+        pos = (Word16) (data + Frame_bits(st, ft));
+    }
+
+    return n;
+}
+
+/*-----------------------------------------------------*
+ * Payload file: each packet is written as one word    *
+ * (2-byte, big endian) payload size + payload         *
+ *-----------------------------------------------------*/
+
+static void Write_packets(FILE * fp, RTP_State * st, Word16 nb_packets)
+{
+    Word16 p;
+    UWord8 size[2];
+
+    for (p = 0; p < nb_packets; p++)
+    {
+        size[0] = (UWord8) (st->packet_len[p] >> 8);
+        size[1] = (UWord8) (st->packet_len[p] & 0xff);
+        fwrite(size, sizeof(UWord8), 2, fp);
+        fwrite(st->packet[p], sizeof(UWord8), st->packet_len[p], fp);
+    }
+}
+
+void Write_rtp(FILE * fp, Word16 prms[], Word16 coding_mode, Word16 mode, Word16 frame_type, RTP_State * st)
+{
+    Write_packets(fp, st, RTP_pack_frame(st, prms, coding_mode, mode, frame_type));
+}
+
+void Flush_rtp(FILE * fp, RTP_State * st)
+{
+    if (st->nb_frames > 0)
+    {
+        Write_packets(fp, st, RTP_flush(st));
+    }
+}
+
+/*-----------------------------------------------------*
+ * Read_rtp -> deliver the next frame, reading and     *
+ *             deinterleaving a new group of packets   *
+ *             when the queue is empty                 *
+ *-----------------------------------------------------*/
+
+Word16 Read_rtp(FILE * fp, Word16 prms[], Word16 * frame_type, Word16 * mode, RTP_State * st)
+{
+    Word16 i, k, n, len, q;
+    UWord8 size[2], packet[RTP_MAX_PAYLOAD];
+    Word16 frm_prms[RTP_MAX_FRAMES][NB_BITS_MAX];
+    Word16 frm_type[RTP_MAX_FRAMES], frm_mode[RTP_MAX_FRAMES], frm_slot[RTP_MAX_FRAMES];
+
+    if (st->next >= st->nb_queued)
+    {
+        st->next = 0;
+        st->nb_queued = 0;
+        for (q = 0; q < RTP_MAX_QUEUE; q++)
+        {
+            st->rx_type[q] = RX_NO_DATA;
+            st->rx_mode[q] = -1;
+        }
+
+        /* read packets up to the last one of the interleaving group */
+        do
+        {
+            if (fread(size, sizeof(UWord8), 2, fp) != 2)
+            {
+                break;
+            }
+            len = (Word16) ((size[0] << 8) | size[1]);
+            if ((len > RTP_MAX_PAYLOAD) || ((Word16) fread(packet, sizeof(UWord8), len, fp) != len))
+            {
+                break;
+            }
+            n = RTP_unpack(st, packet, len, frm_prms, frm_type, frm_mode, frm_slot);
+            if (n < 0)
+            {
+                fprintf(stderr, "Invalid RTP payload, packet skipped\n");
+                continue;
+            }
+            for (k = 0; k < n; k++)
+            {
+                q = frm_slot[k];
+                if (q >= RTP_MAX_QUEUE)
+                {
+                    continue;
+                }
+                for (i = 0; i < NB_BITS_MAX; i++)
+                {
+                    st->rx_prms[q][i] = frm_prms[k][i];
+                }
+                st->rx_type[q] = frm_type[k];
+                st->rx_mode[q] = frm_mode[k];
+                if (q >= st->nb_queued)
+                {
+                    st->nb_queued = (Word16) (q + 1);
+                }
+            }
+        } while (st->ilp_rx != st->ill_rx);
+
+        if (st->nb_queued == 0)
+        {
+            return 0;
+        }
+    }
+
+    /* frames missing in the group are delivered as NO_DATA */
+    q = st->next++;
+    for (i = 0; i < NB_BITS_MAX; i++)
+    {
+        prms[i] = (st->rx_mode[q] < 0) ? BIT_0 : st->rx_prms[q][i];
+    }
+    *frame_type = st->rx_type[q];
+    *mode = (st->rx_mode[q] < 0) ? st->prev_mode : st->rx_mode[q];
+
+    return 1;
+}
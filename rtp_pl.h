@@ -0,0 +1,77 @@
+/*--------------------------------------------------------------------------*
+ *                         RTP_PL.H                                         *
+ *--------------------------------------------------------------------------*
+ *       AMR-WB RTP payload format (RFC 4867)                               *
+ *--------------------------------------------------------------------------*/
+
+#ifndef rtp_pl_h
+#define rtp_pl_h
+
+#include <stdio.h>
+#include "typedef.h"
+#include "bits.h"
+
+#define RTP_MAX_FRAMES    16               /* max frames (ToC entries) per packet          */
+#define RTP_MAX_ILL       8                /* max interleaving group length (ILL + 1)      */
+#define RTP_MAX_PAYLOAD   (2 + RTP_MAX_FRAMES * 61)  /* CMR, ILL/ILP, (ToC + 60 bytes) * N */
+#define RTP_MAX_QUEUE     (RTP_MAX_ILL * RTP_MAX_FRAMES)
+
+#define RTP_NO_CMR        15               /* CMR value for "no mode request"              */
+
+typedef struct RTP_State
+{
+    Word16 octet_aligned;                  /* 1: octet-aligned, 0: bandwidth-efficient     */
+    Word16 interleaved;                    /* ILL/ILP octet present (octet-aligned only)   */
+    Word16 frames_per_packet;              /* N: frames per packet                         */
+    Word16 ill;                            /* L - 1: interleaving length (tx)              */
+    Word16 cmr;                            /* codec mode request sent in each packet       */
+
+    /* packetizer: frames are packed at their final place in the packets */
+    Word16 nb_frames;                      /* frames packed in current interleaving group  */
+    Word16 pos[RTP_MAX_ILL];               /* write position (bits), one per packet        */
+    Word16 packet_len[RTP_MAX_ILL];        /* size of completed packets (bytes)            */
+    UWord8 packet[RTP_MAX_ILL][RTP_MAX_PAYLOAD];
+
+    /* depacketizer */
+    Word16 cmr_rx;                         /* last received codec mode request             */
+    Word16 ill_rx;                         /* ILL and ILP of last received packet          */
+    Word16 ilp_rx;
+    Word16 prev_mode;                      /* mode of last speech frame                    */
+    Word16 nb_queued;                      /* deinterleaved frames waiting for decoder()   */
+    Word16 next;
+    Word16 rx_type[RTP_MAX_QUEUE];
+    Word16 rx_mode[RTP_MAX_QUEUE];
+    Word16 rx_prms[RTP_MAX_QUEUE][NB_BITS_MAX];
+} RTP_State;
+
+Word16 Init_rtp(RTP_State ** st, Word16 octet_aligned, Word16 frames_per_packet, Word16 ill);
+Word16 Close_rtp(RTP_State * st);
+void Reset_rtp(RTP_State * st);
+Word16 Set_rtp_cmr(RTP_State * st, Word16 cmr);
+
+Word16 RTP_pack_frame(                     /* Return number of completed packets     */
+     RTP_State * st,                       /* i/o : packetizer state                 */
+     Word16 prms[],                        /* i   : coder() output parameters        */
+     Word16 coding_mode,                   /* i   : mode used by coder()             */
+     Word16 mode,                          /* i   : speech mode (SID mode indicator) */
+     Word16 frame_type                     /* i   : TX_SPEECH .. TX_NO_DATA          */
+);
+Word16 RTP_flush(                          /* Return number of completed packets     */
+     RTP_State * st                        /* i/o : packetizer state                 */
+);
+Word16 RTP_unpack(                         /* Return number of frames, -1 if invalid */
+     RTP_State * st,                       /* i/o : depacketizer state               */
+     UWord8 packet[],                      /* i   : RTP payload                      */
+     Word16 len,                           /* i   : payload size (bytes)             */
+     Word16 prms[][NB_BITS_MAX],           /* o   : decoder() parameters per frame   */
+     Word16 frame_type[],                  /* o   : RX frame type per frame          */
+     Word16 mode[],                        /* o   : mode per frame                   */
+     Word16 slot[]                         /* o   : index in interleaving group      */
+);
+
+/* payload file: 1 word (2-byte, big endian) payload size + payload, per packet */
+void Write_rtp(FILE * fp, Word16 prms[], Word16 coding_mode, Word16 mode, Word16 frame_type, RTP_State * st);
+void Flush_rtp(FILE * fp, RTP_State * st);
+Word16 Read_rtp(FILE * fp, Word16 prms[], Word16 * frame_type, Word16 * mode, RTP_State * st);
+
+#endif
@@ -0,0 +1,475 @@
+/*------------------------------------------------------------------------*
+ *                         RTSCHED.C                                      *
+ *------------------------------------------------------------------------*
+ * Deadline-aware scheduler of real-time channels                         *
+ *                                                                        *
+ * Each channel (an encoder or a decoder and its buffers) needs one frame *
+ * processed every 20 ms. The scheduler runs one thread per worker:       *
+ *                                                                        *
+ *  - a channel belongs to a home worker (round robin), whose thread can  *
+ *    be pinned to one processor, so the codec state stays in its cache.  *
+ *  - the 20 ms frame is split in SCH_SLOTS ticks and the channels of a   *
+ *    worker are spread over the ticks. At each tick the worker queues    *
+ *    the batch of its channels which are due, oldest first.              *
+ *  - a worker whose queue is empty steals the oldest frame of the worker *
+ *    with the longest queue, so a worker which falls behind is helped    *
+ *    by the others.                                                      *
+ *  - a frame is late when it is done more than SCH_DEADLINE_MS after it  *
+ *    is due. A channel is never processed by two workers at a time: a   *
+ *    frame which becomes due while the previous one is still queued or   *
+ *    processed is counted as pending and processed right after it.     *
+ *                                                                        *
+ * When the complexity counters are off, the only globals written by     *
+ * coder() and decoder() are the Overflow and Carry flags of the basic    *
+ * operators, which are per thread (BASOP_TLS, basic_op.h): any worker    *
+ * can run any channel.                                                   *
+ *------------------------------------------------------------------------*/
+
+#ifdef __linux__
+#define _GNU_SOURCE                        /* pthread_setaffinity_np() */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "typedef.h"
+#include "rtsched.h"
+
+#define TICK_US      (SCH_TICK_MS * 1000.0)
+#define FRAME_US     (SCH_FRAME_MS * 1000.0)
+#define DEADLINE_US  (SCH_DEADLINE_MS * 1000.0)
+
+static double Now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec * 1e6 + (double) ts.tv_nsec * 1e-3;
+}
+
+static void Sleep_until(double t)
+{
+    struct timespec ts;
+    double d;
+
+    d = t - Now_us();
+    if (d <= 0.0)
+    {
+        return;
+    }
+    ts.tv_sec = (time_t) (d * 1e-6);
+    ts.tv_nsec = (long) ((d - (double) ts.tv_sec * 1e6) * 1e3);
+    nanosleep(&ts, NULL);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_sched                                           *
+ *            ~~~~~~~~~~                                           *
+ *   ->Workers for up to max_chan channels.                        *
+ *-----------------------------------------------------------------*/
+
+Word16 Init_sched(Sch_State ** state, Word16 nb_workers, Word16 pin, Word32 max_chan)
+{
+    Sch_State *st;
+    Sch_Worker *w;
+    Word32 size;
+    Word16 k;
+
+    *state = NULL;
+
+    if ((nb_workers < 1) || (nb_workers > SCH_MAX_WORKERS) || (max_chan < 1))
+    {
+        fprintf(stderr, "Init_sched: 1 to %d workers\n", SCH_MAX_WORKERS);
+        return -1;
+    }
+    if ((st = (Sch_State *) malloc(sizeof(Sch_State))) == NULL)
+    {
+        fprintf(stderr, "Init_sched: can not malloc state structure\n");
+        return -1;
+    }
+    st->nb_workers = nb_workers;
+    st->pin = pin;
+    st->nb_chan = 0;
+    st->max_chan = max_chan;
+    st->nb_ticks = 0;
+    st->chan = (Sch_Channel *) malloc(max_chan * sizeof(Sch_Channel));
+
+    /* channels are given round robin: at most size per worker */
+    size = (max_chan + nb_workers - 1) / nb_workers;
+
+    for (k = 0; k < nb_workers; k++)
+    {
+        w = &(st->worker[k]);
+        w->id = k;
+        w->sched = st;
+        w->nb_chan = 0;
+        w->size = size;
+        w->head = 0;
+        w->count = 0;
+        w->chan = (Word32 *) malloc(size * sizeof(Word32));
+        w->queue = (Word32 *) malloc(size * sizeof(Word32));
+        pthread_mutex_init(&(w->lock), NULL);
+
+        if ((st->chan == NULL) || (w->chan == NULL) || (w->queue == NULL))
+        {
+            fprintf(stderr, "Init_sched: can not malloc channel tables\n");
+            st->nb_workers = (Word16) (k + 1);
+            Close_sched(st);
+            return -1;
+        }
+    }
+    *state = st;
+
+    return 0;
+}
+
+void Close_sched(Sch_State * st)
+{
+    Word16 k;
+
+    for (k = 0; k < st->nb_workers; k++)
+    {
+        pthread_mutex_destroy(&(st->worker[k].lock));
+        free(st->worker[k].chan);
+        free(st->worker[k].queue);
+    }
+    free(st->chan);
+    free(st);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Sched_add                                            *
+ *            ~~~~~~~~~                                            *
+ *   ->Adds a channel (before Sched_run()). The channels are given *
+ *     to the workers in turn, and those of a worker to the ticks  *
+ *     in turn, so the batches have the same size.                 *
+ *-----------------------------------------------------------------*/
+
+Word32 Sched_add(Sch_State * st, void *chan, Sch_Frame process)
+{
+    Sch_Channel *ch;
+    Sch_Worker *w;
+    Word32 c;
+
+    if (st->nb_chan >= st->max_chan)
+    {
+        return -1;
+    }
+    c = st->nb_chan++;
+    w = &(st->worker[c % st->nb_workers]);
+
+    ch = &(st->chan[c]);
+    ch->chan = chan;
+    ch->process = process;
+    ch->worker = w->id;
+    ch->pending = 0;
+    ch->due = 0.0;
+
+    w->chan[w->nb_chan++] = c;
+
+    return c;
+}
+
+/*-----------------------------------------------------------------*
+ * Queue of a worker: a ring of channel numbers, under its lock.   *
+ *-----------------------------------------------------------------*/
+
+static void Push_back(Sch_Worker * w, Word32 c)
+{
+    w->queue[(w->head + w->count) % w->size] = c;
+    w->count++;
+
+    return;
+}
+
+static void Push_front(Sch_Worker * w, Word32 c)
+{
+    w->head = (w->head + w->size - 1) % w->size;
+    w->queue[w->head] = c;
+    w->count++;
+
+    return;
+}
+
+static Word32 Pop_front(Sch_Worker * w)
+{
+    Word32 c;
+
+    if (w->count == 0)
+    {
+        return -1;
+    }
+    c = w->queue[w->head];
+    w->head = (w->head + 1) % w->size;
+    w->count--;
+
+    return c;
+}
+
+/*-----------------------------------------------------------------*
+ * Queue_batch: the channels of worker w due at a tick. Channel k  *
+ * of a worker (w->chan[k]) is due at the ticks k % SCH_SLOTS.     *
+ *-----------------------------------------------------------------*/
+
+static void Queue_batch(Sch_Worker * w, Word32 tick)
+{
+    Sch_State *st = w->sched;
+    Sch_Channel *ch;
+    double due;
+    Word32 k;
+
+    due = st->start + (double) tick *TICK_US;
+
+    pthread_mutex_lock(&(w->lock));
+    for (k = tick % SCH_SLOTS; k < w->nb_chan; k += SCH_SLOTS)
+    {
+        ch = &(st->chan[w->chan[k]]);
+        if (ch->pending++ == 0)
+        {
+            ch->due = due;
+            Push_back(w, w->chan[k]);
+        }
+    }
+    w->stats.ticks++;
+    w->stats.queue_sum += (double) w->count;
+    if (w->count > w->stats.queue_max)
+    {
+        w->stats.queue_max = w->count;
+    }
+    pthread_mutex_unlock(&(w->lock));
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ * Take: the oldest frame of the worker's queue, else the oldest   *
+ * frame of the longest queue of the other workers.                *
+ *-----------------------------------------------------------------*/
+
+static Word32 Take(Sch_Worker * w, Word16 * stolen)
+{
+    Sch_State *st = w->sched;
+    Sch_Worker *v;
+    Word32 c, n, best;
+    Word16 k, victim;
+
+    *stolen = 0;
+
+    pthread_mutex_lock(&(w->lock));
+    c = Pop_front(w);
+    pthread_mutex_unlock(&(w->lock));
+    if (c >= 0)
+    {
+        return c;
+    }
+
+    for (;;)
+    {
+        /* the lengths are read without the locks: only a hint */
+        best = 0;
+        victim = -1;
+        for (k = 0; k < st->nb_workers; k++)
+        {
+            n = st->worker[k].count;
+            if ((k != w->id) && (n > best))
+            {
+                best = n;
+                victim = k;
+            }
+        }
+        if (victim < 0)
+        {
+            return -1;
+        }
+        v = &(st->worker[victim]);
+        pthread_mutex_lock(&(v->lock));
+        c = Pop_front(v);
+        pthread_mutex_unlock(&(v->lock));
+        if (c >= 0)
+        {
+            *stolen = 1;
+            return c;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------*
+ * Process: one frame of channel c, on worker w.                   *
+ *-----------------------------------------------------------------*/
+
+static void Process(Sch_Worker * w, Word32 c, Word16 stolen)
+{
+    Sch_State *st = w->sched;
+    Sch_Channel *ch = &(st->chan[c]);
+    Sch_Worker *home = &(st->worker[ch->worker]);
+    double late;
+
+    ch->process(ch->chan);
+
+    late = Now_us() - ch->due;
+    w->stats.frames++;
+    w->stats.stolen += stolen;
+    w->stats.late_sum += late;
+    if (late > DEADLINE_US)
+    {
+        w->stats.misses++;
+    }
+    if (late > (double) w->stats.late_max)
+    {
+        w->stats.late_max = (Word32) late;
+    }
+
+    /* a frame which became due meanwhile is the most urgent of its worker */
+    pthread_mutex_lock(&(home->lock));
+    if (--ch->pending > 0)
+    {
+        ch->due += FRAME_US;
+        Push_front(home, c);
+    }
+    pthread_mutex_unlock(&(home->lock));
+
+    return;
+}
+
+static void *Worker_thread(void *arg)
+{
+    Sch_Worker *w = (Sch_Worker *) arg;
+    Sch_State *st = w->sched;
+    Word32 tick, c;
+    Word16 stolen;
+    double now;
+
+#ifdef __linux__
+    if (st->pin)
+    {
+        cpu_set_t set;
+        long nb_cpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+        CPU_ZERO(&set);
+        CPU_SET(w->id % (nb_cpu > 0 ? nb_cpu : 1), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+
+    tick = 0;
+    for (;;)
+    {
+        now = Now_us();
+        while ((tick < st->nb_ticks) && (now >= st->start + (double) tick *TICK_US))
+        {
+            Queue_batch(w, tick);
+            tick++;
+        }
+
+        c = Take(w, &stolen);
+        if (c >= 0)
+        {
+            Process(w, c, stolen);
+            continue;
+        }
+        if (tick >= st->nb_ticks)
+        {
+            break;
+        }
+        Sleep_until(st->start + (double) tick *TICK_US);
+    }
+
+    return NULL;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Sched_run                                            *
+ *            ~~~~~~~~~                                            *
+ *   ->Runs nb_frames frames of all the channels in real time and  *
+ *     returns when they are all processed.                        *
+ *-----------------------------------------------------------------*/
+
+Word16 Sched_run(Sch_State * st, Word32 nb_frames)
+{
+    Sch_Worker *w;
+    Word32 c;
+    Word16 k, nb_started;
+
+    for (c = 0; c < st->nb_chan; c++)
+    {
+        st->chan[c].pending = 0;
+    }
+    for (k = 0; k < st->nb_workers; k++)
+    {
+        w = &(st->worker[k]);
+        w->head = 0;
+        w->count = 0;
+        w->stats.ticks = 0;
+        w->stats.frames = 0;
+        w->stats.stolen = 0;
+        w->stats.misses = 0;
+        w->stats.late_max = 0;
+        w->stats.late_sum = 0.0;
+        w->stats.queue_max = 0;
+        w->stats.queue_sum = 0.0;
+    }
+    st->nb_ticks = nb_frames * SCH_SLOTS;
+    st->start = Now_us() + TICK_US;        /* time to start the threads */
+
+    for (nb_started = 0; nb_started < st->nb_workers; nb_started++)
+    {
+        w = &(st->worker[nb_started]);
+        if (pthread_create(&(w->thread), NULL, Worker_thread, w) != 0)
+        {
+            fprintf(stderr, "Sched_run: can not start worker %d\n", nb_started);
+            break;
+        }
+    }
+    for (k = 0; k < nb_started; k++)
+    {
+        pthread_join(st->worker[k].thread, NULL);
+    }
+    if (nb_started < st->nb_workers)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+void Sched_stats(Sch_State * st, Sch_Stats * total)
+{
+    Sch_Stats *s;
+    Word16 k;
+
+    total->ticks = 0;
+    total->frames = 0;
+    total->stolen = 0;
+    total->misses = 0;
+    total->late_max = 0;
+    total->late_sum = 0.0;
+    total->queue_max = 0;
+    total->queue_sum = 0.0;
+
+    for (k = 0; k < st->nb_workers; k++)
+    {
+        s = &(st->worker[k].stats);
+        total->ticks += s->ticks;
+        total->frames += s->frames;
+        total->stolen += s->stolen;
+        total->misses += s->misses;
+        total->late_sum += s->late_sum;
+        total->queue_sum += s->queue_sum;
+        if (s->late_max > total->late_max)
+        {
+            total->late_max = s->late_max;
+        }
+        if (s->queue_max > total->queue_max)
+        {
+            total->queue_max = s->queue_max;
+        }
+    }
+    return;
+}
@@ -0,0 +1,88 @@
+/*--------------------------------------------------------------------------*
+ *                         RTSCHED.H                                        *
+ *--------------------------------------------------------------------------*
+ *       Deadline-aware scheduler of real-time channels (POSIX threads)     *
+ *--------------------------------------------------------------------------*/
+
+#ifndef rtsched_h
+#define rtsched_h
+
+#include <pthread.h>
+#include "typedef.h"
+
+#define SCH_FRAME_MS      20               /* one frame per channel every 20 ms           */
+#define SCH_TICK_MS       5                /* channels due in the same tick are batched   */
+#define SCH_SLOTS         (SCH_FRAME_MS / SCH_TICK_MS)
+#define SCH_DEADLINE_MS   SCH_FRAME_MS     /* a frame is done before the next one is due  */
+#define SCH_MAX_WORKERS   64
+
+typedef void (*Sch_Frame) (void *chan);    /* processes one frame of a channel           */
+
+typedef struct
+{
+    Word32 ticks;                          /* batches queued                              */
+    Word32 frames;                         /* frames processed                            */
+    Word32 stolen;                         /* frames taken from another worker's queue    */
+    Word32 misses;                         /* frames done after their deadline            */
+    Word32 late_max;                       /* highest lateness (us, due time to done)     */
+    double late_sum;                       /* sum of the lateness (us)                    */
+    Word32 queue_max;                      /* highest queue depth when a batch is queued  */
+    double queue_sum;
+} Sch_Stats;
+
+typedef struct
+{
+    void *chan;                            /* channel given to process()                  */
+    Sch_Frame process;
+    Word16 worker;                         /* home worker                                 */
+    Word32 pending;                        /* frames due and not done (home queue lock)   */
+    double due;                            /* due time of the oldest pending frame (us)   */
+} Sch_Channel;
+
+typedef struct
+{
+    pthread_t thread;
+    pthread_mutex_t lock;                  /* queue and pending counts of its channels    */
+    Word32 *queue;                         /* channels due (ring of size entries)         */
+    Word32 size;
+    Word32 head;
+    Word32 count;
+    Word32 *chan;                          /* channels of the worker                      */
+    Word32 nb_chan;
+    Word16 id;
+    struct Sch_State *sched;
+    Sch_Stats stats;
+} Sch_Worker;
+
+typedef struct Sch_State
+{
+    Word16 nb_workers;
+    Word16 pin;                            /* 1: worker n runs on processor n             */
+    Sch_Worker worker[SCH_MAX_WORKERS];
+
+    Sch_Channel *chan;
+    Word32 nb_chan;
+    Word32 max_chan;
+
+    Word32 nb_ticks;                       /* length of the run                           */
+    double start;                          /* start time of the run (us)                  */
+} Sch_State;
+
+Word16 Init_sched(Sch_State ** st, Word16 nb_workers, Word16 pin, Word32 max_chan);
+void Close_sched(Sch_State * st);
+
+Word32 Sched_add(                          /* Return the channel number, -1: full         */
+     Sch_State * st,                       /* i/o : scheduler state                       */
+     void *chan,                           /* i   : channel (codec state, buffers, ...)   */
+     Sch_Frame process                     /* i   : called for each frame of the channel  */
+);
+Word16 Sched_run(                          /* Return 0 if ok                              */
+     Sch_State * st,                       /* i/o : scheduler state                       */
+     Word32 nb_frames                      /* i   : frames per channel (x 20 ms)          */
+);
+void Sched_stats(
+     Sch_State * st,                       /* i   : scheduler state                       */
+     Sch_Stats * total                     /* o   : sum of the workers of the last run    */
+);
+
+#endif
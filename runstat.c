@@ -0,0 +1,403 @@
+/*------------------------------------------------------------------------*
+ *                         RUNSTAT.C                                      *
+ *------------------------------------------------------------------------*
+ * Run statistics of the programs                                         *
+ *                                                                        *
+ * The work of each frame (Run_start() .. Run_stop()) is timed on the     *
+ * wall clock and on the CPU time of the process (all its threads: with   *
+ * -pipe or -j the CPU time of a frame can exceed its wall time). The     *
+ * times are kept in histograms of 8 bins per octave from 1 us (bins of   *
+ * at most 12.5 %), from which the percentiles are read; the maxima are   *
+ * exact. The real-time factor is the wall time of the frames over the    *
+ * duration of the speech (20 ms per frame): below 1, faster than real    *
+ * time.                                                                  *
+ *                                                                        *
+ * The frames are counted by class of frame type, the speech frames by    *
+ * mode, and the VAD flag (first bit of a speech frame, 0 for the DTX     *
+ * frames) gives the activity. Run_report() writes all of it as one JSON  *
+ * object.                                                                *
+ *                                                                        *
+ * Run_progress() replaces the frame counter printed for each frame: it   *
+ * prints at most every RUN_PROGRESS s, and the last frame.               *
+ *------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#define POSIX_CLOCKS
+#endif
+
+#include "typedef.h"
+#include "cnst.h"
+#include "bits.h"
+#include "dtx.h"
+#include "runstat.h"
+
+#define FRAME_US   20000.0
+
+/*-----------------------------------------------------------------*
+ * Run_clock: wall clock and CPU time of the process, in us        *
+ *-----------------------------------------------------------------*/
+
+static void Run_clock(double *wall, double *cpu)
+{
+#ifdef POSIX_CLOCKS
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    *wall = (double) ts.tv_sec * 1e6 + (double) ts.tv_nsec * 1e-3;
+    if (cpu != NULL)
+    {
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        *cpu = (double) ts.tv_sec * 1e6 + (double) ts.tv_nsec * 1e-3;
+    }
+#else
+    *wall = (double) clock() * (1e6 / CLOCKS_PER_SEC);
+    if (cpu != NULL)
+    {
+        *cpu = *wall;
+    }
+#endif
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ * Histograms: bin i covers [lo(i), lo(i+1)[ with                  *
+ * lo(i) = 2^(i/8) x (1 + (i%8)/8) us, bin 0 also below 1 us.      *
+ *-----------------------------------------------------------------*/
+
+static double Bin_lo(Word16 i)
+{
+    return ldexp(1.0 + (double) (i % RUN_SUB) / RUN_SUB, i / RUN_SUB);
+}
+
+static void Hist_add(Run_Hist * h, double us)
+{
+    int e;
+    Word16 i;
+    double f;
+
+    i = 0;
+    if (us >= 1.0)
+    {
+        f = frexp(us, &e);                 /* us = f x 2^e, 0.5 <= f < 1 */
+        i = (Word16) ((e - 1) * RUN_SUB + (int) ((2.0 * f - 1.0) * RUN_SUB));
+        if (i >= RUN_BINS)
+        {
+            i = RUN_BINS - 1;
+        }
+    }
+    h->hist[i]++;
+    h->count++;
+    h->sum += us;
+    if (us > h->max)
+    {
+        h->max = us;
+    }
+
+    return;
+}
+
+/* upper bound of the bin of the p-quantile, at most the maximum */
+
+static double Hist_pct(Run_Hist * h, double p)
+{
+    Word16 i;
+    Word32 n, rank;
+    double hi;
+
+    if (h->count == 0)
+    {
+        return 0.0;
+    }
+    rank = (Word32) ceil(p * (double) h->count);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    n = 0;
+    for (i = 0; i < RUN_BINS - 1; i++)
+    {
+        n += h->hist[i];
+        if (n >= rank)
+        {
+            break;
+        }
+    }
+    hi = Bin_lo((Word16) (i + 1));
+
+    return (hi < h->max) ? hi : h->max;
+}
+
+static void Hist_json(FILE * fp, const char *name, Run_Hist * h)
+{
+    Word16 i, first;
+
+    fprintf(fp, "  \"%s\": {\"count\": %ld, \"mean\": %.1f, \"p50\": %.1f, \"p99\": %.1f, \"max\": %.1f,\n",
+        name, (long) h->count, h->count ? h->sum / h->count : 0.0, Hist_pct(h, 0.50), Hist_pct(h, 0.99), h->max);
+    fprintf(fp, "    \"hist\": [");
+    first = 1;
+    for (i = 0; i < RUN_BINS; i++)
+    {
+        if (h->hist[i] != 0)
+        {
+            fprintf(fp, "%s[%.1f, %ld]", first ? "" : ", ", (i == 0) ? 0.0 : Bin_lo(i), (long) h->hist[i]);
+            first = 0;
+        }
+    }
+    fprintf(fp, "]},\n");
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_runstat                                         *
+ *            ~~~~~~~~~~~~                                         *
+ *   ->Initialization of the statistics of a run. Without timing,  *
+ *     Run_start() and Run_stop() do nothing.                      *
+ *-----------------------------------------------------------------*/
+
+Word16 Init_runstat(Run_State ** state, const char *tool, Word16 timing)
+{
+    Run_State *st;
+
+    *state = NULL;
+
+    if ((st = (Run_State *) malloc(sizeof(Run_State))) == NULL)
+    {
+        fprintf(stderr, "Init_runstat: can not malloc state structure\n");
+        return -1;
+    }
+    st->tool = tool;
+    st->timing = timing;
+    Reset_runstat(st);
+
+    *state = st;
+
+    return 0;
+}
+
+void Reset_runstat(Run_State * st)
+{
+    Word16 i;
+
+    for (i = 0; i < RUN_BINS; i++)
+    {
+        st->h_wall.hist[i] = 0;
+        st->h_cpu.hist[i] = 0;
+    }
+    st->h_wall.count = st->h_cpu.count = 0;
+    st->h_wall.sum = st->h_cpu.sum = 0.0;
+    st->h_wall.max = st->h_cpu.max = 0.0;
+
+    st->frames = 0;
+    for (i = 0; i < RUN_TYPES; i++)
+    {
+        st->type[i] = 0;
+    }
+    for (i = 0; i < NUM_OF_MODES; i++)
+    {
+        st->mode[i] = 0;
+    }
+    st->vad = 0;
+    st->vad_known = 0;
+
+    Run_clock(&st->wall0, &st->cpu0);
+    st->wall = st->wall_end = st->wall0;
+    st->cpu = st->cpu_end = st->cpu0;
+    st->progress = st->wall0 - 1e6 * RUN_PROGRESS;
+
+    return;
+}
+
+void Close_runstat(Run_State * st)
+{
+    free(st);
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Run_start, Run_stop                                  *
+ *            ~~~~~~~~~~~~~~~~~~~                                  *
+ *   ->Time of the work of a frame.                                *
+ *-----------------------------------------------------------------*/
+
+void Run_start(Run_State * st)
+{
+    if (st->timing)
+    {
+        Run_clock(&st->wall, &st->cpu);
+    }
+    return;
+}
+
+void Run_stop(Run_State * st)
+{
+    if (st->timing)
+    {
+        Run_clock(&st->wall_end, &st->cpu_end);
+        Hist_add(&st->h_wall, st->wall_end - st->wall);
+        Hist_add(&st->h_cpu, st->cpu_end - st->cpu);
+    }
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Run_frame_tx, Run_frame_rx                           *
+ *            ~~~~~~~~~~~~~~~~~~~~~~~~~~                           *
+ *   ->Frame type, mode and VAD flag of a frame written by an      *
+ *     encoder or read by a decoder.                               *
+ *-----------------------------------------------------------------*/
+
+static void Run_count(Run_State * st, Word16 type, Word16 mode, Word16 vad)
+{
+    st->frames++;
+    st->type[type]++;
+    if ((type == RUN_SPEECH) && (mode >= 0) && (mode < NUM_OF_MODES))
+    {
+        st->mode[mode]++;
+    }
+    if (vad >= 0)
+    {
+        st->vad_known++;
+        st->vad += vad;
+    }
+    return;
+}
+
+void Run_frame_tx(Run_State * st, Word16 tx_type, Word16 mode, Word16 prms[])
+{
+    switch (tx_type)
+    {
+    case TX_SPEECH:
+        Run_count(st, RUN_SPEECH, mode, (Word16) (prms[0] == BIT_1));
+        break;
+    case TX_SID_FIRST:
+        Run_count(st, RUN_SID_FIRST, mode, 0);
+        break;
+    case TX_SID_UPDATE:
+        Run_count(st, RUN_SID_UPDATE, mode, 0);
+        break;
+    default:
+        Run_count(st, RUN_NO_DATA, mode, 0);
+        break;
+    }
+    return;
+}
+
+void Run_frame_rx(Run_State * st, Word16 rx_type, Word16 mode, Word16 prms[])
+{
+    switch (rx_type)
+    {
+    case RX_SPEECH_GOOD:
+        Run_count(st, RUN_SPEECH, mode, (Word16) (prms[0] == BIT_1));
+        break;
+    case RX_SPEECH_PROBABLY_DEGRADED:
+    case RX_SPEECH_LOST:
+    case RX_SPEECH_BAD:
+        Run_count(st, RUN_SPEECH_BAD, mode, -1);
+        break;
+    case RX_SID_FIRST:
+        Run_count(st, RUN_SID_FIRST, mode, 0);
+        break;
+    case RX_SID_UPDATE:
+        Run_count(st, RUN_SID_UPDATE, mode, 0);
+        break;
+    case RX_SID_BAD:
+        Run_count(st, RUN_SID_BAD, mode, 0);
+        break;
+    default:
+        Run_count(st, RUN_NO_DATA, mode, 0);
+        break;
+    }
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Run_progress                                         *
+ *            ~~~~~~~~~~~~                                         *
+ *   ->Frame counter on fp, at most every RUN_PROGRESS s; last:    *
+ *     the end of the run, always printed.                         *
+ *-----------------------------------------------------------------*/
+
+void Run_progress(FILE * fp, Run_State * st, const char *label, long frame, Word16 last)
+{
+    double now;
+
+    Run_clock(&now, NULL);
+    if ((last == 0) && (now - st->progress < 1e6 * RUN_PROGRESS))
+    {
+        return;
+    }
+    st->progress = now;
+    fprintf(fp, " %s: %ld\r", label, frame);
+    if (last)
+    {
+        fprintf(fp, "\n");
+    }
+    fflush(fp);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Run_report                                           *
+ *            ~~~~~~~~~~                                           *
+ *   ->Statistics of the run as a JSON object (times in us).       *
+ *-----------------------------------------------------------------*/
+
+void Run_report(FILE * fp, Run_State * st)
+{
+    static const char *const type_name[RUN_TYPES] =
+    {
+        "speech", "speech_bad", "sid_first", "sid_update", "sid_bad", "no_data"
+    };
+    static const char *const mode_name[NUM_OF_MODES] =
+    {
+        "6.60", "8.85", "12.65", "14.25", "15.85", "18.25", "19.85", "23.05", "23.85", "sid"
+    };
+    Word16 i, first;
+    double wall, cpu, audio;
+
+    Run_clock(&wall, &cpu);
+    audio = st->frames * FRAME_US;
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"tool\": \"%s\",\n", st->tool);
+    fprintf(fp, "  \"frames\": %ld,\n", (long) st->frames);
+    fprintf(fp, "  \"audio_s\": %.3f,\n", audio * 1e-6);
+    fprintf(fp, "  \"wall_s\": %.3f,\n", (wall - st->wall0) * 1e-6);
+    fprintf(fp, "  \"cpu_s\": %.3f,\n", (cpu - st->cpu0) * 1e-6);
+    if (st->timing)
+    {
+        fprintf(fp, "  \"real_time_factor\": %.5f,\n", (audio > 0.0) ? st->h_wall.sum / audio : 0.0);
+        fprintf(fp, "  \"real_time_factor_cpu\": %.5f,\n", (audio > 0.0) ? st->h_cpu.sum / audio : 0.0);
+        Hist_json(fp, "frame_wall_us", &st->h_wall);
+        Hist_json(fp, "frame_cpu_us", &st->h_cpu);
+    }
+    fprintf(fp, "  \"frame_types\": {");
+    for (i = 0; i < RUN_TYPES; i++)
+    {
+        fprintf(fp, "%s\"%s\": %ld", i ? ", " : "", type_name[i], (long) st->type[i]);
+    }
+    fprintf(fp, "},\n");
+    fprintf(fp, "  \"speech_modes\": {");
+    first = 1;
+    for (i = 0; i < NUM_OF_MODES - 1; i++)
+    {
+        if (st->mode[i] != 0)
+        {
+            fprintf(fp, "%s\"%s\": %ld", first ? "" : ", ", mode_name[i], (long) st->mode[i]);
+            first = 0;
+        }
+    }
+    fprintf(fp, "},\n");
+    fprintf(fp, "  \"vad_activity\": %.4f\n", st->vad_known ? (double) st->vad / st->vad_known : 0.0);
+    fprintf(fp, "}\n");
+
+    return;
+}
@@ -0,0 +1,80 @@
+/*--------------------------------------------------------------------------*
+ *                         RUNSTAT.H                                        *
+ *--------------------------------------------------------------------------*
+ *       Run statistics: frame times, real-time factor and frame types      *
+ *--------------------------------------------------------------------------*/
+
+#ifndef runstat_h
+#define runstat_h
+
+#include <stdio.h>
+#include "typedef.h"
+#include "cnst.h"
+
+#define RUN_SUB        8                   /* bins of the histograms per octave */
+#define RUN_OCTAVES    24                  /* 1 us to 16 s                      */
+#define RUN_BINS       (RUN_SUB * RUN_OCTAVES)
+
+#define RUN_PROGRESS   0.5                 /* s between two progress lines      */
+
+/* classes of the frames (TX and RX frame types of dtx.h) */
+#define RUN_SPEECH      0
+#define RUN_SPEECH_BAD  1                  /* degraded, lost or bad speech      */
+#define RUN_SID_FIRST   2
+#define RUN_SID_UPDATE  3
+#define RUN_SID_BAD     4
+#define RUN_NO_DATA     5
+#define RUN_TYPES       6
+
+typedef struct
+{
+    Word32 hist[RUN_BINS];                 /* frames of each bin                */
+    Word32 count;
+    double sum, max;                       /* us                                */
+} Run_Hist;
+
+typedef struct Run_State
+{
+    const char *tool;                      /* name of the program               */
+    Word16 timing;                         /* frame times measured              */
+    double wall0, cpu0;                    /* start of the run                  */
+    double wall, cpu;                      /* start of the frame (Run_start())  */
+    double wall_end, cpu_end;              /* end of the last frame             */
+    Run_Hist h_wall, h_cpu;
+
+    Word32 frames;
+    Word32 type[RUN_TYPES];                /* frames of each class              */
+    Word32 mode[NUM_OF_MODES];             /* speech frames of each mode        */
+    Word32 vad, vad_known;                 /* frames with VAD = 1, with a VAD   */
+
+    double progress;                       /* wall clock of the last progress   */
+} Run_State;
+
+Word16 Init_runstat(                       /* Return 0 if ok, -1 on error       */
+     Run_State ** st,                      /* o   : State structure             */
+     const char *tool,                     /* i   : name of the program         */
+     Word16 timing                         /* i   : measure the frame times     */
+);
+void Reset_runstat(Run_State * st);
+void Close_runstat(Run_State * st);
+
+void Run_start(Run_State * st);            /* start of the work of a frame      */
+void Run_stop(Run_State * st);             /* end of the work of a frame        */
+
+void Run_frame_tx(                         /* frame written by an encoder       */
+     Run_State * st,
+     Word16 tx_type,                       /* i   : TX_SPEECH .. TX_NO_DATA     */
+     Word16 mode,                          /* i   : mode of a speech frame      */
+     Word16 prms[]                         /* i   : bits of the frame           */
+);
+void Run_frame_rx(                         /* frame read by a decoder           */
+     Run_State * st,
+     Word16 rx_type,                       /* i   : RX_SPEECH_GOOD .. NO_DATA   */
+     Word16 mode,                          /* i   : mode of a speech frame      */
+     Word16 prms[]                         /* i   : bits of the frame           */
+);
+
+void Run_progress(FILE * fp, Run_State * st, const char *label, long frame, Word16 last);
+void Run_report(FILE * fp, Run_State * st);
+
+#endif
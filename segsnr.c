@@ -0,0 +1,109 @@
+/*___________________________________________________________________________
+ |                                                                           |
+ | Segmental SNR measurement between two 16 kHz speech files.                |
+ |___________________________________________________________________________|
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "typedef.h"
+#include "cnst.h"
+
+/*-----------------------------------------------------------------*
+ * SEGSNR.C                                                        *
+ * ~~~~~~~~                                                        *
+ * Compares a test file with a reference file (both 16 bits PCM,   *
+ * no header) and reports the global and the segmental SNR.        *
+ * Used to compare the floating-point engine (coder -float,        *
+ * decoder -float) with the bit-exact fixed-point path.            *
+ *                                                                 *
+ *    Usage : segsnr ref_file test_file                            *
+ *                                                                 *
+ * The segmental SNR is the average over L_FRAME16k frames of the  *
+ * frame SNR clipped to [SEG_MIN_DB, SEG_MAX_DB]; frames whose     *
+ * reference energy is below SIL_THRES (silence) are skipped.      *
+ *-----------------------------------------------------------------*/
+
+#define SEG_MIN_DB   -10.0
+#define SEG_MAX_DB   80.0
+#define SIL_THRES    (L_FRAME16k * 16.0 * 16.0)  /* mean amplitude 16 */
+
+int main(int argc, char *argv[])
+{
+    FILE *f_ref, *f_test;
+    Word16 ref[L_FRAME16k], test[L_FRAME16k];
+    Word16 i, n_ref, n_test;
+    double e_sig, e_err, d, snr;
+    double tot_sig, tot_err, seg_sum;
+    long frame, seg_frames, diff_frames;
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage : segsnr ref_file test_file\n");
+        exit(0);
+    }
+    if ((f_ref = fopen(argv[1], "rb")) == NULL)
+    {
+        fprintf(stderr, "Error opening input file  %s !!\n", argv[1]);
+        exit(0);
+    }
+    if ((f_test = fopen(argv[2], "rb")) == NULL)
+    {
+        fprintf(stderr, "Error opening input file  %s !!\n", argv[2]);
+        exit(0);
+    }
+
+    tot_sig = tot_err = seg_sum = 0.0;
+    frame = seg_frames = diff_frames = 0;
+
+    for (;;)
+    {
+        n_ref = (Word16) fread(ref, sizeof(Word16), L_FRAME16k, f_ref);
+        n_test = (Word16) fread(test, sizeof(Word16), L_FRAME16k, f_test);
+        if ((n_ref < L_FRAME16k) || (n_test < L_FRAME16k))
+            break;
+        frame++;
+
+        e_sig = e_err = 0.0;
+        for (i = 0; i < L_FRAME16k; i++)
+        {
+            d = (double) ref[i] - (double) test[i];
+            e_sig += (double) ref[i] * (double) ref[i];
+            e_err += d * d;
+        }
+        tot_sig += e_sig;
+        tot_err += e_err;
+        if (e_err != 0.0)
+            diff_frames++;
+
+        if (e_sig < SIL_THRES)
+            continue;
+
+        if (e_err == 0.0)
+            snr = SEG_MAX_DB;
+        else
+            snr = 10.0 * log10(e_sig / e_err);
+        if (snr < SEG_MIN_DB)
+            snr = SEG_MIN_DB;
+        if (snr > SEG_MAX_DB)
+            snr = SEG_MAX_DB;
+
+        seg_sum += snr;
+        seg_frames++;
+    }
+
+    printf("frames: %ld (%ld differ, %ld active)\n", frame, diff_frames, seg_frames);
+    if (tot_err == 0.0)
+        printf("SNR:    identical\n");
+    else
+        printf("SNR:    %6.2f dB\n", 10.0 * log10((tot_sig + 1.0) / tot_err));
+    if (seg_frames > 0)
+        printf("segSNR: %6.2f dB\n", seg_sum / (double) seg_frames);
+
+    fclose(f_ref);
+    fclose(f_test);
+
+    return (0);
+}
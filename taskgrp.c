@@ -0,0 +1,223 @@
+/*------------------------------------------------------------------------*
+ *                         TASKGRP.C                                      *
+ *------------------------------------------------------------------------*
+ * Task group                                                             *
+ *                                                                        *
+ * A few threads which wait for the tasks of one call: run() hands the n  *
+ * tasks to the helper threads, runs tasks itself and returns when the n  *
+ * tasks are done. The tasks are short (a codebook search iteration), so  *
+ * the helpers are created once and the tasks are taken one by one from  *
+ * a counter under the lock. One caller at a time: a group belongs to one *
+ * encoder.                                                               *
+ *                                                                        *
+ * Without POSIX threads, or with the complexity counters (which are not  *
+ * thread safe), run() runs the tasks in turn.                            *
+ *------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) && (WMOPS == 0)
+#define POSIX_TASKS
+#include <pthread.h>
+#endif
+
+#include "typedef.h"
+#include "taskgrp.h"
+
+#define TASK_MAX_THREADS  16
+
+#ifdef POSIX_TASKS
+typedef struct
+{
+    pthread_t thread[TASK_MAX_THREADS];
+    Word16 nb_helpers;
+    pthread_mutex_t lock;
+    pthread_cond_t start;                  /* a call is posted (or quit)             */
+    pthread_cond_t done;                   /* the last task of the call is done      */
+    Word32 call;                           /* number of the call posted              */
+    Task_Func func;
+    void *arg;
+    Word16 n;                              /* tasks of the call                      */
+    Word16 next;                           /* next task to run                       */
+    Word16 left;                           /* tasks not done                         */
+    Word16 quit;
+} Task_Threads;
+
+/* runs the tasks of the call until there are none left to take */
+static void Run_tasks(Task_Threads * t)
+{
+    Word16 i;
+
+    pthread_mutex_lock(&(t->lock));
+    while (t->next < t->n)
+    {
+        i = t->next++;
+        pthread_mutex_unlock(&(t->lock));
+
+        t->func(t->arg, i);
+
+        pthread_mutex_lock(&(t->lock));
+        if (--t->left == 0)
+        {
+            pthread_cond_signal(&(t->done));
+        }
+    }
+    pthread_mutex_unlock(&(t->lock));
+
+    return;
+}
+
+static void *Helper_thread(void *arg)
+{
+    Task_Threads *t = (Task_Threads *) arg;
+    Word32 call = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&(t->lock));
+        while ((t->call == call) && (t->quit == 0))
+        {
+            pthread_cond_wait(&(t->start), &(t->lock));
+        }
+        call = t->call;
+        if (t->quit != 0)
+        {
+            pthread_mutex_unlock(&(t->lock));
+            break;
+        }
+        pthread_mutex_unlock(&(t->lock));
+
+        Run_tasks(t);
+    }
+
+    return NULL;
+}
+
+static void Run_group(Task_Group * tg, Word16 n, Task_Func func, void *arg)
+{
+    Task_Threads *t = (Task_Threads *) tg->priv;
+
+    pthread_mutex_lock(&(t->lock));
+    t->func = func;
+    t->arg = arg;
+    t->n = n;
+    t->next = 0;
+    t->left = n;
+    t->call++;
+    pthread_cond_broadcast(&(t->start));
+    pthread_mutex_unlock(&(t->lock));
+
+    Run_tasks(t);
+
+    /* the tasks taken by the helpers */
+    pthread_mutex_lock(&(t->lock));
+    while (t->left > 0)
+    {
+        pthread_cond_wait(&(t->done), &(t->lock));
+    }
+    pthread_mutex_unlock(&(t->lock));
+
+    return;
+}
+#else
+static void Run_group(Task_Group * tg, Word16 n, Task_Func func, void *arg)
+{
+    Word16 i;
+
+    for (i = 0; i < n; i++)
+    {
+        func(arg, i);
+    }
+
+    return;
+}
+#endif
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_taskgrp                                         *
+ *            ~~~~~~~~~~~~                                         *
+ *   ->Group of nb_threads threads: the caller of run() and        *
+ *     nb_threads-1 helper threads.                                *
+ *-----------------------------------------------------------------*/
+
+Word16 Init_taskgrp(Task_Group ** state, Word16 nb_threads)
+{
+    Task_Group *tg;
+#ifdef POSIX_TASKS
+    Task_Threads *t;
+    Word16 k;
+#endif
+
+    *state = NULL;
+
+    if ((nb_threads < 1) || (nb_threads > TASK_MAX_THREADS))
+    {
+        fprintf(stderr, "Init_taskgrp: 1 to %d threads\n", TASK_MAX_THREADS);
+        return -1;
+    }
+    if ((tg = (Task_Group *) malloc(sizeof(Task_Group))) == NULL)
+    {
+        fprintf(stderr, "Init_taskgrp: can not malloc state structure\n");
+        return -1;
+    }
+    tg->run = Run_group;
+    tg->priv = NULL;
+
+#ifdef POSIX_TASKS
+    if ((t = (Task_Threads *) malloc(sizeof(Task_Threads))) == NULL)
+    {
+        fprintf(stderr, "Init_taskgrp: can not malloc state structure\n");
+        free(tg);
+        return -1;
+    }
+    pthread_mutex_init(&(t->lock), NULL);
+    pthread_cond_init(&(t->start), NULL);
+    pthread_cond_init(&(t->done), NULL);
+    t->call = 0;
+    t->n = 0;
+    t->next = 0;
+    t->left = 0;
+    t->quit = 0;
+    t->nb_helpers = 0;
+    tg->priv = t;
+
+    for (k = 0; k < nb_threads - 1; k++)
+    {
+        if (pthread_create(&(t->thread[k]), NULL, Helper_thread, t) != 0)
+        {
+            fprintf(stderr, "Init_taskgrp: can not create thread\n");
+            Close_taskgrp(tg);
+            return -1;
+        }
+        t->nb_helpers++;
+    }
+#endif
+    *state = tg;
+
+    return 0;
+}
+
+void Close_taskgrp(Task_Group * tg)
+{
+#ifdef POSIX_TASKS
+    Task_Threads *t = (Task_Threads *) tg->priv;
+    Word16 k;
+
+    pthread_mutex_lock(&(t->lock));
+    t->quit = 1;
+    pthread_cond_broadcast(&(t->start));
+    pthread_mutex_unlock(&(t->lock));
+    for (k = 0; k < t->nb_helpers; k++)
+    {
+        pthread_join(t->thread[k], NULL);
+    }
+    pthread_cond_destroy(&(t->done));
+    pthread_cond_destroy(&(t->start));
+    pthread_mutex_destroy(&(t->lock));
+    free(t);
+#endif
+    free(tg);
+
+    return;
+}
@@ -0,0 +1,32 @@
+/*--------------------------------------------------------------------------*
+ *                         TASKGRP.H                                        *
+ *--------------------------------------------------------------------------*
+ *       Small group of threads running the tasks of one call together      *
+ *--------------------------------------------------------------------------*/
+
+#ifndef taskgrp_h
+#define taskgrp_h
+
+#include "typedef.h"
+
+typedef void (*Task_Func) (void *arg, Word16 i);
+
+/* the codec only calls run(): it does not depend on the thread library */
+typedef struct Task_Group
+{
+    void (*run) (                          /* func(arg, i) for i = 0..n-1, returns when all are done */
+         struct Task_Group * tg,
+         Word16 n,
+         Task_Func func,
+         void *arg
+    );
+    void *priv;                            /* threads (taskgrp.c)                    */
+} Task_Group;
+
+Word16 Init_taskgrp(                       /* Return 0 if ok                         */
+     Task_Group ** tg,                     /* o   : group                            */
+     Word16 nb_threads                     /* i   : threads, the caller included     */
+);
+void Close_taskgrp(Task_Group * tg);
+
+#endif
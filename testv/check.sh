@@ -0,0 +1,229 @@
+#!/bin/sh
+#
+# Conformance of the fixed-point codec with the test vectors:
+#   - tst.inp encoded in the 9 modes and dtx.inp in mode 2 (DTX on), compared
+#     with tst_m*.cod and tst_md.cod;
+#   - tst_m*.cod and tst_md.cod decoded, compared with tst_m*.out and tst_md.out;
+# at each kernel level of the CPU (coder/decoder -cpu, see cpu_disp.c), then with
+# the pipelined encoder (-pipe) and the codebook search on 4 threads (-j 4).
+# The rate controller (-rate) has no reference: its bitstreams of tst.inp and
+# dtx.inp (DTX on) must be the same with -pipe and -j 4.
+# A MIME file ending in a NO_DATA frame must be decoded to its last frame.
+# batch runs the encodings and decodings of the vectors in worker processes.
+# The jitter buffer (decoder -jitter) has no reference file: the synthesis of
+# tst_m2.cod and tst_md.cod over a jbtrace trace (jitter, losses) must have the
+# CRC (cksum) given below. In the conference bridge, two talkers whose streams
+# have the VAD flag set in every frame must each receive the other one alone,
+# coded in its mode: the same stream as decoder and coder give.
+# The transrater (bsproc -mode 2) has no reference either: on a stream mixing
+# modes below and above 2, its synthesis must stay within BSP_SNR dB of the
+# synthesis of the input stream (segsnr).
+#
+# Run in testv/; BIN is the directory of the programs (default ..).
+# The exit status is 1 if a file differs or is not produced; only the kernel
+# levels the CPU lacks are skipped.
+
+BIN=${BIN:-..}
+BSP_SNR=12
+fail=0
+
+# encode and decode all the vectors; $1: name of the run, then the options of coder
+vectors()
+{
+    name=$1
+    shift
+    nb=0
+    for m in 0 1 2 3 4 5 6 7 8 d
+    do
+        if [ $m = d ]; then inp=dtx.inp; mode=2; else inp=tst.inp; mode=$m; fi
+        rm -f _chk.cod
+        $BIN/coder -dtx "$@" $mode $inp _chk.cod > /dev/null 2>&1
+        if [ ! -f _chk.cod ]; then
+            echo "  $name: no bitstream for tst_m$m.cod"
+            fail=1
+            continue
+        fi
+        if ! cmp -s tst_m$m.cod _chk.cod; then
+            echo "  $name: tst_m$m.cod DIFFERS"
+            fail=1
+        fi
+        nb=`expr $nb + 1`
+    done
+    echo "  $name: $nb bitstreams"
+}
+
+decode()
+{
+    name=$1
+    shift
+    nb=0
+    for m in 0 1 2 3 4 5 6 7 8 d
+    do
+        rm -f _chk.out
+        $BIN/decoder "$@" tst_m$m.cod _chk.out > /dev/null 2>&1
+        if [ ! -f _chk.out ]; then
+            echo "  $name: no synthesis for tst_m$m.out"
+            fail=1
+            continue
+        fi
+        if ! cmp -s tst_m$m.out _chk.out; then
+            echo "  $name: tst_m$m.out DIFFERS"
+            fail=1
+        fi
+        nb=`expr $nb + 1`
+    done
+    echo "  $name: $nb syntheses"
+}
+
+# 0 if the kernels of level $1 run on this CPU (coder -cpu, on an empty input)
+supported()
+{
+    rm -f _chk.cod
+    ! $BIN/coder -cpu $1 0 /dev/null _chk.cod 2>&1 | grep -q "not supported by the CPU"
+}
+
+echo "Test vectors"
+for level in ref c sse4.1 avx2 avx512bw
+do
+    if ! supported $level; then
+        echo "  $level: not supported by the CPU, skipped"
+        continue
+    fi
+    vectors "coder $level" -cpu $level
+    decode "decoder $level" -cpu $level
+done
+vectors "coder -pipe" -pipe
+vectors "coder -j 4" -j 4
+vectors "coder -stats" -stats _chk.json
+decode "decoder -stats" -stats _chk.json
+
+nb=0
+for inp in tst.inp dtx.inp
+do
+    rm -f _chk.cod _chk2.cod _chk3.cod
+    $BIN/coder -dtx -rate 12.65 $inp _chk.cod > /dev/null 2>&1
+    $BIN/coder -dtx -pipe -rate 12.65 $inp _chk2.cod > /dev/null 2>&1
+    $BIN/coder -dtx -j 4 -rate 12.65 $inp _chk3.cod > /dev/null 2>&1
+    if cmp -s _chk.cod _chk2.cod && cmp -s _chk.cod _chk3.cod; then
+        nb=`expr $nb + 1`
+    else
+        echo "  coder -rate: $inp DIFFERS with -pipe or -j 4"
+        fail=1
+    fi
+done
+echo "  coder -rate: $nb bitstreams"
+
+# MIME file of one page ending in a NO_DATA frame (ToC 0x7C, no speech byte),
+# parsed out of the mapping of the file: 4087 frames of NO_DATA synthesis
+rm -f _chk.awb _chk.out
+printf '#!AMR-WB\n' > _chk.awb
+dd if=/dev/zero bs=4087 count=1 2> /dev/null | tr '\000' '\174' >> _chk.awb
+if $BIN/decoder -mime _chk.awb _chk.out > /dev/null 2>&1 && \
+    [ `wc -c < _chk.out` -eq `expr 4087 \* 640` ]; then
+    echo "  decoder -mime: NO_DATA at the end of the file"
+else
+    echo "  decoder -mime: NO_DATA at the end of the file FAILS"
+    fail=1
+fi
+
+rm -f _chk.bat
+nb=0
+for m in 0 1 2 3 4 5 6 7 8 d
+do
+    if [ $m = d ]; then inp=dtx.inp; mode=2; else inp=tst.inp; mode=$m; fi
+    rm -f _chk_$m.cod _chk_$m.out
+    echo "enc -dtx $mode $inp _chk_$m.cod" >> _chk.bat
+    echo "dec tst_m$m.cod _chk_$m.out" >> _chk.bat
+done
+$BIN/batch -j 4 _chk.bat > /dev/null 2>&1
+for m in 0 1 2 3 4 5 6 7 8 d
+do
+    if cmp -s tst_m$m.cod _chk_$m.cod && cmp -s tst_m$m.out _chk_$m.out; then
+        nb=`expr $nb + 1`
+    else
+        echo "  batch: tst_m$m.cod or tst_m$m.out DIFFERS"
+        fail=1
+    fi
+    rm -f _chk_$m.cod _chk_$m.out
+done
+echo "  batch -j 4: $nb bitstreams and syntheses"
+
+# jbtrace 200 frames, 60 ms delay, 20 ms mean jitter, 10 % losses, seed 7
+$BIN/jbtrace 200 60 20 10 0 7 > _chk.tr 2> /dev/null
+for v in "tst_m2 4239816952 133120" "tst_md 3005250937 129920"
+do
+    set -- $v
+    rm -f _chk.out
+    $BIN/decoder -jitter _chk.tr $1.cod _chk.out > /dev/null 2>&1
+    crc=`cksum < _chk.out 2> /dev/null`
+    if [ "$crc" = "$2 $3" ]; then
+        echo "  decoder -jitter: $1.cod"
+    else
+        echo "  decoder -jitter: $1.cod DIFFERS"
+        fail=1
+    fi
+done
+
+# $1 with the VAD flag set in every frame of $2 bytes (default format, no DTX)
+vad_on()
+{
+    cp $1 _chk_vad.cod
+    k=0
+    n=`wc -c < $1`
+    n=`expr $n / $2`
+    while [ $k -lt $n ]
+    do
+        printf '\177\000' | dd of=_chk_vad.cod bs=1 seek=`expr $2 \* $k + 6` conv=notrunc 2> /dev/null
+        k=`expr $k + 1`
+    done
+}
+
+# talkers A (mode 2 in, mode 1 out) and B (mode 0 in, mode 8 out), listener C
+rm -f _chk_a.cod _chk_b.cod _chk_c.cod _chk.out _chk2.out _chk3.cod _chk4.cod
+vad_on tst_m2.cod 512
+mv _chk_vad.cod _chk_a.cod
+vad_on tst_m0.cod 270
+mv _chk_vad.cod _chk_b.cod
+: > _chk_c.cod
+$BIN/bridge 1 _chk_a.cod _chk_a.out 8 _chk_b.cod _chk_b.out 2 _chk_c.cod _chk_c.out > /dev/null 2>&1
+$BIN/decoder _chk_a.cod _chk.out > /dev/null 2>&1
+$BIN/decoder _chk_b.cod _chk2.out > /dev/null 2>&1
+$BIN/coder 8 _chk.out _chk3.cod > /dev/null 2>&1
+$BIN/coder 1 _chk2.out _chk4.cod > /dev/null 2>&1
+if [ -s _chk_c.out ] && cmp -s _chk3.cod _chk_b.out && cmp -s _chk4.cod _chk_a.out; then
+    echo "  bridge: mix-minus of 2 talkers"
+else
+    echo "  bridge: mix-minus of 2 talkers DIFFERS"
+    fail=1
+fi
+rm -f _chk_a.cod _chk_b.cod _chk_c.cod _chk_a.out _chk_b.out _chk_c.out _chk3.cod _chk4.cod
+
+rm -f _chk.mod _chk.cod _chk2.cod _chk.out _chk2.out
+i=0
+while [ $i -lt 25 ]
+do
+    for m in 0 1 8 6 8 2 7 3
+    do
+        echo $m >> _chk.mod
+    done
+    i=`expr $i + 1`
+done
+$BIN/coder -modefile _chk.mod tst.inp _chk.cod > /dev/null 2>&1
+$BIN/bsproc -mode 2 _chk.cod _chk2.cod > /dev/null 2>&1
+$BIN/decoder _chk.cod _chk.out > /dev/null 2>&1
+$BIN/decoder _chk2.cod _chk2.out > /dev/null 2>&1
+snr=`$BIN/segsnr _chk.out _chk2.out 2> /dev/null | awk '/^SNR:/ { if ($2 == "identical") print 99; else print int($2) }'`
+if [ -n "$snr" ] && [ $snr -ge $BSP_SNR ]; then
+    echo "  bsproc -mode 2: mixed modes, SNR $snr dB"
+else
+    echo "  bsproc -mode 2: mixed modes, SNR ${snr:-none} dB, below $BSP_SNR dB"
+    fail=1
+fi
+
+rm -f _chk.cod _chk2.cod _chk3.cod _chk.out _chk2.out _chk.mod _chk.awb _chk.json _chk.bat _chk.tr
+if [ $fail = 0 ]; then
+    echo "All vectors bit-exact"
+else
+    echo "VECTORS DIFFER"
+fi
+exit $fail
@@ -0,0 +1,46 @@
+..\c-code\decoder.exe -float tst_m0.cod _tst_fd0.out
+..\c-code\decoder.exe -float tst_m1.cod _tst_fd1.out
+..\c-code\decoder.exe -float tst_m2.cod _tst_fd2.out
+..\c-code\decoder.exe -float tst_m3.cod _tst_fd3.out
+..\c-code\decoder.exe -float tst_m4.cod _tst_fd4.out
+..\c-code\decoder.exe -float tst_m5.cod _tst_fd5.out
+..\c-code\decoder.exe -float tst_m6.cod _tst_fd6.out
+..\c-code\decoder.exe -float tst_m7.cod _tst_fd7.out
+..\c-code\decoder.exe -float tst_m8.cod _tst_fd8.out
+..\c-code\decoder.exe -float tst_md.cod _tst_fdd.out
+
+..\c-code\coder.exe -dtx -float 0 tst.inp _tst_fm0.cod
+..\c-code\coder.exe -dtx -float 1 tst.inp _tst_fm1.cod
+..\c-code\coder.exe -dtx -float 2 tst.inp _tst_fm2.cod
+..\c-code\coder.exe -dtx -float 3 tst.inp _tst_fm3.cod
+..\c-code\coder.exe -dtx -float 4 tst.inp _tst_fm4.cod
+..\c-code\coder.exe -dtx -float 5 tst.inp _tst_fm5.cod
+..\c-code\coder.exe -dtx -float 6 tst.inp _tst_fm6.cod
+..\c-code\coder.exe -dtx -float 7 tst.inp _tst_fm7.cod
+..\c-code\coder.exe -dtx -float 8 tst.inp _tst_fm8.cod
+..\c-code\coder.exe -dtx -float 2 dtx.inp _tst_fmd.cod
+
+..\c-code\decoder.exe -float _tst_fm0.cod _tst_fm0.out
+..\c-code\decoder.exe -float _tst_fm1.cod _tst_fm1.out
+..\c-code\decoder.exe -float _tst_fm2.cod _tst_fm2.out
+..\c-code\decoder.exe -float _tst_fm3.cod _tst_fm3.out
+..\c-code\decoder.exe -float _tst_fm4.cod _tst_fm4.out
+..\c-code\decoder.exe -float _tst_fm5.cod _tst_fm5.out
+..\c-code\decoder.exe -float _tst_fm6.cod _tst_fm6.out
+..\c-code\decoder.exe -float _tst_fm7.cod _tst_fm7.out
+..\c-code\decoder.exe -float _tst_fm8.cod _tst_fm8.out
+..\c-code\decoder.exe -float _tst_fmd.cod _tst_fmd.out
+
+..\c-code\segsnr.exe tst_m0.out _tst_fd0.out
+..\c-code\segsnr.exe tst_m1.out _tst_fd1.out
+..\c-code\segsnr.exe tst_m2.out _tst_fd2.out
+..\c-code\segsnr.exe tst_m3.out _tst_fd3.out
+..\c-code\segsnr.exe tst_m4.out _tst_fd4.out
+..\c-code\segsnr.exe tst_m5.out _tst_fd5.out
+..\c-code\segsnr.exe tst_m6.out _tst_fd6.out
+..\c-code\segsnr.exe tst_m7.out _tst_fd7.out
+..\c-code\segsnr.exe tst_m8.out _tst_fd8.out
+..\c-code\segsnr.exe tst_md.out _tst_fdd.out
+
+del _tst_f*.cod
+del _tst_f*.out
@@ -0,0 +1,174 @@
+/*------------------------------------------------------------------------*
+ *                         TRANSRATE.C                                    *
+ *------------------------------------------------------------------------*
+ * Transrating to a lower mode in the parameter domain                    *
+ *------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "typedef.h"
+#include "basic_op.h"
+#include "cnst.h"
+#include "bits.h"
+#include "dtx.h"
+#include "main.h"
+#include "count.h"
+#include "transrate.h"
+
+/*-----------------------------------------------------------------*
+ * A frame is transrated to a lower mode (e.g. on a CMR request)   *
+ * by decoding it and encoding it again, without the front-end of  *
+ * the encoder:                                                    *
+ *                                                                 *
+ * - the decoder stops at the 12.8kHz synthesis before deemphasis, *
+ *   which is the signal coded by the encoder (no deemphasis,      *
+ *   oversampling or HF generation, see Set_decoder_trans()).      *
+ * - the encoder takes the decoded ISFs instead of the LPC         *
+ *   analysis (Decim_12k8, Autocorr, Levinson, Az_isp) and         *
+ *   requantizes them with the quantizer of the new mode           *
+ *   (Qpisf_2s_36b/46b); the closed-loop pitch search is centered  *
+ *   on the decoded lags instead of Pitch_med_ol(). The codebook   *
+ *   and gain searches are those of the new mode (coder_trans()).  *
+ *                                                                 *
+ * Frames of a mode not above the requested mode, lost frames and  *
+ * DTX frames (SID, NO_DATA) are passed through unchanged. On the  *
+ * speech frames passed through, the memories of the encoder are   *
+ * set to those of the decoder (coder_trans_update()), so that the *
+ * next transrated frame starts from the state of the far-end      *
+ * decoder.                                                        *
+ *-----------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Init_transrate                                       *
+ *            ~~~~~~~~~~~~~~                                       *
+ *   ->Initialization of the decoder and encoder of the transrater.*
+ *-----------------------------------------------------------------*/
+
+Word16 Init_transrate(Trans_State ** state)
+{
+    Trans_State *st;
+
+    *state = NULL;
+
+    test();
+    if ((st = (Trans_State *) malloc(sizeof(Trans_State))) == NULL)
+    {
+        fprintf(stderr, "Init_transrate: can not malloc state structure\n");
+        return -1;
+    }
+    Init_decoder(&(st->dec_state));
+    Init_coder(&(st->enc_state));
+
+    test();test();
+    if ((st->dec_state == NULL) || (st->enc_state == NULL))
+    {
+        fprintf(stderr, "Init_transrate: can not init decoder/encoder\n");
+        Close_transrate(st);
+        return -1;
+    }
+    Set_decoder_trans(st->dec_state, &(st->parm));
+
+    *state = st;
+
+    return 0;
+}
+
+void Reset_transrate(Trans_State * st)
+{
+    Reset_decoder(st->dec_state, 1);
+    Reset_encoder(st->enc_state, 1);
+
+    return;
+}
+
+void Close_transrate(Trans_State * st)
+{
+    test();
+    if (st->dec_state != NULL)
+    {
+        Close_decoder(st->dec_state);
+    }
+    test();
+    if (st->enc_state != NULL)
+    {
+        Close_coder(st->enc_state);
+    }
+    free(st);
+
+    return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Funtion  Transrate                                            *
+ *            ~~~~~~~~~                                            *
+ *   ->Rewrites one received frame in a mode not above mode_out.   *
+ *     Speech frames above mode_out (also bad frames, which are    *
+ *     concealed by the decoder) are coded again in mode_out and   *
+ *     become good frames. A decoder homing frame resets the       *
+ *     transrater and becomes the homing frame of mode_out.        *
+ *-----------------------------------------------------------------*/
+
+void Transrate(
+     Word16 mode_out,                      /* i   : highest mode of the output  */
+     Word16 * mode,                        /* i/o : used mode                   */
+     Word16 prms[],                        /* i/o : parameter vector (serial)   */
+     Word16 * frame_type,                  /* i/o : received frame type         */
+     Trans_State * st                      /* i/o : State structure             */
+)
+{
+    Word16 synth[L_FRAME16k];              /* not written (see Set_decoder_trans) */
+    Word16 frame_length, recode;
+
+    /* speech frames above mode_out, except lost frames (bits not usable) */
+
+    recode = 0;                            move16();
+    test();test();test();
+    if ((sub(*mode, mode_out) > 0) && (sub(*mode, MODE_24k) <= 0) &&
+        ((sub(*frame_type, RX_SPEECH_GOOD) == 0) ||
+         (sub(*frame_type, RX_SPEECH_PROBABLY_DEGRADED) == 0) ||
+         (sub(*frame_type, RX_SPEECH_BAD) == 0)))
+    {
+        recode = 1;                        move16();
+    }
+
+    test();test();
+    if ((sub(*frame_type, RX_SPEECH_GOOD) == 0) && (sub(*mode, MODE_24k) <= 0) &&
+        (decoder_homing_frame_test(prms, *mode) != 0))
+    {
+        Reset_transrate(st);
+
+        test();
+        if (recode != 0)
+        {
+            *mode = mode_out;              move16();
+            decoder_homing_frame(prms, mode_out);
+        }
+        return;
+    }
+
+    decoder(*mode, prms, synth, &frame_length, st->dec_state, *frame_type);
+
+    test();
+    if (sub(st->parm.dtx_state, SPEECH) != 0)
+    {
+        /* comfort noise: SID frames are sent as received, */
+        /* the encoder memories are reset as in coder()    */
+        Reset_encoder(st->enc_state, 0);
+        return;
+    }
+    test();
+    if (recode == 0)
+    {
+        /* passed through: the encoder follows the far-end decoder */
+        coder_trans_update(*mode, &(st->parm), st->enc_state);
+        return;
+    }
+
+    coder_trans(mode_out, &(st->parm), prms, st->enc_state);
+
+    *mode = mode_out;                      move16();
+    *frame_type = RX_SPEECH_GOOD;          move16();
+
+    return;
+}
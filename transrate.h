@@ -0,0 +1,67 @@
+/*--------------------------------------------------------------------------*
+ *                         TRANSRATE.H                                      *
+ *--------------------------------------------------------------------------*
+ *       Transrating to a lower mode in the parameter domain                *
+ *--------------------------------------------------------------------------*/
+
+#ifndef transrate_h
+#define transrate_h
+
+#include "typedef.h"
+#include "cnst.h"
+
+/* decoded frame handed from the decoder to the encoder */
+
+typedef struct
+{
+    Word16 dtx_state;                      /* SPEECH, DTX or DTX_MUTE                 */
+    Word16 vad_flag;                       /* VAD flag of the received frame          */
+    Word16 isf[M];                         /* decoded isf at 4th subframe             */
+    Word16 T0[NB_SUBFR];                   /* decoded pitch lag (integer part)        */
+    Word16 speech[L_FRAME];                /* 12.8kHz synthesis before deemphasis     */
+                                           /* (x 0.5, scale of speech[] in coder())   */
+
+    /* memories of the decoder after the frame (coder_trans_update()) */
+    Word16 old_exc[PIT_MAX + L_INTERPOL];  /* past excitation, scaled by Q_exc        */
+    Word16 Q_exc;
+    Word16 past_isfq[M];                   /* ISF predictor                           */
+    Word16 past_qua_en[4];                 /* gain predictor                          */
+    Word16 tilt_code;                      /* tilt of code                            */
+} Trans_Parm;
+
+typedef struct
+{
+    void *dec_state;                       /* decoder of the received stream          */
+    void *enc_state;                       /* encoder of the transrated stream        */
+    Trans_Parm parm;
+} Trans_State;
+
+Word16 Init_transrate(Trans_State ** st);
+void Reset_transrate(Trans_State * st);
+void Close_transrate(Trans_State * st);
+
+void Transrate(
+     Word16 mode_out,                      /* i   : highest mode of the output  */
+     Word16 * mode,                        /* i/o : used mode                   */
+     Word16 prms[],                        /* i/o : parameter vector (serial)   */
+     Word16 * frame_type,                  /* i/o : received frame type         */
+     Trans_State * st                      /* i/o : State structure             */
+);
+
+/* decoder and encoder sides (dec_main.c, cod_main.c) */
+
+void Set_decoder_trans(void *spd_state, Trans_Parm * parm);
+
+void coder_trans(
+     Word16 mode,                          /* input :  used mode (below 23.85k)              */
+     Trans_Parm * parm,                    /* input :  decoded frame                         */
+     Word16 prms[],                        /* output:  output parameters                     */
+     void *spe_state                       /* i/o   :  State structure                       */
+);
+void coder_trans_update(
+     Word16 mode,                          /* input :  mode of the received frame            */
+     Trans_Parm * parm,                    /* input :  decoded frame                         */
+     void *spe_state                       /* i/o   :  State structure                       */
+);
+
+#endif
@@ -118,6 +118,20 @@ typedef unsigned long UWord32;
 #error cannot find 32-bit type
 #endif
 
+/*
+ ********* define 64 bit signed type & constants (optional: maxWord64
+ ********* is not defined if the compiler has no 64-bit integer)
+ */
+#if LONG_MAX > 2147483647
+typedef long Word64;
+#define minWord64     LONG_MIN
+#define maxWord64     LONG_MAX
+#elif defined(LLONG_MAX)
+typedef long long Word64;
+#define minWord64     LLONG_MIN
+#define maxWord64     LLONG_MAX
+#endif
+
 /*
  ********* define floating point type & constants
  */
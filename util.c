@@ -38,7 +38,7 @@ void Set_zero(
  *-------------------------------------------------------------------*/
 
 void Copy(
-     Word16 x[],                           /* (i)   : input vector   */
+     const Word16 x[],                     /* (i)   : input vector   */
      Word16 y[],                           /* (o)   : output vector  */
      Word16 L                              /* (i)   : vector length  */
 )
@@ -52,3 +52,95 @@ void Copy(
 
     return;
 }
+
+
+/*-------------------------------------------------------------------*
+ * Function  Fir_sym31:                                              *
+ *           ~~~~~~~~~~                                              *
+ * 31-tap FIR filter with symmetric coefficients (fir[j]=fir[30-j]): *
+ *   y[i] = round(sum(x[i+j]*fir[j], j=0..30))   i=0..lg-1           *
+ * x[] holds the 30 samples of memory followed by the lg inputs.     *
+ *                                                                   *
+ * When the sum of |x[]*fir[]| cannot saturate the accumulator, the  *
+ * result is the exact sum, which is computed with the symmetric     *
+ * taps added before the multiplication (16 products instead of 31) *
+ * and 4 outputs per pass in native integer arithmetic, so the       *
+ * compiler can vectorize it. Otherwise, and for the complexity      *
+ * count (WMOPS), the L_mac() loop is used: the output is the same.  *
+ *-------------------------------------------------------------------*/
+
+#define L_FIR31 31
+#define NB_OUT  4                          /* outputs per pass */
+
+void Fir_sym31(
+     Word16 x[],                           /* (i)   : memory + input, lg+30 samples */
+     const Word16 fir[],                   /* (i)   : symmetric coefficients (31)   */
+     Word16 y[],                           /* (o)   : output, lg samples            */
+     Word16 lg                             /* (i)   : number of outputs             */
+)
+{
+    Word16 i, j;
+    Word32 L_tmp;
+#if (WMOPS == 0)
+    Word32 s0, s1, s2, s3, c, max, sum;
+
+    max = 0;
+    for (i = 0; i < lg + L_FIR31 - 1; i++)
+    {
+        c = (x[i] < 0) ? -(Word32) x[i] : (Word32) x[i];
+        if (c > max)
+            max = c;
+    }
+    sum = 0;
+    for (j = 0; j < L_FIR31; j++)
+    {
+        sum += (fir[j] < 0) ? -(Word32) fir[j] : (Word32) fir[j];
+    }
+
+    /* 2 x sum(|x[]*fir[]|) < 2^31: L_mac() never saturates */
+    if ((sum == 0) || (max < 0x40000000L / sum))
+    {
+        for (i = 0; i <= lg - NB_OUT; i += NB_OUT)
+        {
+            c = fir[L_FIR31 / 2];
+            s0 = c * x[i + L_FIR31 / 2];
+            s1 = c * x[i + 1 + L_FIR31 / 2];
+            s2 = c * x[i + 2 + L_FIR31 / 2];
+            s3 = c * x[i + 3 + L_FIR31 / 2];
+
+            for (j = 0; j < L_FIR31 / 2; j++)
+            {
+                c = fir[j];
+                s0 += c * (x[i + j] + x[i + L_FIR31 - 1 - j]);
+                s1 += c * (x[i + 1 + j] + x[i + L_FIR31 - j]);
+                s2 += c * (x[i + 2 + j] + x[i + L_FIR31 + 1 - j]);
+                s3 += c * (x[i + 3 + j] + x[i + L_FIR31 + 2 - j]);
+            }
+            y[i] = round(s0 << 1);
+            y[i + 1] = round(s1 << 1);
+            y[i + 2] = round(s2 << 1);
+            y[i + 3] = round(s3 << 1);
+        }
+        for (; i < lg; i++)
+        {
+            s0 = fir[L_FIR31 / 2] * x[i + L_FIR31 / 2];
+            for (j = 0; j < L_FIR31 / 2; j++)
+            {
+                s0 += fir[j] * (x[i + j] + x[i + L_FIR31 - 1 - j]);
+            }
+            y[i] = round(s0 << 1);
+        }
+        return;
+    }
+#endif
+
+    for (i = 0; i < lg; i++)
+    {
+        L_tmp = 0;                         move32();
+        for (j = 0; j < L_FIR31; j++)
+            L_tmp = L_mac(L_tmp, x[i + j], fir[j]);
+        y[i] = round(L_tmp);               move16();
+    }
+
+    return;
+}